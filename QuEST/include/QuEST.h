@@ -70,6 +70,8 @@ typedef struct {
 
 /** Represents an array of complex numbers grouped into an array of 
  * real components and an array of coressponding complex components.
+ * When compiled with #INTERLEAVED_AMPS, both arrays instead point into a single
+ * array of alternating real and imaginary components.
  *
  * @ingroup type
  * @author Ania Brown
@@ -268,6 +270,89 @@ enum phaseFunc {
  */
 enum bitEncoding {UNSIGNED=0, TWOS_COMPLEMENT=1};
 
+/** Flags for specifying the single-qubit decoherence channel of a ::NoiseChannel.
+ *
+ *    - \p NO_NOISE leaves the qubit unchanged
+ *    - \p DEPHASING_NOISE is the channel induced by mixDephasing()
+ *    - \p DEPOLARISING_NOISE is the channel induced by mixDepolarising()
+ *    - \p DAMPING_NOISE is the channel induced by mixDamping()
+ *    - \p PAULI_NOISE is the channel induced by mixPauli()
+ *
+ * @see
+ * - mixNoiseLayer()
+ *
+ * @ingroup type
+ */
+enum noiseChannelType {NO_NOISE=0, DEPHASING_NOISE=1, DEPOLARISING_NOISE=2, DAMPING_NOISE=3, PAULI_NOISE=4};
+
+/** A single-qubit decoherence channel, of which mixNoiseLayer() applies one to every qubit.
+ *
+ * @see
+ * - mixNoiseLayer()
+ * - setGateNoise()
+ *
+ * @ingroup type
+ */
+typedef struct NoiseChannel
+{
+    //! The kind of channel
+    enum noiseChannelType type;
+    //! The probability of a \p DEPHASING_NOISE, \p DEPOLARISING_NOISE or \p DAMPING_NOISE channel,
+    //! as accepted by mixDephasing(), mixDepolarising() and mixDamping() respectively
+    qreal prob;
+    //! The probabilities of the X, Y and Z errors of a \p PAULI_NOISE channel, as accepted by mixPauli()
+    qreal probX, probY, probZ;
+} NoiseChannel;
+
+/** Flags for specifying the gates of a ::NoiseModel which induce a channel, by the number of 
+ * qubits (controls and targets together) they act upon.
+ *
+ *    - \p ONE_QUBIT_GATES are gates upon a single qubit, like hadamard() and rotateX()
+ *    - \p TWO_QUBIT_GATES are gates upon two qubits, like controlledNot(), swapGate() and 
+ *      twoQubitUnitary()
+ *    - \p MULTI_QUBIT_GATES are gates upon three or more qubits, like multiControlledUnitary()
+ *      with two controls
+ *
+ * @see
+ * - setGateNoise()
+ * - setGateKrausNoise()
+ *
+ * @ingroup type
+ */
+enum noisyGateType {ONE_QUBIT_GATES=0, TWO_QUBIT_GATES=1, MULTI_QUBIT_GATES=2};
+
+/** A description of the decoherence which accompanies every gate and measurement of a density 
+ * matrix, to which it is attached by attachNoiseModel(). 
+ *
+ * After a gate of type t (a ::noisyGateType) acts upon a qubit q (as a control or target), q 
+ * undergoes the single-qubit channel at index t*numQubits + q, which is either a ::NoiseChannel
+ * in \p channels, or a custom Kraus map in \p krausOps (when \p numKrausOps at that index is 
+ * non-zero). Before qubit q is measured, it undergoes a bit-flip with probability 
+ * \p readoutErrorProbs[q].
+ *
+ * The model should be populated with setGateNoise(), setGateKrausNoise() and setReadoutNoise(),
+ * which validate each channel, rather than by modifying its fields directly.
+ *
+ * @see
+ * - createNoiseModel()
+ * - attachNoiseModel()
+ *
+ * @ingroup type
+ */
+typedef struct NoiseModel
+{
+    //! The number of qubits of the density matrices to which the model can be attached
+    int numQubits;
+    //! The channel induced upon each qubit by each ::noisyGateType, at index type*numQubits + qubit
+    NoiseChannel* channels;
+    //! The number of Kraus operators of the custom channel replacing each of \p channels, else 0
+    int* numKrausOps;
+    //! The Kraus operators of each custom channel, else NULL
+    ComplexMatrix2** krausOps;
+    //! The probability that measuring each qubit reports the incorrect outcome
+    qreal* readoutErrorProbs;
+} NoiseModel;
+
 /** A Pauli Hamiltonian, expressed as a real-weighted sum of pauli products,
  * and which can hence represent any Hermitian operator.
  *
@@ -312,6 +397,55 @@ typedef struct DiagonalOp
     ComplexArray deviceOperator;
 } DiagonalOp;
 
+/// \cond HIDDEN_SYMBOLS
+
+/** A buffer of deferred gates, which are fused into a single dense matrix 
+ * upon arrival and applied to the state only when needed. When cache-blocking,
+ * full fused matrices are further queued, and applied together to each tile of
+ * 2^numTileQubits amplitudes in turn.
+ *
+ * @ingroup type
+ */
+typedef struct {
+    
+    int isDeferring;    // whether gates are being fused rather than immediately applied
+    int maxNumQubits;   // the maximum number of qubits the fused gate may act upon
+    int numQubits;      // the number of qubits the fused gate currently acts upon
+    int numGates;       // the number of gates fused since the fused gate was last applied
+    int* qubits;        // the qubits of the fused gate, in order of their significance in the matrix
+    qreal** fusedReal;  // the fused 2^maxNumQubits by 2^maxNumQubits matrix, of which only
+    qreal** fusedImag;  // the leading 2^numQubits rows and columns are populated
+    qreal** gateReal;   // workspace for the matrix of the next gate to be fused
+    qreal** gateImag;
+    qreal* ampsReal;    // workspace for multiplying a gate onto a column of the fused matrix
+    qreal* ampsImag;
+    
+    int numTileQubits;          // the number of (lowest) qubits per tile, or 0 if not cache-blocking
+    int numTiledGates;          // the number of fused matrices awaiting application to every tile
+    int maxNumTiledGates;       // the capacity of tiledGates and tiledTargs
+    ComplexMatrixN* tiledGates; // the fused matrices awaiting application to every tile
+    int** tiledTargs;           // the (tile-local) qubits of each of tiledGates
+    int* physicalQubits;        // the qubit in the state which stores each qubit of the circuit
+    int* circuitQubits;         // the inverse of physicalQubits
+    long long int* lastUsed;    // the gate count when each physical qubit was last targeted
+    long long int gateCount;    // the number of gates deferred since startDeferringGatesInTiles()
+    
+} GateQueue;
+
+/* A counter-based (Philox4x32-10) random number stream, owned by a Qureg. 
+ * The i-th number of sub-stream s is a pure function of (key, s, i), so that 
+ * threads and nodes can each skip ahead to draw independent numbers */
+typedef struct RandomStream
+{
+    unsigned long long int key;         // the key of every sub-stream
+    unsigned long long int numDrawn;    // the number of draws from (and next index of) sub-stream 0
+    unsigned long long int index;       // the creation order of the stream, hashed with the seeds into key
+    long long int epoch;                // the seeding of QuEST from which key was derived
+    
+} RandomStream;
+
+/// \endcond
+
 /** Represents a system of qubits.
  * Qubits are zero-based
  *
@@ -323,6 +457,8 @@ typedef struct Qureg
 {
     //! Whether this instance is a density-state representation
     int isDensityMatrix;
+    //! Whether this density matrix stores only its upper triangle (see createPackedDensityQureg())
+    int isPackedDensityMatrix;
     //! The number of qubits represented in either the state-vector or density matrix
     int numQubitsRepresented;
     //! Number of qubits in the state-vector - this is double the number represented for mixed states
@@ -350,6 +486,15 @@ typedef struct Qureg
     //! Storage for generated QASM output
     QASMLogger* qasmLog;
     
+    //! Storage for gates awaiting fused application
+    GateQueue* gateQueue;
+    
+    //! Counter-based random number stream used by measurement and sampling
+    RandomStream* randStream;
+    
+    //! The noise model induced by every gate and measurement, which is attached when numQubits > 0
+    NoiseModel* noiseModel;
+    
 } Qureg;
 
 /** Information about the environment the program is running in.
@@ -610,6 +755,7 @@ void dumpQuregStateToFile(Qureg qureg, char *filename);
  *
  * @see 
  * - createQureg() to create a state-vector of the equivalent number of qubits, with a square-root memory cost
+ * - createPackedDensityQureg() to create a density matrix of almost half the memory, storing only its upper triangle
  * - createCloneQureg() to create a new qureg of the size and state of an existing qureg.
  * - destroyQureg() to free the allocated \p Qureg memory.
  * - reportQuregParams() to print information about a ::Qureg.
@@ -628,6 +774,58 @@ void dumpQuregStateToFile(Qureg qureg, char *filename);
  */
 Qureg createDensityQureg(int numQubits, QuESTEnv env);
 
+/** Creates a density matrix Qureg object which stores only the upper triangle of its
+ * Hermitian matrix, requiring memory
+ * \f[ 
+ *      \text{qrealBytes} \times 2 \times 2^\text{numQubits} (2^\text{numQubits} + 1)/2 \;\;\text{(bytes)},
+ * \f]
+ * which is just over half that of createDensityQureg(), permitting one additional qubit
+ * in the same memory. Operations upon the packed matrix also read and write only the 
+ * stored triangle, halving their memory traffic.
+ *
+ * The returned ::Qureg begins in the zero state, as produced by initZeroState(), and has 
+ * Qureg.isDensityMatrix and Qureg.isPackedDensityMatrix set. Element (r, c) with r <= c 
+ * is stored at index c(c+1)/2 + r of Qureg.stateVec, though elements should be fetched 
+ * with getDensityAmp().
+ *
+ * Since the lower triangle is never stored, a packed density matrix supports only operations
+ * which keep it Hermitian, and for which a packed implementation exists:
+ * - initialisation: initZeroState(), initBlankState(), initPlusState(), initClassicalState(), 
+ *   initPureState() and cloneQureg() (from another packed density matrix)
+ * - unitaries of one or two target qubits, with any controls: e.g. hadamard(), rotateX(), unitary(), 
+ *   multiStateControlledUnitary(), compactUnitary(), twoQubitUnitary(), pauliX(), controlledNot(), 
+ *   multiQubitNot(), phaseShift(), multiControlledPhaseFlip(), swapGate(), sqrtSwapGate(), multiRotateZ() 
+ *   and multiControlledMultiRotateZ()
+ * - decoherence: mixDephasing(), mixTwoQubitDephasing(), mixDepolarising(), mixTwoQubitDepolarising(), 
+ *   mixDamping(), mixPauli(), mixKrausMap() and mixTwoQubitKrausMap()
+ * - measurement: calcProbOfOutcome(), collapseToOutcome(), measure(), measureWithStats() and applyProjector()
+ * - calculations: getDensityAmp(), calcTotalProb(), calcPurity(), calcFidelity(), calcExpecPauliProd(), 
+ *   calcExpecPauliSum(), calcExpecPauliStrings() and calcExpecPauliHamil()
+ *
+ * Every other function (such as applyPauliSum(), applyMatrix2(), setDensityAmps() and 
+ * multiQubitUnitary()), and gate deferral via startDeferringGates(), reports an error when
+ * given a packed density matrix; use createDensityQureg() for such operations.
+ *
+ * The packed matrix is stored in host memory (Qureg.stateVec) in every backend, and is 
+ * modified there even in GPU mode. It cannot be distributed between multiple nodes.
+ *
+ * @see 
+ * - createDensityQureg() to create a density matrix which supports every operation
+ * - destroyQureg() to free the allocated \p Qureg memory.
+ *
+ * @ingroup type
+ * @returns an object representing the set of qubits
+ * @param[in] numQubits number of qubits in the system
+ * @param[in] env object representing the execution environment
+ * @throws invalidQuESTInputError()
+ * - if \p numQubits <= 0
+ * - if \p numQubits is so large that the number of amplitudes cannot fit in a long long int type
+ * - if QuEST is distributed between more than one node
+ * @throws exit 
+ * - if memory for the packed matrix cannot be allocated.
+ */
+Qureg createPackedDensityQureg(int numQubits, QuESTEnv env);
+
 /** Create a new ::Qureg which is an exact clone of the passed qureg, which can be
  * either a state-vector or a density matrix.
  *
@@ -3143,6 +3341,150 @@ qreal calcProbOfOutcome(Qureg qureg, int measureQubit, int outcome);
  */
 void calcProbOfAllOutcomes(qreal* outcomeProbs, Qureg qureg, int* qubits, int numQubits);
 
+/** Samples \p numShots measurement outcomes of the given \p qubits, without modifying \p qureg.
+ *
+ * Each shot is an independent draw from the distribution computed by calcProbOfAllOutcomes(),
+ * and is written to \p outcomes as the index of the outcome, whereby \p qubits are treated
+ * as <em>increasing</em> significance. For example, given
+ * ```
+ *   int qubits[] = {2, 0};
+ *   int numQubits = 2;
+ *   int numShots = 1000;
+ *
+ *   long long int outcomes[numShots];
+ *   sampleOutcomes(qureg, qubits, numQubits, numShots, outcomes);
+ * ```
+ * an element <b>1</b> of \p outcomes indicates qubit <b>2</b> was measured as <b>1</b>
+ * and qubit <b>0</b> as <b>0</b>.
+ *
+ * This is much faster than repeatedly cloning \p qureg and measuring each qubit, and unlike 
+ * calcProbOfAllOutcomes(), does not require an array of length <b>1<<</b>\p numQubits.
+ * The cumulative probabilities of all basis states (the diagonal elements of a density matrix)
+ * are computed once, in parallel, and each shot is then drawn by a binary search, 
+ * in time logarithmic in the number of amplitudes. In distributed mode, each node
+ * contributes the cumulative probabilities of its own amplitudes, and every node receives 
+ * the full list of outcomes.
+ *
+ * The shots are determined by the same random number generator as measure(), and so are 
+ * reproducible via seedQuEST(). As with calcProbOfAllOutcomes(), \p qureg need not be 
+ * normalised; outcomes are drawn in proportion to their (unnormalised) probabilities.
+ * 
+ * @see 
+ * - calcProbOfAllOutcomes()
+ * - measure()
+ *
+ * @ingroup calc
+ * @param[in] qureg a state-vector or density matrix to sample
+ * @param[in] qubits a list of qubits to sample
+ * @param[in] numQubits the length of list \p qubits
+ * @param[in] numShots the number of outcomes to sample
+ * @param[out] outcomes a pre-allocated array of length \p numShots, which will be 
+ *      modified to contain the sampled outcomes
+ * @throws invalidQuESTInputError()
+ * - if \p numQubits <= 0
+ * - if any index in \p qubits is invalid, i.e. outside <b>[0,</b> \p qureg.numQubitsRepresented <b>)</b>
+ * - if \p qubits contains any repetitions
+ * - if \p numShots <= 0
+ * @throws segmentation-fault
+ * - if \p outcomes is not pre-allocated, or contains space for fewer than \p numShots elements
+ */
+void sampleOutcomes(Qureg qureg, int* qubits, int numQubits, int numShots, long long int* outcomes);
+
+/** Populates \p probs with the probability of every qubit in \p qureg being measured in 
+ * state <b>1</b>, i.e. 
+ * \f[
+ *      \text{probs}[q] = \text{calcProbOfOutcome(qureg, } q \text{, 1)},
+ * \f]
+ * from which \f$\langle Z_q \rangle = 1 - 2 \, \text{probs}[q]\f$ for a normalised state.
+ *
+ * All <b>numQubits</b> probabilities are computed in a single pass over \p qureg (and only 
+ * its diagonal elements, when a density matrix), with a single reduction in distributed mode, 
+ * and so are much faster than calling calcProbOfOutcome() upon every qubit.
+ * The probabilities are not renormalised, so \p qureg need not be normalised.
+ *
+ * @see
+ * - calcZZCorrelationMatrix()
+ * - calcProbOfOutcome()
+ *
+ * @ingroup calc
+ * @param[in] qureg a state-vector or density matrix
+ * @param[out] probs a pre-allocated array of length \p qureg.numQubitsRepresented, 
+ *      which will be modified to contain the probability of each qubit being <b>1</b>
+ * @throws segmentation-fault
+ * - if \p probs contains space for fewer than \p qureg.numQubitsRepresented elements
+ */
+void calcAllQubitMarginals(Qureg qureg, qreal* probs);
+
+/** Populates \p correlations with the expected value of \f$Z_i Z_j\f$ upon \p qureg, for 
+ * every pair of qubits \f$i\f$ and \f$j\f$, as a row-major <b>numQubits</b> by 
+ * <b>numQubits</b> matrix, i.e.
+ * \f[
+ *      \text{correlations}[i \cdot \text{numQubits} + j] = \langle Z_i Z_j \rangle,
+ * \f]
+ * where <b>numQubits</b> is \p qureg.numQubitsRepresented. The matrix is symmetric, and its
+ * diagonal is the total probability of \p qureg (i.e. <b>1</b> when normalised).
+ *
+ * Since \f$Z_i Z_j\f$ is diagonal, all elements are computed in a single pass over the 
+ * probabilities of \p qureg (the diagonal elements, when a density matrix), with a single 
+ * reduction in distributed mode, and without any workspace ::Qureg. This is much faster
+ * than calling calcExpecPauliProd() upon every pair of qubits.
+ *
+ * @see
+ * - calcAllQubitMarginals()
+ * - calcExpecPauliProd()
+ *
+ * @ingroup calc
+ * @param[in] qureg a state-vector or density matrix
+ * @param[out] correlations a pre-allocated array of length <b>numQubits</b>*<b>numQubits</b>,
+ *      which will be modified to contain every \f$\langle Z_i Z_j \rangle\f$
+ * @throws segmentation-fault
+ * - if \p correlations contains space for fewer than <b>numQubits</b>*<b>numQubits</b> elements
+ */
+void calcZZCorrelationMatrix(Qureg qureg, qreal* correlations);
+
+/** Populates \p inds and \p probs with the \p k most probable basis states of \p qureg 
+ * (of all its qubits), and their probabilities, in order of decreasing probability.
+ * Basis states of equal probability are ordered by increasing index.
+ *
+ * For example, the dominant bitstrings of a Grover search can be found via
+ * ```
+ *   int k = 4;
+ *   long long int inds[k];
+ *   qreal probs[k];
+ *   calcTopKOutcomes(qureg, k, inds, probs);
+ * ```
+ * whereafter <b>inds[0]</b> is the most probable basis state, with probability <b>probs[0]</b>.
+ *
+ * Unlike calcProbOfAllOutcomes(), this does not require an array of length 
+ * <b>2^</b>\p qureg.numQubitsRepresented, and so remains feasible when \p qureg is too 
+ * large to duplicate its distribution. Every thread retains only its own \p k most probable 
+ * basis states (in a bounded min-heap), which are merged after a single pass over \p qureg, 
+ * so only <b>O(</b>\p k <b>*</b> <em>numThreads</em><b>)</b> additional memory is needed. 
+ * In distributed mode, each node finds its own \p k most probable, which are then gathered 
+ * and merged by every node. In GPU mode, the probabilities are inspected by the host in 
+ * bounded batches.
+ *
+ * The probabilities are not renormalised, so \p qureg need not be normalised. For density 
+ * matrices, the probabilities are the (real components of the) diagonal elements.
+ *
+ * @see
+ * - calcProbOfAllOutcomes()
+ * - sampleOutcomes()
+ *
+ * @ingroup calc
+ * @param[in] qureg a state-vector or density matrix
+ * @param[in] k the number of most probable basis states to find
+ * @param[out] inds a pre-allocated array of length \p k, which will be modified to contain
+ *      the indices of the most probable basis states
+ * @param[out] probs a pre-allocated array of length \p k, which will be modified to contain
+ *      the probabilities of the basis states in \p inds
+ * @throws invalidQuESTInputError()
+ * - if \p k <= 0, or \p k exceeds the number of basis states, <b>2^</b>\p qureg.numQubitsRepresented
+ * @throws segmentation-fault
+ * - if \p inds or \p probs contain space for fewer than \p k elements
+ */
+void calcTopKOutcomes(Qureg qureg, int k, long long int* inds, qreal* probs);
+
 /** Updates \p qureg to be consistent with measuring \p measureQubit in the given 
  * \p outcome (0 or 1), and returns the probability of such a measurement outcome. 
  * This is effectively performing a renormalising projection, or a measurement with a forced outcome.
@@ -3185,6 +3527,9 @@ qreal collapseToOutcome(Qureg qureg, int measureQubit, int outcome);
  *
  * > The random outcome generator is seeded by seedQuESTDefault() within 
  * > createQuESTEnv(), unless later overridden by seedQuEST().
+ *
+ * If a ::NoiseModel with a readout error upon \p measureQubit is attached to \p qureg 
+ * (see setReadoutNoise()), the qubit first undergoes the corresponding bit-flip.
  * 
  * @see
  * - measureWithStats()
@@ -3211,6 +3556,10 @@ int measure(Qureg qureg, int measureQubit);
  * > The random outcome generator is seeded by seedQuESTDefault() within 
  * > createQuESTEnv(), unless later overridden by seedQuEST().
  *
+ * If a ::NoiseModel with a readout error upon \p measureQubit is attached to \p qureg 
+ * (see setReadoutNoise()), the qubit first undergoes the corresponding bit-flip, and 
+ * \p outcomeProb includes its effect.
+ *
  * @see 
  * - measure()
  * - collapseToOutcome()
@@ -3229,6 +3578,70 @@ int measure(Qureg qureg, int measureQubit);
  */
 int measureWithStats(Qureg qureg, int measureQubit, qreal *outcomeProb);
 
+/** Measures multiple qubits jointly, collapsing them randomly into one of their 
+ * <b>2^</b>\p numQubits classical outcomes, which is returned as an integer
+ * whereby \p qubits are treated as <em>increasing</em> significance.
+ *
+ * This is equivalent to calling measure() upon each qubit in \p qubits (outcome 
+ * <b>i</b> indicates \p qubits[q] was measured as bit \p q of <b>i</b>), but is 
+ * much faster when measuring many qubits. The joint distribution of all outcomes is 
+ * computed in a single pass (as per calcProbOfAllOutcomes()), from which an outcome is 
+ * drawn, before \p qureg is collapsed and renormalised in a second pass. This costs two 
+ * passes (and, in distributed mode, a single reduction) independent of \p numQubits, 
+ * though requires temporary memory of <b>2^</b>\p numQubits \p qreal.
+ *
+ * > The random outcome generator is seeded by seedQuESTDefault() within 
+ * > createQuESTEnv(), unless later overridden by seedQuEST().
+ * 
+ * @see
+ * - measure()
+ * - collapseToMultiOutcome()
+ * - calcProbOfAllOutcomes()
+ * 
+ * @ingroup normgate
+ * @param[in, out] qureg a state-vector or density matrix to measure
+ * @param[in] qubits a list of the qubits to measure
+ * @param[in] numQubits the length of list \p qubits
+ * @return the measurement outcome, in <b>[0, 2^</b>\p numQubits<b>)</b>
+ * @throws invalidQuESTInputError()
+ * - if \p numQubits <= 0 or \p numQubits > \p qureg.numQubitsRepresented
+ * - if any index in \p qubits is invalid, i.e. outside <b>[0,</b> \p qureg.numQubitsRepresented <b>)</b>
+ * - if \p qubits contains any repetitions
+ */
+long long int measureMultiple(Qureg qureg, int* qubits, int numQubits);
+
+/** Updates \p qureg to be consistent with measuring the given \p qubits jointly in 
+ * the given \p outcome, and returns the probability of such a measurement outcome.
+ * 
+ * This is a multi-qubit generalisation of collapseToOutcome(), whereby \p outcome is 
+ * an integer in which bit \p q is the forced outcome of \p qubits[q]. Computational 
+ * states inconsistent with \p outcome are given zero amplitude, and \p qureg is 
+ * renormalised. The given outcome must not have a near zero probability.
+ * Unlike collapseToOutcome(), the probability of \p outcome is computed directly, so 
+ * this function is also correct for un-normalised quregs.
+ *
+ * To avoid renormalisation after projection, use applyMultiQubitProjector().
+ *
+ * @see
+ * - collapseToOutcome()
+ * - measureMultiple()
+ * - applyMultiQubitProjector()
+ *
+ * @ingroup normgate
+ * @param[in,out] qureg a state-vector or density matrix to modify
+ * @param[in] qubits a list of the qubits to collapse
+ * @param[in] numQubits the length of list \p qubits
+ * @param[in] outcome the joint outcome into which to force \p qubits
+ * @return probability of the (forced) measurement outcome
+ * @throws invalidQuESTInputError()
+ * - if \p numQubits <= 0 or \p numQubits > \p qureg.numQubitsRepresented
+ * - if any index in \p qubits is invalid, i.e. outside <b>[0,</b> \p qureg.numQubitsRepresented <b>)</b>
+ * - if \p qubits contains any repetitions
+ * - if \p outcome is outside <b>[0, 2^</b>\p numQubits<b>)</b>
+ * - if the probability of \p outcome is zero (within machine epsilon)
+ */
+qreal collapseToMultiOutcome(Qureg qureg, int* qubits, int numQubits, long long int outcome);
+
 /** Computes the inner product \f$ \langle \text{bra} | \text{ket} \rangle \f$ of two 
  * equal-size state vectors, given by 
  * \f[ 
@@ -3337,6 +3750,9 @@ void seedQuESTDefault(QuESTEnv *env);
  * default keys.
  *
  * This determines the sequence of outcomes in functions like measure() and measureWithStats().
+ * Each ::Qureg draws its random numbers from its own stream, which is keyed by this 
+ * generator upon the Qureg's first random draw after seeding, so that reseeding 
+ * reproduces the outcomes of existing Quregs too.
  *
  * In distributed mode, the key(s) passed to the master node will be broadcast to all 
  * other nodes, such that every node generates the same sequence of pseudorandom numbers.
@@ -3351,6 +3767,7 @@ void seedQuESTDefault(QuESTEnv *env);
  * @see
  * - Use seedQuESTDefault() to seed via the current timestamp and process id.
  * - Use getQuESTSeeds() to obtain the seeds currently being used for RNG.
+ * - Use seedQuregRNG() to seed the random stream of a single ::Qureg.
  *
  * @ingroup debug
  * @param[in] env a pointer to the ::QuESTEnv runtime environment
@@ -3406,6 +3823,29 @@ void seedQuEST(QuESTEnv *env, unsigned long int *seedArray, int numSeeds);
  **/
 void getQuESTSeeds(QuESTEnv env, unsigned long int** seeds, int* numSeeds);
 
+/** Seeds the random number stream of \p qureg, which determines the outcomes of 
+ * functions like measure(), measureMultiple() and sampleOutcomes() upon \p qureg.
+ *
+ * Every ::Qureg draws from its own counter-based 
+ * (<a href="https://doi.org/10.1145/2063384.2063405">Philox4x32-10</a>) stream, 
+ * which is otherwise keyed by the seeds passed to seedQuEST(). Quregs given the
+ * same seed will, when prepared in the same state, produce identical outcomes, 
+ * regardless of the other Quregs measured meanwhile, or of the number of threads 
+ * used to draw them.
+ *
+ * A subsequent call to seedQuEST() or seedQuESTDefault() overrides this seed.
+ *
+ * In distributed mode, every node must pass the same \p seed.
+ *
+ * @see
+ * - seedQuEST()
+ *
+ * @ingroup debug
+ * @param[in,out] qureg the ::Qureg whose random stream to seed
+ * @param[in] seed the key of the random stream
+ */
+void seedQuregRNG(Qureg qureg, unsigned long int seed);
+
 /** Enable QASM recording. Gates applied to qureg will here-after be added to a
  * growing log of QASM instructions, progressively consuming more memory until 
  * disabled with stopRecordingQASM(). The QASM log is bound to this qureg instance.
@@ -3455,6 +3895,111 @@ void printRecordedQASM(Qureg qureg);
  */
 void writeRecordedQASMToFile(Qureg qureg, char* filename);
 
+/** Begin deferring the unitary gates subsequently applied to \p qureg, fusing 
+ * consecutive gates into a single dense matrix upon at most \p maxNumQubits qubits.
+ *
+ * Ordinarily, every gate (e.g. hadamard(), controlledNot(), rotateX()) makes a 
+ * full pass over the state-vector, so that deep circuits of few-qubit gates 
+ * are bound by memory bandwidth. While deferring, such gates are instead 
+ * multiplied into a pending 2^\p maxNumQubits by 2^\p maxNumQubits matrix, 
+ * which is applied to \p qureg (with a single pass, via multiQubitUnitary()) only 
+ * when
+ * - the next gate would grow the fused matrix beyond \p maxNumQubits qubits
+ * - a function which is not a fusable gate is called upon \p qureg, such as 
+ *   a measurement, a calculation like calcProbOfOutcome(), an amplitude getter 
+ *   like getAmp(), a decoherence channel or a state initialisation
+ * - applyDeferredGates() or stopDeferringGates() is called.
+ *
+ * Gates acting upon more than \p maxNumQubits qubits (including their controls)
+ * are applied immediately, after any pending gates. Non-unitary operators 
+ * (like applyMatrixN()) are never deferred. The order in which all operations 
+ * act upon \p qureg is unchanged, as is the QASM recorded by startRecordingQASM(), 
+ * though the numerical result may differ from immediate application by 
+ * floating-point error.
+ *
+ * Fusing gates upon \p maxNumQubits qubits costs up to \f$O(4^{\text{maxNumQubits}})\f$
+ * operations per amplitude when applied, so small values (e.g. 3 to 5) 
+ * best trade fewer passes over the state for arithmetic. 
+ * Calling this function while already deferring first applies any pending gates.
+ *
+ * @see
+ * - stopDeferringGates()
+ * - applyDeferredGates()
+ *
+ * @ingroup unitary
+ * @param[in,out] qureg the state-vector or density matrix upon which to defer gates
+ * @param[in] maxNumQubits the maximum number of qubits upon which a fused gate may act
+ * @throws invalidQuESTInputError()
+ * - if \p maxNumQubits <= 0 or \p maxNumQubits > the number of qubits in \p qureg
+ * - if a fused gate upon \p maxNumQubits qubits cannot fit into a single distributed node's allocation
+ * - if a ::NoiseModel is attached to \p qureg (see attachNoiseModel())
+ */
+void startDeferringGates(Qureg qureg, int maxNumQubits);
+
+/** Begin deferring the unitary gates subsequently applied to state-vector \p qureg, 
+ * like startDeferringGates(), but additionally cache-blocking their application.
+ *
+ * The state-vector is divided into tiles of 2^\p numTileQubits contiguous amplitudes,
+ * which are the amplitudes differing only in the \p numTileQubits lowest qubits.
+ * Fused gates (each upon at most \p maxNumQubits qubits) which act only upon these 
+ * qubits are queued, and when the queue must be applied, every queued gate is applied 
+ * to one tile before the next tile is visited. A tile which fits into a core's 
+ * cache (e.g. \p numTileQubits = 15 for a 512 KiB L2 cache with double precision) is 
+ * then loaded from main memory once per queue, rather than once per gate.
+ *
+ * Gates acting upon qubits outside the tile are made tile-local by swapping those
+ * qubits with the least recently used tile qubits, which costs one pass over the 
+ * state-vector per swap. The original qubit ordering is restored (by further swaps) 
+ * before any function which is not a fusable gate is called upon \p qureg, and by
+ * applyDeferredGates() and stopDeferringGates().
+ *
+ * @see
+ * - startDeferringGates()
+ * - stopDeferringGates()
+ * - applyDeferredGates()
+ *
+ * @ingroup unitary
+ * @param[in,out] qureg the state-vector upon which to defer gates
+ * @param[in] maxNumQubits the maximum number of qubits upon which a fused gate may act
+ * @param[in] numTileQubits the number of lowest qubits spanned by each tile
+ * @throws invalidQuESTInputError()
+ * - if \p qureg is a density matrix
+ * - if \p maxNumQubits <= 0 or \p maxNumQubits > the number of qubits in \p qureg
+ * - if a fused gate upon \p maxNumQubits qubits cannot fit into a single distributed node's allocation
+ * - if \p numTileQubits < \p maxNumQubits, or a tile would exceed a single distributed node's allocation
+ */
+void startDeferringGatesInTiles(Qureg qureg, int maxNumQubits, int numTileQubits);
+
+/** Stop deferring gates upon \p qureg, applying any which are pending. 
+ * Subsequent gates are applied immediately, as usual.
+ *
+ * Has no effect if \p qureg was not deferring gates.
+ *
+ * @see
+ * - startDeferringGates()
+ *
+ * @ingroup unitary
+ * @param[in,out] qureg the state-vector or density matrix to stop deferring gates upon
+ * @throws invalidQuESTInputError()
+ * - if a ::NoiseModel is attached to \p qureg (see attachNoiseModel())
+ */
+void stopDeferringGates(Qureg qureg);
+
+/** Apply to \p qureg all gates which have been deferred since startDeferringGates(),
+ * as a single fused matrix. \p qureg continues to defer subsequent gates.
+ *
+ * Has no effect if \p qureg has no pending gates.
+ *
+ * @see
+ * - startDeferringGates()
+ *
+ * @ingroup unitary
+ * @param[in,out] qureg the state-vector or density matrix with deferred gates
+ * @throws invalidQuESTInputError()
+ * - if a ::NoiseModel is attached to \p qureg (see attachNoiseModel())
+ */
+void applyDeferredGates(Qureg qureg);
+
 /** Mixes a density matrix \p qureg to induce single-qubit dephasing noise.
  * With probability \p prob, applies Pauli Z to \p targetQubit.
  *
@@ -3707,6 +4252,194 @@ void mixTwoQubitDepolarising(Qureg qureg, int qubit1, int qubit2, qreal prob);
  */
 void mixPauli(Qureg qureg, int targetQubit, qreal probX, qreal probY, qreal probZ);
 
+/** Mixes a density matrix \p qureg to induce an independent single-qubit channel upon every 
+ * qubit, such as a layer of noise following a layer of gates. Qubit q undergoes the channel 
+ * \p channels[q], which is one of
+ *    - \p NO_NOISE, leaving the qubit unchanged
+ *    - \p DEPHASING_NOISE, as induced by mixDephasing() with probability \p channels[q].prob
+ *    - \p DEPOLARISING_NOISE, as induced by mixDepolarising() with probability \p channels[q].prob
+ *    - \p DAMPING_NOISE, as induced by mixDamping() with probability \p channels[q].prob
+ *    - \p PAULI_NOISE, as induced by mixPauli() with probabilities \p channels[q].probX, 
+ *      \p channels[q].probY and \p channels[q].probZ
+ *
+ * The result is equivalent to (but much faster than) calling the corresponding functions 
+ * upon each qubit in turn, since the channels upon different qubits commute. 
+ * Every dephasing channel merely scales each off-diagonal element \f$\rho_{rc}\f$ by 
+ * \f$\prod_q (1 - 2 \, \text{prob}_q)\f$ over the qubits q at which r and c differ. The 
+ * remaining channels are applied (on the CPU) to four qubits per pass, by modifying each small 
+ * block of elements which differ only in those qubits while the block resides in cache, and 
+ * the dephasing is folded into the first such pass. A layer of m non-dephasing channels hence 
+ * costs ceil(m/4) passes over \p qureg, or a single pass when every channel is dephasing.
+ *
+ * On the GPU, every channel is instead applied one qubit at a time, as are packed density 
+ * matrices (see createPackedDensityQureg()). In distributed mode, the non-dephasing channels 
+ * upon qubits whose column elements are not local to a node are applied one qubit at a time.
+ *
+ * @see
+ * - ::NoiseChannel
+ * - mixDephasing()
+ * - mixDepolarising()
+ * - mixDamping()
+ * - mixPauli()
+ *
+ * @ingroup decoherence
+ * @param[in,out] qureg a density matrix
+ * @param[in] channels an array of length \p qureg.numQubitsRepresented, of the channel to induce upon each qubit
+ * @throws invalidQuESTInputError()
+ * - if \p qureg is not a density matrix
+ * - if any channel has a type other than those listed above
+ * - if any channel's probabilities are invalid for the corresponding function, 
+ *   i.e. mixDephasing(), mixDepolarising(), mixDamping() or mixPauli()
+ */
+void mixNoiseLayer(Qureg qureg, NoiseChannel* channels);
+
+/** Dynamically allocates a ::NoiseModel for density matrices of \p numQubits qubits, which 
+ * induces no noise until populated by setGateNoise(), setGateKrausNoise() and setReadoutNoise().
+ *
+ * > The returned \p NoiseModel must later be freed via destroyNoiseModel().
+ *
+ * @see
+ * - attachNoiseModel()
+ * - destroyNoiseModel()
+ *
+ * @ingroup type
+ * @param[in] numQubits the number of qubits of the density matrices to which the model can be attached
+ * @returns a dynamic \p NoiseModel, with every channel \p NO_NOISE and every readout error probability zero
+ * @throws invalidQuESTInputError()
+ * - if \p numQubits <= 0
+ */
+NoiseModel createNoiseModel(int numQubits);
+
+/** Destroys a ::NoiseModel created with createNoiseModel(), including the Kraus operators 
+ * copied by setGateKrausNoise(). The model must not be attached to any density matrix.
+ *
+ * @ingroup type
+ * @param[in] model a dynamic \p NoiseModel
+ */
+void destroyNoiseModel(NoiseModel model);
+
+/** Sets the single-qubit channel which \p qubit undergoes after every gate of type \p gateType
+ * acts upon it (as either a control or a target), replacing any channel previously set by 
+ * setGateNoise() or setGateKrausNoise(). For example,
+ *
+ *     NoiseChannel depol = {.type=DEPOLARISING_NOISE, .prob=0.01};
+ *     setGateNoise(model, TWO_QUBIT_GATES, 3, depol);
+ *
+ * depolarises qubit 3 after every two-qubit gate upon it, such as controlledNot() with qubit 3
+ * as either the control or the target.
+ *
+ * Changes to a model affect every density matrix to which it is attached.
+ *
+ * @see
+ * - ::NoiseChannel
+ * - setGateKrausNoise()
+ * - attachNoiseModel()
+ *
+ * @ingroup type
+ * @param[in,out] model the noise model to modify
+ * @param[in] gateType the ::noisyGateType of gate after which the channel occurs
+ * @param[in] qubit the qubit which undergoes the channel
+ * @param[in] channel the channel, as accepted by mixNoiseLayer()
+ * @throws invalidQuESTInputError()
+ * - if \p gateType is not one of \p ONE_QUBIT_GATES, \p TWO_QUBIT_GATES or \p MULTI_QUBIT_GATES
+ * - if \p qubit is outside [0, \p model.numQubits)
+ * - if \p channel has an invalid type or invalid probabilities (see mixNoiseLayer())
+ */
+void setGateNoise(NoiseModel model, enum noisyGateType gateType, int qubit, NoiseChannel channel);
+
+/** Sets a custom single-qubit Kraus map which \p qubit undergoes after every gate of type 
+ * \p gateType acts upon it, replacing any channel previously set by setGateNoise() or 
+ * setGateKrausNoise(). The \p numOps operators are copied into \p model, as if passed to 
+ * mixKrausMap().
+ *
+ * @see
+ * - setGateNoise()
+ * - mixKrausMap()
+ * - attachNoiseModel()
+ *
+ * @ingroup type
+ * @param[in,out] model the noise model to modify
+ * @param[in] gateType the ::noisyGateType of gate after which the map occurs
+ * @param[in] qubit the qubit which undergoes the map
+ * @param[in] ops an array of at least \p numOps Kraus operators
+ * @param[in] numOps the number of operators in \p ops, which must be >0 and <= 4
+ * @throws invalidQuESTInputError()
+ * - if \p gateType is not one of \p ONE_QUBIT_GATES, \p TWO_QUBIT_GATES or \p MULTI_QUBIT_GATES
+ * - if \p qubit is outside [0, \p model.numQubits)
+ * - if \p numOps is outside [1, 4]
+ * - if \p ops do not create a completely positive, trace preserving map
+ */
+void setGateKrausNoise(NoiseModel model, enum noisyGateType gateType, int qubit, ComplexMatrix2* ops, int numOps);
+
+/** Sets the probability that measuring \p qubit, via measure() or measureWithStats(), reports 
+ * the incorrect outcome. This is simulated as a bit-flip of probability \p prob (as induced by 
+ * mixPauli() with \p probX = \p prob) immediately before the qubit is measured, so that the 
+ * outcome probabilities are those of a faulty readout, and the collapsed state is consistent 
+ * with the reported outcome.
+ *
+ * @see
+ * - measure()
+ * - attachNoiseModel()
+ *
+ * @ingroup type
+ * @param[in,out] model the noise model to modify
+ * @param[in] qubit the qubit with a faulty readout
+ * @param[in] prob the probability of reporting the incorrect outcome
+ * @throws invalidQuESTInputError()
+ * - if \p qubit is outside [0, \p model.numQubits)
+ * - if \p prob is outside [0, 1/2]
+ */
+void setReadoutNoise(NoiseModel model, int qubit, qreal prob);
+
+/** Attaches a ::NoiseModel to density matrix \p qureg, so that every subsequent unitary gate 
+ * (e.g. hadamard(), controlledNot(), multiQubitUnitary()) is followed by the model's channel 
+ * upon each of the gate's qubits, and every measurement by measure() or measureWithStats() is 
+ * preceded by the qubit's readout error. This replaces hand-interleaving calls like 
+ * mixDepolarising() after every gate. Other operations, such as applyMatrixN(), the phase 
+ * functions, applyQFT() and the decoherence functions, are unaffected by the model.
+ *
+ * A gate upon one or two qubits is applied together with its channels as a single 
+ * superoperator, in one pass over \p qureg, rather than one pass for the gate and 
+ * one per channel. Gates whose qubits undergo no noise are applied as usual, and gates 
+ * upon three or more qubits are followed by their channels in separate passes.
+ *
+ * The model is not copied, so its subsequent modification (e.g. by setGateNoise()) affects
+ * \p qureg, and it must remain allocated until detached by detachNoiseModel() or the 
+ * destruction of \p qureg. Attaching a model replaces any model already attached. 
+ * While attached, gates cannot be deferred by startDeferringGates(), nor their deferral 
+ * controlled by stopDeferringGates() and applyDeferredGates().
+ *
+ * @see
+ * - createNoiseModel()
+ * - setGateNoise()
+ * - setGateKrausNoise()
+ * - setReadoutNoise()
+ * - detachNoiseModel()
+ *
+ * @ingroup decoherence
+ * @param[in,out] qureg a density matrix
+ * @param[in] model the noise model to attach
+ * @throws invalidQuESTInputError()
+ * - if \p qureg is not a density matrix
+ * - if \p qureg is a packed density matrix (see createPackedDensityQureg())
+ * - if \p model.numQubits differs from \p qureg.numQubitsRepresented
+ * - if gates upon \p qureg are being deferred (see startDeferringGates())
+ * - if a two-qubit superoperator cannot fit into a single distributed node's allocation
+ */
+void attachNoiseModel(Qureg qureg, NoiseModel model);
+
+/** Detaches any ::NoiseModel from \p qureg, so that its subsequent gates and measurements 
+ * are noiseless. The model itself is unchanged, and must still be destroyed by 
+ * destroyNoiseModel().
+ *
+ * @see
+ * - attachNoiseModel()
+ *
+ * @ingroup decoherence
+ * @param[in,out] qureg a density matrix or state-vector
+ */
+void detachNoiseModel(Qureg qureg);
+
 /** Modifies combineQureg to become (1-\p prob)\p combineProb + \p prob \p otherQureg.
  * Both registers must be equal-dimension density matrices, and prob must be in [0, 1].
  *
@@ -4220,16 +4953,13 @@ void multiControlledMultiRotatePauli(Qureg qureg, int* controlQubits, int numCon
  * applies to the least-significant qubit, i.e. that with index 0).
  *
  * \p workspace must be a register with the same type (state-vector vs density matrix) and dimensions 
- * (number of represented qubits) as \p qureg, and is used as working space. When this function returns, \p qureg 
- * will be unchanged and \p workspace will be set to \f$ \sigma | \psi \rangle \f$ (if \p qureg is a state-vector)
- * or \f$ \sigma \rho \f$ (if \p qureg is a density matrix). NOTE that this last quantity is NOT the result of applying 
- * the paulis as unitaries, \f$ \sigma^\dagger \rho \sigma \f$, but is instead the result of their direct 
- * multiplication with the density matrix. It is therefore itself not a valid density matrix.
+ * (number of represented qubits) as \p qureg. It is retained for compatibility but is no longer 
+ * used nor modified; both \p qureg and \p workspace are unchanged when this function returns.
  *
- * This function works by cloning the \p qureg state into \p workspace, applying the specified 
- * Pauli operators to \p workspace then computing its inner product with \p qureg (for state-vectors)
- * or its trace (for density matrices). It therefore should scale linearly in time with the number of 
- * specified non-identity Pauli operators, which is bounded by the number of represented qubits.
+ * This function reads each amplitude of \p qureg once, pairing it with the amplitude to which 
+ * \f$ \sigma \f$ maps it, so needs no working memory. For density matrices, only the 
+ * \f$ 2^N \f$ elements contributing to the trace are read. 
+ * In distributed mode, at most one exchange of amplitudes between nodes is needed.
  *
  * @see
  * - calcExpecDiagonalOp()
@@ -4242,8 +4972,7 @@ void multiControlledMultiRotatePauli(Qureg qureg, int* controlQubits, int numCon
  * @param[in] pauliCodes a list of the Pauli codes (0=PAULI_I, 1=PAULI_X, 2=PAULI_Y, 3=PAULI_Z) 
  *      to apply to the corresponding qubits in \p targetQubits
  * @param[in] numTargets number of target qubits, i.e. the length of \p targetQubits and \p pauliCodes
- * @param[in,out] workspace a working-space qureg with the same dimensions as \p qureg, which is modified 
- *      to be the result of multiplying the state with the pauli operators
+ * @param[in] workspace a qureg with the same type and dimensions as \p qureg, which is unused
  * @throws invalidQuESTInputError()
  * - if \p numTargets is outside [1, \p qureg.numQubitsRepresented])
  * - if any qubit in \p targetQubits is outside [0, \p qureg.numQubitsRepresented))
@@ -4277,19 +5006,18 @@ qreal calcExpecPauliProd(Qureg qureg, int* targetQubits, enum pauliOpType* pauli
  * applies to the least-significant qubit, i.e. that with index 0).
  * 
  * \p workspace must be a register with the same type (state-vector vs density matrix) and dimensions 
- * (number of represented qubits) as \p qureg, and is used as working space. When this function returns, \p qureg 
- * will be unchanged and \p workspace will be set to \p qureg pre-multiplied with the final Pauli product.
- * NOTE that if \p qureg is a density matrix, \p workspace will become \f$ \hat{\sigma} \rho \f$ 
- * which is itself not a density matrix (it is distinct from \f$ \hat{\sigma} \rho \hat{\sigma}^\dagger \f$).
+ * (number of represented qubits) as \p qureg. It is retained for compatibility but is no longer 
+ * used nor modified; both \p qureg and \p workspace are unchanged when this function returns.
  *
- * This function works by cloning the \p qureg state into \p workspace, applying each of the specified
- * Pauli products to \p workspace (one Pauli operation at a time), then computing its inner product with \p qureg (for state-vectors)
- * or its trace (for density matrices) multiplied with the corresponding coefficient, and summing these contributions. 
- * It therefore should scale linearly in time with the total number of non-identity specified Pauli operators.
+ * This function evaluates every Pauli product together with calcExpecPauliStrings(), which 
+ * passes over \p qureg in cache-sized blocks, evaluating all terms upon each block before 
+ * proceeding. Hence \p qureg is read from memory once (per distinct distributed exchange), 
+ * rather than once per term, and no working memory is needed.
  *
  * @see
  * - calcExpecDiagonalOp()
  * - calcExpecPauliProd()
+ * - calcExpecPauliStrings()
  * - calcExpecPauliHamil()
  *
  * @ingroup calc
@@ -4299,8 +5027,7 @@ qreal calcExpecPauliProd(Qureg qureg, int* targetQubits, enum pauliOpType* pauli
  *      in the register, in every term of the sum.
  * @param[in] termCoeffs The coefficients of each term in the sum of Pauli products
  * @param[in] numSumTerms The total number of Pauli products specified
- * @param[in,out] workspace a working-space qureg with the same dimensions as \p qureg, which is modified 
- *      to be the result of multiplying the state with the final specified Pauli product
+ * @param[in] workspace a qureg with the same type and dimensions as \p qureg, which is unused
  * @throws invalidQuESTInputError()
  * - if any code in \p allPauliCodes is not in {0,1,2,3}
  * - if \p numSumTerms <= 0,
@@ -4309,6 +5036,48 @@ qreal calcExpecPauliProd(Qureg qureg, int* targetQubits, enum pauliOpType* pauli
  */
 qreal calcExpecPauliSum(Qureg qureg, enum pauliOpType* allPauliCodes, qreal* termCoeffs, int numSumTerms, Qureg workspace);
 
+/** Computes the expected values of many products of Pauli operators at once, without any 
+ * working memory.
+ * Letting \f$ \sigma_i = \otimes_j^{N} \hat{\sigma}_{i,j} \f$ be the i-th product indicated 
+ * by \p allPauliCodes (where \f$ N = \f$ \p qureg.numQubitsRepresented), this function sets
+ * \p expecs[i] to \f$ \langle \psi | \sigma_i | \psi \rangle \f$ if \p qureg = \f$ \psi \f$ 
+ * is a state-vector, or to \f$ \text{Trace}(\sigma_i \rho) \f$ if \p qureg = \f$ \rho \f$ is 
+ * a density matrix.
+ *
+ * \p allPauliCodes is an array of length \p numStrings*\p qureg.numQubitsRepresented, 
+ * arranged as in calcExpecPauliSum(). For example, on a 3-qubit state-vector,
+ * ```
+ *     int paulis[6] = {PAULI_X, PAULI_I, PAULI_I,  PAULI_X, PAULI_Y, PAULI_Z};
+ *     qreal expecs[2];
+ *     calcExpecPauliStrings(qureg, paulis, 2, expecs);
+ * ```
+ * will set \p expecs to \f$ \{ \langle \psi | X I I | \psi \rangle, \; \langle \psi | X Y Z | \psi \rangle \} \f$.
+ *
+ * Each product maps a basis state to a single (phased) basis state, so its expected value is 
+ * computed by reading each amplitude alongside its partner, and for density matrices, by reading 
+ * only the \f$ 2^N \f$ elements which contribute to the trace. \p qureg is visited in 
+ * cache-sized blocks upon which every product is evaluated, so that all \p numStrings products 
+ * cost a single pass over memory. In distributed mode, products are grouped by the node holding 
+ * each amplitude's partner, costing one exchange per group and a single final reduction.
+ *
+ * @see
+ * - calcExpecPauliProd()
+ * - calcExpecPauliSum()
+ *
+ * @ingroup calc
+ * @param[in] qureg the register of which to find the expected values, which is unchanged by this function
+ * @param[in] allPauliCodes a list of the Pauli codes (0=PAULI_I, 1=PAULI_X, 2=PAULI_Y, 3=PAULI_Z) 
+ *      of every product, with a Pauli specified for each qubit in the register
+ * @param[in] numStrings the number of Pauli products specified
+ * @param[out] expecs the array of length \p numStrings to populate with the expected values
+ * @throws invalidQuESTInputError()
+ * - if any code in \p allPauliCodes is not in {0,1,2,3}
+ * - if \p numStrings <= 0
+ * @throws segmentation-fault
+ * - if \p expecs contains space for fewer than \p numStrings elements
+ */
+void calcExpecPauliStrings(Qureg qureg, enum pauliOpType* allPauliCodes, int numStrings, qreal* expecs);
+
 /** Computes the expected value of \p qureg under Hermitian operator \p hamil.
  * Represent \p hamil as \f$ H = \sum_i c_i \otimes_j^{N} \hat{\sigma}_{i,j} \f$
  *  (where \f$ c_i \in \f$ \p hamil.termCoeffs and \f$ N = \f$ \p hamil.numQubits).
@@ -4320,16 +5089,14 @@ qreal calcExpecPauliSum(Qureg qureg, enum pauliOpType* allPauliCodes, qreal* ter
  * there for an elaboration.
  * 
  * \p workspace must be a register with the same type (state-vector vs density matrix) and dimensions 
- * (number of represented qubits) as \p qureg and \p hamil, and is used as working space. 
- * When this function returns, \p qureg  will be unchanged and \p workspace will be set to
- * \p qureg pre-multiplied with the final Pauli product in \p hamil.
- * NOTE that if \p qureg is a density matrix, \p workspace will become \f$ \hat{\sigma} \rho \f$ 
- * which is itself not a density matrix (it is distinct from \f$ \hat{\sigma} \rho \hat{\sigma}^\dagger \f$).
+ * (number of represented qubits) as \p qureg and \p hamil. It is retained for compatibility but 
+ * is no longer used nor modified.
  *
- * This function works by cloning the \p qureg state into \p workspace, applying each of the specified
- * Pauli products in \p hamil to \p workspace (one Pauli operation at a time), then computing its inner product with \p qureg (for state-vectors)
- * or its trace (for density matrices) multiplied with the corresponding coefficient, and summing these contributions. 
- * It therefore should scale linearly in time with the total number of non-identity specified Pauli operators.
+ * The terms of \p hamil acting only as \p PAULI_I or \p PAULI_Z commute qubit-wise, and are 
+ * evaluated together (while they span at most 20 qubits) from the probabilities of all outcomes of 
+ * their qubits, found in a single pass, from which every such term's expected value follows as a 
+ * sum of \f$ \pm 1 \f$ weighted probabilities. The remaining terms are evaluated together in a 
+ * single further pass, as by calcExpecPauliSum().
  *
  * @see 
  * - createPauliHamil()
@@ -4340,8 +5107,7 @@ qreal calcExpecPauliSum(Qureg qureg, enum pauliOpType* allPauliCodes, qreal* ter
  * @ingroup calc
  * @param[in] qureg the register of which to find the expected value, which is unchanged by this function
  * @param[in] hamil a \p PauliHamil created with createPauliHamil() or createPauliHamilFromFile()
- * @param[in,out] workspace a working-space qureg with the same dimensions as \p qureg, which is modified 
- *      to be the result of multiplying the state with the final specified Pauli product
+ * @param[in] workspace a qureg with the same type and dimensions as \p qureg, which is unused
  * @throws invalidQuESTInputError()
  * - if any code in \p hamil.pauliCodes is not a valid Pauli code
  * - if \p hamil.numSumTerms <= 0
@@ -4905,11 +5671,16 @@ void mixTwoQubitKrausMap(Qureg qureg, int target1, int target2, ComplexMatrix4 *
  *
  * The first qubit in \p targets is treated as the \p least significant qubit in each op in \p ops.
  *
- * Note that in distributed mode, this routine requires that each node contains at least (2N)^2 amplitudes.
- * This means an q-qubit register can be distributed by at most 2^(q-2)/N^2 nodes.
+ * On the CPU, the map is applied directly to each 2^N by 2^N block of elements of \p qureg 
+ * which differ only in the target bits of their row and column, in O(numOps 8^N) operations 
+ * per block, whenever this is cheaper than using a superoperator (below); typically when 
+ * numOps < 2^(N-1), or when \p qureg is not much larger than the targeted blocks.
+ * In distributed mode, the map is applied directly (needing no communication) only when 
+ * every qubit in \p targets is less than log2(numAmpsPerChunk) - \p qureg.numQubitsRepresented.
  *
- * Note too that this routine internally creates a 'superoperator'; a complex matrix of dimensions
- * 2^(2*numTargets) by 2^(2*numTargets). Therefore, invoking this function incurs, 
+ * Otherwise (and always on the GPU), this routine internally creates a 'superoperator'; 
+ * a complex matrix of dimensions 2^(2*numTargets) by 2^(2*numTargets), applied in O(16^N) 
+ * operations per block. Invoking this function then incurs, 
  * for numTargs={1,2,3,4,5, ...}, an additional memory overhead of (at double-precision)
  * {0.25 KiB, 4 KiB, 64 KiB, 1 MiB, 16 MiB, ...} (respectively).
  * At quad precision (usually 10 B per number, but possibly 16 B due to alignment),
@@ -4918,6 +5689,9 @@ void mixTwoQubitKrausMap(Qureg qureg, int target1, int target2, ComplexMatrix4 *
  * stack. For numTargs >= 4, the superoperator will be allocated in the heap and 
  * therefore this routine may suffer an anomalous slowdown.
  *
+ * Either way, in distributed mode each node must contain at least 2^(2N) amplitudes, 
+ * so that a q-qubit register can be distributed between at most 2^(2q-2N) nodes.
+ *
  * @see
  * - createComplexMatrixN()
  * - initComplexMatrixN()
@@ -4937,7 +5711,7 @@ void mixTwoQubitKrausMap(Qureg qureg, int target1, int target2, ComplexMatrix4 *
  * - if \p numOps is outside [1, (2 \p numTargets)^2]
  * - if any ComplexMatrixN in \p ops does not have op.numQubits == \p numTargets
  * - if \p ops do not create a completely positive, trace preserving map
- * - if a node cannot fit (2N)^2 amplitudes in distributed mode
+ * - if a node cannot fit 2^(2N) amplitudes in distributed mode
  * @author Tyson Jones
  * @author Balint Koczor
  */
@@ -5025,17 +5799,19 @@ void setWeightedQureg(Complex fac1, Qureg qureg1, Complex fac2, Qureg qureg2, Co
  * will apply Hermitian operation \f$ (1.5 X I I - 3.6 X Y Z) \f$ 
  * (where in this notation, the left-most operator applies to the least-significant qubit, i.e. that with index 0).
  *
- * In theory, \p inQureg is unchanged though its state is temporarily 
- * modified and is reverted by re-applying Paulis (XX=YY=ZZ=I), so may see a change by small numerical errors.
+ * \p inQureg is only read, and is unchanged.
  * The initial state in \p outQureg is not used.
  *
  * \p inQureg and \p outQureg must both be state-vectors, or both density matrices,
  * of equal dimensions. \p inQureg cannot be \p outQureg.
  *
- * This function works by applying each Pauli product to \p inQureg in turn, 
- * and adding the resulting state (weighted by a coefficient in \p termCoeffs)
- * to the initially-blanked \p outQureg. Ergo it should scale with the total number 
- * of Pauli operators specified (excluding identities), and the qureg dimension. 
+ * This function works by grouping the terms which flip the same qubits (i.e. which have
+ * \p PAULI_X or \p PAULI_Y upon the same qubits), so that each group is a diagonal matrix
+ * multiplied by a permutation. Every amplitude of \p outQureg is then the sum, over groups,
+ * of a diagonal element times a single gathered amplitude of \p inQureg. Ergo it should 
+ * scale with the number of terms and the qureg dimension, but make only one pass over
+ * \p inQureg per group (or a single pass, when \p inQureg fits in cache), rather than 
+ * one per Pauli operator.
  *
  * @see
  * - calcExpecPauliSum()
@@ -5043,8 +5819,8 @@ void setWeightedQureg(Complex fac1, Qureg qureg1, Complex fac2, Qureg qureg2, Co
  *
  * @ingroup operator
  * @param[in] inQureg the register containing the state which \p outQureg will be set to, under
- *      the action of the Hermitiain operator specified by the Pauli codes. \p inQureg should be 
- *      unchanged, though may vary slightly due to numerical error.
+ *      the action of the Hermitiain operator specified by the Pauli codes. \p inQureg is 
+ *      unchanged.
  * @param[in] allPauliCodes a list of the Pauli codes (0=PAULI_I, 1=PAULI_X, 2=PAULI_Y, 3=PAULI_Z) 
  *      of all Paulis involved in the products of terms. A Pauli must be specified for each qubit 
  *      in the register, in every term of the sum.
@@ -5072,18 +5848,15 @@ void applyPauliSum(Qureg inQureg, enum pauliOpType* allPauliCodes, qreal* termCo
  * this function effects \f$ \alpha | \psi \rangle \f$ on state-vector \f$ |\psi\rangle \f$
  * and \f$\alpha \rho\f$ (left matrix multiplication) on density matrix \f$ \rho \f$.
  *
- * In theory, \p inQureg is unchanged though its state is temporarily 
- * modified and is reverted by re-applying Paulis (XX=YY=ZZ=I), so may see a change by small numerical errors.
+ * \p inQureg is only read, and is unchanged.
  * The initial state in \p outQureg is not used.
  *
  * \p inQureg and \p outQureg must both be state-vectors, or both density matrices,
  * of equal dimensions to \p hamil.
  * \p inQureg cannot be \p outQureg.
  *
- * This function works by applying each Pauli product in \p hamil to \p inQureg in turn, 
- * and adding the resulting state (weighted by a coefficient in \p termCoeffs)
- * to the initially-blanked \p outQureg. Ergo it should scale with the total number 
- * of Pauli operators specified (excluding identities), and the qureg dimension. 
+ * Like applyPauliSum(), this function groups the terms of \p hamil which flip the same 
+ * qubits, and sets each amplitude of \p outQureg in one gather from \p inQureg per group. 
  *
  * @see
  * - createPauliHamil()
@@ -5093,7 +5866,7 @@ void applyPauliSum(Qureg inQureg, enum pauliOpType* allPauliCodes, qreal* termCo
  *
  * @ingroup operator
  * @param[in] inQureg the register containing the state which \p outQureg will be set to, under
- *      the action of \p hamil. \p inQureg should be unchanged, though may vary slightly due to numerical error.
+ *      the action of \p hamil. \p inQureg is unchanged.
  * @param[in] hamil a weighted sum of products of pauli operators
  * @param[out] outQureg the qureg to modify to be the result of applyling \p hamil to the state in \p inQureg
  * @throws invalidQuESTInputError()
@@ -5144,6 +5917,12 @@ void applyPauliHamil(Qureg inQureg, PauliHamil hamil, Qureg outQureg);
  * These formulations are taken from 'Finding Exponential Product Formulas
  * of Higher Orders', Naomichi Hatano and Masuo Suzuki (2005) (<a href="https://arxiv.org/abs/math-ph/0506007">arXiv</a>).
  *
+ * The diagonal terms of \p hamil (those containing only \p PAULI_Z and \p PAULI_I) commute with 
+ * one another, so within each product above they are gathered and applied exactly, as a single 
+ * diagonal phase, before (or in the reversed products, after) the remaining terms. This leaves the 
+ * order of the decomposition unchanged, and evolves a purely diagonal \p hamil without 
+ * Trotter error, in one pass over \p qureg per product.
+ *
  * Note that the applied Trotter circuit is captured by QASM, if QASM logging is enabled
  * on \p qureg. \n
  * For example:
@@ -5749,6 +6528,31 @@ void applyPhaseFunc(Qureg qureg, int* qubits, int numQubits, enum bitEncoding en
  */
 void applyPhaseFuncOverrides(Qureg qureg, int* qubits, int numQubits, enum bitEncoding encoding, qreal* coeffs, qreal* exponents, int numTerms, long long int* overrideInds, qreal* overridePhases, int numOverrides);
 
+/** Sets whether the table of phases computed by applyPhaseFunc() and applyPhaseFuncOverrides()
+ * is retained between calls.
+ *
+ * When applying a phase function upon \f$n\f$ qubits, the CPU backend first evaluates
+ * \f$\exp(i f(r))\f$ at each of the \f$2^n\f$ distinct values of \f$r\f$, before 
+ * multiplying every amplitude of \p qureg by its corresponding phase. 
+ * With caching enabled, the most recent such table is kept, and reused by a subsequent call 
+ * with an identical \p numQubits, \p encoding, \p coeffs, \p exponents and overrides 
+ * (regardless of which qubits are targeted), avoiding re-evaluating the phase function. 
+ * This benefits circuits which repeatedly apply the same phase function, at the cost 
+ * of retaining \f$2^n\f$ complex numbers in memory.
+ *
+ * Caching is disabled by default. Disabling it (or calling destroyQuESTEnv()) frees any 
+ * retained table. Caching has no effect on the GPU backend, which evaluates each phase directly.
+ *
+ * @see
+ * - applyPhaseFunc()
+ * - applyPhaseFuncOverrides()
+ *
+ * @ingroup operator
+ * @param[in] env the ::QuESTEnv runtime environment
+ * @param[in] cacheTables whether (1) or not (0) to retain the most recent phase table
+ */
+void setPhaseFuncCaching(QuESTEnv env, int cacheTables);
+
 /** Induces a phase change upon each amplitude of \p qureg, determined by a
  * multi-variable exponential polynomial "phase function". 
  *
@@ -6632,6 +7436,31 @@ void applyQFT(Qureg qureg, int* qubits, int numQubits);
  */
 void applyProjector(Qureg qureg, int qubit, int outcome);
 
+/** Force the target \p qubits of \p qureg into the given classical \p outcome, via a 
+ * non-renormalising projection.
+ *
+ * This is a multi-qubit generalisation of applyProjector(), whereby \p outcome is 
+ * an integer in which bit \p q is the outcome to project \p qubits[q] into. All amplitudes 
+ * inconsistent with \p outcome are zeroed in a single pass, and \p qureg is not thereafter
+ * normalised, so may be left in a non-physical (or blank) state.
+ * 
+ * @see
+ * - applyProjector()
+ * - collapseToMultiOutcome() for a norm-preserving equivalent, like a forced measurement
+ *
+ * @ingroup operator
+ * @param[in,out] qureg a state-vector or density matrix to modify
+ * @param[in] qubits a list of the qubits to which to apply the projector 
+ * @param[in] numQubits the length of list \p qubits
+ * @param[in] outcome the joint outcome to project \p qubits into
+ * @throws invalidQuESTInputError()
+ * - if \p numQubits <= 0 or \p numQubits > \p qureg.numQubitsRepresented
+ * - if any index in \p qubits is invalid, i.e. outside <b>[0,</b> \p qureg.numQubitsRepresented <b>)</b>
+ * - if \p qubits contains any repetitions
+ * - if \p outcome is outside <b>[0, 2^</b>\p numQubits<b>)</b>
+ */
+void applyMultiQubitProjector(Qureg qureg, int* qubits, int numQubits, long long int outcome);
+
 // end prevention of C++ name mangling
 #ifdef __cplusplus
 }
@@ -72,6 +72,19 @@
 # define MAX_NUM_REGS_APPLY_ARBITRARY_PHASE 100
 
 
+// \cond HIDDEN_SYMBOLS
+// the distance between consecutive real (or imaginary) components in a ComplexArray
+# ifdef INTERLEAVED_AMPS
+    # define AMP_STRIDE 2
+# else
+    # define AMP_STRIDE 1
+# endif
+
+// the position in ComplexArray.real (or .imag) of the amplitude with index i
+# define AMP_INDEX(i) (AMP_STRIDE*(i))
+// \endcond
+
+
 /** @def QuEST_PREC 
  *
  * Sets the precision of \ref qreal and \ref qcomp floating-point numbers, and 
@@ -107,4 +120,24 @@
  * @author Tyson Jones (doc)
  */
 
+/** @def INTERLEAVED_AMPS
+ *
+ * When defined during compilation, the real and imaginary components of each
+ * amplitude in a \p Qureg are stored adjacently in a single array (as an
+ * array of complex structs), rather than in two separate arrays.
+ * Every amplitude update then touches one memory stream instead of two, which
+ * can improve the bandwidth utilisation of the CPU backend.
+ *
+ * \p qureg.stateVec.real and \p qureg.stateVec.imag remain valid, but point into
+ * the same array with a stride of 2, so the amplitude with index \p i is at
+ * <b>qureg.stateVec.real[2*i]</b> and <b>qureg.stateVec.imag[2*i]</b>.
+ * Users should instead access amplitudes via getAmp() and setAmps(), which adapt
+ * to the layout automatically.
+ *
+ * #INTERLEAVED_AMPS is set by passing \p -DINTERLEAVED_AMPS=1 to cmake, and is
+ * supported only by the single-node CPU backend.
+ *
+ * @ingroup type
+ */
+
 # endif // QUEST_PRECISION_H
@@ -13,6 +13,7 @@
 # include "QuEST.h"
 # include "QuEST_internal.h"
 # include "QuEST_precision.h"
+# include "QuEST_packed.h"
 # include "mt19937ar.h"
 
 # include "QuEST_cpu_internal.h"
@@ -20,6 +21,7 @@
 # include <math.h>  
 # include <stdio.h>
 # include <stdlib.h>
+# include <string.h>
 # include <stdint.h>
 # include <assert.h>
 
@@ -75,8 +77,8 @@ void densmatr_oneQubitDegradeOffDiagonal(Qureg qureg, int targetQubit, qreal ret
             if ((thisPattern==innerMask) || (thisPattern==outerMask)){
                 // do dephase
                 // the lines below will degrade the off-diagonal terms |..0..><..1..| and |..1..><..0..|
-                qureg.stateVec.real[thisTask] = retain*qureg.stateVec.real[thisTask]; 
-                qureg.stateVec.imag[thisTask] = retain*qureg.stateVec.imag[thisTask]; 
+                qureg.stateVec.real[AMP_INDEX(thisTask)] = retain*qureg.stateVec.real[AMP_INDEX(thisTask)]; 
+                qureg.stateVec.imag[AMP_INDEX(thisTask)] = retain*qureg.stateVec.imag[AMP_INDEX(thisTask)]; 
             } 
         }  
     }
@@ -121,8 +123,8 @@ void densmatr_mixTwoQubitDephasing(Qureg qureg, int qubit1, int qubit2, qreal de
                     (thisPatternQubit2==innerMaskQubit2) || (thisPatternQubit2==outerMaskQubit2) ){ 
                 // do dephase
                 // the lines below will degrade the off-diagonal terms |..0..><..1..| and |..1..><..0..|
-                qureg.stateVec.real[thisTask] = retain*qureg.stateVec.real[thisTask]; 
-                qureg.stateVec.imag[thisTask] = retain*qureg.stateVec.imag[thisTask]; 
+                qureg.stateVec.real[AMP_INDEX(thisTask)] = retain*qureg.stateVec.real[AMP_INDEX(thisTask)]; 
+                qureg.stateVec.imag[AMP_INDEX(thisTask)] = retain*qureg.stateVec.imag[AMP_INDEX(thisTask)]; 
             } 
         }  
     }
@@ -157,20 +159,20 @@ void densmatr_mixDepolarisingLocal(Qureg qureg, int targetQubit, qreal depolLeve
             if ((thisPattern==innerMask) || (thisPattern==outerMask)){
                 // do dephase
                 // the lines below will degrade the off-diagonal terms |..0..><..1..| and |..1..><..0..|
-                qureg.stateVec.real[thisTask] = retain*qureg.stateVec.real[thisTask]; 
-                qureg.stateVec.imag[thisTask] = retain*qureg.stateVec.imag[thisTask]; 
+                qureg.stateVec.real[AMP_INDEX(thisTask)] = retain*qureg.stateVec.real[AMP_INDEX(thisTask)]; 
+                qureg.stateVec.imag[AMP_INDEX(thisTask)] = retain*qureg.stateVec.imag[AMP_INDEX(thisTask)]; 
             } else {
                 if ((thisTask&totMask)==0){ //this element relates to targetQubit in state 0
                     // do depolarise
                     partner = thisTask | totMask;
-                    realAv =  (qureg.stateVec.real[thisTask] + qureg.stateVec.real[partner]) /2 ;
-                    imagAv =  (qureg.stateVec.imag[thisTask] + qureg.stateVec.imag[partner]) /2 ;
+                    realAv =  (qureg.stateVec.real[AMP_INDEX(thisTask)] + qureg.stateVec.real[AMP_INDEX(partner)]) /2 ;
+                    imagAv =  (qureg.stateVec.imag[AMP_INDEX(thisTask)] + qureg.stateVec.imag[AMP_INDEX(partner)]) /2 ;
                     
-                    qureg.stateVec.real[thisTask] = retain*qureg.stateVec.real[thisTask] + depolLevel*realAv;
-                    qureg.stateVec.imag[thisTask] = retain*qureg.stateVec.imag[thisTask] + depolLevel*imagAv;
+                    qureg.stateVec.real[AMP_INDEX(thisTask)] = retain*qureg.stateVec.real[AMP_INDEX(thisTask)] + depolLevel*realAv;
+                    qureg.stateVec.imag[AMP_INDEX(thisTask)] = retain*qureg.stateVec.imag[AMP_INDEX(thisTask)] + depolLevel*imagAv;
                     
-                    qureg.stateVec.real[partner] = retain*qureg.stateVec.real[partner] + depolLevel*realAv;
-                    qureg.stateVec.imag[partner] = retain*qureg.stateVec.imag[partner] + depolLevel*imagAv;
+                    qureg.stateVec.real[AMP_INDEX(partner)] = retain*qureg.stateVec.real[AMP_INDEX(partner)] + depolLevel*realAv;
+                    qureg.stateVec.imag[AMP_INDEX(partner)] = retain*qureg.stateVec.imag[AMP_INDEX(partner)] + depolLevel*imagAv;
                 }
             }
         }  
@@ -207,20 +209,20 @@ void densmatr_mixDampingLocal(Qureg qureg, int targetQubit, qreal damping) {
             if ((thisPattern==innerMask) || (thisPattern==outerMask)){
                 // do dephase
                 // the lines below will degrade the off-diagonal terms |..0..><..1..| and |..1..><..0..|
-                qureg.stateVec.real[thisTask] = dephase*qureg.stateVec.real[thisTask]; 
-                qureg.stateVec.imag[thisTask] = dephase*qureg.stateVec.imag[thisTask]; 
+                qureg.stateVec.real[AMP_INDEX(thisTask)] = dephase*qureg.stateVec.real[AMP_INDEX(thisTask)]; 
+                qureg.stateVec.imag[AMP_INDEX(thisTask)] = dephase*qureg.stateVec.imag[AMP_INDEX(thisTask)]; 
             } else {
                 if ((thisTask&totMask)==0){ //this element relates to targetQubit in state 0
                     // do depolarise
                     partner = thisTask | totMask;
-                    //realAv =  (qureg.stateVec.real[thisTask] + qureg.stateVec.real[partner]) /2 ;
-                    //imagAv =  (qureg.stateVec.imag[thisTask] + qureg.stateVec.imag[partner]) /2 ;
+                    //realAv =  (qureg.stateVec.real[AMP_INDEX(thisTask)] + qureg.stateVec.real[AMP_INDEX(partner)]) /2 ;
+                    //imagAv =  (qureg.stateVec.imag[AMP_INDEX(thisTask)] + qureg.stateVec.imag[AMP_INDEX(partner)]) /2 ;
                     
-                    qureg.stateVec.real[thisTask] = qureg.stateVec.real[thisTask] + damping*qureg.stateVec.real[partner];
-                    qureg.stateVec.imag[thisTask] = qureg.stateVec.imag[thisTask] + damping*qureg.stateVec.imag[partner];
+                    qureg.stateVec.real[AMP_INDEX(thisTask)] = qureg.stateVec.real[AMP_INDEX(thisTask)] + damping*qureg.stateVec.real[AMP_INDEX(partner)];
+                    qureg.stateVec.imag[AMP_INDEX(thisTask)] = qureg.stateVec.imag[AMP_INDEX(thisTask)] + damping*qureg.stateVec.imag[AMP_INDEX(partner)];
                     
-                    qureg.stateVec.real[partner] = retain*qureg.stateVec.real[partner];
-                    qureg.stateVec.imag[partner] = retain*qureg.stateVec.imag[partner];
+                    qureg.stateVec.real[AMP_INDEX(partner)] = retain*qureg.stateVec.real[AMP_INDEX(partner)];
+                    qureg.stateVec.imag[AMP_INDEX(partner)] = retain*qureg.stateVec.imag[AMP_INDEX(partner)];
                 }
             }
         }  
@@ -273,9 +275,9 @@ void densmatr_mixDepolarisingDistributed(Qureg qureg, int targetQubit, qreal dep
         for (thisTask=0; thisTask<numTasks; thisTask++) {
             // we want to process all columns in the density matrix,
             // updating the values for half of each column (one half of each inner block)
-            thisOuterColumn = thisTask / sizeOuterHalfColumn;
+            thisOuterColumn = thisTask >> (qureg.numQubitsRepresented-1); // thisTask / sizeOuterHalfColumn
             thisIndexInOuterColumn = thisTask&(sizeOuterHalfColumn-1); // thisTask % sizeOuterHalfColumn
-            thisInnerBlock = thisIndexInOuterColumn/sizeInnerHalfBlock;
+            thisInnerBlock = thisIndexInOuterColumn >> targetQubit; // thisIndexInOuterColumn / sizeInnerHalfBlock
             // get index in state vector corresponding to upper inner block
             thisIndexInInnerBlock = thisTask&(sizeInnerHalfBlock-1); // thisTask % sizeInnerHalfBlock
             thisIndex = thisOuterColumn*sizeOuterColumn + thisInnerBlock*sizeInnerBlock 
@@ -294,11 +296,11 @@ void densmatr_mixDepolarisingDistributed(Qureg qureg, int targetQubit, qreal dep
            
             // state[thisIndex] = (1-depolLevel)*state[thisIndex] + depolLevel*(state[thisIndex]
             //      + pair[thisTask])/2
-            qureg.stateVec.real[thisIndex] = (1-depolLevel)*qureg.stateVec.real[thisIndex] +
-                    depolLevel*(qureg.stateVec.real[thisIndex] + qureg.pairStateVec.real[thisTask])/2;
+            qureg.stateVec.real[AMP_INDEX(thisIndex)] = (1-depolLevel)*qureg.stateVec.real[AMP_INDEX(thisIndex)] +
+                    depolLevel*(qureg.stateVec.real[AMP_INDEX(thisIndex)] + qureg.pairStateVec.real[AMP_INDEX(thisTask)])/2;
             
-            qureg.stateVec.imag[thisIndex] = (1-depolLevel)*qureg.stateVec.imag[thisIndex] +
-                    depolLevel*(qureg.stateVec.imag[thisIndex] + qureg.pairStateVec.imag[thisTask])/2;
+            qureg.stateVec.imag[AMP_INDEX(thisIndex)] = (1-depolLevel)*qureg.stateVec.imag[AMP_INDEX(thisIndex)] +
+                    depolLevel*(qureg.stateVec.imag[AMP_INDEX(thisIndex)] + qureg.pairStateVec.imag[AMP_INDEX(thisTask)])/2;
         } 
     }    
 }
@@ -351,9 +353,9 @@ void densmatr_mixDampingDistributed(Qureg qureg, int targetQubit, qreal damping)
         for (thisTask=0; thisTask<numTasks; thisTask++) {
             // we want to process all columns in the density matrix,
             // updating the values for half of each column (one half of each inner block)
-            thisOuterColumn = thisTask / sizeOuterHalfColumn;
+            thisOuterColumn = thisTask >> (qureg.numQubitsRepresented-1); // thisTask / sizeOuterHalfColumn
             thisIndexInOuterColumn = thisTask&(sizeOuterHalfColumn-1); // thisTask % sizeOuterHalfColumn
-            thisInnerBlock = thisIndexInOuterColumn/sizeInnerHalfBlock;
+            thisInnerBlock = thisIndexInOuterColumn >> targetQubit; // thisIndexInOuterColumn / sizeInnerHalfBlock
             // get index in state vector corresponding to upper inner block
             thisIndexInInnerBlock = thisTask&(sizeInnerHalfBlock-1); // thisTask % sizeInnerHalfBlock
             thisIndex = thisOuterColumn*sizeOuterColumn + thisInnerBlock*sizeInnerBlock 
@@ -376,15 +378,15 @@ void densmatr_mixDampingDistributed(Qureg qureg, int targetQubit, qreal damping)
             // state[thisIndex] = (1-depolLevel)*state[thisIndex] + depolLevel*(state[thisIndex]
             //      + pair[thisTask])/2
             if(stateBit == 0){
-                qureg.stateVec.real[thisIndex] = qureg.stateVec.real[thisIndex] +
-                    damping*( qureg.pairStateVec.real[thisTask]);
+                qureg.stateVec.real[AMP_INDEX(thisIndex)] = qureg.stateVec.real[AMP_INDEX(thisIndex)] +
+                    damping*( qureg.pairStateVec.real[AMP_INDEX(thisTask)]);
                 
-                qureg.stateVec.imag[thisIndex] = qureg.stateVec.imag[thisIndex] +
-                    damping*( qureg.pairStateVec.imag[thisTask]);
+                qureg.stateVec.imag[AMP_INDEX(thisIndex)] = qureg.stateVec.imag[AMP_INDEX(thisIndex)] +
+                    damping*( qureg.pairStateVec.imag[AMP_INDEX(thisTask)]);
             } else{
-                qureg.stateVec.real[thisIndex] = retain*qureg.stateVec.real[thisIndex];
+                qureg.stateVec.real[AMP_INDEX(thisIndex)] = retain*qureg.stateVec.real[AMP_INDEX(thisIndex)];
             
-                qureg.stateVec.imag[thisIndex] = retain*qureg.stateVec.imag[thisIndex];
+                qureg.stateVec.imag[AMP_INDEX(thisIndex)] = retain*qureg.stateVec.imag[AMP_INDEX(thisIndex)];
             }
         } 
     }    
@@ -423,16 +425,16 @@ void densmatr_mixTwoQubitDepolarisingLocal(Qureg qureg, int qubit1, int qubit2,
                         || (thisPatternQubit2==totMaskQubit2))){ 
                 //this element of form |...X...0...><...X...0...|  for X either 0 or 1.
                 partner = thisTask | totMaskQubit1;
-                real00 =  qureg.stateVec.real[thisTask];
-                imag00 =  qureg.stateVec.imag[thisTask];
+                real00 =  qureg.stateVec.real[AMP_INDEX(thisTask)];
+                imag00 =  qureg.stateVec.imag[AMP_INDEX(thisTask)];
                     
-                qureg.stateVec.real[thisTask] = qureg.stateVec.real[thisTask] 
-                    + delta*qureg.stateVec.real[partner];
-                qureg.stateVec.imag[thisTask] = qureg.stateVec.imag[thisTask] 
-                    + delta*qureg.stateVec.imag[partner];
+                qureg.stateVec.real[AMP_INDEX(thisTask)] = qureg.stateVec.real[AMP_INDEX(thisTask)] 
+                    + delta*qureg.stateVec.real[AMP_INDEX(partner)];
+                qureg.stateVec.imag[AMP_INDEX(thisTask)] = qureg.stateVec.imag[AMP_INDEX(thisTask)] 
+                    + delta*qureg.stateVec.imag[AMP_INDEX(partner)];
                     
-                qureg.stateVec.real[partner] = qureg.stateVec.real[partner] + delta*real00;
-                qureg.stateVec.imag[partner] = qureg.stateVec.imag[partner] + delta*imag00;
+                qureg.stateVec.real[AMP_INDEX(partner)] = qureg.stateVec.real[AMP_INDEX(partner)] + delta*real00;
+                qureg.stateVec.imag[AMP_INDEX(partner)] = qureg.stateVec.imag[AMP_INDEX(partner)] + delta*imag00;
                                 
             }
         }
@@ -447,16 +449,16 @@ void densmatr_mixTwoQubitDepolarisingLocal(Qureg qureg, int qubit1, int qubit2,
                         || (thisPatternQubit1==totMaskQubit1))){ 
                 //this element of form |...0...X...><...0...X...|  for X either 0 or 1.
                 partner = thisTask | totMaskQubit2;
-                real00 =  qureg.stateVec.real[thisTask];
-                imag00 =  qureg.stateVec.imag[thisTask];
+                real00 =  qureg.stateVec.real[AMP_INDEX(thisTask)];
+                imag00 =  qureg.stateVec.imag[AMP_INDEX(thisTask)];
                     
-                qureg.stateVec.real[thisTask] = qureg.stateVec.real[thisTask] 
-                    + delta*qureg.stateVec.real[partner];
-                qureg.stateVec.imag[thisTask] = qureg.stateVec.imag[thisTask] 
-                    + delta*qureg.stateVec.imag[partner];
+                qureg.stateVec.real[AMP_INDEX(thisTask)] = qureg.stateVec.real[AMP_INDEX(thisTask)] 
+                    + delta*qureg.stateVec.real[AMP_INDEX(partner)];
+                qureg.stateVec.imag[AMP_INDEX(thisTask)] = qureg.stateVec.imag[AMP_INDEX(thisTask)] 
+                    + delta*qureg.stateVec.imag[AMP_INDEX(partner)];
                     
-                qureg.stateVec.real[partner] = qureg.stateVec.real[partner] + delta*real00;
-                qureg.stateVec.imag[partner] = qureg.stateVec.imag[partner] + delta*imag00;
+                qureg.stateVec.real[AMP_INDEX(partner)] = qureg.stateVec.real[AMP_INDEX(partner)] + delta*real00;
+                qureg.stateVec.imag[AMP_INDEX(partner)] = qureg.stateVec.imag[AMP_INDEX(partner)] + delta*imag00;
 
             }
         }
@@ -473,17 +475,17 @@ void densmatr_mixTwoQubitDepolarisingLocal(Qureg qureg, int qubit1, int qubit2,
                 //this element of form |...0...X...><...0...X...|  for X either 0 or 1.
                 partner = thisTask | totMaskQubit2;
                 partner = partner ^ totMaskQubit1;
-                real00 =  qureg.stateVec.real[thisTask];
-                imag00 =  qureg.stateVec.imag[thisTask];
+                real00 =  qureg.stateVec.real[AMP_INDEX(thisTask)];
+                imag00 =  qureg.stateVec.imag[AMP_INDEX(thisTask)];
 
-                qureg.stateVec.real[thisTask] = gamma * (qureg.stateVec.real[thisTask] 
-                        + delta*qureg.stateVec.real[partner]);
-                qureg.stateVec.imag[thisTask] = gamma * (qureg.stateVec.imag[thisTask] 
-                        + delta*qureg.stateVec.imag[partner]);
+                qureg.stateVec.real[AMP_INDEX(thisTask)] = gamma * (qureg.stateVec.real[AMP_INDEX(thisTask)] 
+                        + delta*qureg.stateVec.real[AMP_INDEX(partner)]);
+                qureg.stateVec.imag[AMP_INDEX(thisTask)] = gamma * (qureg.stateVec.imag[AMP_INDEX(thisTask)] 
+                        + delta*qureg.stateVec.imag[AMP_INDEX(partner)]);
                     
-                qureg.stateVec.real[partner] = gamma * (qureg.stateVec.real[partner] 
+                qureg.stateVec.real[AMP_INDEX(partner)] = gamma * (qureg.stateVec.real[AMP_INDEX(partner)] 
                         + delta*real00);
-                qureg.stateVec.imag[partner] = gamma * (qureg.stateVec.imag[partner] 
+                qureg.stateVec.imag[AMP_INDEX(partner)] = gamma * (qureg.stateVec.imag[AMP_INDEX(partner)] 
                         + delta*imag00);
 
             }
@@ -528,16 +530,16 @@ void densmatr_mixTwoQubitDepolarisingLocalPart1(Qureg qureg, int qubit1, int qub
                         || (thisPatternQubit2==totMaskQubit2))){ 
                 //this element of form |...X...0...><...X...0...|  for X either 0 or 1.
                 partner = thisTask | totMaskQubit1;
-                real00 =  qureg.stateVec.real[thisTask];
-                imag00 =  qureg.stateVec.imag[thisTask];
+                real00 =  qureg.stateVec.real[AMP_INDEX(thisTask)];
+                imag00 =  qureg.stateVec.imag[AMP_INDEX(thisTask)];
                     
-                qureg.stateVec.real[thisTask] = qureg.stateVec.real[thisTask] 
-                    + delta*qureg.stateVec.real[partner];
-                qureg.stateVec.imag[thisTask] = qureg.stateVec.imag[thisTask] 
-                    + delta*qureg.stateVec.imag[partner];
+                qureg.stateVec.real[AMP_INDEX(thisTask)] = qureg.stateVec.real[AMP_INDEX(thisTask)] 
+                    + delta*qureg.stateVec.real[AMP_INDEX(partner)];
+                qureg.stateVec.imag[AMP_INDEX(thisTask)] = qureg.stateVec.imag[AMP_INDEX(thisTask)] 
+                    + delta*qureg.stateVec.imag[AMP_INDEX(partner)];
                     
-                qureg.stateVec.real[partner] = qureg.stateVec.real[partner] + delta*real00;
-                qureg.stateVec.imag[partner] = qureg.stateVec.imag[partner] + delta*imag00;
+                qureg.stateVec.real[AMP_INDEX(partner)] = qureg.stateVec.real[AMP_INDEX(partner)] + delta*real00;
+                qureg.stateVec.imag[AMP_INDEX(partner)] = qureg.stateVec.imag[AMP_INDEX(partner)] + delta*imag00;
                                 
             }
         }
@@ -592,13 +594,13 @@ void densmatr_mixTwoQubitDepolarisingDistributed(Qureg qureg, int targetQubit,
         for (thisTask=0; thisTask<numTasks; thisTask++) {
             // we want to process all columns in the density matrix,
             // updating the values for half of each column (one half of each inner block)
-            thisOuterColumn = thisTask / sizeOuterQuarterColumn;
+            thisOuterColumn = thisTask >> (qureg.numQubitsRepresented-2); // thisTask / sizeOuterQuarterColumn
             // thisTask % sizeOuterQuarterColumn
             thisIndexInOuterColumn = thisTask&(sizeOuterQuarterColumn-1); 
-            thisInnerBlockQ2 = thisIndexInOuterColumn / sizeInnerQuarterBlockQ2;
+            thisInnerBlockQ2 = thisIndexInOuterColumn >> (qubit2-1); // thisIndexInOuterColumn / sizeInnerQuarterBlockQ2
             // thisTask % sizeInnerQuarterBlockQ2;
             thisIndexInInnerBlockQ2 = thisTask&(sizeInnerQuarterBlockQ2-1);
-            thisInnerBlockQ1InInnerBlockQ2 = thisIndexInInnerBlockQ2 / sizeInnerHalfBlockQ1;
+            thisInnerBlockQ1InInnerBlockQ2 = thisIndexInInnerBlockQ2 >> targetQubit; // thisIndexInInnerBlockQ2 / sizeInnerHalfBlockQ1
             // thisTask % sizeInnerHalfBlockQ1;
             thisIndexInInnerBlockQ1 = thisTask&(sizeInnerHalfBlockQ1-1);
 
@@ -627,10 +629,10 @@ void densmatr_mixTwoQubitDepolarisingDistributed(Qureg qureg, int targetQubit,
             // state[thisIndex] = (1-depolLevel)*state[thisIndex] + depolLevel*(state[thisIndex]
             //      + pair[thisTask])/2
             // NOTE: must set gamma=1 if using this function for steps 1 or 2
-            qureg.stateVec.real[thisIndex] = gamma*(qureg.stateVec.real[thisIndex] +
-                    delta*qureg.pairStateVec.real[thisTask]);
-            qureg.stateVec.imag[thisIndex] = gamma*(qureg.stateVec.imag[thisIndex] +
-                    delta*qureg.pairStateVec.imag[thisTask]);
+            qureg.stateVec.real[AMP_INDEX(thisIndex)] = gamma*(qureg.stateVec.real[AMP_INDEX(thisIndex)] +
+                    delta*qureg.pairStateVec.real[AMP_INDEX(thisTask)]);
+            qureg.stateVec.imag[AMP_INDEX(thisIndex)] = gamma*(qureg.stateVec.imag[AMP_INDEX(thisIndex)] +
+                    delta*qureg.pairStateVec.imag[AMP_INDEX(thisTask)]);
         } 
     }    
 }
@@ -686,13 +688,13 @@ void densmatr_mixTwoQubitDepolarisingQ1LocalQ2DistributedPart3(Qureg qureg, int
         for (thisTask=0; thisTask<numTasks; thisTask++) {
             // we want to process all columns in the density matrix,
             // updating the values for half of each column (one half of each inner block)
-            thisOuterColumn = thisTask / sizeOuterQuarterColumn;
+            thisOuterColumn = thisTask >> (qureg.numQubitsRepresented-2); // thisTask / sizeOuterQuarterColumn
             // thisTask % sizeOuterQuarterColumn
             thisIndexInOuterColumn = thisTask&(sizeOuterQuarterColumn-1); 
-            thisInnerBlockQ2 = thisIndexInOuterColumn / sizeInnerQuarterBlockQ2;
+            thisInnerBlockQ2 = thisIndexInOuterColumn >> (qubit2-1); // thisIndexInOuterColumn / sizeInnerQuarterBlockQ2
             // thisTask % sizeInnerQuarterBlockQ2;
             thisIndexInInnerBlockQ2 = thisTask&(sizeInnerQuarterBlockQ2-1);
-            thisInnerBlockQ1InInnerBlockQ2 = thisIndexInInnerBlockQ2 / sizeInnerHalfBlockQ1;
+            thisInnerBlockQ1InInnerBlockQ2 = thisIndexInInnerBlockQ2 >> targetQubit; // thisIndexInInnerBlockQ2 / sizeInnerHalfBlockQ1
             // thisTask % sizeInnerHalfBlockQ1;
             thisIndexInInnerBlockQ1 = thisTask&(sizeInnerHalfBlockQ1-1);
 
@@ -725,11 +727,11 @@ void densmatr_mixTwoQubitDepolarisingQ1LocalQ2DistributedPart3(Qureg qureg, int
            
             // state[thisIndex] = (1-depolLevel)*state[thisIndex] + depolLevel*(state[thisIndex]
             //      + pair[thisIndexInPairVector])/2
-            qureg.stateVec.real[thisIndex] = gamma*(qureg.stateVec.real[thisIndex] +
-                    delta*qureg.pairStateVec.real[thisIndexInPairVector]);
+            qureg.stateVec.real[AMP_INDEX(thisIndex)] = gamma*(qureg.stateVec.real[AMP_INDEX(thisIndex)] +
+                    delta*qureg.pairStateVec.real[AMP_INDEX(thisIndexInPairVector)]);
             
-            qureg.stateVec.imag[thisIndex] = gamma*(qureg.stateVec.imag[thisIndex] +
-                    delta*qureg.pairStateVec.imag[thisIndexInPairVector]);
+            qureg.stateVec.imag[AMP_INDEX(thisIndex)] = gamma*(qureg.stateVec.imag[AMP_INDEX(thisIndex)] +
+                    delta*qureg.pairStateVec.imag[AMP_INDEX(thisIndexInPairVector)]);
         } 
     }    
 
@@ -743,8 +745,8 @@ void zeroSomeAmps(Qureg qureg, long long int startInd, long long int numAmps) {
 # pragma omp parallel for schedule (static)
 # endif
     for (i=startInd; i < startInd+numAmps; i++) {
-        qureg.stateVec.real[i] = 0;
-        qureg.stateVec.imag[i] = 0;
+        qureg.stateVec.real[AMP_INDEX(i)] = 0;
+        qureg.stateVec.imag[AMP_INDEX(i)] = 0;
     }
 }
 void normaliseSomeAmps(Qureg qureg, qreal norm, long long int startInd, long long int numAmps) {
@@ -753,8 +755,8 @@ void normaliseSomeAmps(Qureg qureg, qreal norm, long long int startInd, long lon
 # pragma omp parallel for schedule (static)
 # endif
     for (i=startInd; i < startInd+numAmps; i++) {
-        qureg.stateVec.real[i] /= norm;
-        qureg.stateVec.imag[i] /= norm;
+        qureg.stateVec.real[AMP_INDEX(i)] /= norm;
+        qureg.stateVec.imag[AMP_INDEX(i)] /= norm;
     }
 }
 void alternateNormZeroingSomeAmpBlocks(
@@ -869,6 +871,61 @@ void densmatr_collapseToKnownProbOutcome(Qureg qureg, int measureQubit, int outc
     
 }
 
+/** Multiplies every local amplitude, whose global index satisfies (index & mask) == maskedOutcome, 
+ * by factor, and sets all others to zero, in a single pass
+ */
+static void collapseToMaskedOutcome(Qureg qureg, long long int mask, long long int maskedOutcome, qreal factor) {
+    
+    long long int numAmps = qureg.numAmpsPerChunk;
+    long long int globalStartInd = qureg.chunkId * numAmps;
+    qreal* stateRe = qureg.stateVec.real;
+    qreal* stateIm = qureg.stateVec.imag;
+    
+    long long int index;
+    qreal fac;
+
+# ifdef _OPENMP
+# pragma omp parallel for schedule (static) \
+    default  (none) \
+    shared   (numAmps,globalStartInd, stateRe,stateIm, mask,maskedOutcome,factor) \
+    private  (index, fac)
+# endif
+    for (index=0; index<numAmps; index++) {
+        fac = (((globalStartInd + index) & mask) == maskedOutcome)? factor : 0;
+        stateRe[AMP_INDEX(index)] *= fac;
+        stateIm[AMP_INDEX(index)] *= fac;
+    }
+}
+
+/** Renorms (/sqrt(prob)) every amplitude in which qubits are in the given outcome, setting all others to zero */
+void statevec_collapseToKnownProbMultiOutcome(Qureg qureg, int* qubits, int numQubits, long long int outcome, qreal outcomeProb) {
+    
+    long long int mask = 0;
+    long long int maskedOutcome = 0;
+    for (int q=0; q<numQubits; q++) {
+        mask |= 1LL << qubits[q];
+        maskedOutcome |= ((long long int) extractBit(q, outcome)) << qubits[q];
+    }
+    
+    collapseToMaskedOutcome(qureg, mask, maskedOutcome, 1/sqrt(outcomeProb));
+}
+
+/** Renorms (/prob) every | * outcome * >< * outcome * | state, setting all others to zero */
+void densmatr_collapseToKnownProbMultiOutcome(Qureg qureg, int* qubits, int numQubits, long long int outcome, qreal outcomeProb) {
+    
+    // the qubits must be in outcome in both the row and column index of each element
+    int shift = qureg.numQubitsRepresented;
+    long long int mask = 0;
+    long long int maskedOutcome = 0;
+    for (int q=0; q<numQubits; q++) {
+        long long int bit = extractBit(q, outcome);
+        mask |= (1LL << qubits[q]) | (1LL << (qubits[q] + shift));
+        maskedOutcome |= (bit << qubits[q]) | (bit << (qubits[q] + shift));
+    }
+    
+    collapseToMaskedOutcome(qureg, mask, maskedOutcome, 1/outcomeProb);
+}
+
 qreal densmatr_calcPurityLocal(Qureg qureg) {
     
     /* sum of qureg^2, which is sum_i |qureg[i]|^2 */
@@ -891,7 +948,7 @@ qreal densmatr_calcPurityLocal(Qureg qureg) {
 # endif
         for (index=0LL; index<numAmps; index++) {
                         
-            trace += vecRe[index]*vecRe[index] + vecIm[index]*vecIm[index];
+            trace += vecRe[AMP_INDEX(index)]*vecRe[AMP_INDEX(index)] + vecIm[AMP_INDEX(index)]*vecIm[AMP_INDEX(index)];
         }
     }
     
@@ -921,11 +978,11 @@ void densmatr_mixDensityMatrix(Qureg combineQureg, qreal otherProb, Qureg otherQ
 # pragma omp for schedule  (static)
 # endif
         for (index=0; index < numAmps; index++) {
-            combineVecRe[index] *= 1-otherProb;
-            combineVecIm[index] *= 1-otherProb;
+            combineVecRe[AMP_INDEX(index)] *= 1-otherProb;
+            combineVecIm[AMP_INDEX(index)] *= 1-otherProb;
             
-            combineVecRe[index] += otherProb * otherVecRe[index];
-            combineVecIm[index] += otherProb * otherVecIm[index];
+            combineVecRe[AMP_INDEX(index)] += otherProb * otherVecRe[AMP_INDEX(index)];
+            combineVecIm[AMP_INDEX(index)] += otherProb * otherVecIm[AMP_INDEX(index)];
         }
     }
 }
@@ -956,8 +1013,8 @@ qreal densmatr_calcHilbertSchmidtDistanceSquaredLocal(Qureg a, Qureg b) {
 # endif
         for (index=0LL; index<numAmps; index++) {
                         
-            difRe = aRe[index] - bRe[index];
-            difIm = aIm[index] - bIm[index];
+            difRe = aRe[AMP_INDEX(index)] - bRe[AMP_INDEX(index)];
+            difIm = aIm[AMP_INDEX(index)] - bIm[AMP_INDEX(index)];
             trace += difRe*difRe + difIm*difIm;
         }
     }
@@ -989,7 +1046,7 @@ qreal densmatr_calcInnerProductLocal(Qureg a, Qureg b) {
 # pragma omp for schedule  (static)
 # endif
         for (index=0LL; index<numAmps; index++) {
-            trace += aRe[index]*bRe[index] + aIm[index]*bIm[index];
+            trace += aRe[AMP_INDEX(index)]*bRe[AMP_INDEX(index)] + aIm[AMP_INDEX(index)]*bIm[AMP_INDEX(index)];
         }
     }
     
@@ -1051,8 +1108,8 @@ qreal densmatr_calcFidelityLocal(Qureg qureg, Qureg pureState) {
         for (row=0; row < dim; row++) {
             
             // single element of conj(pureState)
-            prefacRe =   vecRe[row];
-            prefacIm = - vecIm[row];
+            prefacRe =   vecRe[AMP_INDEX(row)];
+            prefacIm = - vecIm[AMP_INDEX(row)];
                     
             rowSumRe = 0;
             rowSumIm = 0;
@@ -1061,12 +1118,12 @@ qreal densmatr_calcFidelityLocal(Qureg qureg, Qureg pureState) {
             for (col=0; col < colsPerNode; col++) {
             
                 // my local density element
-                densElemRe = densRe[row + dim*col];
-                densElemIm = densIm[row + dim*col];
+                densElemRe = densRe[AMP_INDEX(row + dim*col)];
+                densElemIm = densIm[AMP_INDEX(row + dim*col)];
             
                 // state-vector element
-                vecElemRe = vecRe[startCol + col];
-                vecElemIm = vecIm[startCol + col];
+                vecElemRe = vecRe[AMP_INDEX(startCol + col)];
+                vecElemIm = vecIm[AMP_INDEX(startCol + col)];
             
                 rowSumRe += densElemRe*vecElemRe - densElemIm*vecElemIm;
                 rowSumIm += densElemRe*vecElemIm + densElemIm*vecElemRe;
@@ -1104,10 +1161,10 @@ Complex statevec_calcInnerProductLocal(Qureg bra, Qureg ket) {
 # pragma omp for schedule  (static)
 # endif
         for (index=0; index < numAmps; index++) {
-            braRe = braVecReal[index];
-            braIm = braVecImag[index];
-            ketRe = ketVecReal[index];
-            ketIm = ketVecImag[index];
+            braRe = braVecReal[AMP_INDEX(index)];
+            braIm = braVecImag[AMP_INDEX(index)];
+            ketRe = ketVecReal[AMP_INDEX(index)];
+            ketIm = ketVecImag[AMP_INDEX(index)];
             
             // conj(bra_i) * ket_i
             innerProdReal += braRe*ketRe + braIm*ketIm;
@@ -1145,8 +1202,8 @@ void densmatr_initClassicalState (Qureg qureg, long long int stateInd)
 # pragma omp for schedule (static)
 # endif
         for (index=0; index<densityNumElems; index++) {
-            densityReal[index] = 0.0;
-            densityImag[index] = 0.0;
+            densityReal[AMP_INDEX(index)] = 0.0;
+            densityImag[AMP_INDEX(index)] = 0.0;
         }
     }
     
@@ -1156,8 +1213,8 @@ void densmatr_initClassicalState (Qureg qureg, long long int stateInd)
 
     // give the specified classical state prob 1
     if (qureg.chunkId == densityInd / densityNumElems){
-        densityReal[densityInd % densityNumElems] = 1.0;
-        densityImag[densityInd % densityNumElems] = 0.0;
+        densityReal[AMP_INDEX(densityInd % densityNumElems)] = 1.0;
+        densityImag[AMP_INDEX(densityInd % densityNumElems)] = 0.0;
     }
 }
 
@@ -1186,8 +1243,8 @@ void densmatr_initPlusState (Qureg qureg)
 # pragma omp for schedule (static)
 # endif
         for (index=0; index<chunkSize; index++) {
-            densityReal[index] = probFactor;
-            densityImag[index] = 0.0;
+            densityReal[AMP_INDEX(index)] = probFactor;
+            densityImag[AMP_INDEX(index)] = 0.0;
         }
     }
 }
@@ -1231,15 +1288,15 @@ void densmatr_initPureStateLocal(Qureg targetQureg, Qureg copyQureg) {
             for (row=0; row < rowsPerNode; row++) {
             
                 // get pure state amps
-                ketRe = vecRe[row];
-                ketIm = vecIm[row];
-                braRe =   vecRe[col + colOffset];
-                braIm = - vecIm[col + colOffset]; // minus for conjugation
+                ketRe = vecRe[AMP_INDEX(row)];
+                ketIm = vecIm[AMP_INDEX(row)];
+                braRe =   vecRe[AMP_INDEX(col + colOffset)];
+                braIm = - vecIm[AMP_INDEX(col + colOffset)]; // minus for conjugation
             
                 // update density matrix
                 index = row + col*rowsPerNode; // local ind
-                densRe[index] = ketRe*braRe - ketIm*braIm;
-                densIm[index] = ketRe*braIm + ketIm*braRe;
+                densRe[AMP_INDEX(index)] = ketRe*braRe - ketIm*braIm;
+                densIm[AMP_INDEX(index)] = ketRe*braIm + ketIm*braRe;
             }
         }
     }
@@ -1281,8 +1338,8 @@ void statevec_setAmps(Qureg qureg, long long int startInd, qreal* reals, qreal*
 # endif
         // iterate these local inds - this might involve no iterations
         for (index=localStartInd; index < localEndInd; index++) {
-            vecRe[index] = reals[index + offset];
-            vecIm[index] = imags[index + offset];
+            vecRe[AMP_INDEX(index)] = reals[index + offset];
+            vecIm[AMP_INDEX(index)] = imags[index + offset];
         }
     }
 }
@@ -1298,8 +1355,14 @@ void statevec_createQureg(Qureg *qureg, int numQubits, QuESTEnv env)
     }
 
     size_t arrSize = (size_t) (numAmpsPerRank * sizeof(*(qureg->stateVec.real)));
+# ifdef INTERLEAVED_AMPS
+    // the imaginary components are interleaved between the real components of one array
+    qureg->stateVec.real = malloc(2 * arrSize);
+    qureg->stateVec.imag = (qureg->stateVec.real)? qureg->stateVec.real + 1 : NULL;
+# else
     qureg->stateVec.real = malloc(arrSize);
     qureg->stateVec.imag = malloc(arrSize);
+# endif
     if (env.numRanks>1){
         qureg->pairStateVec.real = malloc(arrSize);
         qureg->pairStateVec.imag = malloc(arrSize);
@@ -1323,6 +1386,7 @@ void statevec_createQureg(Qureg *qureg, int numQubits, QuESTEnv env)
     qureg->chunkId = env.rank;
     qureg->numChunks = env.numRanks;
     qureg->isDensityMatrix = 0;
+    qureg->isPackedDensityMatrix = 0;
 }
 
 void statevec_destroyQureg(Qureg qureg, QuESTEnv env){
@@ -1332,7 +1396,9 @@ void statevec_destroyQureg(Qureg qureg, QuESTEnv env){
     qureg.numAmpsPerChunk = 0;
 
     free(qureg.stateVec.real);
+# ifndef INTERLEAVED_AMPS
     free(qureg.stateVec.imag);
+# endif
     if (env.numRanks>1){
         free(qureg.pairStateVec.real);
         free(qureg.pairStateVec.imag);
@@ -1466,8 +1532,8 @@ void statevec_reportStateToScreen(Qureg qureg, QuESTEnv env, int reportRank){
                 }
 
                 for(index=0; index<qureg.numAmpsPerChunk; index++){
-                    //printf(REAL_STRING_FORMAT ", " REAL_STRING_FORMAT "\n", qureg.pairStateVec.real[index], qureg.pairStateVec.imag[index]);
-                    printf(REAL_STRING_FORMAT ", " REAL_STRING_FORMAT "\n", qureg.stateVec.real[index], qureg.stateVec.imag[index]);
+                    //printf(REAL_STRING_FORMAT ", " REAL_STRING_FORMAT "\n", qureg.pairStateVec.real[AMP_INDEX(index)], qureg.pairStateVec.imag[AMP_INDEX(index)]);
+                    printf(REAL_STRING_FORMAT ", " REAL_STRING_FORMAT "\n", qureg.stateVec.real[AMP_INDEX(index)], qureg.stateVec.imag[AMP_INDEX(index)]);
                 }
                 if (reportRank || rank==qureg.numChunks-1) printf("]\n");
             }
@@ -1500,8 +1566,8 @@ void statevec_initBlankState (Qureg qureg)
 # pragma omp for schedule (static)
 # endif
         for (index=0; index<stateVecSize; index++) {
-            stateVecReal[index] = 0.0;
-            stateVecImag[index] = 0.0;
+            stateVecReal[AMP_INDEX(index)] = 0.0;
+            stateVecImag[AMP_INDEX(index)] = 0.0;
         }
     }
 }
@@ -1511,8 +1577,8 @@ void statevec_initZeroState (Qureg qureg)
     statevec_initBlankState(qureg);
     if (qureg.chunkId==0){
         // zero state |0000..0000> has probability 1
-        qureg.stateVec.real[0] = 1.0;
-        qureg.stateVec.imag[0] = 0.0;
+        qureg.stateVec.real[AMP_INDEX(0)] = 1.0;
+        qureg.stateVec.imag[AMP_INDEX(0)] = 0.0;
     }
 }
 
@@ -1542,8 +1608,8 @@ void statevec_initPlusState (Qureg qureg)
 # pragma omp for schedule (static)
 # endif
         for (index=0; index<chunkSize; index++) {
-            stateVecReal[index] = normFactor;
-            stateVecImag[index] = 0.0;
+            stateVecReal[AMP_INDEX(index)] = normFactor;
+            stateVecImag[AMP_INDEX(index)] = 0.0;
         }
     }
 }
@@ -1572,15 +1638,15 @@ void statevec_initClassicalState (Qureg qureg, long long int stateInd)
 # pragma omp for schedule (static)
 # endif
         for (index=0; index<stateVecSize; index++) {
-            stateVecReal[index] = 0.0;
-            stateVecImag[index] = 0.0;
+            stateVecReal[AMP_INDEX(index)] = 0.0;
+            stateVecImag[AMP_INDEX(index)] = 0.0;
         }
     }
 
     // give the specified classical state prob 1
     if (qureg.chunkId == stateInd/stateVecSize){
-        stateVecReal[stateInd % stateVecSize] = 1.0;
-        stateVecImag[stateInd % stateVecSize] = 0.0;
+        stateVecReal[AMP_INDEX(stateInd % stateVecSize)] = 1.0;
+        stateVecImag[AMP_INDEX(stateInd % stateVecSize)] = 0.0;
     }
 }
 
@@ -1611,8 +1677,8 @@ void statevec_cloneQureg(Qureg targetQureg, Qureg copyQureg) {
 # pragma omp for schedule (static)
 # endif
         for (index=0; index<stateVecSize; index++) {
-            targetStateVecReal[index] = copyStateVecReal[index];
-            targetStateVecImag[index] = copyStateVecImag[index];
+            targetStateVecReal[AMP_INDEX(index)] = copyStateVecReal[AMP_INDEX(index)];
+            targetStateVecImag[AMP_INDEX(index)] = copyStateVecImag[AMP_INDEX(index)];
         }
     }
 }
@@ -1653,11 +1719,11 @@ void statevec_initStateOfSingleQubit(Qureg *qureg, int qubitId, int outcome)
         for (index=0; index<chunkSize; index++) {
             bit = extractBit(qubitId, index+chunkId*chunkSize);
             if (bit==outcome) {
-                stateVecReal[index] = normFactor;
-                stateVecImag[index] = 0.0;
+                stateVecReal[AMP_INDEX(index)] = normFactor;
+                stateVecImag[AMP_INDEX(index)] = 0.0;
             } else {
-                stateVecReal[index] = 0.0;
-                stateVecImag[index] = 0.0;
+                stateVecReal[AMP_INDEX(index)] = 0.0;
+                stateVecImag[AMP_INDEX(index)] = 0.0;
             }
         }
     }
@@ -1696,8 +1762,8 @@ void statevec_initDebugState (Qureg qureg)
 # pragma omp for schedule (static)
 # endif
         for (index=0; index<chunkSize; index++) {
-            stateVecReal[index] = ((indexOffset + index)*2.0)/10.0;
-            stateVecImag[index] = ((indexOffset + index)*2.0+1.0)/10.0;
+            stateVecReal[AMP_INDEX(index)] = ((indexOffset + index)*2.0)/10.0;
+            stateVecImag[AMP_INDEX(index)] = ((indexOffset + index)*2.0+1.0)/10.0;
         }
     }
 }
@@ -1730,14 +1796,14 @@ int statevec_initStateFromSingleFile(Qureg *qureg, char filename[200], QuESTEnv
                     int chunkId = (int) (totalIndex/chunkSize);
                     if (chunkId==qureg->chunkId){
                         # if QuEST_PREC==1
-                        sscanf(line, "%f, %f", &(stateVecReal[indexInChunk]), 
-                                &(stateVecImag[indexInChunk])); 
+                        sscanf(line, "%f, %f", &(stateVecReal[AMP_INDEX(indexInChunk)]), 
+                                &(stateVecImag[AMP_INDEX(indexInChunk)])); 
                         # elif QuEST_PREC==2                    
-                        sscanf(line, "%lf, %lf", &(stateVecReal[indexInChunk]), 
-                                &(stateVecImag[indexInChunk]));
+                        sscanf(line, "%lf, %lf", &(stateVecReal[AMP_INDEX(indexInChunk)]), 
+                                &(stateVecImag[AMP_INDEX(indexInChunk)]));
                         # elif QuEST_PREC==4
-                        sscanf(line, "%Lf, %Lf", &(stateVecReal[indexInChunk]), 
-                                &(stateVecImag[indexInChunk]));
+                        sscanf(line, "%Lf, %Lf", &(stateVecReal[AMP_INDEX(indexInChunk)]), 
+                                &(stateVecImag[AMP_INDEX(indexInChunk)]));
                         # endif
                         indexInChunk += 1;
                     }
@@ -1758,14 +1824,214 @@ int statevec_compareStates(Qureg mq1, Qureg mq2, qreal precision){
     long long int chunkSize = mq1.numAmpsPerChunk;
     
     for (long long int i=0; i<chunkSize; i++){
-        diff = absReal(mq1.stateVec.real[i] - mq2.stateVec.real[i]);
+        diff = absReal(mq1.stateVec.real[AMP_INDEX(i)] - mq2.stateVec.real[AMP_INDEX(i)]);
         if (diff>precision) return 0;
-        diff = absReal(mq1.stateVec.imag[i] - mq2.stateVec.imag[i]);
+        diff = absReal(mq1.stateVec.imag[AMP_INDEX(i)] - mq2.stateVec.imag[AMP_INDEX(i)]);
         if (diff>precision) return 0;
     }
     return 1;
 }
 
+/*
+ * Vectorised kernels, which modify contiguous runs of amplitudes (in the split real
+ * and imaginary arrays) and are compiled separately for several instruction sets.
+ * The best supported by the executing CPU is chosen by selectVectorisedKernels()
+ * when the QuESTEnv is created, so a single build makes use of AVX2 or AVX-512
+ * where available. Other compilers and architectures use only the default build.
+ */
+
+# if (defined(__GNUC__) || defined(__clang__)) && !defined(__INTEL_COMPILER) \
+    && (defined(__x86_64__) || defined(__i386__))
+# define MULTI_ISA_KERNELS
+# endif
+
+# ifdef MULTI_ISA_KERNELS
+# define RESTRICT __restrict__
+# else
+# define RESTRICT
+# endif
+
+# if defined(_OPENMP) && _OPENMP >= 201307
+# define SIMD_LOOP _Pragma("omp simd")
+# else
+# define SIMD_LOOP
+# endif
+
+/** The number of contiguous amplitude pairs (or quads) processed by a vectorised 
+ * kernel call. Targets below log2(MIN_VECTORISED_RUN) use the scalar loops, which
+ * avoid the per-run overhead. Both must be powers of 2.
+ */
+# define MIN_VECTORISED_RUN 8
+# define MAX_VECTORISED_RUN 1024
+
+/* the real and imaginary components of row j of u multiplied onto {r0..r3} + i {m0..m3} */
+# define APPLY_ROW_REAL(u, j) ( \
+    u.real[j][0]*r0 - u.imag[j][0]*m0 + u.real[j][1]*r1 - u.imag[j][1]*m1 + \
+    u.real[j][2]*r2 - u.imag[j][2]*m2 + u.real[j][3]*r3 - u.imag[j][3]*m3 )
+# define APPLY_ROW_IMAG(u, j) ( \
+    u.real[j][0]*m0 + u.imag[j][0]*r0 + u.real[j][1]*m1 + u.imag[j][1]*r1 + \
+    u.real[j][2]*m2 + u.imag[j][2]*r2 + u.real[j][3]*m3 + u.imag[j][3]*r3 )
+
+/* defines the kernels for one instruction set, where ATTRIB is its target attribute */
+# define DEFINE_VECTORISED_KERNELS(ISA, ATTRIB) \
+    \
+    ATTRIB static void applyMatrix2ToAmpPairs_##ISA( \
+        qreal* RESTRICT reUp, qreal* RESTRICT imUp, \
+        qreal* RESTRICT reLo, qreal* RESTRICT imLo, \
+        long long int numPairs, ComplexMatrix2 u \
+    ) { \
+        qreal r00=u.real[0][0], r01=u.real[0][1], r10=u.real[1][0], r11=u.real[1][1]; \
+        qreal i00=u.imag[0][0], i01=u.imag[0][1], i10=u.imag[1][0], i11=u.imag[1][1]; \
+        SIMD_LOOP \
+        for (long long int i=0; i<numPairs; i++) { \
+            qreal ru=reUp[AMP_INDEX(i)], iu=imUp[AMP_INDEX(i)], rl=reLo[AMP_INDEX(i)], il=imLo[AMP_INDEX(i)]; \
+            reUp[AMP_INDEX(i)] = r00*ru - i00*iu + r01*rl - i01*il; \
+            imUp[AMP_INDEX(i)] = r00*iu + i00*ru + r01*il + i01*rl; \
+            reLo[AMP_INDEX(i)] = r10*ru - i10*iu + r11*rl - i11*il; \
+            imLo[AMP_INDEX(i)] = r10*iu + i10*ru + r11*il + i11*rl; \
+        } \
+    } \
+    \
+    ATTRIB static void swapAmpPairs_##ISA( \
+        qreal* RESTRICT reUp, qreal* RESTRICT imUp, \
+        qreal* RESTRICT reLo, qreal* RESTRICT imLo, \
+        long long int numPairs \
+    ) { \
+        SIMD_LOOP \
+        for (long long int i=0; i<numPairs; i++) { \
+            qreal ru=reUp[AMP_INDEX(i)], iu=imUp[AMP_INDEX(i)]; \
+            reUp[AMP_INDEX(i)] = reLo[AMP_INDEX(i)]; imUp[AMP_INDEX(i)] = imLo[AMP_INDEX(i)]; \
+            reLo[AMP_INDEX(i)] = ru;      imLo[AMP_INDEX(i)] = iu; \
+        } \
+    } \
+    \
+    ATTRIB static void applyMatrix4ToAmpQuads_##ISA( \
+        qreal* RESTRICT re0, qreal* RESTRICT im0, qreal* RESTRICT re1, qreal* RESTRICT im1, \
+        qreal* RESTRICT re2, qreal* RESTRICT im2, qreal* RESTRICT re3, qreal* RESTRICT im3, \
+        long long int numQuads, ComplexMatrix4 u \
+    ) { \
+        SIMD_LOOP \
+        for (long long int i=0; i<numQuads; i++) { \
+            qreal r0=re0[AMP_INDEX(i)], r1=re1[AMP_INDEX(i)], r2=re2[AMP_INDEX(i)], r3=re3[AMP_INDEX(i)]; \
+            qreal m0=im0[AMP_INDEX(i)], m1=im1[AMP_INDEX(i)], m2=im2[AMP_INDEX(i)], m3=im3[AMP_INDEX(i)]; \
+            re0[AMP_INDEX(i)] = APPLY_ROW_REAL(u, 0); im0[AMP_INDEX(i)] = APPLY_ROW_IMAG(u, 0); \
+            re1[AMP_INDEX(i)] = APPLY_ROW_REAL(u, 1); im1[AMP_INDEX(i)] = APPLY_ROW_IMAG(u, 1); \
+            re2[AMP_INDEX(i)] = APPLY_ROW_REAL(u, 2); im2[AMP_INDEX(i)] = APPLY_ROW_IMAG(u, 2); \
+            re3[AMP_INDEX(i)] = APPLY_ROW_REAL(u, 3); im3[AMP_INDEX(i)] = APPLY_ROW_IMAG(u, 3); \
+        } \
+    }
+
+DEFINE_VECTORISED_KERNELS(default, )
+
+# ifdef MULTI_ISA_KERNELS
+DEFINE_VECTORISED_KERNELS(avx2, __attribute__((target("avx2,fma"))))
+DEFINE_VECTORISED_KERNELS(avx512, __attribute__((target("avx512f,avx2,fma"))))
+# endif
+
+static void (*applyMatrix2ToAmpPairs)(qreal*, qreal*, qreal*, qreal*, long long int, ComplexMatrix2) 
+    = applyMatrix2ToAmpPairs_default;
+static void (*swapAmpPairs)(qreal*, qreal*, qreal*, qreal*, long long int) 
+    = swapAmpPairs_default;
+static void (*applyMatrix4ToAmpQuads)(qreal*, qreal*, qreal*, qreal*, qreal*, qreal*, qreal*, qreal*, long long int, ComplexMatrix4) 
+    = applyMatrix4ToAmpQuads_default;
+static const char* vectorisedKernelsName = "default";
+
+void selectVectorisedKernels(void) {
+    
+# ifdef MULTI_ISA_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        applyMatrix2ToAmpPairs = applyMatrix2ToAmpPairs_avx512;
+        swapAmpPairs = swapAmpPairs_avx512;
+        applyMatrix4ToAmpQuads = applyMatrix4ToAmpQuads_avx512;
+        vectorisedKernelsName = "AVX-512";
+    }
+    else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        applyMatrix2ToAmpPairs = applyMatrix2ToAmpPairs_avx2;
+        swapAmpPairs = swapAmpPairs_avx2;
+        applyMatrix4ToAmpQuads = applyMatrix4ToAmpQuads_avx2;
+        vectorisedKernelsName = "AVX2";
+    }
+# endif
+}
+
+const char* getVectorisedKernelsName(void) {
+    return vectorisedKernelsName;
+}
+
+/** Returns the length of the contiguous runs of amplitudes (with equal bits at and above
+ * lowestQubit) passed to a vectorised kernel, or 0 if the runs are too short to benefit
+ */
+static long long int getVectorisedRunLength(int lowestQubit, long long int numTasks) {
+    
+    long long int runLen = 1LL << lowestQubit;
+    if (runLen < MIN_VECTORISED_RUN || numTasks < MIN_VECTORISED_RUN)
+        return 0;
+    if (runLen > MAX_VECTORISED_RUN)
+        runLen = MAX_VECTORISED_RUN;
+    if (runLen > numTasks)
+        runLen = numTasks;
+    return runLen;
+}
+
+/** Left-multiplies u onto every pair of local amplitudes differing only in targetQubit, 
+ * via the vectorised kernels. Requires getVectorisedRunLength(targetQubit, numTasks) > 0
+ */
+static void applyMatrix2Vectorised(Qureg qureg, int targetQubit, ComplexMatrix2 u) {
+    
+    long long int numTasks = qureg.numAmpsPerChunk >> 1;
+    long long int runLen = getVectorisedRunLength(targetQubit, numTasks);
+    long long int numRuns = numTasks / runLen;
+    long long int sizeHalfBlock = 1LL << targetQubit;
+    long long int thisRun, indexUp;
+
+    qreal *stateVecReal = qureg.stateVec.real;
+    qreal *stateVecImag = qureg.stateVec.imag;
+
+# ifdef _OPENMP
+# pragma omp parallel for schedule (static) \
+    default  (none) \
+    shared   (numRuns,runLen,sizeHalfBlock,targetQubit, stateVecReal,stateVecImag, u, applyMatrix2ToAmpPairs) \
+    private  (thisRun, indexUp)
+# endif
+    for (thisRun=0; thisRun<numRuns; thisRun++) {
+        indexUp = insertZeroBit(thisRun*runLen, targetQubit);
+        applyMatrix2ToAmpPairs(
+            &stateVecReal[AMP_INDEX(indexUp)], &stateVecImag[AMP_INDEX(indexUp)],
+            &stateVecReal[AMP_INDEX(indexUp + sizeHalfBlock)], &stateVecImag[AMP_INDEX(indexUp + sizeHalfBlock)],
+            runLen, u);
+    }
+}
+
+/** Swaps every pair of local amplitudes differing only in targetQubit, via the 
+ * vectorised kernels. Requires getVectorisedRunLength(targetQubit, numTasks) > 0
+ */
+static void swapAmpPairsVectorised(Qureg qureg, int targetQubit) {
+    
+    long long int numTasks = qureg.numAmpsPerChunk >> 1;
+    long long int runLen = getVectorisedRunLength(targetQubit, numTasks);
+    long long int numRuns = numTasks / runLen;
+    long long int sizeHalfBlock = 1LL << targetQubit;
+    long long int thisRun, indexUp;
+
+    qreal *stateVecReal = qureg.stateVec.real;
+    qreal *stateVecImag = qureg.stateVec.imag;
+
+# ifdef _OPENMP
+# pragma omp parallel for schedule (static) \
+    default  (none) \
+    shared   (numRuns,runLen,sizeHalfBlock,targetQubit, stateVecReal,stateVecImag, swapAmpPairs) \
+    private  (thisRun, indexUp)
+# endif
+    for (thisRun=0; thisRun<numRuns; thisRun++) {
+        indexUp = insertZeroBit(thisRun*runLen, targetQubit);
+        swapAmpPairs(
+            &stateVecReal[AMP_INDEX(indexUp)], &stateVecImag[AMP_INDEX(indexUp)],
+            &stateVecReal[AMP_INDEX(indexUp + sizeHalfBlock)], &stateVecImag[AMP_INDEX(indexUp + sizeHalfBlock)],
+            runLen);
+    }
+}
+
 void statevec_compactUnitaryLocal (Qureg qureg, int targetQubit, Complex alpha, Complex beta)
 {
     long long int sizeBlock, sizeHalfBlock;
@@ -1776,6 +2042,15 @@ void statevec_compactUnitaryLocal (Qureg qureg, int targetQubit, Complex alpha,
     long long int thisTask;         
     long long int numTasks=qureg.numAmpsPerChunk>>1;
 
+    // all but the lowest targets modify contiguous runs of amplitudes, which are vectorised
+    if (getVectorisedRunLength(targetQubit, numTasks)) {
+        ComplexMatrix2 u = {
+            .real = {{alpha.real, - beta.real}, {beta.real, alpha.real}},
+            .imag = {{alpha.imag,   beta.imag}, {beta.imag, - alpha.imag}}};
+        applyMatrix2Vectorised(qureg, targetQubit, u);
+        return;
+    }
+
     // set dimensions
     sizeHalfBlock = 1LL << targetQubit;  
     sizeBlock     = 2LL * sizeHalfBlock; 
@@ -1789,7 +2064,7 @@ void statevec_compactUnitaryLocal (Qureg qureg, int targetQubit, Complex alpha,
 # ifdef _OPENMP
 # pragma omp parallel \
     default  (none) \
-    shared   (sizeBlock,sizeHalfBlock, stateVecReal,stateVecImag, alphaReal,alphaImag, betaReal,betaImag, numTasks) \
+    shared   (sizeBlock,sizeHalfBlock,targetQubit, stateVecReal,stateVecImag, alphaReal,alphaImag, betaReal,betaImag, numTasks) \
     private  (thisTask,thisBlock ,indexUp,indexLo, stateRealUp,stateImagUp,stateRealLo,stateImagLo)
 # endif
     {
@@ -1798,54 +2073,114 @@ void statevec_compactUnitaryLocal (Qureg qureg, int targetQubit, Complex alpha,
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
 
-            thisBlock   = thisTask / sizeHalfBlock;
-            indexUp     = thisBlock*sizeBlock + thisTask%sizeHalfBlock;
+            thisBlock   = thisTask >> targetQubit; // thisTask / sizeHalfBlock
+            indexUp     = thisBlock*sizeBlock + (thisTask&(sizeHalfBlock-1));
             indexLo     = indexUp + sizeHalfBlock;
 
             // store current state vector values in temp variables
-            stateRealUp = stateVecReal[indexUp];
-            stateImagUp = stateVecImag[indexUp];
+            stateRealUp = stateVecReal[AMP_INDEX(indexUp)];
+            stateImagUp = stateVecImag[AMP_INDEX(indexUp)];
 
-            stateRealLo = stateVecReal[indexLo];
-            stateImagLo = stateVecImag[indexLo];
+            stateRealLo = stateVecReal[AMP_INDEX(indexLo)];
+            stateImagLo = stateVecImag[AMP_INDEX(indexLo)];
 
             // state[indexUp] = alpha * state[indexUp] - conj(beta)  * state[indexLo]
-            stateVecReal[indexUp] = alphaReal*stateRealUp - alphaImag*stateImagUp 
+            stateVecReal[AMP_INDEX(indexUp)] = alphaReal*stateRealUp - alphaImag*stateImagUp 
                 - betaReal*stateRealLo - betaImag*stateImagLo;
-            stateVecImag[indexUp] = alphaReal*stateImagUp + alphaImag*stateRealUp 
+            stateVecImag[AMP_INDEX(indexUp)] = alphaReal*stateImagUp + alphaImag*stateRealUp 
                 - betaReal*stateImagLo + betaImag*stateRealLo;
 
             // state[indexLo] = beta  * state[indexUp] + conj(alpha) * state[indexLo]
-            stateVecReal[indexLo] = betaReal*stateRealUp - betaImag*stateImagUp 
+            stateVecReal[AMP_INDEX(indexLo)] = betaReal*stateRealUp - betaImag*stateImagUp 
                 + alphaReal*stateRealLo + alphaImag*stateImagLo;
-            stateVecImag[indexLo] = betaReal*stateImagUp + betaImag*stateRealUp 
+            stateVecImag[AMP_INDEX(indexLo)] = betaReal*stateImagUp + betaImag*stateRealUp 
                 + alphaReal*stateImagLo - alphaImag*stateRealLo;
         } 
     }
 
 } 
 
+/** Finds the local amplitudes in which every control qubit in ctrlMask is 1 (or 0, where 
+ * also set in ctrlFlipMask), so that multi-controlled kernels enumerate only those rather
+ * than testing every amplitude. Populates fixedQubits with the ascending local control 
+ * and target qubits, and sets ctrlBits to the required values of the local controls, such
+ * that insertZeroBits(task, fixedQubits, numFixed) | ctrlBits is the index of every task's 
+ * amplitude (with targets 0) for task < numAmpsPerChunk >> numFixed. Returns numFixed, or
+ * -1 if the controls determined by this node's rank are not satisfied.
+ */
+static int getControlSubspace(
+    Qureg qureg, long long int ctrlMask, long long int ctrlFlipMask, long long int targMask,
+    int* fixedQubits, long long int* ctrlBits
+) {
+    long long int localMask = qureg.numAmpsPerChunk - 1;
+    long long int globalIndStart = qureg.chunkId*qureg.numAmpsPerChunk;
+    
+    // controls beyond the local amplitudes are fixed for the whole node
+    long long int rankCtrlMask = ctrlMask & ~localMask;
+    if (((globalIndStart ^ ctrlFlipMask) & rankCtrlMask) != rankCtrlMask)
+        return -1;
+    
+    long long int fixedMask = (ctrlMask | targMask) & localMask;
+    int numFixed = 0;
+    for (int q=0; fixedMask >> q; q++)
+        if (extractBit(q, fixedMask))
+            fixedQubits[numFixed++] = q;
+    
+    *ctrlBits = ctrlMask & ~ctrlFlipMask & localMask;
+    return numFixed;
+}
+
 void statevec_multiControlledTwoQubitUnitaryLocal(Qureg qureg, long long int ctrlMask, int q1, int q2, ComplexMatrix4 u) {
 
     // can't use qureg.stateVec as a private OMP var
     qreal *reVec = qureg.stateVec.real;
     qreal *imVec = qureg.stateVec.imag;
     
-    // the global (between all nodes) index of this node's start index
-    long long int globalIndStart = qureg.chunkId*qureg.numAmpsPerChunk; 
+    // only the amplitudes satisfying the controls are enumerated
+    int fixedQubits[64]; // [numFixed]
+    long long int ctrlBits;
+    long long int targMask = (1LL << q1) | (1LL << q2);
+    int numFixed = getControlSubspace(qureg, ctrlMask, 0, targMask, fixedQubits, &ctrlBits);
+    if (numFixed < 0)
+        return;
     
-    long long int numTasks = qureg.numAmpsPerChunk >> 2; // each iteration updates 4 amplitudes
+    long long int numTasks = qureg.numAmpsPerChunk >> numFixed; // each iteration updates 4 amplitudes
     long long int thisTask;
-    long long int thisGlobalInd00;
     long long int ind00, ind01, ind10, ind11;
     qreal re00, re01, re10, re11;
     qreal im00, im01, im10, im11;
     
+    // runs of amplitudes below the lowest target and control qubit are vectorised
+    long long int runLen = getVectorisedRunLength(fixedQubits[0], numTasks);
+    if (runLen) {
+        long long int numRuns = numTasks / runLen;
+        long long int thisRun;
+        
+# ifdef _OPENMP
+# pragma omp parallel for schedule (static) \
+    default  (none) \
+    shared   (reVec,imVec,numRuns,runLen,fixedQubits,numFixed,ctrlBits,u,q2,q1, applyMatrix4ToAmpQuads) \
+    private  (thisRun, ind00,ind01,ind10,ind11)
+# endif
+        for (thisRun=0; thisRun<numRuns; thisRun++) {
+            
+            ind00 = insertZeroBits(thisRun*runLen, fixedQubits, numFixed) | ctrlBits;
+            ind01 = flipBit(ind00, q1);
+            ind10 = flipBit(ind00, q2);
+            ind11 = flipBit(ind01, q2);
+            applyMatrix4ToAmpQuads(
+                &reVec[AMP_INDEX(ind00)], &imVec[AMP_INDEX(ind00)], &reVec[AMP_INDEX(ind01)], &imVec[AMP_INDEX(ind01)],
+                &reVec[AMP_INDEX(ind10)], &imVec[AMP_INDEX(ind10)], &reVec[AMP_INDEX(ind11)], &imVec[AMP_INDEX(ind11)],
+                runLen, u);
+        }
+        return;
+    }
+    
 # ifdef _OPENMP
 # pragma omp parallel \
     default  (none) \
-    shared   (reVec,imVec,globalIndStart,numTasks,ctrlMask,u,q2,q1) \
-    private  (thisTask, thisGlobalInd00, ind00,ind01,ind10,ind11, re00,re01,re10,re11, im00,im01,im10,im11)
+    shared   (reVec,imVec,numTasks,fixedQubits,numFixed,ctrlBits,u,q2,q1) \
+    private  (thisTask, ind00,ind01,ind10,ind11, re00,re01,re10,re11, im00,im01,im10,im11)
 # endif
     {
 # ifdef _OPENMP
@@ -1853,13 +2188,8 @@ void statevec_multiControlledTwoQubitUnitaryLocal(Qureg qureg, long long int ctr
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
             
-            // determine ind00 of |..0..0..>
-            ind00 = insertTwoZeroBits(thisTask, q1, q2);
-            
-            // skip amplitude if controls aren't in 1 state (overloaded for speed)
-            thisGlobalInd00 = ind00 + globalIndStart;
-            if (ctrlMask && ((ctrlMask & thisGlobalInd00) != ctrlMask))
-                continue;
+            // determine ind00 of |..0..0..>, with controls in the 1 state
+            ind00 = insertZeroBits(thisTask, fixedQubits, numFixed) | ctrlBits;
             
             // inds of |..0..1..>, |..1..0..> and |..1..1..>
             ind01 = flipBit(ind00, q1);
@@ -1867,51 +2197,51 @@ void statevec_multiControlledTwoQubitUnitaryLocal(Qureg qureg, long long int ctr
             ind11 = flipBit(ind01, q2);
 
             // extract statevec amplitudes 
-            re00 = reVec[ind00]; im00 = imVec[ind00];
-            re01 = reVec[ind01]; im01 = imVec[ind01];
-            re10 = reVec[ind10]; im10 = imVec[ind10];
-            re11 = reVec[ind11]; im11 = imVec[ind11];
+            re00 = reVec[AMP_INDEX(ind00)]; im00 = imVec[AMP_INDEX(ind00)];
+            re01 = reVec[AMP_INDEX(ind01)]; im01 = imVec[AMP_INDEX(ind01)];
+            re10 = reVec[AMP_INDEX(ind10)]; im10 = imVec[AMP_INDEX(ind10)];
+            re11 = reVec[AMP_INDEX(ind11)]; im11 = imVec[AMP_INDEX(ind11)];
 
             // apply u * {amp00, amp01, amp10, amp11}
-            reVec[ind00] = 
+            reVec[AMP_INDEX(ind00)] = 
                 u.real[0][0]*re00 - u.imag[0][0]*im00 +
                 u.real[0][1]*re01 - u.imag[0][1]*im01 +
                 u.real[0][2]*re10 - u.imag[0][2]*im10 +
                 u.real[0][3]*re11 - u.imag[0][3]*im11;
-            imVec[ind00] =
+            imVec[AMP_INDEX(ind00)] =
                 u.imag[0][0]*re00 + u.real[0][0]*im00 +
                 u.imag[0][1]*re01 + u.real[0][1]*im01 +
                 u.imag[0][2]*re10 + u.real[0][2]*im10 +
                 u.imag[0][3]*re11 + u.real[0][3]*im11;
                 
-            reVec[ind01] = 
+            reVec[AMP_INDEX(ind01)] = 
                 u.real[1][0]*re00 - u.imag[1][0]*im00 +
                 u.real[1][1]*re01 - u.imag[1][1]*im01 +
                 u.real[1][2]*re10 - u.imag[1][2]*im10 +
                 u.real[1][3]*re11 - u.imag[1][3]*im11;
-            imVec[ind01] =
+            imVec[AMP_INDEX(ind01)] =
                 u.imag[1][0]*re00 + u.real[1][0]*im00 +
                 u.imag[1][1]*re01 + u.real[1][1]*im01 +
                 u.imag[1][2]*re10 + u.real[1][2]*im10 +
                 u.imag[1][3]*re11 + u.real[1][3]*im11;
                 
-            reVec[ind10] = 
+            reVec[AMP_INDEX(ind10)] = 
                 u.real[2][0]*re00 - u.imag[2][0]*im00 +
                 u.real[2][1]*re01 - u.imag[2][1]*im01 +
                 u.real[2][2]*re10 - u.imag[2][2]*im10 +
                 u.real[2][3]*re11 - u.imag[2][3]*im11;
-            imVec[ind10] =
+            imVec[AMP_INDEX(ind10)] =
                 u.imag[2][0]*re00 + u.real[2][0]*im00 +
                 u.imag[2][1]*re01 + u.real[2][1]*im01 +
                 u.imag[2][2]*re10 + u.real[2][2]*im10 +
                 u.imag[2][3]*re11 + u.real[2][3]*im11;    
                 
-            reVec[ind11] = 
+            reVec[AMP_INDEX(ind11)] = 
                 u.real[3][0]*re00 - u.imag[3][0]*im00 +
                 u.real[3][1]*re01 - u.imag[3][1]*im01 +
                 u.real[3][2]*re10 - u.imag[3][2]*im10 +
                 u.real[3][3]*re11 - u.imag[3][3]*im11;
-            imVec[ind11] =
+            imVec[AMP_INDEX(ind11)] =
                 u.imag[3][0]*re00 + u.real[3][0]*im00 +
                 u.imag[3][1]*re01 + u.real[3][1]*im01 +
                 u.imag[3][2]*re10 + u.real[3][2]*im10 +
@@ -1920,31 +2250,33 @@ void statevec_multiControlledTwoQubitUnitaryLocal(Qureg qureg, long long int ctr
     }
 }
 
-int qsortComp(const void *a, const void *b) {
-    return *(int*)a - *(int*)b; 
-}
-
 void statevec_multiControlledMultiQubitUnitaryLocal(Qureg qureg, long long int ctrlMask, int* targs, int numTargs, ComplexMatrixN u)
 {
     // can't use qureg.stateVec as a private OMP var
     qreal *reVec = qureg.stateVec.real;
     qreal *imVec = qureg.stateVec.imag;
     
-    long long int numTasks = qureg.numAmpsPerChunk >> numTargs;  // kernel called on every 1 in 2^numTargs amplitudes
-    long long int numTargAmps = 1 << u.numQubits;  // num amps to be modified by each task
+    // only the amplitudes satisfying the controls are enumerated, with the control and
+    // target qubits (fixedMask) held at ctrlBits in every task's |..0..0..> index
+    int fixedQubits[64]; // [numFixed]
+    long long int ctrlBits;
+    long long int targMask = getQubitBitMask(targs, numTargs);
+    int numFixed = getControlSubspace(qureg, ctrlMask, 0, targMask, fixedQubits, &ctrlBits);
+    if (numFixed < 0)
+        return;
+    long long int fixedMask = (ctrlMask | targMask) & (qureg.numAmpsPerChunk - 1);
     
-    // the global (between all nodes) index of this node's start index
-    long long int globalIndStart = qureg.chunkId*qureg.numAmpsPerChunk; 
+    long long int numTasks = qureg.numAmpsPerChunk >> numFixed;  // kernel called on every 1 in 2^numFixed amplitudes
+    long long int numTargAmps = 1 << u.numQubits;  // num amps to be modified by each task
     
     long long int thisTask;
+    long long int prevTask; // the task last performed by this thread
     long long int thisInd00; // this thread's index of |..0..0..> (target qubits = 0) 
-    long long int thisGlobalInd00; // the global (between all nodes) index of this thread's |..0..0..> state
     long long int ind;   // each thread's iteration of amplitudes to modify
     int i, t, r, c;  // each thread's iteration of amps and targets 
     qreal reElem, imElem;  // each thread's iteration of u elements
     
     // each thread/task will record and modify numTargAmps amplitudes, privately
-    // (of course, tasks eliminated by the ctrlMask won't edit their allocation)
     //
     // If we're NOT on windows, we can fortunately use the stack directly
     #ifndef _WIN32
@@ -1952,26 +2284,28 @@ void statevec_multiControlledMultiQubitUnitaryLocal(Qureg qureg, long long int c
         qreal reAmps[numTargAmps];
         qreal imAmps[numTargAmps];
 
-        int sortedTargs[numTargs];
+        long long int ampOffsets[numTargAmps];
     // on Windows, with no VLA, we can use _malloca to allocate on stack (must free)
     #else
         long long int* ampInds;
         qreal* reAmps;
         qreal* imAmps;
-        int* sortedTargs = (int*) _malloca(numTargs * sizeof *sortedTargs);
+        long long int* ampOffsets = (long long int*) _malloca(numTargAmps * sizeof *ampOffsets);
     #endif
 
-    // we need a sorted targets list to find thisInd00 for each task.
-    // we can't modify targets, because the user-ordering of targets matters in u
-    for (int t=0; t < numTargs; t++) 
-        sortedTargs[t] = targs[t];
-    qsort(sortedTargs, numTargs, sizeof(int), qsortComp);
+    // the offset of each target amplitude from |..0..0..> is the same for every task
+    for (i=0; i < numTargAmps; i++) {
+        ampOffsets[i] = 0;
+        for (t=0; t < numTargs; t++)
+            if (extractBit(t, i))
+                ampOffsets[i] = flipBit(ampOffsets[i], targs[t]);
+    }
     
 # ifdef _OPENMP
 # pragma omp parallel \
     default  (none) \
-    shared   (reVec,imVec, numTasks,numTargAmps,globalIndStart, ctrlMask,targs,sortedTargs,u,numTargs) \
-    private  (thisTask,thisInd00,thisGlobalInd00,ind,i,t,r,c,reElem,imElem,  ampInds,reAmps,imAmps)
+    shared   (reVec,imVec, numTasks,numTargAmps, fixedMask,fixedQubits,numFixed,ctrlBits,ampOffsets,u) \
+    private  (thisTask,prevTask,thisInd00,ind,i,r,c,reElem,imElem,  ampInds,reAmps,imAmps)
 # endif
     {
         // when manually allocating array memory (on Windows), this must be done in each thread
@@ -1981,47 +2315,44 @@ void statevec_multiControlledMultiQubitUnitaryLocal(Qureg qureg, long long int c
             reAmps = (qreal*) _malloca(numTargAmps * sizeof *reAmps);
             imAmps = (qreal*) _malloca(numTargAmps * sizeof *imAmps);
         # endif
+        prevTask = -2;
+        thisInd00 = 0;
 # ifdef _OPENMP
 # pragma omp for schedule (static)
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
             
-            // find this task's start index (where all targs are 0)
-            thisInd00 = thisTask;
-            for (t=0; t < numTargs; t++)
-                thisInd00 = insertZeroBit(thisInd00, sortedTargs[t]);
-                
-            // this task only modifies amplitudes if control qubits are 1 for this state
-            thisGlobalInd00 = thisInd00 + globalIndStart;
-            if (ctrlMask && ((ctrlMask & thisGlobalInd00) != ctrlMask))
-                continue;
+            // find this task's start index (where all targs are 0 and ctrls are 1), which for 
+            // consecutive tasks is found by incrementing the previous index with fixed qubits held at 1
+            if (thisTask == prevTask + 1)
+                thisInd00 = (((thisInd00 | fixedMask) + 1) & ~fixedMask) | ctrlBits;
+            else
+                thisInd00 = insertZeroBits(thisTask, fixedQubits, numFixed) | ctrlBits;
+            prevTask = thisTask;
                 
             // determine the indices and record values of this tasks's target amps
             for (i=0; i < numTargAmps; i++) {
                 
                 // get statevec index of current target qubit assignment
-                ind = thisInd00;
-                for (t=0; t < numTargs; t++)
-                    if (extractBit(t, i))
-                        ind = flipBit(ind, targs[t]);
+                ind = thisInd00 | ampOffsets[i];
                 
                 // update this tasks's private arrays
                 ampInds[i] = ind;
-                reAmps [i] = reVec[ind];
-                imAmps [i] = imVec[ind];
+                reAmps [i] = reVec[AMP_INDEX(ind)];
+                imAmps [i] = imVec[AMP_INDEX(ind)];
             }
             
             // modify this tasks's target amplitudes
             for (r=0; r < numTargAmps; r++) {
                 ind = ampInds[r];
-                reVec[ind] = 0;
-                imVec[ind] = 0;
+                reVec[AMP_INDEX(ind)] = 0;
+                imVec[AMP_INDEX(ind)] = 0;
                 
                 for (c=0; c < numTargAmps; c++) {
                     reElem = u.real[r][c];
                     imElem = u.imag[r][c];
-                    reVec[ind] += reAmps[c]*reElem - imAmps[c]*imElem;
-                    imVec[ind] += reAmps[c]*imElem + imAmps[c]*reElem;
+                    reVec[AMP_INDEX(ind)] += reAmps[c]*reElem - imAmps[c]*imElem;
+                    imVec[AMP_INDEX(ind)] += reAmps[c]*imElem + imAmps[c]*reElem;
                 }
             }
         }
@@ -2034,10 +2365,69 @@ void statevec_multiControlledMultiQubitUnitaryLocal(Qureg qureg, long long int c
     }
 
     #ifdef _WIN32
-        _freea(sortedTargs);
+        _freea(ampOffsets);
     #endif
 }
 
+/** Applies every gate to one tile of 2^numTileQubits contiguous amplitudes before the
+ * next, so that each tile is loaded into cache once, rather than once per gate. Every
+ * gate must target only qubits below numTileQubits, and each tile is treated as a 
+ * (non-distributed) register of numTileQubits qubits, upon which the local kernels 
+ * are reused. Tiles are processed in parallel when there are enough to occupy every
+ * thread, otherwise the kernels parallelise within each tile.
+ */
+void statevec_applyGatesInTiles(Qureg qureg, int numTileQubits, ComplexMatrixN* gates, int** targs, int numGates) {
+    
+    long long int tileSize = 1LL << numTileQubits;
+    long long int numTiles = qureg.numAmpsPerChunk >> numTileQubits;
+    long long int thisTile;
+    int numThreads = 1;
+# ifdef _OPENMP
+    numThreads = omp_get_max_threads();
+# endif
+
+# ifdef _OPENMP
+# pragma omp parallel for schedule (static) if (numTiles >= numThreads) \
+    default  (none) \
+    shared   (qureg, tileSize,numTiles,numTileQubits, gates,targs,numGates) \
+    private  (thisTile)
+# endif
+    for (thisTile=0; thisTile<numTiles; thisTile++) {
+        
+        Qureg tile = qureg;
+        tile.stateVec.real = &qureg.stateVec.real[AMP_INDEX(thisTile*tileSize)];
+        tile.stateVec.imag = &qureg.stateVec.imag[AMP_INDEX(thisTile*tileSize)];
+        tile.numQubitsInStateVec = numTileQubits;
+        tile.numAmpsPerChunk = tileSize;
+        tile.numAmpsTotal = tileSize;
+        tile.chunkId = 0;
+        tile.numChunks = 1;
+        
+        for (int g=0; g<numGates; g++) {
+            ComplexMatrixN u = gates[g];
+            
+            if (u.numQubits == 1) {
+                ComplexMatrix2 u2 = {
+                    .real = {{u.real[0][0], u.real[0][1]}, {u.real[1][0], u.real[1][1]}},
+                    .imag = {{u.imag[0][0], u.imag[0][1]}, {u.imag[1][0], u.imag[1][1]}}};
+                statevec_unitaryLocal(tile, targs[g][0], u2);
+            }
+            else if (u.numQubits == 2) {
+                ComplexMatrix4 u4;
+                for (int r=0; r<4; r++) {
+                    for (int c=0; c<4; c++) {
+                        u4.real[r][c] = u.real[r][c];
+                        u4.imag[r][c] = u.imag[r][c];
+                    }
+                }
+                statevec_multiControlledTwoQubitUnitaryLocal(tile, 0, targs[g][0], targs[g][1], u4);
+            }
+            else
+                statevec_multiControlledMultiQubitUnitaryLocal(tile, 0, targs[g], u.numQubits, u);
+        }
+    }
+}
+
 void statevec_unitaryLocal(Qureg qureg, int targetQubit, ComplexMatrix2 u)
 {
     long long int sizeBlock, sizeHalfBlock;
@@ -2048,6 +2438,12 @@ void statevec_unitaryLocal(Qureg qureg, int targetQubit, ComplexMatrix2 u)
     long long int thisTask;         
     long long int numTasks=qureg.numAmpsPerChunk>>1;
 
+    // all but the lowest targets modify contiguous runs of amplitudes, which are vectorised
+    if (getVectorisedRunLength(targetQubit, numTasks)) {
+        applyMatrix2Vectorised(qureg, targetQubit, u);
+        return;
+    }
+
     // set dimensions
     sizeHalfBlock = 1LL << targetQubit;  
     sizeBlock     = 2LL * sizeHalfBlock; 
@@ -2059,7 +2455,7 @@ void statevec_unitaryLocal(Qureg qureg, int targetQubit, ComplexMatrix2 u)
 # ifdef _OPENMP
 # pragma omp parallel \
     default  (none) \
-    shared   (sizeBlock,sizeHalfBlock, stateVecReal,stateVecImag, u,numTasks) \
+    shared   (sizeBlock,sizeHalfBlock,targetQubit, stateVecReal,stateVecImag, u,numTasks) \
     private  (thisTask,thisBlock ,indexUp,indexLo, stateRealUp,stateImagUp,stateRealLo,stateImagLo)
 # endif
     {
@@ -2068,28 +2464,28 @@ void statevec_unitaryLocal(Qureg qureg, int targetQubit, ComplexMatrix2 u)
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
 
-            thisBlock   = thisTask / sizeHalfBlock;
-            indexUp     = thisBlock*sizeBlock + thisTask%sizeHalfBlock;
+            thisBlock   = thisTask >> targetQubit; // thisTask / sizeHalfBlock
+            indexUp     = thisBlock*sizeBlock + (thisTask&(sizeHalfBlock-1));
             indexLo     = indexUp + sizeHalfBlock;
 
             // store current state vector values in temp variables
-            stateRealUp = stateVecReal[indexUp];
-            stateImagUp = stateVecImag[indexUp];
+            stateRealUp = stateVecReal[AMP_INDEX(indexUp)];
+            stateImagUp = stateVecImag[AMP_INDEX(indexUp)];
 
-            stateRealLo = stateVecReal[indexLo];
-            stateImagLo = stateVecImag[indexLo];
+            stateRealLo = stateVecReal[AMP_INDEX(indexLo)];
+            stateImagLo = stateVecImag[AMP_INDEX(indexLo)];
 
 
             // state[indexUp] = u00 * state[indexUp] + u01 * state[indexLo]
-            stateVecReal[indexUp] = u.real[0][0]*stateRealUp - u.imag[0][0]*stateImagUp 
+            stateVecReal[AMP_INDEX(indexUp)] = u.real[0][0]*stateRealUp - u.imag[0][0]*stateImagUp 
                 + u.real[0][1]*stateRealLo - u.imag[0][1]*stateImagLo;
-            stateVecImag[indexUp] = u.real[0][0]*stateImagUp + u.imag[0][0]*stateRealUp 
+            stateVecImag[AMP_INDEX(indexUp)] = u.real[0][0]*stateImagUp + u.imag[0][0]*stateRealUp 
                 + u.real[0][1]*stateImagLo + u.imag[0][1]*stateRealLo;
 
             // state[indexLo] = u10  * state[indexUp] + u11 * state[indexLo]
-            stateVecReal[indexLo] = u.real[1][0]*stateRealUp  - u.imag[1][0]*stateImagUp 
+            stateVecReal[AMP_INDEX(indexLo)] = u.real[1][0]*stateRealUp  - u.imag[1][0]*stateImagUp 
                 + u.real[1][1]*stateRealLo  -  u.imag[1][1]*stateImagLo;
-            stateVecImag[indexLo] = u.real[1][0]*stateImagUp + u.imag[1][0]*stateRealUp 
+            stateVecImag[AMP_INDEX(indexLo)] = u.real[1][0]*stateImagUp + u.imag[1][0]*stateRealUp 
                 + u.real[1][1]*stateImagLo + u.imag[1][1]*stateRealLo;
 
         } 
@@ -2137,15 +2533,15 @@ void statevec_compactUnitaryDistributed (Qureg qureg,
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
             // store current state vector values in temp variables
-            stateRealUp = stateVecRealUp[thisTask];
-            stateImagUp = stateVecImagUp[thisTask];
+            stateRealUp = stateVecRealUp[AMP_INDEX(thisTask)];
+            stateImagUp = stateVecImagUp[AMP_INDEX(thisTask)];
 
-            stateRealLo = stateVecRealLo[thisTask];
-            stateImagLo = stateVecImagLo[thisTask];
+            stateRealLo = stateVecRealLo[AMP_INDEX(thisTask)];
+            stateImagLo = stateVecImagLo[AMP_INDEX(thisTask)];
 
             // state[indexUp] = alpha * state[indexUp] - conj(beta)  * state[indexLo]
-            stateVecRealOut[thisTask] = rot1Real*stateRealUp - rot1Imag*stateImagUp + rot2Real*stateRealLo + rot2Imag*stateImagLo;
-            stateVecImagOut[thisTask] = rot1Real*stateImagUp + rot1Imag*stateRealUp + rot2Real*stateImagLo - rot2Imag*stateRealLo;
+            stateVecRealOut[AMP_INDEX(thisTask)] = rot1Real*stateRealUp - rot1Imag*stateImagUp + rot2Real*stateRealLo + rot2Imag*stateImagLo;
+            stateVecImagOut[AMP_INDEX(thisTask)] = rot1Real*stateImagUp + rot1Imag*stateRealUp + rot2Real*stateImagLo - rot2Imag*stateRealLo;
         }
     }
 }
@@ -2194,15 +2590,15 @@ void statevec_unitaryDistributed (Qureg qureg,
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
             // store current state vector values in temp variables
-            stateRealUp = stateVecRealUp[thisTask];
-            stateImagUp = stateVecImagUp[thisTask];
+            stateRealUp = stateVecRealUp[AMP_INDEX(thisTask)];
+            stateImagUp = stateVecImagUp[AMP_INDEX(thisTask)];
 
-            stateRealLo = stateVecRealLo[thisTask];
-            stateImagLo = stateVecImagLo[thisTask];
+            stateRealLo = stateVecRealLo[AMP_INDEX(thisTask)];
+            stateImagLo = stateVecImagLo[AMP_INDEX(thisTask)];
 
-            stateVecRealOut[thisTask] = rot1Real*stateRealUp - rot1Imag*stateImagUp 
+            stateVecRealOut[AMP_INDEX(thisTask)] = rot1Real*stateRealUp - rot1Imag*stateImagUp 
                 + rot2Real*stateRealLo - rot2Imag*stateImagLo;
-            stateVecImagOut[thisTask] = rot1Real*stateImagUp + rot1Imag*stateRealUp 
+            stateVecImagOut[AMP_INDEX(thisTask)] = rot1Real*stateImagUp + rot1Imag*stateRealUp 
                 + rot2Real*stateImagLo + rot2Imag*stateRealLo;
         }
     }
@@ -2236,7 +2632,7 @@ void statevec_controlledCompactUnitaryLocal (Qureg qureg, int controlQubit, int
 # ifdef _OPENMP
 # pragma omp parallel \
     default  (none) \
-    shared   (sizeBlock,sizeHalfBlock, stateVecReal,stateVecImag, alphaReal,alphaImag, betaReal,betaImag, \
+    shared   (sizeBlock,sizeHalfBlock,targetQubit, stateVecReal,stateVecImag, alphaReal,alphaImag, betaReal,betaImag, \
                 numTasks,chunkId,chunkSize,controlQubit) \
     private  (thisTask,thisBlock ,indexUp,indexLo, stateRealUp,stateImagUp,stateRealLo,stateImagLo,controlBit)
 # endif
@@ -2246,29 +2642,29 @@ void statevec_controlledCompactUnitaryLocal (Qureg qureg, int controlQubit, int
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
 
-            thisBlock   = thisTask / sizeHalfBlock;
-            indexUp     = thisBlock*sizeBlock + thisTask%sizeHalfBlock;
+            thisBlock   = thisTask >> targetQubit; // thisTask / sizeHalfBlock
+            indexUp     = thisBlock*sizeBlock + (thisTask&(sizeHalfBlock-1));
             indexLo     = indexUp + sizeHalfBlock;
 
             controlBit = extractBit (controlQubit, indexUp+chunkId*chunkSize);
             if (controlBit){
                 // store current state vector values in temp variables
-                stateRealUp = stateVecReal[indexUp];
-                stateImagUp = stateVecImag[indexUp];
+                stateRealUp = stateVecReal[AMP_INDEX(indexUp)];
+                stateImagUp = stateVecImag[AMP_INDEX(indexUp)];
 
-                stateRealLo = stateVecReal[indexLo];
-                stateImagLo = stateVecImag[indexLo];
+                stateRealLo = stateVecReal[AMP_INDEX(indexLo)];
+                stateImagLo = stateVecImag[AMP_INDEX(indexLo)];
 
                 // state[indexUp] = alpha * state[indexUp] - conj(beta)  * state[indexLo]
-                stateVecReal[indexUp] = alphaReal*stateRealUp - alphaImag*stateImagUp 
+                stateVecReal[AMP_INDEX(indexUp)] = alphaReal*stateRealUp - alphaImag*stateImagUp 
                     - betaReal*stateRealLo - betaImag*stateImagLo;
-                stateVecImag[indexUp] = alphaReal*stateImagUp + alphaImag*stateRealUp 
+                stateVecImag[AMP_INDEX(indexUp)] = alphaReal*stateImagUp + alphaImag*stateRealUp 
                     - betaReal*stateImagLo + betaImag*stateRealLo;
 
                 // state[indexLo] = beta  * state[indexUp] + conj(alpha) * state[indexLo]
-                stateVecReal[indexLo] = betaReal*stateRealUp - betaImag*stateImagUp 
+                stateVecReal[AMP_INDEX(indexLo)] = betaReal*stateRealUp - betaImag*stateImagUp 
                     + alphaReal*stateRealLo + alphaImag*stateImagLo;
-                stateVecImag[indexLo] = betaReal*stateImagUp + betaImag*stateRealUp 
+                stateVecImag[AMP_INDEX(indexLo)] = betaReal*stateImagUp + betaImag*stateRealUp 
                     + alphaReal*stateImagLo - alphaImag*stateRealLo;
             }
         } 
@@ -2285,19 +2681,23 @@ void statevec_multiControlledUnitaryLocal(
     long long int ctrlQubitsMask, long long int ctrlFlipMask,
     ComplexMatrix2 u)
 {
-    long long int sizeBlock, sizeHalfBlock;
-    long long int thisBlock, // current block
-         indexUp,indexLo;    // current index and corresponding index in lower half block
+    long long int sizeHalfBlock;
+    long long int indexUp,indexLo;    // current index and corresponding index in lower half block
 
     qreal stateRealUp,stateRealLo,stateImagUp,stateImagLo;
     long long int thisTask;         
-    long long int numTasks=qureg.numAmpsPerChunk>>1;
-    long long int chunkSize=qureg.numAmpsPerChunk;
-    long long int chunkId=qureg.chunkId;
+
+    // only the amplitudes whose control qubits have the desired values are enumerated
+    int fixedQubits[64]; // [numFixed]
+    long long int ctrlBits;
+    int numFixed = getControlSubspace(
+        qureg, ctrlQubitsMask, ctrlFlipMask, 1LL << targetQubit, fixedQubits, &ctrlBits);
+    if (numFixed < 0)
+        return;
+    long long int numTasks=qureg.numAmpsPerChunk>>numFixed;
 
     // set dimensions
     sizeHalfBlock = 1LL << targetQubit;  
-    sizeBlock     = 2LL * sizeHalfBlock; 
 
     // Can't use qureg.stateVec as a private OMP var
     qreal *stateVecReal = qureg.stateVec.real;
@@ -2306,9 +2706,8 @@ void statevec_multiControlledUnitaryLocal(
 # ifdef _OPENMP
 # pragma omp parallel \
     default  (none) \
-    shared   (sizeBlock,sizeHalfBlock, stateVecReal,stateVecImag, u, ctrlQubitsMask,ctrlFlipMask, \
-                numTasks,chunkId,chunkSize) \
-    private  (thisTask,thisBlock, indexUp,indexLo, stateRealUp,stateImagUp,stateRealLo,stateImagLo)
+    shared   (sizeHalfBlock, stateVecReal,stateVecImag, u, fixedQubits,numFixed,ctrlBits, numTasks) \
+    private  (thisTask, indexUp,indexLo, stateRealUp,stateImagUp,stateRealLo,stateImagLo)
 # endif
     {
 # ifdef _OPENMP
@@ -2316,141 +2715,692 @@ void statevec_multiControlledUnitaryLocal(
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
 
-            thisBlock   = thisTask / sizeHalfBlock;
-            indexUp     = thisBlock*sizeBlock + thisTask%sizeHalfBlock;
+            indexUp     = insertZeroBits(thisTask, fixedQubits, numFixed) | ctrlBits;
             indexLo     = indexUp + sizeHalfBlock;
             
-            
-            // take the basis index, flip the designated (XOR) 'control' bits, AND with the controls.
-            // if this equals the control mask, the control qubits have the desired values in the basis index
-            if (ctrlQubitsMask == (ctrlQubitsMask & ((indexUp+chunkId*chunkSize) ^ ctrlFlipMask))) {
-                // store current state vector values in temp variables
-                stateRealUp = stateVecReal[indexUp];
-                stateImagUp = stateVecImag[indexUp];
+            // store current state vector values in temp variables
+            stateRealUp = stateVecReal[AMP_INDEX(indexUp)];
+            stateImagUp = stateVecImag[AMP_INDEX(indexUp)];
 
-                stateRealLo = stateVecReal[indexLo];
-                stateImagLo = stateVecImag[indexLo];
+            stateRealLo = stateVecReal[AMP_INDEX(indexLo)];
+            stateImagLo = stateVecImag[AMP_INDEX(indexLo)];
 
-                // state[indexUp] = u00 * state[indexUp] + u01 * state[indexLo]
-                stateVecReal[indexUp] = u.real[0][0]*stateRealUp - u.imag[0][0]*stateImagUp 
-                    + u.real[0][1]*stateRealLo - u.imag[0][1]*stateImagLo;
-                stateVecImag[indexUp] = u.real[0][0]*stateImagUp + u.imag[0][0]*stateRealUp 
-                    + u.real[0][1]*stateImagLo + u.imag[0][1]*stateRealLo;
+            // state[indexUp] = u00 * state[indexUp] + u01 * state[indexLo]
+            stateVecReal[AMP_INDEX(indexUp)] = u.real[0][0]*stateRealUp - u.imag[0][0]*stateImagUp 
+                + u.real[0][1]*stateRealLo - u.imag[0][1]*stateImagLo;
+            stateVecImag[AMP_INDEX(indexUp)] = u.real[0][0]*stateImagUp + u.imag[0][0]*stateRealUp 
+                + u.real[0][1]*stateImagLo + u.imag[0][1]*stateRealLo;
 
-                // state[indexLo] = u10  * state[indexUp] + u11 * state[indexLo]
-                stateVecReal[indexLo] = u.real[1][0]*stateRealUp  - u.imag[1][0]*stateImagUp 
-                    + u.real[1][1]*stateRealLo  -  u.imag[1][1]*stateImagLo;
-                stateVecImag[indexLo] = u.real[1][0]*stateImagUp + u.imag[1][0]*stateRealUp 
-                    + u.real[1][1]*stateImagLo + u.imag[1][1]*stateRealLo;
-            }
+            // state[indexLo] = u10  * state[indexUp] + u11 * state[indexLo]
+            stateVecReal[AMP_INDEX(indexLo)] = u.real[1][0]*stateRealUp  - u.imag[1][0]*stateImagUp 
+                + u.real[1][1]*stateRealLo  -  u.imag[1][1]*stateImagLo;
+            stateVecImag[AMP_INDEX(indexLo)] = u.real[1][0]*stateImagUp + u.imag[1][0]*stateRealUp 
+                + u.real[1][1]*stateImagLo + u.imag[1][1]*stateRealLo;
         } 
     }
 
 }
 
-void statevec_controlledUnitaryLocal(Qureg qureg, int controlQubit, int targetQubit, 
-        ComplexMatrix2 u)
-{
-    long long int sizeBlock, sizeHalfBlock;
-    long long int thisBlock, // current block
-         indexUp,indexLo;    // current index and corresponding index in lower half block
-
-    qreal stateRealUp,stateRealLo,stateImagUp,stateImagLo;
-    long long int thisTask;         
-    long long int numTasks=qureg.numAmpsPerChunk>>1;
-    long long int chunkSize=qureg.numAmpsPerChunk;
-    long long int chunkId=qureg.chunkId;
-
-    int controlBit;
-
-    // set dimensions
-    sizeHalfBlock = 1LL << targetQubit;  
-    sizeBlock     = 2LL * sizeHalfBlock; 
+/** Overwrites the amplitude pair (re0,im0), (re1,im1) with u (or conj(u), if conjFac=-1) 
+ * multiplied upon it */
+static inline void applyMatrix2ToPair(
+    ComplexMatrix2* u, qreal conjFac, qreal* re0, qreal* im0, qreal* re1, qreal* im1
+) {
+    qreal r0=*re0, i0=*im0, r1=*re1, i1=*im1;
+    *re0 = u->real[0][0]*r0 - conjFac*u->imag[0][0]*i0 + u->real[0][1]*r1 - conjFac*u->imag[0][1]*i1;
+    *im0 = u->real[0][0]*i0 + conjFac*u->imag[0][0]*r0 + u->real[0][1]*i1 + conjFac*u->imag[0][1]*r1;
+    *re1 = u->real[1][0]*r0 - conjFac*u->imag[1][0]*i0 + u->real[1][1]*r1 - conjFac*u->imag[1][1]*i1;
+    *im1 = u->real[1][0]*i0 + conjFac*u->imag[1][0]*r0 + u->real[1][1]*i1 + conjFac*u->imag[1][1]*r1;
+}
 
-    // Can't use qureg.stateVec as a private OMP var
+/** Effects rho -> U rho U^dagger for the single-qubit u, controlled on ctrlMask (with qubits 
+ * in ctrlFlipMask conditioned on 0), in a single pass. Each task updates the four elements 
+ * (r, c) which differ only in the target bit of the row r and column c; u is left-multiplied 
+ * upon them when the controls of r are satisfied, and conj(u) right-multiplied when those of c 
+ * are. The column target qubit (targetQubit + numQubitsRepresented) must be within the chunk.
+ */
+void densmatr_multiControlledUnitaryLocal(
+    Qureg qureg, long long int ctrlMask, long long int ctrlFlipMask, int targetQubit, ComplexMatrix2 u
+) {
+    int numQubits = qureg.numQubitsRepresented;
+    int rowBit = targetQubit;
+    int colBit = targetQubit + numQubits;
+    long long int offset = qureg.chunkId * qureg.numAmpsPerChunk;
+    long long int numTasks = qureg.numAmpsPerChunk >> 2;
+    long long int rowCtrlMask = ctrlMask;
+    long long int rowFlipMask = ctrlFlipMask;
+    long long int colCtrlMask = ctrlMask << numQubits;
+    long long int colFlipMask = ctrlFlipMask << numQubits;
     qreal *stateVecReal = qureg.stateVec.real;
     qreal *stateVecImag = qureg.stateVec.imag;
+    
+    long long int thisTask, ind00, ind01, ind10, ind11, globalInd;
+    int rowCtrl, colCtrl;
+    qreal re00, im00, re01, im01, re10, im10, re11, im11;
 
 # ifdef _OPENMP
 # pragma omp parallel \
     default  (none) \
-    shared   (sizeBlock,sizeHalfBlock, stateVecReal,stateVecImag, u,numTasks,chunkId,chunkSize,controlQubit) \
-    private  (thisTask,thisBlock ,indexUp,indexLo, stateRealUp,stateImagUp,stateRealLo,stateImagLo,controlBit)
+    shared   (rowBit,colBit,offset,numTasks, rowCtrlMask,rowFlipMask,colCtrlMask,colFlipMask, \
+              stateVecReal,stateVecImag, u) \
+    private  (thisTask, ind00,ind01,ind10,ind11,globalInd, rowCtrl,colCtrl, \
+              re00,im00,re01,im01,re10,im10,re11,im11)
 # endif
     {
 # ifdef _OPENMP
 # pragma omp for schedule (static)
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
-
-            thisBlock   = thisTask / sizeHalfBlock;
-            indexUp     = thisBlock*sizeBlock + thisTask%sizeHalfBlock;
-            indexLo     = indexUp + sizeHalfBlock;
-
-            controlBit = extractBit (controlQubit, indexUp+chunkId*chunkSize);
-            if (controlBit){
-                // store current state vector values in temp variables
-                stateRealUp = stateVecReal[indexUp];
-                stateImagUp = stateVecImag[indexUp];
-
-                stateRealLo = stateVecReal[indexLo];
-                stateImagLo = stateVecImag[indexLo];
-
-
-                // state[indexUp] = u00 * state[indexUp] + u01 * state[indexLo]
-                stateVecReal[indexUp] = u.real[0][0]*stateRealUp - u.imag[0][0]*stateImagUp 
-                    + u.real[0][1]*stateRealLo - u.imag[0][1]*stateImagLo;
-                stateVecImag[indexUp] = u.real[0][0]*stateImagUp + u.imag[0][0]*stateRealUp 
-                    + u.real[0][1]*stateImagLo + u.imag[0][1]*stateRealLo;
-
-                // state[indexLo] = u10  * state[indexUp] + u11 * state[indexLo]
-                stateVecReal[indexLo] = u.real[1][0]*stateRealUp  - u.imag[1][0]*stateImagUp 
-                    + u.real[1][1]*stateRealLo  -  u.imag[1][1]*stateImagLo;
-                stateVecImag[indexLo] = u.real[1][0]*stateImagUp + u.imag[1][0]*stateRealUp 
-                    + u.real[1][1]*stateImagLo + u.imag[1][1]*stateRealLo;
+            
+            // indRC has row target bit R and column target bit C
+            ind00 = insertTwoZeroBits(thisTask, rowBit, colBit);
+            globalInd = ind00 + offset;
+            rowCtrl = (((globalInd ^ rowFlipMask) & rowCtrlMask) == rowCtrlMask);
+            colCtrl = (((globalInd ^ colFlipMask) & colCtrlMask) == colCtrlMask);
+            if (!rowCtrl && !colCtrl)
+                continue;
+            
+            ind10 = flipBit(ind00, rowBit);
+            ind01 = flipBit(ind00, colBit);
+            ind11 = flipBit(ind01, rowBit);
+            re00 = stateVecReal[AMP_INDEX(ind00)]; im00 = stateVecImag[AMP_INDEX(ind00)];
+            re01 = stateVecReal[AMP_INDEX(ind01)]; im01 = stateVecImag[AMP_INDEX(ind01)];
+            re10 = stateVecReal[AMP_INDEX(ind10)]; im10 = stateVecImag[AMP_INDEX(ind10)];
+            re11 = stateVecReal[AMP_INDEX(ind11)]; im11 = stateVecImag[AMP_INDEX(ind11)];
+            
+            // U rho, upon both columns
+            if (rowCtrl) {
+                applyMatrix2ToPair(&u, 1, &re00, &im00, &re10, &im10);
+                applyMatrix2ToPair(&u, 1, &re01, &im01, &re11, &im11);
             }
-        } 
+            // rho U^dagger, which is conj(U) upon both rows' column indices
+            if (colCtrl) {
+                applyMatrix2ToPair(&u, -1, &re00, &im00, &re01, &im01);
+                applyMatrix2ToPair(&u, -1, &re10, &im10, &re11, &im11);
+            }
+            
+            stateVecReal[AMP_INDEX(ind00)] = re00; stateVecImag[AMP_INDEX(ind00)] = im00;
+            stateVecReal[AMP_INDEX(ind01)] = re01; stateVecImag[AMP_INDEX(ind01)] = im01;
+            stateVecReal[AMP_INDEX(ind10)] = re10; stateVecImag[AMP_INDEX(ind10)] = im10;
+            stateVecReal[AMP_INDEX(ind11)] = re11; stateVecImag[AMP_INDEX(ind11)] = im11;
+        }
     }
+}
 
+/** Overwrites the four amplitudes re[inds[k]], im[inds[k]] with u (or conj(u), if conjFac=-1)
+ * multiplied upon them */
+static inline void applyMatrix4ToQuad(ComplexMatrix4* u, qreal conjFac, qreal* re, qreal* im, int* inds) {
+    
+    qreal r[4], i[4];
+    for (int k=0; k<4; k++) {
+        r[k] = re[inds[k]];
+        i[k] = im[inds[k]];
+    }
+    for (int k=0; k<4; k++) {
+        qreal sumRe = 0;
+        qreal sumIm = 0;
+        for (int l=0; l<4; l++) {
+            sumRe += u->real[k][l]*r[l] - conjFac*u->imag[k][l]*i[l];
+            sumIm += u->real[k][l]*i[l] + conjFac*u->imag[k][l]*r[l];
+        }
+        re[inds[k]] = sumRe;
+        im[inds[k]] = sumIm;
+    }
 }
 
-/** Rotate a single qubit in the state vector of probability amplitudes, given two complex 
- * numbers alpha and beta and a subset of the state vector with upper and lower block values 
- * stored seperately. Only perform the rotation where the control qubit is one.
- *                                               
- *  @param[in,out] qureg object representing the set of qubits
- *  @param[in] controlQubit qubit to determine whether or not to perform a rotation 
- *  @param[in] rot1 rotation angle
- *  @param[in] rot2 rotation angle
- *  @param[in] stateVecUp probability amplitudes in upper half of a block
- *  @param[in] stateVecLo probability amplitudes in lower half of a block
- *  @param[out] stateVecOut array section to update (will correspond to either the lower or upper half of a block)
+/** Effects rho -> U rho U^dagger for the two-qubit u, controlled on ctrlMask, in a single pass.
+ * Each task updates the 16 elements (r, c) which differ only in the target bits of r and c, 
+ * left-multiplying u when the controls of r are satisfied and right-multiplying u^dagger when 
+ * those of c are. The column target qubits must be within the chunk.
  */
-void statevec_controlledCompactUnitaryDistributed (Qureg qureg, int controlQubit,
-        Complex rot1, Complex rot2,
-        ComplexArray stateVecUp,
-        ComplexArray stateVecLo,
-        ComplexArray stateVecOut)
-{
-
-    qreal   stateRealUp,stateRealLo,stateImagUp,stateImagLo;
-    long long int thisTask;  
-    long long int numTasks=qureg.numAmpsPerChunk;
-    long long int chunkSize=qureg.numAmpsPerChunk;
-    long long int chunkId=qureg.chunkId;
-
-    int controlBit;
-
-    qreal rot1Real=rot1.real, rot1Imag=rot1.imag;
-    qreal rot2Real=rot2.real, rot2Imag=rot2.imag;
-    qreal *stateVecRealUp=stateVecUp.real, *stateVecImagUp=stateVecUp.imag;
-    qreal *stateVecRealLo=stateVecLo.real, *stateVecImagLo=stateVecLo.imag;
-    qreal *stateVecRealOut=stateVecOut.real, *stateVecImagOut=stateVecOut.imag;
+void densmatr_multiControlledTwoQubitUnitaryLocal(
+    Qureg qureg, long long int ctrlMask, int targetQubit1, int targetQubit2, ComplexMatrix4 u
+) {
+    int numQubits = qureg.numQubitsRepresented;
+    long long int offset = qureg.chunkId * qureg.numAmpsPerChunk;
+    long long int numTasks = qureg.numAmpsPerChunk >> 4;
+    long long int rowCtrlMask = ctrlMask;
+    long long int colCtrlMask = ctrlMask << numQubits;
+    qreal *stateVecReal = qureg.stateVec.real;
+    qreal *stateVecImag = qureg.stateVec.imag;
+    
+    // the basis state k of the targets (where bit 0 is targetQubit1) has row offset rowOffs[k]
+    long long int rowOffs[4], colOffs[4];
+    for (int k=0; k<4; k++) {
+        rowOffs[k] = ((k & 1LL) << targetQubit1) | (((k >> 1) & 1LL) << targetQubit2);
+        colOffs[k] = rowOffs[k] << numQubits;
+    }
+    
+    // zero bits are inserted in increasing order
+    int sortedBits[4] = {targetQubit1, targetQubit2, targetQubit1 + numQubits, targetQubit2 + numQubits};
+    if (sortedBits[0] > sortedBits[1]) {
+        sortedBits[0] = targetQubit2;
+        sortedBits[1] = targetQubit1;
+        sortedBits[2] = targetQubit2 + numQubits;
+        sortedBits[3] = targetQubit1 + numQubits;
+    }
+    
+    // the 16 elements, with row k and column l at [4*k + l]
+    int rowInds[4][4] = {{0,4,8,12}, {1,5,9,13}, {2,6,10,14}, {3,7,11,15}}; // [l][k]
+    int colInds[4][4] = {{0,1,2,3}, {4,5,6,7}, {8,9,10,11}, {12,13,14,15}}; // [k][l]
+    
+    long long int thisTask, ind0, globalInd;
+    long long int inds[16];
+    qreal re[16], im[16];
+    int k, l, rowCtrl, colCtrl;
 
 # ifdef _OPENMP
 # pragma omp parallel \
     default  (none) \
-    shared   (stateVecRealUp,stateVecImagUp,stateVecRealLo,stateVecImagLo,stateVecRealOut,stateVecImagOut, \
+    shared   (offset,numTasks, rowCtrlMask,colCtrlMask, stateVecReal,stateVecImag, u, \
+              rowOffs,colOffs,sortedBits, rowInds,colInds) \
+    private  (thisTask, ind0,globalInd, inds,re,im, k,l, rowCtrl,colCtrl)
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (thisTask=0; thisTask<numTasks; thisTask++) {
+            
+            ind0 = insertZeroBits(thisTask, sortedBits, 4);
+            globalInd = ind0 + offset;
+            rowCtrl = ((globalInd & rowCtrlMask) == rowCtrlMask);
+            colCtrl = ((globalInd & colCtrlMask) == colCtrlMask);
+            if (!rowCtrl && !colCtrl)
+                continue;
+            
+            for (k=0; k<4; k++) {
+                for (l=0; l<4; l++) {
+                    inds[4*k+l] = ind0 | rowOffs[k] | colOffs[l];
+                    re[4*k+l] = stateVecReal[AMP_INDEX(inds[4*k+l])];
+                    im[4*k+l] = stateVecImag[AMP_INDEX(inds[4*k+l])];
+                }
+            }
+            
+            // U rho upon every column, then rho U^dagger (conj(U) upon column indices) upon every row
+            if (rowCtrl)
+                for (l=0; l<4; l++)
+                    applyMatrix4ToQuad(&u, 1, re, im, rowInds[l]);
+            if (colCtrl)
+                for (k=0; k<4; k++)
+                    applyMatrix4ToQuad(&u, -1, re, im, colInds[k]);
+            
+            for (k=0; k<16; k++) {
+                stateVecReal[AMP_INDEX(inds[k])] = re[k];
+                stateVecImag[AMP_INDEX(inds[k])] = im[k];
+            }
+        }
+    }
+}
+
+/** Effects rho -> sum_i K_i rho K_i^dagger for the numTargets-qubit Kraus operators ops, without 
+ * constructing their 4^numTargets x 4^numTargets superoperator. Each task gathers the 2^k x 2^k 
+ * block of elements (r, c) which differ only in the target bits of r and c, accumulates 
+ * sum_i (K_i B) K_i^dagger into a private workspace in O(numOps 8^k) flops, then overwrites B.
+ * The column target qubits must be within the chunk.
+ */
+void densmatr_mixMultiQubitKrausMapLocal(Qureg qureg, int* targets, int numTargets, ComplexMatrixN* ops, int numOps)
+{
+    int numQubits = qureg.numQubitsRepresented;
+    long long int dim = 1LL << numTargets;
+    long long int numElems = dim * dim;
+    long long int numTasks = qureg.numAmpsPerChunk >> (2*numTargets);
+    qreal *stateVecReal = qureg.stateVec.real;
+    qreal *stateVecImag = qureg.stateVec.imag;
+    
+    // zero bits are inserted in increasing order, and every row target is below every column target
+    int sortedBits[64]; // [2*numTargets]
+    for (int t=0; t<numTargets; t++) {
+        int j = t;
+        for (; j>0 && sortedBits[j-1] > targets[t]; j--)
+            sortedBits[j] = sortedBits[j-1];
+        sortedBits[j] = targets[t];
+    }
+    for (int t=0; t<numTargets; t++)
+        sortedBits[t + numTargets] = sortedBits[t] + numQubits;
+    
+    // the basis state k of the targets (where bit 0 is targets[0]) has row offset rowOffs[k]
+    long long int* rowOffs = malloc(2 * dim * sizeof *rowOffs);
+    long long int* colOffs = &rowOffs[dim];
+    for (long long int k=0; k<dim; k++) {
+        rowOffs[k] = 0;
+        for (int t=0; t<numTargets; t++)
+            if (extractBit(t, k))
+                rowOffs[k] = flipBit(rowOffs[k], targets[t]);
+        colOffs[k] = rowOffs[k] << numQubits;
+    }
+    
+    // every thread privately stores the block B, the product K_i B, and the sum, each row-major
+    int maxNumThreads = 1;
+# ifdef _OPENMP
+    maxNumThreads = omp_get_max_threads();
+# endif
+    qreal* works = malloc(maxNumThreads * 6 * numElems * sizeof *works);
+    
+    long long int thisTask, ind0, k, l, m;
+    qreal *blockRe, *blockIm, *prodRe, *prodIm, *sumRe, *sumIm;
+    qreal *opRe, *opIm, *rowRe, *rowIm;
+    qreal elemRe, elemIm, accRe, accIm;
+    int threadId, i;
+    
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (numTasks,dim,numElems, stateVecReal,stateVecImag, ops,numOps,numTargets, \
+              sortedBits,rowOffs,colOffs, works) \
+    private  (thisTask,ind0, k,l,m, blockRe,blockIm,prodRe,prodIm,sumRe,sumIm, \
+              opRe,opIm,rowRe,rowIm, elemRe,elemIm,accRe,accIm, threadId,i)
+# endif
+    {
+        threadId = 0;
+# ifdef _OPENMP
+        threadId = omp_get_thread_num();
+# endif
+        blockRe = &works[threadId * 6 * numElems];
+        blockIm = &blockRe[numElems];
+        prodRe = &blockIm[numElems];
+        prodIm = &prodRe[numElems];
+        sumRe = &prodIm[numElems];
+        sumIm = &sumRe[numElems];
+        
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (thisTask=0; thisTask<numTasks; thisTask++) {
+            
+            ind0 = insertZeroBits(thisTask, sortedBits, 2*numTargets);
+            for (k=0; k<dim; k++) {
+                for (l=0; l<dim; l++) {
+                    blockRe[k*dim + l] = stateVecReal[AMP_INDEX(ind0 | rowOffs[k] | colOffs[l])];
+                    blockIm[k*dim + l] = stateVecImag[AMP_INDEX(ind0 | rowOffs[k] | colOffs[l])];
+                    sumRe[k*dim + l] = 0;
+                    sumIm[k*dim + l] = 0;
+                }
+            }
+            
+            for (i=0; i<numOps; i++) {
+                
+                // prod = K_i B, accumulating whole rows of B
+                for (k=0; k<numElems; k++) {
+                    prodRe[k] = 0;
+                    prodIm[k] = 0;
+                }
+                for (k=0; k<dim; k++) {
+                    opRe = ops[i].real[k];
+                    opIm = ops[i].imag[k];
+                    rowRe = &prodRe[k*dim];
+                    rowIm = &prodIm[k*dim];
+                    for (m=0; m<dim; m++) {
+                        elemRe = opRe[m];
+                        elemIm = opIm[m];
+                        for (l=0; l<dim; l++) {
+                            rowRe[l] += elemRe*blockRe[m*dim + l] - elemIm*blockIm[m*dim + l];
+                            rowIm[l] += elemRe*blockIm[m*dim + l] + elemIm*blockRe[m*dim + l];
+                        }
+                    }
+                }
+                
+                // sum += prod K_i^dagger, where (K_i^dagger)_ml = conj(K_i)_lm
+                for (k=0; k<dim; k++) {
+                    rowRe = &prodRe[k*dim];
+                    rowIm = &prodIm[k*dim];
+                    for (l=0; l<dim; l++) {
+                        opRe = ops[i].real[l];
+                        opIm = ops[i].imag[l];
+                        accRe = 0;
+                        accIm = 0;
+                        for (m=0; m<dim; m++) {
+                            accRe += rowRe[m]*opRe[m] + rowIm[m]*opIm[m];
+                            accIm += rowIm[m]*opRe[m] - rowRe[m]*opIm[m];
+                        }
+                        sumRe[k*dim + l] += accRe;
+                        sumIm[k*dim + l] += accIm;
+                    }
+                }
+            }
+            
+            for (k=0; k<dim; k++) {
+                for (l=0; l<dim; l++) {
+                    stateVecReal[AMP_INDEX(ind0 | rowOffs[k] | colOffs[l])] = sumRe[k*dim + l];
+                    stateVecImag[AMP_INDEX(ind0 | rowOffs[k] | colOffs[l])] = sumIm[k*dim + l];
+                }
+            }
+        }
+    }
+    
+    free(rowOffs);
+    free(works);
+}
+
+/** Populates four tables of the products of dephaseFacs over every assignment of 8 consecutive 
+ * qubits, from which the product over the qubits at which a row and column differ is assembled. 
+ * Returns whether any qubit is dephased.
+ */
+static int getDephasingFactorTables(int numQubits, qreal* dephaseFacs, qreal facTables[4][256])
+{
+    int isDephased = 0;
+    for (int q=0; q<numQubits; q++)
+        isDephased = isDephased || (dephaseFacs[q] != 1);
+    if (!isDephased)
+        return 0;
+    
+    // a density matrix index contains 2*numQubits <= 62 bits
+    for (int t=0; t<4; t++) {
+        for (int v=0; v<256; v++) {
+            facTables[t][v] = 1;
+            for (int b=0; b<8; b++)
+                if (extractBit(b, v) && 8*t + b < numQubits)
+                    facTables[t][v] *= dephaseFacs[8*t + b];
+        }
+    }
+    return 1;
+}
+
+/** Scales every element rho_rc by the product of dephaseFacs[q] over the qubits q at which r and c 
+ * differ, effecting the dephasing of every qubit in a single pass. This is used only when no 
+ * other channel is applied, since the batched channels otherwise perform the scaling.
+ */
+static void densmatr_mixDephasingLayerLocal(Qureg qureg, qreal* dephaseFacs)
+{
+    int numQubits = qureg.numQubitsRepresented;
+    qreal facTables[4][256];
+    if (!getDephasingFactorTables(numQubits, dephaseFacs, facTables))
+        return;
+    
+    long long int offset = qureg.chunkId * qureg.numAmpsPerChunk;
+    long long int numTasks = qureg.numAmpsPerChunk;
+    long long int rowMask = (1LL << numQubits) - 1;
+    qreal *stateVecReal = qureg.stateVec.real;
+    qreal *stateVecImag = qureg.stateVec.imag;
+    
+    long long int thisTask, ind, diff;
+    qreal fac;
+    
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (offset,numTasks,numQubits,rowMask, stateVecReal,stateVecImag, facTables) \
+    private  (thisTask,ind,diff,fac)
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (thisTask=0; thisTask<numTasks; thisTask++) {
+            
+            // the qubits at which the row and column differ
+            ind = thisTask + offset;
+            diff = (ind ^ (ind >> numQubits)) & rowMask;
+            fac = facTables[0][diff & 255] * facTables[1][(diff >> 8) & 255] * 
+                  facTables[2][(diff >> 16) & 255] * facTables[3][(diff >> 24) & 255];
+            
+            stateVecReal[AMP_INDEX(thisTask)] *= fac;
+            stateVecImag[AMP_INDEX(thisTask)] *= fac;
+        }
+    }
+}
+
+# define MAX_NOISE_BATCH_QUBITS 4   // each batch modifies blocks of 4^4 elements...
+# define MAX_NOISE_BATCH_RUN 8       // ...of 8 contiguous amplitudes, occupying 32 KiB at double precision
+
+/** Applies the single-qubit channels upon (at most MAX_NOISE_BATCH_QUBITS) ascending targets in 
+ * one pass, by gathering each 2^k x 2^k block of elements (r, c) which differ only in the target 
+ * bits of r and c, and applying to it every channel's population and coherence matrices (as 
+ * populated by getNoiseLayerMatrices()) while it resides in cache. Each task processes the blocks
+ * of a run of (at most MAX_NOISE_BATCH_RUN, and fewer when targets[0] < 3) contiguous amplitudes 
+ * below the targets together, so that the innermost loops are contiguous and vectorisable.
+ * Unless dephaseFacs is NULL, every gathered element is also scaled as by 
+ * densmatr_mixDephasingLayerLocal(), which commutes with the channels.
+ */
+static void densmatr_mixOneQubitChannelsBatchLocal(
+    Qureg qureg, qreal* dephaseFacs, int* targets, int numTargets, qreal* popMatrs, qreal* cohMatrs
+) {
+    int numQubits = qureg.numQubitsRepresented;
+    qreal facTables[4][256];
+    int isDephased = (dephaseFacs != NULL) && getDephasingFactorTables(numQubits, dephaseFacs, facTables);
+    long long int offset = qureg.chunkId * qureg.numAmpsPerChunk;
+    long long int rowMask = (1LL << numQubits) - 1;
+    long long int dim = 1LL << numTargets;
+    long long int runLen = 1;
+    while (2*runLen <= MAX_NOISE_BATCH_RUN && (2*runLen <= (1LL << targets[0])))
+        runLen *= 2;
+    long long int numTasks = qureg.numAmpsPerChunk / (dim * dim * runLen);
+    qreal *stateVecReal = qureg.stateVec.real;
+    qreal *stateVecImag = qureg.stateVec.imag;
+    
+    // every row target is below every column target
+    int sortedBits[2*MAX_NOISE_BATCH_QUBITS];
+    for (int t=0; t<numTargets; t++) {
+        sortedBits[t] = targets[t];
+        sortedBits[t + numTargets] = targets[t] + numQubits;
+    }
+    
+    // the basis state k of the targets (where bit 0 is targets[0]) has row offset rowOffs[k]
+    long long int rowOffs[1 << MAX_NOISE_BATCH_QUBITS], colOffs[1 << MAX_NOISE_BATCH_QUBITS];
+    for (long long int k=0; k<dim; k++) {
+        rowOffs[k] = 0;
+        for (int t=0; t<numTargets; t++)
+            if (extractBit(t, k))
+                rowOffs[k] = flipBit(rowOffs[k], targets[t]);
+        colOffs[k] = rowOffs[k] << numQubits;
+    }
+    
+    // the run of each block element, with row k and column l at [(k*dim + l)*runLen]
+    qreal re[(1 << (2*MAX_NOISE_BATCH_QUBITS)) * MAX_NOISE_BATCH_RUN];
+    qreal im[(1 << (2*MAX_NOISE_BATCH_QUBITS)) * MAX_NOISE_BATCH_RUN];
+    long long int thisTask, ind0, ind, k, l, k0, l0, v, bit, i00, i01, i10, i11, glob, diff;
+    qreal *pop, *coh;
+    qreal re00, im00, re01, im01, fac;
+    int t;
+    
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (numTasks,dim,runLen,numTargets,numQubits,offset,rowMask,isDephased, \
+              stateVecReal,stateVecImag, popMatrs,cohMatrs,facTables, sortedBits,rowOffs,colOffs) \
+    private  (thisTask,ind0,ind, k,l,k0,l0,v,bit,i00,i01,i10,i11,glob,diff, \
+              pop,coh, re00,im00,re01,im01,fac, t, re,im)
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (thisTask=0; thisTask<numTasks; thisTask++) {
+            
+            // the run occupies the lowest bits, beneath every target
+            ind0 = insertZeroBits(thisTask * runLen, sortedBits, 2*numTargets);
+            for (l=0; l<dim; l++) {
+                for (k=0; k<dim; k++) {
+                    ind = ind0 | colOffs[l] | rowOffs[k];
+                    for (v=0; v<runLen; v++) {
+                        re[(k*dim + l)*runLen + v] = stateVecReal[AMP_INDEX(ind + v)];
+                        im[(k*dim + l)*runLen + v] = stateVecImag[AMP_INDEX(ind + v)];
+                    }
+                    if (!isDephased)
+                        continue;
+                    
+                    // scale by the dephasing of the qubits at which the row and column differ
+                    for (v=0; v<runLen; v++) {
+                        glob = ind + v + offset;
+                        diff = (glob ^ (glob >> numQubits)) & rowMask;
+                        fac = facTables[0][diff & 255] * facTables[1][(diff >> 8) & 255] * 
+                              facTables[2][(diff >> 16) & 255] * facTables[3][(diff >> 24) & 255];
+                        re[(k*dim + l)*runLen + v] *= fac;
+                        im[(k*dim + l)*runLen + v] *= fac;
+                    }
+                }
+            }
+            
+            // each channel mixes the real and imaginary components alike, and visits every 
+            // (k, l) with bit t of both k and l clear
+            for (t=0; t<numTargets; t++) {
+                bit = 1LL << t;
+                pop = &popMatrs[4*t];
+                coh = &cohMatrs[4*t];
+                for (k0=0; k0<dim; k0+=2*bit) for (k=k0; k<k0+bit; k++) {
+                    for (l0=0; l0<dim; l0+=2*bit) for (l=l0; l<l0+bit; l++) {
+                        i00 = (k*dim + l)*runLen;
+                        i01 = i00 + bit*runLen;
+                        i10 = i00 + bit*dim*runLen;
+                        i11 = i10 + bit*runLen;
+                        
+                        SIMD_LOOP
+                        for (v=0; v<runLen; v++) {
+                            re00 = re[i00+v]; im00 = im[i00+v];
+                            re[i00+v] = pop[0]*re00 + pop[1]*re[i11+v];
+                            im[i00+v] = pop[0]*im00 + pop[1]*im[i11+v];
+                            re[i11+v] = pop[2]*re00 + pop[3]*re[i11+v];
+                            im[i11+v] = pop[2]*im00 + pop[3]*im[i11+v];
+                            
+                            re01 = re[i01+v]; im01 = im[i01+v];
+                            re[i01+v] = coh[0]*re01 + coh[1]*re[i10+v];
+                            im[i01+v] = coh[0]*im01 + coh[1]*im[i10+v];
+                            re[i10+v] = coh[2]*re01 + coh[3]*re[i10+v];
+                            im[i10+v] = coh[2]*im01 + coh[3]*im[i10+v];
+                        }
+                    }
+                }
+            }
+            
+            for (l=0; l<dim; l++) {
+                for (k=0; k<dim; k++) {
+                    ind = ind0 | colOffs[l] | rowOffs[k];
+                    for (v=0; v<runLen; v++) {
+                        stateVecReal[AMP_INDEX(ind + v)] = re[(k*dim + l)*runLen + v];
+                        stateVecImag[AMP_INDEX(ind + v)] = im[(k*dim + l)*runLen + v];
+                    }
+                }
+            }
+        }
+    }
+}
+
+/** Applies the dephasing factors and the single-qubit channels upon the ascending targets (described 
+ * by their population and coherence matrices) in one pass per MAX_NOISE_BATCH_QUBITS targets, with 
+ * the dephasing folded into the first pass. This is ceil(numTargets/4) passes, or a single pass when 
+ * only dephasing is applied. The column target qubits must be within the chunk.
+ */
+void densmatr_mixOneQubitChannelsLocal(
+    Qureg qureg, qreal* dephaseFacs, int* targets, int numTargets, qreal* popMatrs, qreal* cohMatrs
+) {
+    if (numTargets == 0) {
+        densmatr_mixDephasingLayerLocal(qureg, dephaseFacs);
+        return;
+    }
+    
+    for (int t=0; t<numTargets; t+=MAX_NOISE_BATCH_QUBITS) {
+        int batchSize = numTargets - t;
+        if (batchSize > MAX_NOISE_BATCH_QUBITS)
+            batchSize = MAX_NOISE_BATCH_QUBITS;
+        densmatr_mixOneQubitChannelsBatchLocal(
+            qureg, (t == 0)? dephaseFacs : NULL, 
+            &targets[t], batchSize, &popMatrs[4*t], &cohMatrs[4*t]);
+    }
+}
+
+void statevec_controlledUnitaryLocal(Qureg qureg, int controlQubit, int targetQubit, 
+        ComplexMatrix2 u)
+{
+    long long int sizeBlock, sizeHalfBlock;
+    long long int thisBlock, // current block
+         indexUp,indexLo;    // current index and corresponding index in lower half block
+
+    qreal stateRealUp,stateRealLo,stateImagUp,stateImagLo;
+    long long int thisTask;         
+    long long int numTasks=qureg.numAmpsPerChunk>>1;
+    long long int chunkSize=qureg.numAmpsPerChunk;
+    long long int chunkId=qureg.chunkId;
+
+    int controlBit;
+
+    // set dimensions
+    sizeHalfBlock = 1LL << targetQubit;  
+    sizeBlock     = 2LL * sizeHalfBlock; 
+
+    // Can't use qureg.stateVec as a private OMP var
+    qreal *stateVecReal = qureg.stateVec.real;
+    qreal *stateVecImag = qureg.stateVec.imag;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (sizeBlock,sizeHalfBlock,targetQubit, stateVecReal,stateVecImag, u,numTasks,chunkId,chunkSize,controlQubit) \
+    private  (thisTask,thisBlock ,indexUp,indexLo, stateRealUp,stateImagUp,stateRealLo,stateImagLo,controlBit)
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (thisTask=0; thisTask<numTasks; thisTask++) {
+
+            thisBlock   = thisTask >> targetQubit; // thisTask / sizeHalfBlock
+            indexUp     = thisBlock*sizeBlock + (thisTask&(sizeHalfBlock-1));
+            indexLo     = indexUp + sizeHalfBlock;
+
+            controlBit = extractBit (controlQubit, indexUp+chunkId*chunkSize);
+            if (controlBit){
+                // store current state vector values in temp variables
+                stateRealUp = stateVecReal[AMP_INDEX(indexUp)];
+                stateImagUp = stateVecImag[AMP_INDEX(indexUp)];
+
+                stateRealLo = stateVecReal[AMP_INDEX(indexLo)];
+                stateImagLo = stateVecImag[AMP_INDEX(indexLo)];
+
+
+                // state[indexUp] = u00 * state[indexUp] + u01 * state[indexLo]
+                stateVecReal[AMP_INDEX(indexUp)] = u.real[0][0]*stateRealUp - u.imag[0][0]*stateImagUp 
+                    + u.real[0][1]*stateRealLo - u.imag[0][1]*stateImagLo;
+                stateVecImag[AMP_INDEX(indexUp)] = u.real[0][0]*stateImagUp + u.imag[0][0]*stateRealUp 
+                    + u.real[0][1]*stateImagLo + u.imag[0][1]*stateRealLo;
+
+                // state[indexLo] = u10  * state[indexUp] + u11 * state[indexLo]
+                stateVecReal[AMP_INDEX(indexLo)] = u.real[1][0]*stateRealUp  - u.imag[1][0]*stateImagUp 
+                    + u.real[1][1]*stateRealLo  -  u.imag[1][1]*stateImagLo;
+                stateVecImag[AMP_INDEX(indexLo)] = u.real[1][0]*stateImagUp + u.imag[1][0]*stateRealUp 
+                    + u.real[1][1]*stateImagLo + u.imag[1][1]*stateRealLo;
+            }
+        } 
+    }
+
+}
+
+/** Rotate a single qubit in the state vector of probability amplitudes, given two complex 
+ * numbers alpha and beta and a subset of the state vector with upper and lower block values 
+ * stored seperately. Only perform the rotation where the control qubit is one.
+ *                                               
+ *  @param[in,out] qureg object representing the set of qubits
+ *  @param[in] controlQubit qubit to determine whether or not to perform a rotation 
+ *  @param[in] rot1 rotation angle
+ *  @param[in] rot2 rotation angle
+ *  @param[in] stateVecUp probability amplitudes in upper half of a block
+ *  @param[in] stateVecLo probability amplitudes in lower half of a block
+ *  @param[out] stateVecOut array section to update (will correspond to either the lower or upper half of a block)
+ */
+void statevec_controlledCompactUnitaryDistributed (Qureg qureg, int controlQubit,
+        Complex rot1, Complex rot2,
+        ComplexArray stateVecUp,
+        ComplexArray stateVecLo,
+        ComplexArray stateVecOut)
+{
+
+    qreal   stateRealUp,stateRealLo,stateImagUp,stateImagLo;
+    long long int thisTask;  
+    long long int numTasks=qureg.numAmpsPerChunk;
+    long long int chunkSize=qureg.numAmpsPerChunk;
+    long long int chunkId=qureg.chunkId;
+
+    int controlBit;
+
+    qreal rot1Real=rot1.real, rot1Imag=rot1.imag;
+    qreal rot2Real=rot2.real, rot2Imag=rot2.imag;
+    qreal *stateVecRealUp=stateVecUp.real, *stateVecImagUp=stateVecUp.imag;
+    qreal *stateVecRealLo=stateVecLo.real, *stateVecImagLo=stateVecLo.imag;
+    qreal *stateVecRealOut=stateVecOut.real, *stateVecImagOut=stateVecOut.imag;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (stateVecRealUp,stateVecImagUp,stateVecRealLo,stateVecImagLo,stateVecRealOut,stateVecImagOut, \
             rot1Real,rot1Imag, rot2Real,rot2Imag,numTasks,chunkId,chunkSize,controlQubit) \
     private  (thisTask,stateRealUp,stateImagUp,stateRealLo,stateImagLo,controlBit)
 # endif
@@ -2462,15 +3412,15 @@ void statevec_controlledCompactUnitaryDistributed (Qureg qureg, int controlQubit
             controlBit = extractBit (controlQubit, thisTask+chunkId*chunkSize);
             if (controlBit){
                 // store current state vector values in temp variables
-                stateRealUp = stateVecRealUp[thisTask];
-                stateImagUp = stateVecImagUp[thisTask];
+                stateRealUp = stateVecRealUp[AMP_INDEX(thisTask)];
+                stateImagUp = stateVecImagUp[AMP_INDEX(thisTask)];
 
-                stateRealLo = stateVecRealLo[thisTask];
-                stateImagLo = stateVecImagLo[thisTask];
+                stateRealLo = stateVecRealLo[AMP_INDEX(thisTask)];
+                stateImagLo = stateVecImagLo[AMP_INDEX(thisTask)];
 
                 // state[indexUp] = alpha * state[indexUp] - conj(beta)  * state[indexLo]
-                stateVecRealOut[thisTask] = rot1Real*stateRealUp - rot1Imag*stateImagUp + rot2Real*stateRealLo + rot2Imag*stateImagLo;
-                stateVecImagOut[thisTask] = rot1Real*stateImagUp + rot1Imag*stateRealUp + rot2Real*stateImagLo - rot2Imag*stateRealLo;
+                stateVecRealOut[AMP_INDEX(thisTask)] = rot1Real*stateRealUp - rot1Imag*stateImagUp + rot2Real*stateRealLo + rot2Imag*stateImagLo;
+                stateVecImagOut[AMP_INDEX(thisTask)] = rot1Real*stateImagUp + rot1Imag*stateRealUp + rot2Real*stateImagLo - rot2Imag*stateRealLo;
             }
         }
     }
@@ -2524,15 +3474,15 @@ void statevec_controlledUnitaryDistributed (Qureg qureg, int controlQubit,
             controlBit = extractBit (controlQubit, thisTask+chunkId*chunkSize);
             if (controlBit){
                 // store current state vector values in temp variables
-                stateRealUp = stateVecRealUp[thisTask];
-                stateImagUp = stateVecImagUp[thisTask];
+                stateRealUp = stateVecRealUp[AMP_INDEX(thisTask)];
+                stateImagUp = stateVecImagUp[AMP_INDEX(thisTask)];
 
-                stateRealLo = stateVecRealLo[thisTask];
-                stateImagLo = stateVecImagLo[thisTask];
+                stateRealLo = stateVecRealLo[AMP_INDEX(thisTask)];
+                stateImagLo = stateVecImagLo[AMP_INDEX(thisTask)];
 
-                stateVecRealOut[thisTask] = rot1Real*stateRealUp - rot1Imag*stateImagUp 
+                stateVecRealOut[AMP_INDEX(thisTask)] = rot1Real*stateRealUp - rot1Imag*stateImagUp 
                     + rot2Real*stateRealLo - rot2Imag*stateImagLo;
-                stateVecImagOut[thisTask] = rot1Real*stateImagUp + rot1Imag*stateRealUp 
+                stateVecImagOut[AMP_INDEX(thisTask)] = rot1Real*stateImagUp + rot1Imag*stateRealUp 
                     + rot2Real*stateImagLo + rot2Imag*stateRealLo;
             }
         }
@@ -2590,15 +3540,15 @@ void statevec_multiControlledUnitaryDistributed (
         for (thisTask=0; thisTask<numTasks; thisTask++) {
             if (ctrlQubitsMask == (ctrlQubitsMask & ((thisTask+chunkId*chunkSize) ^ ctrlFlipMask))) {
                 // store current state vector values in temp variables
-                stateRealUp = stateVecRealUp[thisTask];
-                stateImagUp = stateVecImagUp[thisTask];
+                stateRealUp = stateVecRealUp[AMP_INDEX(thisTask)];
+                stateImagUp = stateVecImagUp[AMP_INDEX(thisTask)];
 
-                stateRealLo = stateVecRealLo[thisTask];
-                stateImagLo = stateVecImagLo[thisTask];
+                stateRealLo = stateVecRealLo[AMP_INDEX(thisTask)];
+                stateImagLo = stateVecImagLo[AMP_INDEX(thisTask)];
 
-                stateVecRealOut[thisTask] = rot1Real*stateRealUp - rot1Imag*stateImagUp 
+                stateVecRealOut[AMP_INDEX(thisTask)] = rot1Real*stateRealUp - rot1Imag*stateImagUp 
                     + rot2Real*stateRealLo - rot2Imag*stateImagLo;
-                stateVecImagOut[thisTask] = rot1Real*stateImagUp + rot1Imag*stateRealUp 
+                stateVecImagOut[AMP_INDEX(thisTask)] = rot1Real*stateImagUp + rot1Imag*stateRealUp 
                     + rot2Real*stateImagLo + rot2Imag*stateRealLo;
             }
         }
@@ -2615,6 +3565,12 @@ void statevec_pauliXLocal(Qureg qureg, int targetQubit)
     long long int thisTask;         
     long long int numTasks=qureg.numAmpsPerChunk>>1;
 
+    // all but the lowest targets modify contiguous runs of amplitudes, which are vectorised
+    if (getVectorisedRunLength(targetQubit, numTasks)) {
+        swapAmpPairsVectorised(qureg, targetQubit);
+        return;
+    }
+
     // set dimensions
     sizeHalfBlock = 1LL << targetQubit;  
     sizeBlock     = 2LL * sizeHalfBlock; 
@@ -2626,7 +3582,7 @@ void statevec_pauliXLocal(Qureg qureg, int targetQubit)
 # ifdef _OPENMP
 # pragma omp parallel \
     default  (none) \
-    shared   (sizeBlock,sizeHalfBlock, stateVecReal,stateVecImag, numTasks) \
+    shared   (sizeBlock,sizeHalfBlock,targetQubit, stateVecReal,stateVecImag, numTasks) \
     private  (thisTask,thisBlock ,indexUp,indexLo, stateRealUp,stateImagUp)
 # endif
     {
@@ -2634,18 +3590,18 @@ void statevec_pauliXLocal(Qureg qureg, int targetQubit)
 # pragma omp for schedule (static)
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
-            thisBlock   = thisTask / sizeHalfBlock;
-            indexUp     = thisBlock*sizeBlock + thisTask%sizeHalfBlock;
+            thisBlock   = thisTask >> targetQubit; // thisTask / sizeHalfBlock
+            indexUp     = thisBlock*sizeBlock + (thisTask&(sizeHalfBlock-1));
             indexLo     = indexUp + sizeHalfBlock;
 
-            stateRealUp = stateVecReal[indexUp];
-            stateImagUp = stateVecImag[indexUp];
+            stateRealUp = stateVecReal[AMP_INDEX(indexUp)];
+            stateImagUp = stateVecImag[AMP_INDEX(indexUp)];
 
-            stateVecReal[indexUp] = stateVecReal[indexLo];
-            stateVecImag[indexUp] = stateVecImag[indexLo];
+            stateVecReal[AMP_INDEX(indexUp)] = stateVecReal[AMP_INDEX(indexLo)];
+            stateVecImag[AMP_INDEX(indexUp)] = stateVecImag[AMP_INDEX(indexLo)];
 
-            stateVecReal[indexLo] = stateRealUp;
-            stateVecImag[indexLo] = stateImagUp;
+            stateVecReal[AMP_INDEX(indexLo)] = stateRealUp;
+            stateVecImag[AMP_INDEX(indexLo)] = stateImagUp;
         } 
     }
 
@@ -2685,8 +3641,8 @@ void statevec_pauliXDistributed (Qureg qureg,
 # pragma omp for schedule (static)
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
-            stateVecRealOut[thisTask] = stateVecRealIn[thisTask];
-            stateVecImagOut[thisTask] = stateVecImagIn[thisTask];
+            stateVecRealOut[AMP_INDEX(thisTask)] = stateVecRealIn[AMP_INDEX(thisTask)];
+            stateVecImagOut[AMP_INDEX(thisTask)] = stateVecImagIn[AMP_INDEX(thisTask)];
         }
     }
 } 
@@ -2716,7 +3672,7 @@ void statevec_controlledNotLocal(Qureg qureg, int controlQubit, int targetQubit)
 # ifdef _OPENMP
 # pragma omp parallel \
     default  (none) \
-    shared   (sizeBlock,sizeHalfBlock, stateVecReal,stateVecImag,numTasks,chunkId,chunkSize,controlQubit) \
+    shared   (sizeBlock,sizeHalfBlock,targetQubit, stateVecReal,stateVecImag,numTasks,chunkId,chunkSize,controlQubit) \
     private  (thisTask,thisBlock ,indexUp,indexLo, stateRealUp,stateImagUp,controlBit)
 # endif
     {
@@ -2724,20 +3680,20 @@ void statevec_controlledNotLocal(Qureg qureg, int controlQubit, int targetQubit)
 # pragma omp for schedule (static)
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
-            thisBlock   = thisTask / sizeHalfBlock;
-            indexUp     = thisBlock*sizeBlock + thisTask%sizeHalfBlock;
+            thisBlock   = thisTask >> targetQubit; // thisTask / sizeHalfBlock
+            indexUp     = thisBlock*sizeBlock + (thisTask&(sizeHalfBlock-1));
             indexLo     = indexUp + sizeHalfBlock;
 
             controlBit = extractBit(controlQubit, indexUp+chunkId*chunkSize);
             if (controlBit){
-                stateRealUp = stateVecReal[indexUp];
-                stateImagUp = stateVecImag[indexUp];
+                stateRealUp = stateVecReal[AMP_INDEX(indexUp)];
+                stateImagUp = stateVecImag[AMP_INDEX(indexUp)];
 
-                stateVecReal[indexUp] = stateVecReal[indexLo];
-                stateVecImag[indexUp] = stateVecImag[indexLo];
+                stateVecReal[AMP_INDEX(indexUp)] = stateVecReal[AMP_INDEX(indexLo)];
+                stateVecImag[AMP_INDEX(indexUp)] = stateVecImag[AMP_INDEX(indexLo)];
 
-                stateVecReal[indexLo] = stateRealUp;
-                stateVecImag[indexLo] = stateImagUp;
+                stateVecReal[AMP_INDEX(indexLo)] = stateRealUp;
+                stateVecImag[AMP_INDEX(indexLo)] = stateImagUp;
             }
         } 
     }
@@ -2783,8 +3739,8 @@ void statevec_controlledNotDistributed (Qureg qureg, int controlQubit,
         for (thisTask=0; thisTask<numTasks; thisTask++) {
             controlBit = extractBit (controlQubit, thisTask+chunkId*chunkSize);
             if (controlBit){
-                stateVecRealOut[thisTask] = stateVecRealIn[thisTask];
-                stateVecImagOut[thisTask] = stateVecImagIn[thisTask];
+                stateVecRealOut[AMP_INDEX(thisTask)] = stateVecRealIn[AMP_INDEX(thisTask)];
+                stateVecImagOut[AMP_INDEX(thisTask)] = stateVecImagIn[AMP_INDEX(thisTask)];
             }
         }
     }
@@ -2834,14 +3790,14 @@ void statevec_multiControlledMultiQubitNotLocal(Qureg qureg, int ctrlMask, int t
             if (mateInd < ampInd)
                 continue;
             
-            mateRe = stateRe[mateInd];
-            mateIm = stateIm[mateInd];
+            mateRe = stateRe[AMP_INDEX(mateInd)];
+            mateIm = stateIm[AMP_INDEX(mateInd)];
             
             // swap amp with mate
-            stateRe[mateInd] = stateRe[ampInd];
-            stateIm[mateInd] = stateIm[ampInd];
-            stateRe[ampInd] = mateRe;
-            stateIm[ampInd] = mateIm;
+            stateRe[AMP_INDEX(mateInd)] = stateRe[AMP_INDEX(ampInd)];
+            stateIm[AMP_INDEX(mateInd)] = stateIm[AMP_INDEX(ampInd)];
+            stateRe[AMP_INDEX(ampInd)] = mateRe;
+            stateIm[AMP_INDEX(ampInd)] = mateIm;
         }
     }
 }
@@ -2891,10 +3847,10 @@ void statevec_multiControlledMultiQubitNotDistributed(
              * However, the arithmetic doesn't necessitate knowing the rank of stateVecIn 
              */
             inIndGlobal = outIndGlobal ^ targMask;
-            inInd = inIndGlobal % numAmps;              // = inIndGlobal - pairRank * numAmps
+            inInd = inIndGlobal & (numAmps-1);          // = inIndGlobal - pairRank * numAmps
             
-            outReal[outInd] = inReal[inInd];
-            outImag[outInd] = inImag[inInd];
+            outReal[AMP_INDEX(outInd)] = inReal[AMP_INDEX(inInd)];
+            outImag[AMP_INDEX(outInd)] = inImag[AMP_INDEX(inInd)];
         }
     }
 }
@@ -2920,7 +3876,7 @@ void statevec_pauliYLocal(Qureg qureg, int targetQubit, int conjFac)
 # ifdef _OPENMP
 # pragma omp parallel \
     default  (none) \
-    shared   (sizeBlock,sizeHalfBlock, stateVecReal,stateVecImag, numTasks,conjFac) \
+    shared   (sizeBlock,sizeHalfBlock,targetQubit, stateVecReal,stateVecImag, numTasks,conjFac) \
     private  (thisTask,thisBlock ,indexUp,indexLo, stateRealUp,stateImagUp)
 # endif
     {
@@ -2928,17 +3884,17 @@ void statevec_pauliYLocal(Qureg qureg, int targetQubit, int conjFac)
 # pragma omp for schedule (static)
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
-            thisBlock   = thisTask / sizeHalfBlock;
-            indexUp     = thisBlock*sizeBlock + thisTask%sizeHalfBlock;
+            thisBlock   = thisTask >> targetQubit; // thisTask / sizeHalfBlock
+            indexUp     = thisBlock*sizeBlock + (thisTask&(sizeHalfBlock-1));
             indexLo     = indexUp + sizeHalfBlock;
 
-            stateRealUp = stateVecReal[indexUp];
-            stateImagUp = stateVecImag[indexUp];
+            stateRealUp = stateVecReal[AMP_INDEX(indexUp)];
+            stateImagUp = stateVecImag[AMP_INDEX(indexUp)];
 
-            stateVecReal[indexUp] = conjFac * stateVecImag[indexLo];
-            stateVecImag[indexUp] = conjFac * -stateVecReal[indexLo];
-            stateVecReal[indexLo] = conjFac * -stateImagUp;
-            stateVecImag[indexLo] = conjFac * stateRealUp;
+            stateVecReal[AMP_INDEX(indexUp)] = conjFac * stateVecImag[AMP_INDEX(indexLo)];
+            stateVecImag[AMP_INDEX(indexUp)] = conjFac * -stateVecReal[AMP_INDEX(indexLo)];
+            stateVecReal[AMP_INDEX(indexLo)] = conjFac * -stateImagUp;
+            stateVecImag[AMP_INDEX(indexLo)] = conjFac * stateRealUp;
         } 
     }
 }
@@ -2985,8 +3941,8 @@ void statevec_pauliYDistributed(Qureg qureg,
 # pragma omp for schedule (static)
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
-            stateVecRealOut[thisTask] = conjFac * realSign * stateVecImagIn[thisTask];
-            stateVecImagOut[thisTask] = conjFac * imagSign * stateVecRealIn[thisTask];
+            stateVecRealOut[AMP_INDEX(thisTask)] = conjFac * realSign * stateVecImagIn[AMP_INDEX(thisTask)];
+            stateVecImagOut[AMP_INDEX(thisTask)] = conjFac * imagSign * stateVecRealIn[AMP_INDEX(thisTask)];
         }
     }
 } 
@@ -3019,7 +3975,7 @@ void statevec_controlledPauliYLocal(Qureg qureg, int controlQubit, int targetQub
 # ifdef _OPENMP
 # pragma omp parallel \
     default  (none) \
-    shared   (sizeBlock,sizeHalfBlock, stateVecReal,stateVecImag, numTasks,chunkId, \
+    shared   (sizeBlock,sizeHalfBlock,targetQubit, stateVecReal,stateVecImag, numTasks,chunkId, \
                 chunkSize,controlQubit,conjFac) \
     private  (thisTask,thisBlock ,indexUp,indexLo, stateRealUp,stateImagUp,controlBit)
 # endif
@@ -3028,20 +3984,20 @@ void statevec_controlledPauliYLocal(Qureg qureg, int controlQubit, int targetQub
 # pragma omp for schedule (static)
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
-            thisBlock   = thisTask / sizeHalfBlock;
-            indexUp     = thisBlock*sizeBlock + thisTask%sizeHalfBlock;
+            thisBlock   = thisTask >> targetQubit; // thisTask / sizeHalfBlock
+            indexUp     = thisBlock*sizeBlock + (thisTask&(sizeHalfBlock-1));
             indexLo     = indexUp + sizeHalfBlock;
 
             controlBit = extractBit(controlQubit, indexUp+chunkId*chunkSize);
             if (controlBit){
-                stateRealUp = stateVecReal[indexUp];
-                stateImagUp = stateVecImag[indexUp];
+                stateRealUp = stateVecReal[AMP_INDEX(indexUp)];
+                stateImagUp = stateVecImag[AMP_INDEX(indexUp)];
 
                 // update under +-{{0, -i}, {i, 0}}
-                stateVecReal[indexUp] = conjFac * stateVecImag[indexLo];
-                stateVecImag[indexUp] = conjFac * -stateVecReal[indexLo];
-                stateVecReal[indexLo] = conjFac * -stateImagUp;
-                stateVecImag[indexLo] = conjFac * stateRealUp;
+                stateVecReal[AMP_INDEX(indexUp)] = conjFac * stateVecImag[AMP_INDEX(indexLo)];
+                stateVecImag[AMP_INDEX(indexUp)] = conjFac * -stateVecReal[AMP_INDEX(indexLo)];
+                stateVecReal[AMP_INDEX(indexLo)] = conjFac * -stateImagUp;
+                stateVecImag[AMP_INDEX(indexLo)] = conjFac * stateRealUp;
             }
         } 
     }
@@ -3077,8 +4033,8 @@ void statevec_controlledPauliYDistributed (Qureg qureg, int controlQubit,
         for (thisTask=0; thisTask<numTasks; thisTask++) {
             controlBit = extractBit (controlQubit, thisTask+chunkId*chunkSize);
             if (controlBit){
-                stateVecRealOut[thisTask] = conjFac * stateVecImagIn[thisTask];
-                stateVecImagOut[thisTask] = conjFac * -stateVecRealIn[thisTask];
+                stateVecRealOut[AMP_INDEX(thisTask)] = conjFac * stateVecImagIn[AMP_INDEX(thisTask)];
+                stateVecImagOut[AMP_INDEX(thisTask)] = conjFac * -stateVecRealIn[AMP_INDEX(thisTask)];
             }
         }
     }
@@ -3100,6 +4056,14 @@ void statevec_hadamardLocal(Qureg qureg, int targetQubit)
     long long int thisTask;         
     long long int numTasks=qureg.numAmpsPerChunk>>1;
 
+    // all but the lowest targets modify contiguous runs of amplitudes, which are vectorised
+    if (getVectorisedRunLength(targetQubit, numTasks)) {
+        qreal fac = 1.0/sqrt(2);
+        ComplexMatrix2 u = {.real = {{fac, fac}, {fac, -fac}}, .imag = {{0}}};
+        applyMatrix2Vectorised(qureg, targetQubit, u);
+        return;
+    }
+
     // set dimensions
     sizeHalfBlock = 1LL << targetQubit;  
     sizeBlock     = 2LL * sizeHalfBlock; 
@@ -3113,7 +4077,7 @@ void statevec_hadamardLocal(Qureg qureg, int targetQubit)
 # ifdef _OPENMP
 # pragma omp parallel \
     default  (none) \
-    shared   (sizeBlock,sizeHalfBlock, stateVecReal,stateVecImag, recRoot2, numTasks) \
+    shared   (sizeBlock,sizeHalfBlock,targetQubit, stateVecReal,stateVecImag, recRoot2, numTasks) \
     private  (thisTask,thisBlock ,indexUp,indexLo, stateRealUp,stateImagUp,stateRealLo,stateImagLo)
 # endif
     {
@@ -3121,21 +4085,21 @@ void statevec_hadamardLocal(Qureg qureg, int targetQubit)
 # pragma omp for schedule (static)
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
-            thisBlock   = thisTask / sizeHalfBlock;
-            indexUp     = thisBlock*sizeBlock + thisTask%sizeHalfBlock;
+            thisBlock   = thisTask >> targetQubit; // thisTask / sizeHalfBlock
+            indexUp     = thisBlock*sizeBlock + (thisTask&(sizeHalfBlock-1));
             indexLo     = indexUp + sizeHalfBlock;
 
-            stateRealUp = stateVecReal[indexUp];
-            stateImagUp = stateVecImag[indexUp];
+            stateRealUp = stateVecReal[AMP_INDEX(indexUp)];
+            stateImagUp = stateVecImag[AMP_INDEX(indexUp)];
 
-            stateRealLo = stateVecReal[indexLo];
-            stateImagLo = stateVecImag[indexLo];
+            stateRealLo = stateVecReal[AMP_INDEX(indexLo)];
+            stateImagLo = stateVecImag[AMP_INDEX(indexLo)];
 
-            stateVecReal[indexUp] = recRoot2*(stateRealUp + stateRealLo);
-            stateVecImag[indexUp] = recRoot2*(stateImagUp + stateImagLo);
+            stateVecReal[AMP_INDEX(indexUp)] = recRoot2*(stateRealUp + stateRealLo);
+            stateVecImag[AMP_INDEX(indexUp)] = recRoot2*(stateImagUp + stateImagLo);
 
-            stateVecReal[indexLo] = recRoot2*(stateRealUp - stateRealLo);
-            stateVecImag[indexLo] = recRoot2*(stateImagUp - stateImagLo);
+            stateVecReal[AMP_INDEX(indexLo)] = recRoot2*(stateRealUp - stateRealLo);
+            stateVecImag[AMP_INDEX(indexLo)] = recRoot2*(stateImagUp - stateImagLo);
         } 
     }
 }
@@ -3185,14 +4149,14 @@ void statevec_hadamardDistributed(Qureg qureg,
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
             // store current state vector values in temp variables
-            stateRealUp = stateVecRealUp[thisTask];
-            stateImagUp = stateVecImagUp[thisTask];
+            stateRealUp = stateVecRealUp[AMP_INDEX(thisTask)];
+            stateImagUp = stateVecImagUp[AMP_INDEX(thisTask)];
 
-            stateRealLo = stateVecRealLo[thisTask];
-            stateImagLo = stateVecImagLo[thisTask];
+            stateRealLo = stateVecRealLo[AMP_INDEX(thisTask)];
+            stateImagLo = stateVecImagLo[AMP_INDEX(thisTask)];
 
-            stateVecRealOut[thisTask] = recRoot2*(stateRealUp + sign*stateRealLo);
-            stateVecImagOut[thisTask] = recRoot2*(stateImagUp + sign*stateImagLo);
+            stateVecRealOut[AMP_INDEX(thisTask)] = recRoot2*(stateRealUp + sign*stateRealLo);
+            stateVecImagOut[AMP_INDEX(thisTask)] = recRoot2*(stateImagUp + sign*stateImagLo);
         }
     }
 }
@@ -3229,11 +4193,11 @@ void statevec_phaseShiftByTerm (Qureg qureg, int targetQubit, Complex term)
         targetBit = extractBit (targetQubit, index+chunkId*chunkSize);
         if (targetBit) {
             
-            stateRealLo = stateVecReal[index];
-            stateImagLo = stateVecImag[index];
+            stateRealLo = stateVecReal[AMP_INDEX(index)];
+            stateImagLo = stateVecImag[AMP_INDEX(index)];
             
-            stateVecReal[index] = cosAngle*stateRealLo - sinAngle*stateImagLo;
-            stateVecImag[index] = sinAngle*stateRealLo + cosAngle*stateImagLo;  
+            stateVecReal[AMP_INDEX(index)] = cosAngle*stateRealLo - sinAngle*stateImagLo;
+            stateVecImag[AMP_INDEX(index)] = sinAngle*stateRealLo + cosAngle*stateImagLo;  
         }
     }
 }
@@ -3269,26 +4233,30 @@ void statevec_controlledPhaseShift (Qureg qureg, int idQubit1, int idQubit2, qre
         bit2 = extractBit (idQubit2, index+chunkId*chunkSize);
         if (bit1 && bit2) {
             
-            stateRealLo = stateVecReal[index];
-            stateImagLo = stateVecImag[index];
+            stateRealLo = stateVecReal[AMP_INDEX(index)];
+            stateImagLo = stateVecImag[AMP_INDEX(index)];
             
-            stateVecReal[index] = cosAngle*stateRealLo - sinAngle*stateImagLo;
-            stateVecImag[index] = sinAngle*stateRealLo + cosAngle*stateImagLo;  
+            stateVecReal[AMP_INDEX(index)] = cosAngle*stateRealLo - sinAngle*stateImagLo;
+            stateVecImag[AMP_INDEX(index)] = sinAngle*stateRealLo + cosAngle*stateImagLo;  
         }
     }
 }
 
 void statevec_multiControlledPhaseShift(Qureg qureg, int *controlQubits, int numControlQubits, qreal angle)
 {
-    long long int index;
-    long long int stateVecSize;
-
-    long long int chunkSize=qureg.numAmpsPerChunk;
-    long long int chunkId=qureg.chunkId;
+    long long int index, thisTask;
+    long long int numTasks;
 
     long long int mask = getQubitBitMask(controlQubits, numControlQubits);
 
-    stateVecSize = qureg.numAmpsPerChunk;
+    // only the amplitudes with all control qubits in the 1 state are enumerated
+    int fixedQubits[64]; // [numFixed]
+    long long int ctrlBits;
+    int numFixed = getControlSubspace(qureg, mask, 0, 0, fixedQubits, &ctrlBits);
+    if (numFixed < 0)
+        return;
+
+    numTasks = qureg.numAmpsPerChunk >> numFixed;
     qreal *stateVecReal = qureg.stateVec.real;
     qreal *stateVecImag = qureg.stateVec.imag;
     
@@ -3299,22 +4267,21 @@ void statevec_multiControlledPhaseShift(Qureg qureg, int *controlQubits, int num
 # ifdef _OPENMP
 # pragma omp parallel \
     default  (none)              \
-    shared   (stateVecSize, stateVecReal, stateVecImag, mask, chunkId,chunkSize,cosAngle,sinAngle) \
-    private  (index, stateRealLo, stateImagLo)
+    shared   (numTasks, stateVecReal, stateVecImag, fixedQubits,numFixed,ctrlBits, cosAngle,sinAngle) \
+    private  (thisTask, index, stateRealLo, stateImagLo)
 # endif
     {
 # ifdef _OPENMP
 # pragma omp for schedule (static)
 # endif
-        for (index=0; index<stateVecSize; index++) {
-            if (mask == (mask & (index+chunkId*chunkSize)) ){
+        for (thisTask=0; thisTask<numTasks; thisTask++) {
+            index = insertZeroBits(thisTask, fixedQubits, numFixed) | ctrlBits;
                 
-                stateRealLo = stateVecReal[index];
-                stateImagLo = stateVecImag[index];
-            
-                stateVecReal[index] = cosAngle*stateRealLo - sinAngle*stateImagLo;
-                stateVecImag[index] = sinAngle*stateRealLo + cosAngle*stateImagLo;  
-            }
+            stateRealLo = stateVecReal[AMP_INDEX(index)];
+            stateImagLo = stateVecImag[AMP_INDEX(index)];
+        
+            stateVecReal[AMP_INDEX(index)] = cosAngle*stateRealLo - sinAngle*stateImagLo;
+            stateVecImag[AMP_INDEX(index)] = sinAngle*stateRealLo + cosAngle*stateImagLo;  
         }
     }
 }
@@ -3359,13 +4326,13 @@ void statevec_multiRotateZ(Qureg qureg, long long int mask, qreal angle)
 # pragma omp for schedule (static)
 # endif
         for (index=0; index<stateVecSize; index++) {
-            stateReal = stateVecReal[index];
-            stateImag = stateVecImag[index];
+            stateReal = stateVecReal[AMP_INDEX(index)];
+            stateImag = stateVecImag[AMP_INDEX(index)];
             
             // odd-parity target qubits get fac_j = -1
             fac = getBitMaskParity(mask & (index+chunkId*chunkSize))? -1 : 1;
-            stateVecReal[index] = cosAngle*stateReal + fac * sinAngle*stateImag;
-            stateVecImag[index] = - fac * sinAngle*stateReal + cosAngle*stateImag;  
+            stateVecReal[AMP_INDEX(index)] = cosAngle*stateReal + fac * sinAngle*stateImag;
+            stateVecImag[AMP_INDEX(index)] = - fac * sinAngle*stateReal + cosAngle*stateImag;  
         }
     }
 }
@@ -3398,8 +4365,8 @@ void statevec_multiControlledMultiRotateZ(Qureg qureg, long long int ctrlMask, l
 # pragma omp for schedule (static)
 # endif
         for (index=0; index<stateVecSize; index++) {
-            stateReal = stateVecReal[index];
-            stateImag = stateVecImag[index];
+            stateReal = stateVecReal[AMP_INDEX(index)];
+            stateImag = stateVecImag[AMP_INDEX(index)];
             
             // states with not-all-one control qubits are unmodified
             globalIndex = index + offset;
@@ -3408,13 +4375,287 @@ void statevec_multiControlledMultiRotateZ(Qureg qureg, long long int ctrlMask, l
             
             // odd-parity target qubits get fac_j = -1 (avoid thread divergence)
             fac = 1-2*getBitMaskParity(targMask & globalIndex);
-            stateVecReal[index] = cosAngle*stateReal + fac * sinAngle*stateImag;
-            stateVecImag[index] = - fac * sinAngle*stateReal + cosAngle*stateImag;  
+            stateVecReal[AMP_INDEX(index)] = cosAngle*stateReal + fac * sinAngle*stateImag;
+            stateVecImag[AMP_INDEX(index)] = - fac * sinAngle*stateReal + cosAngle*stateImag;  
         }
     }    
 }
 
-qreal densmatr_findProbabilityOfZeroLocal(Qureg qureg, int measureQubit) {
+/** Applies the product of commuting rotations exp(-i angles[j]/2 Z_{masks[j]}) in a single pass, 
+ * multiplying each amplitude by the phase exp(-i/2 sum_j angles[j] (-1)^|index & masks[j]|) 
+ */
+void statevec_multiRotateZProduct(Qureg qureg, long long int* masks, qreal* angles, int numRotations)
+{
+    long long int offset = qureg.chunkId * qureg.numAmpsPerChunk;
+    long long int stateVecSize = qureg.numAmpsPerChunk;
+    qreal *stateVecReal = qureg.stateVec.real;
+    qreal *stateVecImag = qureg.stateVec.imag;
+    
+    qreal stateReal, stateImag, phase, cosPhase, sinPhase;
+    long long int index, globalIndex;
+    int j;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none)              \
+    shared   (offset, stateVecSize, stateVecReal,stateVecImag, masks,angles,numRotations) \
+    private  (index,globalIndex, j, phase,cosPhase,sinPhase, stateReal,stateImag)
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (index=0; index<stateVecSize; index++) {
+            globalIndex = index + offset;
+            
+            // odd-parity rotations contribute -angle
+            phase = 0;
+            for (j=0; j<numRotations; j++)
+                phase += (getBitMaskParity(masks[j] & globalIndex))? -angles[j] : angles[j];
+            cosPhase = cos(phase/2);
+            sinPhase = sin(phase/2);
+            
+            stateReal = stateVecReal[AMP_INDEX(index)];
+            stateImag = stateVecImag[AMP_INDEX(index)];
+            stateVecReal[AMP_INDEX(index)] = cosPhase*stateReal + sinPhase*stateImag;
+            stateVecImag[AMP_INDEX(index)] = - sinPhase*stateReal + cosPhase*stateImag;
+        }
+    }
+}
+
+/** Effects rho -> D rho D^dagger for the diagonal D which multiplies by term every basis state 
+ * with all qubits in mask set, as a single pass. Element (r, c) is modified only when exactly 
+ * one of r and c has every qubit of mask set, multiplying it by term or conj(term) respectively.
+ */
+void densmatr_multiControlledPhaseShiftByTerm(Qureg qureg, long long int mask, Complex term)
+{
+    if (qureg.isPackedDensityMatrix) {
+        packed_multiControlledPhaseShiftByTerm(qureg, mask, term);
+        return;
+    }
+
+    int numQubits = qureg.numQubitsRepresented;
+    long long int offset = qureg.chunkId * qureg.numAmpsPerChunk;
+    long long int numAmps = qureg.numAmpsPerChunk;
+    long long int rowMask = mask;
+    long long int colMask = mask << numQubits;
+    qreal *stateVecReal = qureg.stateVec.real;
+    qreal *stateVecImag = qureg.stateVec.imag;
+    qreal termReal = term.real;
+    qreal termImag = term.imag;
+    
+    qreal stateReal, stateImag, facImag;
+    long long int index, globalIndex;
+    int rowSet, colSet;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none)              \
+    shared   (offset,numAmps,rowMask,colMask, stateVecReal,stateVecImag, termReal,termImag) \
+    private  (index,globalIndex, rowSet,colSet, facImag, stateReal,stateImag)
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (index=0; index<numAmps; index++) {
+            globalIndex = index + offset;
+            rowSet = ((globalIndex & rowMask) == rowMask);
+            colSet = ((globalIndex & colMask) == colMask);
+            if (rowSet == colSet)
+                continue;
+            
+            // multiply by term (when only the row is set) else conj(term)
+            facImag = (rowSet)? termImag : - termImag;
+            stateReal = stateVecReal[AMP_INDEX(index)];
+            stateImag = stateVecImag[AMP_INDEX(index)];
+            stateVecReal[AMP_INDEX(index)] = termReal*stateReal - facImag*stateImag;
+            stateVecImag[AMP_INDEX(index)] = termReal*stateImag + facImag*stateReal;
+        }
+    }
+}
+
+/** Effects rho -> R rho R^dagger for R = exp(-i angle/2 Z..Z) upon the qubits of targMask, 
+ * controlled on ctrlMask, as a single pass. Each element is multiplied by the phase 
+ * exp(-+ i angle/2) of its row (if its controls are satisfied) then the conjugate phase of 
+ * its column, exactly as if R were applied to the rows and columns in separate passes.
+ */
+void densmatr_multiControlledMultiRotateZ(Qureg qureg, long long int ctrlMask, long long int targMask, qreal angle)
+{
+    if (qureg.isPackedDensityMatrix) {
+        packed_multiControlledMultiRotateZ(qureg, ctrlMask, targMask, angle);
+        return;
+    }
+
+    int numQubits = qureg.numQubitsRepresented;
+    long long int offset = qureg.chunkId * qureg.numAmpsPerChunk;
+    long long int numAmps = qureg.numAmpsPerChunk;
+    long long int rowCtrlMask = ctrlMask;
+    long long int colCtrlMask = ctrlMask << numQubits;
+    long long int rowTargMask = targMask;
+    long long int colTargMask = targMask << numQubits;
+    qreal *stateVecReal = qureg.stateVec.real;
+    qreal *stateVecImag = qureg.stateVec.imag;
+    qreal cosAngle = cos(angle/2);
+    qreal sinAngle = sin(angle/2);
+    
+    qreal stateReal, stateImag, newReal, sinPhase;
+    long long int index, globalIndex;
+    int rowCtrl, colCtrl;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none)              \
+    shared   (offset,numAmps, rowCtrlMask,colCtrlMask,rowTargMask,colTargMask, \
+              stateVecReal,stateVecImag, cosAngle,sinAngle) \
+    private  (index,globalIndex, rowCtrl,colCtrl, newReal,sinPhase, stateReal,stateImag)
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (index=0; index<numAmps; index++) {
+            globalIndex = index + offset;
+            rowCtrl = ((globalIndex & rowCtrlMask) == rowCtrlMask);
+            colCtrl = ((globalIndex & colCtrlMask) == colCtrlMask);
+            if (!rowCtrl && !colCtrl)
+                continue;
+            
+            stateReal = stateVecReal[AMP_INDEX(index)];
+            stateImag = stateVecImag[AMP_INDEX(index)];
+            
+            // the row contributes exp(-i angle/2) when of even parity, else exp(i angle/2)
+            if (rowCtrl) {
+                sinPhase = (getBitMaskParity(globalIndex & rowTargMask))? sinAngle : - sinAngle;
+                newReal = cosAngle*stateReal - sinPhase*stateImag;
+                stateImag = cosAngle*stateImag + sinPhase*stateReal;
+                stateReal = newReal;
+            }
+            // and the column contributes the conjugate
+            if (colCtrl) {
+                sinPhase = (getBitMaskParity(globalIndex & colTargMask))? - sinAngle : sinAngle;
+                newReal = cosAngle*stateReal - sinPhase*stateImag;
+                stateImag = cosAngle*stateImag + sinPhase*stateReal;
+                stateReal = newReal;
+            }
+            stateVecReal[AMP_INDEX(index)] = stateReal;
+            stateVecImag[AMP_INDEX(index)] = stateImag;
+        }
+    }
+}
+
+/** Applies exp(-i angle/2 P) for the Pauli string P with X or Y upon the qubits of xMask and 
+ * Y or Z upon zMask (all within the chunk, and xMask non-zero), controlled on ctrlMask, as a 
+ * single pass over the pairs of amplitudes which P maps to one another. Each becomes 
+ * psi_a -> cosAngle psi_a + pairFac (-1)^|a & zMask| psi_{a ^ xMask}, with pairFac given by 
+ * getPauliRotationPairFactor(), in lieu of rotating every X and Y target to and from the Z basis.
+ */
+void statevec_multiControlledMultiRotatePauliLocal(
+    Qureg qureg, long long int ctrlMask, long long int xMask, long long int zMask, 
+    qreal cosAngle, Complex pairFac
+) {
+    long long int offset = qureg.chunkId * qureg.numAmpsPerChunk;
+    long long int numTasks = qureg.numAmpsPerChunk >> 1;
+    qreal *stateVecReal = qureg.stateVec.real;
+    qreal *stateVecImag = qureg.stateVec.imag;
+    qreal facReal = pairFac.real, facImag = pairFac.imag;
+    
+    // each pair is indexed by the task with a zero inserted at the highest bit of xMask
+    int pairBit = 0;
+    while (xMask >> (pairBit+1))
+        pairBit++;
+    
+    // the sign of the second of each pair differs from the first by (-1)^|xMask & zMask|
+    int pairSign = getBitMaskParity(xMask & zMask)? -1 : 1;
+    
+    long long int thisTask, indA, indB;
+    int signA, signB;
+    qreal reA, imA, reB, imB;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (offset,numTasks, stateVecReal,stateVecImag, ctrlMask,xMask,zMask, pairBit,pairSign, cosAngle,facReal,facImag) \
+    private  (thisTask,indA,indB, signA,signB, reA,imA,reB,imB)
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (thisTask=0; thisTask<numTasks; thisTask++) {
+            indA = insertZeroBit(thisTask, pairBit);
+            indB = indA ^ xMask;
+            
+            // pairs with not-all-one control qubits are unmodified (controls and targets are disjoint)
+            if (ctrlMask && ((ctrlMask & (indA + offset)) != ctrlMask))
+                continue;
+            
+            signA = getBitMaskParity(zMask & (indA + offset))? -1 : 1;
+            signB = signA * pairSign;
+            
+            reA = stateVecReal[AMP_INDEX(indA)];
+            imA = stateVecImag[AMP_INDEX(indA)];
+            reB = stateVecReal[AMP_INDEX(indB)];
+            imB = stateVecImag[AMP_INDEX(indB)];
+            
+            stateVecReal[AMP_INDEX(indA)] = cosAngle*reA + signA*(facReal*reB - facImag*imB);
+            stateVecImag[AMP_INDEX(indA)] = cosAngle*imA + signA*(facReal*imB + facImag*reB);
+            stateVecReal[AMP_INDEX(indB)] = cosAngle*reB + signB*(facReal*reA - facImag*imA);
+            stateVecImag[AMP_INDEX(indB)] = cosAngle*imB + signB*(facReal*imA + facImag*reA);
+        }
+    }
+}
+
+/** As statevec_multiControlledMultiRotatePauliLocal(), but where xMask targets qubits beyond 
+ * the chunk, such that every partner amplitude psi_{a ^ xMask} resides in pairStateVec (at the 
+ * local index given by the lower bits of xMask). Only the local amplitudes are updated.
+ */
+void statevec_multiControlledMultiRotatePauliDistributed(
+    Qureg qureg, long long int ctrlMask, long long int xMask, long long int zMask, 
+    qreal cosAngle, Complex pairFac, ComplexArray pairStateVec
+) {
+    long long int offset = qureg.chunkId * qureg.numAmpsPerChunk;
+    long long int numTasks = qureg.numAmpsPerChunk;
+    long long int localXMask = xMask & (numTasks - 1);
+    qreal *stateVecReal = qureg.stateVec.real;
+    qreal *stateVecImag = qureg.stateVec.imag;
+    qreal *pairVecReal = pairStateVec.real;
+    qreal *pairVecImag = pairStateVec.imag;
+    qreal facReal = pairFac.real, facImag = pairFac.imag;
+    
+    long long int thisTask, pairInd;
+    int sign;
+    qreal re, im, pairRe, pairIm;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (offset,numTasks,localXMask, stateVecReal,stateVecImag,pairVecReal,pairVecImag, ctrlMask,zMask, cosAngle,facReal,facImag) \
+    private  (thisTask,pairInd, sign, re,im,pairRe,pairIm)
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (thisTask=0; thisTask<numTasks; thisTask++) {
+            if (ctrlMask && ((ctrlMask & (thisTask + offset)) != ctrlMask))
+                continue;
+            
+            pairInd = thisTask ^ localXMask;
+            sign = getBitMaskParity(zMask & (thisTask + offset))? -1 : 1;
+            
+            re = stateVecReal[AMP_INDEX(thisTask)];
+            im = stateVecImag[AMP_INDEX(thisTask)];
+            pairRe = pairVecReal[AMP_INDEX(pairInd)];
+            pairIm = pairVecImag[AMP_INDEX(pairInd)];
+            
+            stateVecReal[AMP_INDEX(thisTask)] = cosAngle*re + sign*(facReal*pairRe - facImag*pairIm);
+            stateVecImag[AMP_INDEX(thisTask)] = cosAngle*im + sign*(facReal*pairIm + facImag*pairRe);
+        }
+    }
+}
+
+qreal densmatr_findProbabilityOfZeroLocal(Qureg qureg, int measureQubit) {
     
     // computes first local index containing a diagonal element
     long long int localNumAmps = qureg.numAmpsPerChunk;
@@ -3454,7 +4695,7 @@ qreal densmatr_findProbabilityOfZeroLocal(Qureg qureg, int measureQubit) {
             index = localIndNextDiag + diagSpacing * visitedDiags;
     
             if (extractBit(measureQubit, basisStateInd) == 0)
-                zeroProb += stateVecReal[index]; // assume imag[diagonls] ~ 0
+                zeroProb += stateVecReal[AMP_INDEX(index)]; // assume imag[diagonls] ~ 0
 
         }
     }
@@ -3508,11 +4749,11 @@ qreal statevec_findProbabilityOfZeroLocal (Qureg qureg,
 # pragma omp for schedule  (static)
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
-            thisBlock = thisTask / sizeHalfBlock;
-            index     = thisBlock*sizeBlock + thisTask%sizeHalfBlock;
+            thisBlock = thisTask >> measureQubit; // thisTask / sizeHalfBlock
+            index     = thisBlock*sizeBlock + (thisTask&(sizeHalfBlock-1));
 
-            totalProbability += stateVecReal[index]*stateVecReal[index]
-                + stateVecImag[index]*stateVecImag[index];
+            totalProbability += stateVecReal[AMP_INDEX(index)]*stateVecReal[AMP_INDEX(index)]
+                + stateVecImag[AMP_INDEX(index)]*stateVecImag[AMP_INDEX(index)];
         }
     }
     return totalProbability;
@@ -3553,149 +4794,942 @@ qreal statevec_findProbabilityOfZeroDistributed (Qureg qureg) {
 # pragma omp for schedule  (static)
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
-            totalProbability += stateVecReal[thisTask]*stateVecReal[thisTask]
-                + stateVecImag[thisTask]*stateVecImag[thisTask];
+            totalProbability += stateVecReal[AMP_INDEX(thisTask)]*stateVecReal[AMP_INDEX(thisTask)]
+                + stateVecImag[AMP_INDEX(thisTask)]*stateVecImag[AMP_INDEX(thisTask)];
         }
     }
 
     return totalProbability;
 }
 
+/** Populates lookup tables which map each byte of a basis state index to its contribution 
+ * to the outcome index of the given qubits, such that the outcome index of basis state i is
+ * the bitwise OR of tables[b][(i >> shifts[b]) & 255] over every b < the returned number of 
+ * tables. Only the bytes containing a qubit in qubits receive a table, so few qubits need
+ * few lookups.
+ */
+static int populateOutcomeIndexTables(int* qubits, int numQubits, long long int tables[][256], int* shifts) {
+    
+    int numTables = 0;
+    int byteTable[8]; // [8] byte -> table (or -1)
+    for (int b=0; b<8; b++)
+        byteTable[b] = -1;
+    
+    for (int q=0; q<numQubits; q++) {
+        int byte = qubits[q] >> 3;
+        if (byteTable[byte] == -1) {
+            byteTable[byte] = numTables;
+            shifts[numTables] = 8*byte;
+            for (int v=0; v<256; v++)
+                tables[numTables][v] = 0;
+            numTables++;
+        }
+        
+        long long int* table = tables[byteTable[byte]];
+        int bit = qubits[q] & 7;
+        for (int v=0; v<256; v++)
+            table[v] |= ((long long int) extractBit(bit, v)) << q;
+    }
+    return numTables;
+}
+
+/** Returns the number of private outcome histograms (beyond outcomeProbs itself, which the 
+ * first thread populates) into which threads accumulate, before they're summed into outcomeProbs.
+ * This is 0 when it is cheaper for every thread to atomically update outcomeProbs, i.e. when
+ * the histograms would be larger than the numTasks contributions which fill them.
+ */
+static int getNumPrivateOutcomeHistograms(long long int numOutcomeProbs, long long int numTasks) {
+    
+    int numThreads = 1;
+# ifdef _OPENMP
+    numThreads = omp_get_max_threads();
+# endif
+    if (numThreads * numOutcomeProbs > numTasks)
+        return 0;
+    return numThreads - 1;
+}
+
+/** Adds the numHists private histograms in hists into outcomeProbs */
+static void mergeOutcomeHistograms(qreal* outcomeProbs, long long int numOutcomeProbs, qreal* hists, int numHists) {
+    
+    long long int j;
+    int h;
+
+# ifdef _OPENMP
+# pragma omp parallel for schedule (static) \
+    default  (none) \
+    shared   (outcomeProbs,numOutcomeProbs, hists,numHists) \
+    private  (j, h)
+# endif
+    for (j=0; j<numOutcomeProbs; j++)
+        for (h=0; h<numHists; h++)
+            outcomeProbs[j] += hists[h*numOutcomeProbs + j];
+}
+
 void statevec_calcProbOfAllOutcomesLocal(qreal* outcomeProbs, Qureg qureg, int* qubits, int numQubits) {
     
-    /* Below, we manually reduce amplitudes into outcomeProbs by using atomic update.
+    /* Below, each thread accumulates into its own (zero-initialised) private histogram of outcomes 
+     * (the first thread using outcomeProbs itself), which are summed once all amplitudes are visited. 
+     * This avoids contention upon the same few elements when there are few outcomes.
+     * When the histograms would be larger than the state itself, we instead manually reduce 
+     * amplitudes into outcomeProbs by using atomic update. 
      * This maintains OpenMP 3.1 compatibility. An alternative is to use array reduction 
      * (requires OpenMP 4.5, limits #qubits since outcomeProbs must be a local stack array)
      * or a dynamic list of omp locks (duplicates memory cost of outcomeProbs).
-     * Using locks was always slower than the method below. Using reduction was only 
-     * faster for very few threads, or very few outcomeProbs.
+     * Using locks was always slower than the atomic method. 
      * Finally, we exclude the 'update' clause after 'atomic' to maintain MSVC compatibility 
      */
 
-    long long int numOutcomeProbs = (1 << numQubits);
-    long long int j;
+    long long int numOutcomeProbs = (1LL << numQubits);
+    long long int numTasks = qureg.numAmpsPerChunk;
+    long long int offset = qureg.chunkId*qureg.numAmpsPerChunk;
+    qreal* stateRe = qureg.stateVec.real;
+    qreal* stateIm = qureg.stateVec.imag;
+    
+    // the outcome index of each amplitude is gathered from its bytes
+    long long int tables[8][256];
+    int shifts[8];
+    int numTables = populateOutcomeIndexTables(qubits, numQubits, tables, shifts);
+    
+    int numHists = getNumPrivateOutcomeHistograms(numOutcomeProbs, numTasks);
+    qreal* hists = (numHists > 0)? calloc(numHists * numOutcomeProbs, sizeof *hists) : NULL;
+    
+    long long int i, j;
+    long long int outcomeInd;
+    int b, threadId;
+    qreal prob;
+    qreal* hist;
     
-    // clear outcomeProbs (in parallel, in case it's large)
 # ifdef _OPENMP
 # pragma omp parallel \
-    default (none) \
-    shared    (numOutcomeProbs,outcomeProbs) \
-    private   (j)
+    default  (none) \
+    shared    (numTasks,offset, numOutcomeProbs,outcomeProbs, stateRe,stateIm, tables,shifts,numTables, numHists,hists) \
+    private   (i, j, b, outcomeInd, prob, threadId, hist)
 # endif 
     {
+        threadId = 0;
+# ifdef _OPENMP
+        threadId = omp_get_thread_num();
+# endif
+        // the first thread accumulates directly into outcomeProbs (when there are private histograms)
+        hist = outcomeProbs;
+        if (numHists > 0 && threadId > 0)
+            hist = &hists[(threadId-1)*numOutcomeProbs];
+        
+        // clear outcomeProbs (in parallel, in case it's large)
 # ifdef _OPENMP
 # pragma omp for schedule  (static)
 # endif
-        for (j=0; j<numOutcomeProbs; j++)
-            outcomeProbs[j] = 0;
-    }   
+        for (j=0; j<numOutcomeProbs; j++)
+            outcomeProbs[j] = 0;
+        
+# ifdef _OPENMP
+# pragma omp for schedule  (static)
+# endif
+        // every amplitude contributes to a single element of retProbs
+        for (i=0; i<numTasks; i++) {
+            
+            // determine index informed by qubits outcome
+            outcomeInd = 0;
+            for (b=0; b<numTables; b++)
+                outcomeInd |= tables[b][((i + offset) >> shifts[b]) & 255];
+            
+            prob = stateRe[AMP_INDEX(i)]*stateRe[AMP_INDEX(i)] + stateIm[AMP_INDEX(i)]*stateIm[AMP_INDEX(i)];
+            
+            if (numHists > 0)
+                hist[outcomeInd] += prob;
+            else {
+                // atomicly update corresponding outcome array element
+                # ifdef _OPENMP
+                # pragma omp atomic
+                # endif
+                outcomeProbs[outcomeInd] += prob;
+            }
+        }
+    }
+    
+    if (numHists > 0) {
+        mergeOutcomeHistograms(outcomeProbs, numOutcomeProbs, hists, numHists);
+        free(hists);
+    }
+}
+
+void densmatr_calcProbOfAllOutcomesLocal(qreal* outcomeProbs, Qureg qureg, int* qubits, int numQubits) {
+    
+    long long int numOutcomeProbs = (1LL << numQubits);
+    
+    // compute first local index containing a diagonal element
+    long long int localNumAmps = qureg.numAmpsPerChunk;
+    long long int densityDim = (1LL << qureg.numQubitsRepresented);
+    long long int diagSpacing = 1LL + densityDim;
+    long long int maxNumDiagsPerChunk = 1 + localNumAmps / diagSpacing;
+    long long int numPrevDiags = (qureg.chunkId>0)? 1+(qureg.chunkId*localNumAmps)/diagSpacing : 0;
+    long long int globalIndNextDiag = diagSpacing * numPrevDiags;
+    long long int localIndNextDiag = globalIndNextDiag % localNumAmps;
+    
+    // computes how many diagonals are contained in this chunk
+    long long int numDiagsInThisChunk = maxNumDiagsPerChunk;
+    if (localIndNextDiag + (numDiagsInThisChunk-1)*diagSpacing >= localNumAmps)
+        numDiagsInThisChunk -= 1;
+        
+    long long int visitedDiags;     // number of visited diagonals in this chunk so far
+    long long int basisStateInd;    // current diagonal index being considered
+    long long int index;            // index in the local chunk
+    
+    // the outcome index of each diagonal is gathered from the bytes of its basis state
+    long long int tables[8][256];
+    int shifts[8];
+    int numTables = populateOutcomeIndexTables(qubits, numQubits, tables, shifts);
+    
+    // threads accumulate into private histograms, as per statevec_calcProbOfAllOutcomesLocal
+    int numHists = getNumPrivateOutcomeHistograms(numOutcomeProbs, numDiagsInThisChunk);
+    qreal* hists = (numHists > 0)? calloc(numHists * numOutcomeProbs, sizeof *hists) : NULL;
+    
+    int b, threadId;
+    long long int j, outcomeInd;
+    qreal *stateRe = qureg.stateVec.real;
+    qreal* hist;
+    
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared    (localIndNextDiag, numPrevDiags, diagSpacing, stateRe, numDiagsInThisChunk, tables,shifts,numTables, numOutcomeProbs,outcomeProbs, numHists,hists) \
+    private   (visitedDiags, basisStateInd, index, b,j,outcomeInd, threadId,hist)
+# endif 
+    {
+        threadId = 0;
+# ifdef _OPENMP
+        threadId = omp_get_thread_num();
+# endif
+        hist = outcomeProbs;
+        if (numHists > 0 && threadId > 0)
+            hist = &hists[(threadId-1)*numOutcomeProbs];
+        
+        // clear outcomeProbs (in parallel, in case it's large)
+# ifdef _OPENMP
+# pragma omp for schedule  (static)
+# endif
+        for (j=0; j<numOutcomeProbs; j++)
+            outcomeProbs[j] = 0;
+        
+# ifdef _OPENMP
+# pragma omp for schedule  (static)
+# endif
+        // sums the diagonal elems of the density matrix where measureQubit=0
+        for (visitedDiags = 0; visitedDiags < numDiagsInThisChunk; visitedDiags++) {
+            
+            basisStateInd = numPrevDiags + visitedDiags;
+            index = localIndNextDiag + diagSpacing * visitedDiags;
+            
+            // determine outcome implied by basisStateInd
+            outcomeInd = 0;
+            for (b=0; b<numTables; b++)
+                outcomeInd |= tables[b][(basisStateInd >> shifts[b]) & 255];
+            
+            if (numHists > 0)
+                hist[outcomeInd] += stateRe[AMP_INDEX(index)];
+            else {
+                // atomicly update corresponding outcome array element
+                # ifdef _OPENMP
+                # pragma omp atomic
+                # endif
+                outcomeProbs[outcomeInd] += stateRe[AMP_INDEX(index)];
+            }
+        }
+    }
+    
+    if (numHists > 0) {
+        mergeOutcomeHistograms(outcomeProbs, numOutcomeProbs, hists, numHists);
+        free(hists);
+    }
+}
+
+/** Returns a malloc'd array of the running sum of the numProbs probabilities, where the k-th 
+ * is |amp|^2 (or only the real component, when stateIm is NULL) of the local amplitude with 
+ * index firstInd + k*stride. Each thread sums a contiguous block, before offsetting it by 
+ * the totals of the preceding blocks.
+ */
+static qreal* createCumulativeProbs(
+    long long int numProbs, qreal* stateRe, qreal* stateIm, long long int firstInd, long long int stride
+) {
+    qreal* cumProbs = malloc((numProbs > 0? numProbs : 1) * sizeof *cumProbs);
+
+    int maxNumThreads = 1;
+# ifdef _OPENMP
+    maxNumThreads = omp_get_max_threads();
+# endif
+    qreal* blockTotals = malloc(maxNumThreads * sizeof *blockTotals);
+
+    long long int k, ind, blockSize, blockStart, blockEnd;
+    int threadId, numThreads, b;
+    qreal sum, offset;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (cumProbs,numProbs, stateRe,stateIm, firstInd,stride, blockTotals) \
+    private  (k,ind, blockSize,blockStart,blockEnd, threadId,numThreads,b, sum,offset)
+# endif
+    {
+        threadId = 0;
+        numThreads = 1;
+# ifdef _OPENMP
+        threadId = omp_get_thread_num();
+        numThreads = omp_get_num_threads();
+# endif
+        blockSize = (numProbs + numThreads - 1) / numThreads;
+        blockStart = threadId * blockSize;
+        blockEnd = (blockStart + blockSize < numProbs)? blockStart + blockSize : numProbs;
+        
+        // each thread computes the running sum of its own block
+        sum = 0;
+        for (k=blockStart; k<blockEnd; k++) {
+            ind = firstInd + k*stride;
+            if (stateIm == NULL)
+                sum += stateRe[AMP_INDEX(ind)];
+            else
+                sum += stateRe[AMP_INDEX(ind)]*stateRe[AMP_INDEX(ind)] + stateIm[AMP_INDEX(ind)]*stateIm[AMP_INDEX(ind)];
+            cumProbs[k] = sum;
+        }
+        blockTotals[threadId] = sum;
+        
+# ifdef _OPENMP
+# pragma omp barrier
+# endif
+        // and then adds the totals of all preceding blocks
+        offset = 0;
+        for (b=0; b<threadId; b++)
+            offset += blockTotals[b];
+        for (k=blockStart; k<blockEnd; k++)
+            cumProbs[k] += offset;
+    }
+    
+    free(blockTotals);
+    return cumProbs;
+}
+
+qreal* statevec_createCumulativeProbsLocal(Qureg qureg, long long int* numProbs, long long int* firstBasisInd) {
+    
+    *numProbs = qureg.numAmpsPerChunk;
+    *firstBasisInd = qureg.chunkId*qureg.numAmpsPerChunk;
+    return createCumulativeProbs(*numProbs, qureg.stateVec.real, qureg.stateVec.imag, 0, 1);
+}
+
+/** Sets numDiags to the number of diagonal elements of density matrix qureg stored in this chunk,
+ * firstBasisInd to the basis state (row) of the first, and firstLocalInd to its local index 
+ */
+static void getLocalDiagonals(Qureg qureg, long long int* numDiags, long long int* firstBasisInd, long long int* firstLocalInd) {
+    
+    // compute first local index containing a diagonal element
+    long long int localNumAmps = qureg.numAmpsPerChunk;
+    long long int densityDim = (1LL << qureg.numQubitsRepresented);
+    long long int diagSpacing = 1LL + densityDim;
+    long long int maxNumDiagsPerChunk = 1 + localNumAmps / diagSpacing;
+    long long int numPrevDiags = (qureg.chunkId>0)? 1+(qureg.chunkId*localNumAmps)/diagSpacing : 0;
+    long long int globalIndNextDiag = diagSpacing * numPrevDiags;
+    long long int localIndNextDiag = globalIndNextDiag % localNumAmps;
+    
+    // computes how many diagonals are contained in this chunk
+    long long int numDiagsInThisChunk = maxNumDiagsPerChunk;
+    if (localIndNextDiag + (numDiagsInThisChunk-1)*diagSpacing >= localNumAmps)
+        numDiagsInThisChunk -= 1;
+    
+    *numDiags = numDiagsInThisChunk;
+    *firstBasisInd = numPrevDiags;
+    *firstLocalInd = localIndNextDiag;
+}
+
+qreal* densmatr_createCumulativeProbsLocal(Qureg qureg, long long int* numProbs, long long int* firstBasisInd) {
+    
+    long long int firstLocalInd;
+    getLocalDiagonals(qureg, numProbs, firstBasisInd, &firstLocalInd);
+    
+    // only the real components of the diagonal elements are consulted
+    long long int diagSpacing = 1LL + (1LL << qureg.numQubitsRepresented);
+    return createCumulativeProbs(*numProbs, qureg.stateVec.real, NULL, firstLocalInd, diagSpacing);
+}
+
+/* the number of lowest qubits whose every outcome is tallied by calcQubitCorrelationSums() */
+# define CORRELATION_BLOCK_QUBITS 8
+
+/** Populates sums with the total probability (sums[0]), the probability that each qubit q is 1
+ * (sums[1+q]) and, if calcPairs, the probability that qubits q1 and q2 are both 1 
+ * (sums[1+numQubits + q1*numQubits + q2]), among the numProbs basis states beginning at 
+ * firstBasisInd. The k-th has probability |amp|^2 (or only the real component, when stateIm 
+ * is NULL) of the local amplitude with index firstInd + k*stride.
+ *
+ * Basis states are visited in blocks which share all but their lowest CORRELATION_BLOCK_QUBITS 
+ * bits. Each thread sums every block into a histogram of the lower bits, which after the sweep
+ * yields all sums involving only lower qubits. The total probability of each block is added to 
+ * the sums of its (set) upper qubits and pairs thereof, and when calcPairs, its probabilities 
+ * are added to a further histogram per set upper qubit, which yields the sums of mixed pairs.
+ * Hence each amplitude is read once, and costs O(1) (or O(numQubits) contiguous additions, 
+ * when calcPairs) rather than O(numQubits^2).
+ */
+static void calcQubitCorrelationSums(
+    qreal* sums, int numQubits, int calcPairs, long long int numProbs, long long int firstBasisInd, 
+    qreal* stateRe, qreal* stateIm, long long int firstInd, long long int stride
+) {
+    int numLow = (numQubits < CORRELATION_BLOCK_QUBITS)? numQubits : CORRELATION_BLOCK_QUBITS;
+    int numHigh = numQubits - numLow;
+    int numHighHists = calcPairs? numHigh : 0;
+    long long int blockSize = 1LL << numLow;
+    
+    // each thread's workspace is its low-bit histogram, its upper-qubit histograms, a buffer
+    // of the probabilities of its current block, the sums of upper qubits and of upper pairs
+    long long int workSize = (2 + numHighHists)*blockSize + numHigh + numHighHists*numHigh;
+    int maxNumThreads = 1;
+# ifdef _OPENMP
+    maxNumThreads = omp_get_max_threads();
+# endif
+    qreal* works = calloc(maxNumThreads * workSize, sizeof *works);
+    
+    long long int firstBlock = firstBasisInd >> numLow;
+    long long int numBlocks = (numProbs > 0)? 1 + ((firstBasisInd + numProbs - 1) >> numLow) - firstBlock : 0;
+    long long int endBasisInd = firstBasisInd + numProbs;
+    
+    long long int b, blockInd, basisStart, basisEnd, basisInd, ind, k;
+    int threadId, j, j2;
+    qreal blockTotal, prob;
+    qreal *work, *lowHist, *highHists, *blockProbs, *highSums, *highPairSums, *hist;
+    
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (works,workSize, numLow,numHigh,numHighHists,blockSize, firstBlock,numBlocks, \
+                firstBasisInd,endBasisInd, stateRe,stateIm, firstInd,stride) \
+    private  (b,blockInd,basisStart,basisEnd,basisInd,ind,k, threadId,j,j2, blockTotal,prob, \
+                work,lowHist,highHists,blockProbs,highSums,highPairSums,hist)
+# endif
+    {
+        threadId = 0;
+# ifdef _OPENMP
+        threadId = omp_get_thread_num();
+# endif
+        work = &works[threadId * workSize];
+        lowHist = work;
+        highHists = &lowHist[blockSize];
+        blockProbs = &highHists[numHighHists*blockSize];
+        highSums = &blockProbs[blockSize];
+        highPairSums = &highSums[numHigh];
+        
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (b=0; b<numBlocks; b++) {
+            
+            // the (possibly partial, at the ends of the chunk) range of basis states in this block
+            blockInd = firstBlock + b;
+            basisStart = blockInd << numLow;
+            basisEnd = basisStart + blockSize;
+            if (basisStart < firstBasisInd || basisEnd > endBasisInd)
+                for (k=0; k<blockSize; k++)
+                    blockProbs[k] = 0;
+            if (basisStart < firstBasisInd)
+                basisStart = firstBasisInd;
+            if (basisEnd > endBasisInd)
+                basisEnd = endBasisInd;
+            
+            // read every amplitude in the block once
+            blockTotal = 0;
+            for (basisInd=basisStart; basisInd<basisEnd; basisInd++) {
+                ind = firstInd + (basisInd - firstBasisInd)*stride;
+                if (stateIm == NULL)
+                    prob = stateRe[AMP_INDEX(ind)];
+                else
+                    prob = stateRe[AMP_INDEX(ind)]*stateRe[AMP_INDEX(ind)] + stateIm[AMP_INDEX(ind)]*stateIm[AMP_INDEX(ind)];
+                blockProbs[basisInd & (blockSize-1)] = prob;
+                blockTotal += prob;
+            }
+            for (k=0; k<blockSize; k++)
+                lowHist[k] += blockProbs[k];
+            
+            // the upper qubits (numLow + j) are fixed throughout the block
+            for (j=0; j<numHigh; j++) {
+                if (!extractBit(j, blockInd))
+                    continue;
+                highSums[j] += blockTotal;
+                if (numHighHists == 0)
+                    continue;
+                for (j2=j+1; j2<numHigh; j2++)
+                    if (extractBit(j2, blockInd))
+                        highPairSums[j*numHigh + j2] += blockTotal;
+                hist = &highHists[j*blockSize];
+                for (k=0; k<blockSize; k++)
+                    hist[k] += blockProbs[k];
+            }
+        }
+    }
+    
+    // merge every thread's workspace into the first's
+    for (int t=1; t<maxNumThreads; t++)
+        for (k=0; k<workSize; k++)
+            works[k] += works[t*workSize + k];
+    lowHist = works;
+    highHists = &lowHist[blockSize];
+    highSums = &highHists[numHighHists*blockSize + blockSize];
+    highPairSums = &highSums[numHigh];
+    
+    // resolve the total and single-qubit sums
+    for (int q=0; q<1+numQubits; q++)
+        sums[q] = 0;
+    for (k=0; k<blockSize; k++) {
+        sums[0] += lowHist[k];
+        for (int q=0; q<numLow; q++)
+            if (extractBit(q, k))
+                sums[1+q] += lowHist[k];
+    }
+    for (j=0; j<numHigh; j++)
+        sums[1+numLow+j] = highSums[j];
+    
+    if (!calcPairs) {
+        free(works);
+        return;
+    }
+    
+    // resolve the pair sums (of which the diagonal are the single-qubit sums)
+    qreal* pairSums = &sums[1+numQubits];
+    for (int q1=0; q1<numQubits; q1++) {
+        pairSums[q1*numQubits + q1] = sums[1+q1];
+        for (int q2=q1+1; q2<numQubits; q2++) {
+            qreal sum = 0;
+            if (q2 < numLow) {
+                for (k=0; k<blockSize; k++)
+                    if (extractBit(q1, k) && extractBit(q2, k))
+                        sum += lowHist[k];
+            }
+            else if (q1 < numLow) {
+                hist = &highHists[(q2-numLow)*blockSize];
+                for (k=0; k<blockSize; k++)
+                    if (extractBit(q1, k))
+                        sum += hist[k];
+            }
+            else
+                sum = highPairSums[(q1-numLow)*numHigh + (q2-numLow)];
+            
+            pairSums[q1*numQubits + q2] = sum;
+            pairSums[q2*numQubits + q1] = sum;
+        }
+    }
+    free(works);
+}
+
+void statevec_calcQubitCorrelationSumsLocal(Qureg qureg, qreal* sums, int calcPairs) {
+    
+    calcQubitCorrelationSums(
+        sums, qureg.numQubitsRepresented, calcPairs, qureg.numAmpsPerChunk, qureg.chunkId*qureg.numAmpsPerChunk,
+        qureg.stateVec.real, qureg.stateVec.imag, 0, 1);
+}
+
+void densmatr_calcQubitCorrelationSumsLocal(Qureg qureg, qreal* sums, int calcPairs) {
+    
+    long long int numDiags, firstBasisInd, firstLocalInd;
+    getLocalDiagonals(qureg, &numDiags, &firstBasisInd, &firstLocalInd);
+    
+    // only the real components of the diagonal elements are consulted
+    long long int diagSpacing = 1LL + (1LL << qureg.numQubitsRepresented);
+    calcQubitCorrelationSums(
+        sums, qureg.numQubitsRepresented, calcPairs, numDiags, firstBasisInd, 
+        qureg.stateVec.real, NULL, firstLocalInd, diagSpacing);
+}
+
+/** Populates inds and probs with the k most probable of the numProbs basis states beginning at 
+ * firstBasisInd, in decreasing probability (and increasing index among equal probabilities), 
+ * padded with index -1 when numProbs < k. The i-th has probability |amp|^2 (or only the real 
+ * component, when stateIm is NULL) of the local amplitude with index firstInd + i*stride. 
+ * Each thread retains its own most probable k in a bounded min-heap, and the heaps are merged 
+ * once all amplitudes are visited, so that only O(k * numThreads) memory is needed.
+ */
+static void findTopOutcomes(
+    int k, long long int* inds, qreal* probs, long long int numProbs, long long int firstBasisInd,
+    qreal* stateRe, qreal* stateIm, long long int firstInd, long long int stride
+) {
+    int maxNumThreads = 1;
+# ifdef _OPENMP
+    maxNumThreads = omp_get_max_threads();
+# endif
+    long long int* heapInds = malloc(maxNumThreads * k * sizeof *heapInds);
+    qreal* heapProbs = malloc(maxNumThreads * k * sizeof *heapProbs);
+    
+    // unused heap elements are ignored when merged
+    for (long long int i=0; i<maxNumThreads * (long long int) k; i++)
+        heapInds[i] = -1;
+    
+    long long int i, ind;
+    long long int *threadInds;
+    qreal *threadProbs;
+    int threadId, heapSize;
+    qreal prob;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (k, numProbs,firstBasisInd, stateRe,stateIm, firstInd,stride, heapInds,heapProbs) \
+    private  (i,ind, threadInds,threadProbs, threadId,heapSize, prob)
+# endif
+    {
+        threadId = 0;
+# ifdef _OPENMP
+        threadId = omp_get_thread_num();
+# endif
+        threadInds = &heapInds[threadId * (long long int) k];
+        threadProbs = &heapProbs[threadId * (long long int) k];
+        heapSize = 0;
+        
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (i=0; i<numProbs; i++) {
+            ind = firstInd + i*stride;
+            if (stateIm == NULL)
+                prob = stateRe[AMP_INDEX(ind)];
+            else
+                prob = stateRe[AMP_INDEX(ind)]*stateRe[AMP_INDEX(ind)] + stateIm[AMP_INDEX(ind)]*stateIm[AMP_INDEX(ind)];
+            
+            // since indices increase, a full heap rejects any outcome no more probable than its least
+            if (heapSize == k && prob <= threadProbs[0])
+                continue;
+            offerTopOutcome(threadInds, threadProbs, &heapSize, k, firstBasisInd + i, prob);
+        }
+    }
+    
+    selectTopOutcomes(heapInds, heapProbs, maxNumThreads * (long long int) k, k, inds, probs);
+    free(heapInds);
+    free(heapProbs);
+}
+
+void statevec_findTopOutcomesLocal(Qureg qureg, int k, long long int* inds, qreal* probs) {
+    
+    findTopOutcomes(
+        k, inds, probs, qureg.numAmpsPerChunk, qureg.chunkId*qureg.numAmpsPerChunk,
+        qureg.stateVec.real, qureg.stateVec.imag, 0, 1);
+}
+
+void densmatr_findTopOutcomesLocal(Qureg qureg, int k, long long int* inds, qreal* probs) {
+    
+    long long int numDiags, firstBasisInd, firstLocalInd;
+    getLocalDiagonals(qureg, &numDiags, &firstBasisInd, &firstLocalInd);
+    
+    // only the real components of the diagonal elements are consulted
+    long long int diagSpacing = 1LL + (1LL << qureg.numQubitsRepresented);
+    findTopOutcomes(
+        k, inds, probs, numDiags, firstBasisInd, 
+        qureg.stateVec.real, NULL, firstLocalInd, diagSpacing);
+}
+
+/* the number of amplitudes within which every Pauli string of a batch is evaluated, before 
+ * proceeding to the next, so that each is loaded from memory once per batch (must be a power of 2) */
+# define PAULI_STRING_BLOCK_SIZE 4096
+
+/** Returns the real component of (-i)^numY (sumRe + i sumIm), which is the expected value of 
+ * a Pauli string with numY Y operators, given the sum of its sign-adjusted elements
+ */
+static qreal getRealPauliStringExpec(long long int xMask, long long int zMask, qreal sumRe, qreal sumIm) {
+    
+    int numY = 0;
+    for (long long int yMask = xMask & zMask; yMask; yMask &= yMask-1)
+        numY++;
+    
+    switch (numY % 4) {
+        case 0: return  sumRe;
+        case 1: return  sumIm;
+        case 2: return -sumRe;
+        default: return -sumIm;
+    }
+}
+
+/** Adds to each expecs[t] the local contribution to the expected value of the Pauli string 
+ * with X or Y upon the qubits of xMasks[t] and Y or Z upon zMasks[t], which is 
+ * Re[ (-i)^numY sum_a (-1)^|a & zMask| conj(psi_a) psi_{a ^ xMask} ]. The upper bits of every 
+ * xMasks[t] (beyond the chunk) must be identical, such that pairRe and pairIm are the amplitudes 
+ * of the chunk containing every psi_{a ^ xMask}; they are the local amplitudes when those bits 
+ * are zero. The state is only read, and in blocks of PAULI_STRING_BLOCK_SIZE amplitudes, within 
+ * which every string is evaluated, so that the whole batch costs a single sweep of memory.
+ */
+void statevec_calcExpecPauliStringsLocal(
+    Qureg qureg, qreal* pairRe, qreal* pairIm, 
+    long long int* xMasks, long long int* zMasks, int numStrings, qreal* expecs
+) {
+    long long int numAmps = qureg.numAmpsPerChunk;
+    long long int globalOffset = qureg.chunkId*numAmps;
+    long long int localMask = numAmps - 1;
+    long long int blockSize = (numAmps < PAULI_STRING_BLOCK_SIZE)? numAmps : PAULI_STRING_BLOCK_SIZE;
+    long long int numBlocks = numAmps / blockSize;
+    qreal* stateRe = qureg.stateVec.real;
+    qreal* stateIm = qureg.stateVec.imag;
+    
+    // each thread accumulates the real and imaginary sums of every string
+    int maxNumThreads = 1;
+# ifdef _OPENMP
+    maxNumThreads = omp_get_max_threads();
+# endif
+    qreal* sums = calloc(2 * maxNumThreads * (long long int) numStrings, sizeof *sums);
+    
+    long long int b, blockStart, i, j, xMask, zMask;
+    int threadId, t, baseParity;
+    qreal *threadSums, sumRe, sumIm, reI, imI, reJ, imJ, sign;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (numAmps,globalOffset,localMask,blockSize,numBlocks, stateRe,stateIm,pairRe,pairIm, xMasks,zMasks,numStrings, sums) \
+    private  (b,blockStart,i,j,xMask,zMask, threadId,t,baseParity, threadSums,sumRe,sumIm,reI,imI,reJ,imJ,sign)
+# endif
+    {
+        threadId = 0;
+# ifdef _OPENMP
+        threadId = omp_get_thread_num();
+# endif
+        threadSums = &sums[2 * threadId * (long long int) numStrings];
+        
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (b=0; b<numBlocks; b++) {
+            blockStart = b*blockSize;
+            
+            for (t=0; t<numStrings; t++) {
+                xMask = xMasks[t] & localMask;
+                zMask = zMasks[t];
+                
+                // the parity of the (aligned) upper bits is fixed throughout the block
+                baseParity = getBitMaskParity(zMask & (globalOffset + blockStart));
+                zMask &= blockSize - 1;
+                
+                sumRe = 0;
+                sumIm = 0;
+                for (i=blockStart; i<blockStart+blockSize; i++) {
+                    j = i ^ xMask;
+                    reI = stateRe[AMP_INDEX(i)];
+                    imI = stateIm[AMP_INDEX(i)];
+                    reJ = pairRe[AMP_INDEX(j)];
+                    imJ = pairIm[AMP_INDEX(j)];
+                    
+                    // conj(psi_i) psi_j
+                    sign = (baseParity ^ getBitMaskParity(zMask & i))? -1 : 1;
+                    sumRe += sign * (reI*reJ + imI*imJ);
+                    sumIm += sign * (reI*imJ - imI*reJ);
+                }
+                threadSums[2*t] += sumRe;
+                threadSums[2*t+1] += sumIm;
+            }
+        }
+    }
     
-    long long int numTasks = qureg.numAmpsPerChunk;
-    long long int offset = qureg.chunkId*qureg.numAmpsPerChunk;
+    for (t=0; t<numStrings; t++) {
+        sumRe = 0;
+        sumIm = 0;
+        for (threadId=0; threadId<maxNumThreads; threadId++) {
+            sumRe += sums[2 * (threadId * (long long int) numStrings + t)];
+            sumIm += sums[2 * (threadId * (long long int) numStrings + t) + 1];
+        }
+        expecs[t] += getRealPauliStringExpec(xMasks[t], zMasks[t], sumRe, sumIm);
+    }
+    free(sums);
+}
+
+/** Adds to each expecs[t] the local contribution to Tr(P rho) of the Pauli string P described
+ * by xMasks[t] and zMasks[t], which is Re[ (-i)^numY sum_c (-1)^|c & zMask| rho_{c ^ xMask, c} ].
+ * Only the one element per column which contributes is read, so no workspace nor communication
+ * is needed, and the cost is O(2^numQubits) rather than O(4^numQubits) per string.
+ */
+void densmatr_calcExpecPauliStringsLocal(
+    Qureg qureg, long long int* xMasks, long long int* zMasks, int numStrings, qreal* expecs
+) {
+    int numQubits = qureg.numQubitsRepresented;
+    long long int firstLocalInd = qureg.chunkId*qureg.numAmpsPerChunk;
+    long long int endLocalInd = firstLocalInd + qureg.numAmpsPerChunk;
+    long long int firstCol = firstLocalInd >> numQubits;
+    long long int endCol = ((endLocalInd - 1) >> numQubits) + 1;
     qreal* stateRe = qureg.stateVec.real;
     qreal* stateIm = qureg.stateVec.imag;
     
-    long long int i;
-    long long int outcomeInd;
-    int q;
-    qreal prob;
+    long long int c, ind, xMask, zMask;
+    qreal sumRe, sumIm, sign;
     
+    for (int t=0; t<numStrings; t++) {
+        xMask = xMasks[t];
+        zMask = zMasks[t];
+        sumRe = 0;
+        sumIm = 0;
+        
 # ifdef _OPENMP
 # pragma omp parallel \
-    shared    (numTasks,offset, qubits,numQubits, stateRe,stateIm, outcomeProbs) \
-    private   (i, q, outcomeInd, prob)
-# endif 
-    {
+    default  (none) \
+    shared   (numQubits,firstLocalInd,endLocalInd,firstCol,endCol, stateRe,stateIm, xMask,zMask) \
+    private  (c,ind,sign) \
+    reduction ( +:sumRe,sumIm )
+# endif
+        {
 # ifdef _OPENMP
-# pragma omp for schedule  (static)
+# pragma omp for schedule (static)
 # endif
-        // every amplitude contributes to a single element of retProbs
-        for (i=0; i<numTasks; i++) {
-            
-            // determine index informed by qubits outcome
-            outcomeInd = 0;
-            for (q=0; q<numQubits; q++)
-                outcomeInd += extractBit(qubits[q], i + offset) * (1LL << q);
-            
-            prob = stateRe[i]*stateRe[i] + stateIm[i]*stateIm[i];
-            
-            // atomicly update corresponding outcome array element
-            # ifdef _OPENMP
-            # pragma omp atomic
-            # endif
-            outcomeProbs[outcomeInd] += prob;
+            for (c=firstCol; c<endCol; c++) {
+                
+                // the element (c ^ xMask, c) may reside in another chunk, when columns are split
+                ind = (c ^ xMask) + (c << numQubits);
+                if (ind < firstLocalInd || ind >= endLocalInd)
+                    continue;
+                
+                sign = getBitMaskParity(zMask & c)? -1 : 1;
+                sumRe += sign * stateRe[AMP_INDEX(ind - firstLocalInd)];
+                sumIm += sign * stateIm[AMP_INDEX(ind - firstLocalInd)];
+            }
         }
+        expecs[t] += getRealPauliStringExpec(xMask, zMask, sumRe, sumIm);
     }
 }
 
-void densmatr_calcProbOfAllOutcomesLocal(qreal* outcomeProbs, Qureg qureg, int* qubits, int numQubits) {
+/** Adds to outQureg the local contribution of the groups of Pauli strings sharing X masks 
+ * groupXMasks[g], i.e. out_a += sum_g d_g(a) psi_{a ^ xMask_g}, where the diagonal 
+ * d_g(a) = sum_t termCoeffs[t] (-1)^|a & termZMasks[t]| sums the terms (of index 
+ * groupStarts[g] to groupStarts[g+1]) of group g. As in statevec_calcExpecPauliStringsLocal, 
+ * the upper bits of every groupXMasks[g] must be identical, and pairRe and pairIm are the 
+ * amplitudes of the chunk containing every psi_{a ^ xMask}. The input state is only read, and 
+ * every group is gathered into a block of PAULI_STRING_BLOCK_SIZE output amplitudes before 
+ * proceeding to the next, so that outQureg is written once per batch.
+ */
+void statevec_applyPauliMaskGroupsLocal(
+    Qureg outQureg, qreal* pairRe, qreal* pairIm, 
+    long long int* groupXMasks, int* groupStarts, int numGroups, 
+    long long int* termZMasks, qreal* termCoeffsRe, qreal* termCoeffsIm
+) {
+    long long int numAmps = outQureg.numAmpsPerChunk;
+    long long int globalOffset = outQureg.chunkId*numAmps;
+    long long int localMask = numAmps - 1;
+    long long int blockSize = (numAmps < PAULI_STRING_BLOCK_SIZE)? numAmps : PAULI_STRING_BLOCK_SIZE;
+    long long int numBlocks = numAmps / blockSize;
+    qreal* outRe = outQureg.stateVec.real;
+    qreal* outIm = outQureg.stateVec.imag;
     
-    // clear outcomeProbs (in parallel, in case it's large)
-    long long int numOutcomeProbs = (1 << numQubits);
-    long long int j;
+    // each thread evaluates the diagonal of one group at a time, over its current block
+    int maxNumThreads = 1;
+# ifdef _OPENMP
+    maxNumThreads = omp_get_max_threads();
+# endif
+    qreal* diags = malloc(2 * maxNumThreads * blockSize * sizeof *diags);
     
+    long long int b, blockStart, i, j, k, xMask, zMask;
+    int threadId, g, t, baseParity;
+    qreal *diagRe, *diagIm, coeffRe, coeffIm, sign, reJ, imJ;
+
 # ifdef _OPENMP
 # pragma omp parallel \
-    default (none) \
-    shared    (numOutcomeProbs,outcomeProbs) \
-    private   (j)
-# endif 
+    default  (none) \
+    shared   (numAmps,globalOffset,localMask,blockSize,numBlocks, outRe,outIm,pairRe,pairIm, \
+              groupXMasks,groupStarts,numGroups, termZMasks,termCoeffsRe,termCoeffsIm, diags) \
+    private  (b,blockStart,i,j,k,xMask,zMask, threadId,g,t,baseParity, diagRe,diagIm,coeffRe,coeffIm,sign,reJ,imJ)
+# endif
     {
+        threadId = 0;
 # ifdef _OPENMP
-# pragma omp for schedule  (static)
+        threadId = omp_get_thread_num();
 # endif
-        for (j=0; j<numOutcomeProbs; j++)
-            outcomeProbs[j] = 0;
-    }  
+        diagRe = &diags[2 * threadId * blockSize];
+        diagIm = &diagRe[blockSize];
+        
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (b=0; b<numBlocks; b++) {
+            blockStart = b*blockSize;
+            
+            for (g=0; g<numGroups; g++) {
+                xMask = groupXMasks[g] & localMask;
+                
+                for (k=0; k<blockSize; k++) {
+                    diagRe[k] = 0;
+                    diagIm[k] = 0;
+                }
+                for (t=groupStarts[g]; t<groupStarts[g+1]; t++) {
+                    coeffRe = termCoeffsRe[t];
+                    coeffIm = termCoeffsIm[t];
+                    
+                    // the parity of the (aligned) upper bits is fixed throughout the block
+                    baseParity = getBitMaskParity(termZMasks[t] & (globalOffset + blockStart));
+                    zMask = termZMasks[t] & (blockSize - 1);
+                    
+                    for (k=0; k<blockSize; k++) {
+                        sign = (baseParity ^ getBitMaskParity(zMask & k))? -1 : 1;
+                        diagRe[k] += sign * coeffRe;
+                        diagIm[k] += sign * coeffIm;
+                    }
+                }
+                
+                // out_i += d(i) psi_{i ^ xMask}
+                for (k=0; k<blockSize; k++) {
+                    i = blockStart + k;
+                    j = i ^ xMask;
+                    reJ = pairRe[AMP_INDEX(j)];
+                    imJ = pairIm[AMP_INDEX(j)];
+                    outRe[AMP_INDEX(i)] += diagRe[k]*reJ - diagIm[k]*imJ;
+                    outIm[AMP_INDEX(i)] += diagRe[k]*imJ + diagIm[k]*reJ;
+                }
+            }
+        }
+    }
     
-    // compute first local index containing a diagonal element
-    long long int localNumAmps = qureg.numAmpsPerChunk;
-    long long int densityDim = (1LL << qureg.numQubitsRepresented);
-    long long int diagSpacing = 1LL + densityDim;
-    long long int maxNumDiagsPerChunk = 1 + localNumAmps / diagSpacing;
-    long long int numPrevDiags = (qureg.chunkId>0)? 1+(qureg.chunkId*localNumAmps)/diagSpacing : 0;
-    long long int globalIndNextDiag = diagSpacing * numPrevDiags;
-    long long int localIndNextDiag = globalIndNextDiag % localNumAmps;
+    free(diags);
+}
+
+long long int findIndexOfCumulativeProb(qreal* cumProbs, long long int numProbs, qreal prob) {
     
-    // computes how many diagonals are contained in this chunk
-    long long int numDiagsInThisChunk = maxNumDiagsPerChunk;
-    if (localIndNextDiag + (numDiagsInThisChunk-1)*diagSpacing >= localNumAmps)
-        numDiagsInThisChunk -= 1;
-        
-    long long int visitedDiags;     // number of visited diagonals in this chunk so far
-    long long int basisStateInd;    // current diagonal index being considered
-    long long int index;            // index in the local chunk
+    // binary search for the first element exceeding prob, which never has zero probability
+    long long int lo = 0;
+    long long int hi = numProbs;
+    while (lo < hi) {
+        long long int mid = lo + (hi - lo)/2;
+        if (cumProbs[mid] > prob)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    if (lo < numProbs)
+        return lo;
     
-    int q;
-    long long int outcomeInd;
-    qreal *stateRe = qureg.stateVec.real;
+    // if prob met the total (through finite precision), choose the final non-zero element
+    qreal total = cumProbs[numProbs-1];
+    lo = 0;
+    hi = numProbs-1;
+    while (lo < hi) {
+        long long int mid = lo + (hi - lo)/2;
+        if (cumProbs[mid] >= total)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo;
+}
+
+void sampleOutcomesFromCumulativeProbsLocal(
+    long long int* outcomes, qreal* shotProbs, int numShots, 
+    qreal* cumProbs, long long int numProbs, long long int firstBasisInd, 
+    int* qubits, int numQubits
+) {
+    // the outcome index of each basis state is gathered from its bytes
+    long long int tables[8][256];
+    int shifts[8];
+    int numTables = populateOutcomeIndexTables(qubits, numQubits, tables, shifts);
     
+    long long int basisInd, outcomeInd;
+    int s, b;
+
 # ifdef _OPENMP
-# pragma omp parallel \
-    shared    (localIndNextDiag, numPrevDiags, diagSpacing, stateRe, numDiagsInThisChunk, qubits,numQubits, outcomeProbs) \
-    private   (visitedDiags, basisStateInd, index, q,outcomeInd)
-# endif 
-    {
-# ifdef _OPENMP
-# pragma omp for schedule  (static)
+# pragma omp parallel for schedule (static) \
+    default  (none) \
+    shared   (outcomes,shotProbs,numShots, cumProbs,numProbs,firstBasisInd, tables,shifts,numTables) \
+    private  (s, b, basisInd, outcomeInd)
 # endif
-        // sums the diagonal elems of the density matrix where measureQubit=0
-        for (visitedDiags = 0; visitedDiags < numDiagsInThisChunk; visitedDiags++) {
-            
-            basisStateInd = numPrevDiags + visitedDiags;
-            index = localIndNextDiag + diagSpacing * visitedDiags;
-            
-            // determine outcome implied by basisStateInd
-            outcomeInd = 0;
-            for (q=0; q<numQubits; q++)
-                outcomeInd += extractBit(qubits[q], basisStateInd) * (1LL << q);
-    
-            // atomicly update corresponding outcome array element
-            # ifdef _OPENMP
-            # pragma omp atomic
-            # endif
-            outcomeProbs[outcomeInd] += stateRe[index];
+    for (s=0; s<numShots; s++) {
+        
+        // shots with a negative probability are sampled elsewhere
+        outcomeInd = 0;
+        if (shotProbs[s] >= 0) {
+            basisInd = firstBasisInd + findIndexOfCumulativeProb(cumProbs, numProbs, shotProbs[s]);
+            for (b=0; b<numTables; b++)
+                outcomeInd |= tables[b][(basisInd >> shifts[b]) & 255];
         }
+        outcomes[s] = outcomeInd;
     }
 }
 
@@ -3724,41 +5758,44 @@ void statevec_controlledPhaseFlip (Qureg qureg, int idQubit1, int idQubit2)
         bit1 = extractBit (idQubit1, index+chunkId*chunkSize);
         bit2 = extractBit (idQubit2, index+chunkId*chunkSize);
         if (bit1 && bit2) {
-            stateVecReal [index] = - stateVecReal [index];
-            stateVecImag [index] = - stateVecImag [index];
+            stateVecReal [AMP_INDEX(index)] = - stateVecReal [AMP_INDEX(index)];
+            stateVecImag [AMP_INDEX(index)] = - stateVecImag [AMP_INDEX(index)];
         }
     }
 }
 
 void statevec_multiControlledPhaseFlip(Qureg qureg, int *controlQubits, int numControlQubits)
 {
-    long long int index;
-    long long int stateVecSize;
-
-    long long int chunkSize=qureg.numAmpsPerChunk;
-    long long int chunkId=qureg.chunkId;
+    long long int index, thisTask;
+    long long int numTasks;
 
     long long int mask = getQubitBitMask(controlQubits, numControlQubits);
 
-    stateVecSize = qureg.numAmpsPerChunk;
+    // only the amplitudes with all control qubits in the 1 state are enumerated
+    int fixedQubits[64]; // [numFixed]
+    long long int ctrlBits;
+    int numFixed = getControlSubspace(qureg, mask, 0, 0, fixedQubits, &ctrlBits);
+    if (numFixed < 0)
+        return;
+
+    numTasks = qureg.numAmpsPerChunk >> numFixed;
     qreal *stateVecReal = qureg.stateVec.real;
     qreal *stateVecImag = qureg.stateVec.imag;
 
 # ifdef _OPENMP
 # pragma omp parallel \
     default  (none)              \
-    shared   (stateVecSize, stateVecReal,stateVecImag, mask, chunkId,chunkSize ) \
-    private  (index)
+    shared   (numTasks, stateVecReal,stateVecImag, fixedQubits,numFixed,ctrlBits ) \
+    private  (thisTask, index)
 # endif
     {
 # ifdef _OPENMP
 # pragma omp for schedule (static)
 # endif
-        for (index=0; index<stateVecSize; index++) {
-            if (mask == (mask & (index+chunkId*chunkSize)) ){
-                stateVecReal [index] = - stateVecReal [index];
-                stateVecImag [index] = - stateVecImag [index];
-            }
+        for (thisTask=0; thisTask<numTasks; thisTask++) {
+            index = insertZeroBits(thisTask, fixedQubits, numFixed) | ctrlBits;
+            stateVecReal [AMP_INDEX(index)] = - stateVecReal [AMP_INDEX(index)];
+            stateVecImag [AMP_INDEX(index)] = - stateVecImag [AMP_INDEX(index)];
         }
     }
 }
@@ -3809,7 +5846,7 @@ void statevec_collapseToKnownProbOutcomeLocal(Qureg qureg, int measureQubit, int
 # ifdef _OPENMP
 # pragma omp parallel \
     default (none) \
-    shared    (numTasks,sizeBlock,sizeHalfBlock, stateVecReal,stateVecImag,renorm,outcome) \
+    shared    (numTasks,sizeBlock,sizeHalfBlock,measureQubit, stateVecReal,stateVecImag,renorm,outcome) \
     private   (thisTask,thisBlock,index)
 # endif
     {
@@ -3819,13 +5856,13 @@ void statevec_collapseToKnownProbOutcomeLocal(Qureg qureg, int measureQubit, int
 # pragma omp for schedule  (static)
 # endif
             for (thisTask=0; thisTask<numTasks; thisTask++) {
-                thisBlock = thisTask / sizeHalfBlock;
-                index     = thisBlock*sizeBlock + thisTask%sizeHalfBlock;
-                stateVecReal[index]=stateVecReal[index]*renorm;
-                stateVecImag[index]=stateVecImag[index]*renorm;
+                thisBlock = thisTask >> measureQubit; // thisTask / sizeHalfBlock
+                index     = thisBlock*sizeBlock + (thisTask&(sizeHalfBlock-1));
+                stateVecReal[AMP_INDEX(index)]=stateVecReal[AMP_INDEX(index)]*renorm;
+                stateVecImag[AMP_INDEX(index)]=stateVecImag[AMP_INDEX(index)]*renorm;
 
-                stateVecReal[index+sizeHalfBlock]=0;
-                stateVecImag[index+sizeHalfBlock]=0;
+                stateVecReal[AMP_INDEX(index+sizeHalfBlock)]=0;
+                stateVecImag[AMP_INDEX(index+sizeHalfBlock)]=0;
             }
         } else {
             // measure qubit is 1
@@ -3833,13 +5870,13 @@ void statevec_collapseToKnownProbOutcomeLocal(Qureg qureg, int measureQubit, int
 # pragma omp for schedule  (static)
 # endif
             for (thisTask=0; thisTask<numTasks; thisTask++) {
-                thisBlock = thisTask / sizeHalfBlock;
-                index     = thisBlock*sizeBlock + thisTask%sizeHalfBlock;
-                stateVecReal[index]=0;
-                stateVecImag[index]=0;
+                thisBlock = thisTask >> measureQubit; // thisTask / sizeHalfBlock
+                index     = thisBlock*sizeBlock + (thisTask&(sizeHalfBlock-1));
+                stateVecReal[AMP_INDEX(index)]=0;
+                stateVecImag[AMP_INDEX(index)]=0;
 
-                stateVecReal[index+sizeHalfBlock]=stateVecReal[index+sizeHalfBlock]*renorm;
-                stateVecImag[index+sizeHalfBlock]=stateVecImag[index+sizeHalfBlock]*renorm;
+                stateVecReal[AMP_INDEX(index+sizeHalfBlock)]=stateVecReal[AMP_INDEX(index+sizeHalfBlock)]*renorm;
+                stateVecImag[AMP_INDEX(index+sizeHalfBlock)]=stateVecImag[AMP_INDEX(index+sizeHalfBlock)]*renorm;
             }
         }
     }
@@ -3882,8 +5919,8 @@ void statevec_collapseToKnownProbOutcomeDistributedRenorm (Qureg qureg, int meas
 # pragma omp for schedule  (static)
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
-            stateVecReal[thisTask] = stateVecReal[thisTask]*renorm;
-            stateVecImag[thisTask] = stateVecImag[thisTask]*renorm;
+            stateVecReal[AMP_INDEX(thisTask)] = stateVecReal[AMP_INDEX(thisTask)]*renorm;
+            stateVecImag[AMP_INDEX(thisTask)] = stateVecImag[AMP_INDEX(thisTask)]*renorm;
         }
     }
 }
@@ -3922,8 +5959,8 @@ void statevec_collapseToOutcomeDistributedSetZero(Qureg qureg)
 # pragma omp for schedule  (static)
 # endif
         for (thisTask=0; thisTask<numTasks; thisTask++) {
-            stateVecReal[thisTask] = 0;
-            stateVecImag[thisTask] = 0;
+            stateVecReal[AMP_INDEX(thisTask)] = 0;
+            stateVecImag[AMP_INDEX(thisTask)] = 0;
         }
     }
 }
@@ -3963,12 +6000,12 @@ void statevec_swapQubitAmpsLocal(Qureg qureg, int qb1, int qb2) {
             ind10 = flipBit(ind00, qb2);
 
             // extract statevec amplitudes 
-            re01 = reVec[ind01]; im01 = imVec[ind01];
-            re10 = reVec[ind10]; im10 = imVec[ind10];
+            re01 = reVec[AMP_INDEX(ind01)]; im01 = imVec[AMP_INDEX(ind01)];
+            re10 = reVec[AMP_INDEX(ind10)]; im10 = imVec[AMP_INDEX(ind10)];
 
             // swap 01 and 10 amps
-            reVec[ind01] = re10; reVec[ind10] = re01;
-            imVec[ind01] = im10; imVec[ind10] = im01;
+            reVec[AMP_INDEX(ind01)] = re10; reVec[AMP_INDEX(ind10)] = re01;
+            imVec[AMP_INDEX(ind01)] = im10; imVec[AMP_INDEX(ind10)] = im01;
         }
     }
 }
@@ -4010,8 +6047,8 @@ void statevec_swapQubitAmpsDistributed(Qureg qureg, int pairRank, int qb1, int q
                 pairGlobalInd = flipBit(flipBit(globalInd, qb1), qb2);
                 pairLocalInd = pairGlobalInd - pairGlobalStartInd;
                 
-                reVec[localInd] = rePairVec[pairLocalInd];
-                imVec[localInd] = imPairVec[pairLocalInd];
+                reVec[AMP_INDEX(localInd)] = rePairVec[AMP_INDEX(pairLocalInd)];
+                imVec[AMP_INDEX(localInd)] = imPairVec[AMP_INDEX(pairLocalInd)];
             }
         }
     }
@@ -4048,13 +6085,13 @@ void statevec_setWeightedQureg(Complex fac1, Qureg qureg1, Complex fac2, Qureg q
 # pragma omp for schedule  (static)
 # endif
         for (index=0LL; index<numAmps; index++) {
-            re1 = vecRe1[index]; im1 = vecIm1[index];
-            re2 = vecRe2[index]; im2 = vecIm2[index];
-            reOut = vecReOut[index];
-            imOut = vecImOut[index];
+            re1 = vecRe1[AMP_INDEX(index)]; im1 = vecIm1[AMP_INDEX(index)];
+            re2 = vecRe2[AMP_INDEX(index)]; im2 = vecIm2[AMP_INDEX(index)];
+            reOut = vecReOut[AMP_INDEX(index)];
+            imOut = vecImOut[AMP_INDEX(index)];
 
-            vecReOut[index] = (facReOut*reOut - facImOut*imOut) + (facRe1*re1 - facIm1*im1) + (facRe2*re2 - facIm2*im2);
-            vecImOut[index] = (facReOut*imOut + facImOut*reOut) + (facRe1*im1 + facIm1*re1) + (facRe2*im2 + facIm2*re2);
+            vecReOut[AMP_INDEX(index)] = (facReOut*reOut - facImOut*imOut) + (facRe1*re1 - facIm1*im1) + (facRe2*re2 - facIm2*im2);
+            vecImOut[AMP_INDEX(index)] = (facReOut*imOut + facImOut*reOut) + (facRe1*im1 + facIm1*re1) + (facRe2*im2 + facIm2*re2);
         }
     }
 }
@@ -4082,14 +6119,14 @@ void statevec_applyDiagonalOp(Qureg qureg, DiagonalOp op) {
 # pragma omp for schedule  (static)
 # endif
         for (index=0LL; index<numAmps; index++) {
-            a = stateRe[index];
-            b = stateIm[index];
+            a = stateRe[AMP_INDEX(index)];
+            b = stateIm[AMP_INDEX(index)];
             c = opRe[index];
             d = opIm[index];
 
             // (a + b i)(c + d i) = (a c - b d) + i (a d + b c)
-            stateRe[index] = a*c - b*d;
-            stateIm[index] = a*d + b*c;
+            stateRe[AMP_INDEX(index)] = a*c - b*d;
+            stateIm[AMP_INDEX(index)] = a*d + b*c;
         }
     }
 }
@@ -4124,14 +6161,14 @@ void densmatr_applyDiagonalOpLocal(Qureg qureg, DiagonalOp op) {
 # pragma omp for schedule  (static)
 # endif
         for (index=0LL; index<numAmps; index++) {
-            a = stateRe[index];
-            b = stateIm[index];
-            c = opRe[index % opDim];
-            d = opIm[index % opDim];
+            a = stateRe[AMP_INDEX(index)];
+            b = stateIm[AMP_INDEX(index)];
+            c = opRe[index & (opDim-1)]; // opRe[index % opDim]
+            d = opIm[index & (opDim-1)];
 
             // (a + b i)(c + d i) = (a c - b d) + i (a d + b c)
-            stateRe[index] = a*c - b*d;
-            stateIm[index] = a*d + b*c;
+            stateRe[AMP_INDEX(index)] = a*c - b*d;
+            stateIm[AMP_INDEX(index)] = a*d + b*c;
         }
     }
 }
@@ -4161,8 +6198,8 @@ Complex statevec_calcExpecDiagonalOpLocal(Qureg qureg, DiagonalOp op) {
 # pragma omp for schedule  (static)
 # endif
         for (index=0; index < numAmps; index++) {
-            vecRe = stateReal[index];
-            vecIm = stateImag[index];
+            vecRe = stateReal[AMP_INDEX(index)];
+            vecIm = stateImag[AMP_INDEX(index)];
             opRe = opReal[index];
             opIm = opImag[index];
             
@@ -4221,8 +6258,8 @@ Complex densmatr_calcExpecDiagonalOpLocal(Qureg qureg, DiagonalOp op) {
 # endif
         for (stateInd=localIndNextDiag; stateInd < numAmps; stateInd += diagSpacing) {
             
-            matRe = stateReal[stateInd];
-            matIm = stateImag[stateInd];
+            matRe = stateReal[AMP_INDEX(stateInd)];
+            matIm = stateImag[AMP_INDEX(stateInd)];
             opInd = (stateInd - localIndNextDiag) / diagSpacing;
             opRe = opReal[opInd];
             opIm = opImag[opInd];
@@ -4280,6 +6317,176 @@ void agnostic_setDiagonalOpElems(DiagonalOp op, long long int startInd, qreal* r
     }
 }
 
+/* the most recent table of exp(i phase) built by statevec_applyPhaseFuncOverrides, and the 
+ * key (the encoding, terms and overrides) which produced it, retained only when caching is enabled
+ */
+static int phaseTableCachingEnabled = 0;
+static qreal* cachedPhaseTableKey = NULL;
+static long long int cachedPhaseTableKeyLen = 0;
+static qreal* cachedPhaseTableRe = NULL;
+static qreal* cachedPhaseTableIm = NULL;
+
+static void freeCachedPhaseTable(void) {
+    free(cachedPhaseTableKey);
+    free(cachedPhaseTableRe);
+    free(cachedPhaseTableIm);
+    cachedPhaseTableKey = NULL;
+    cachedPhaseTableKeyLen = 0;
+    cachedPhaseTableRe = NULL;
+    cachedPhaseTableIm = NULL;
+}
+
+void agnostic_setPhaseFuncCaching(int cacheTables) {
+    phaseTableCachingEnabled = cacheTables;
+    if (!cacheTables)
+        freeCachedPhaseTable();
+}
+
+/** Returns the hash of the numRegs phase indices in phaseInds, for indexing an override table */
+static inline unsigned long long int hashPhaseInds(long long int* phaseInds, int numRegs) {
+    
+    // combines the indices as per splitmix64
+    unsigned long long int hash = 0;
+    for (int r=0; r<numRegs; r++) {
+        hash += (unsigned long long int) phaseInds[r] + 0x9E3779B97F4A7C15ULL;
+        hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+        hash ^= hash >> 31;
+    }
+    return hash;
+}
+
+/** Returns a malloc'd open-addressing hash table of the numOverrides (flat) multi-register 
+ * indices in overrideInds, which is NULL if there are no overrides. Each slot of the table 
+ * contains the position of an override in overrideInds, or -1 if empty. The table has 
+ * (tableMask+1) slots, which is a power of 2 at least twice numOverrides. Repeated 
+ * overrides are not inserted, so that the first is used, as per a linear search.
+ */
+static int* createOverrideTable(long long int* overrideInds, int numOverrides, int numRegs, long long int* tableMask) {
+    
+    *tableMask = 0;
+    if (numOverrides == 0)
+        return NULL;
+    
+    long long int numSlots = 2;
+    while (numSlots < 2LL*numOverrides)
+        numSlots <<= 1;
+    *tableMask = numSlots - 1;
+    
+    int* table = malloc(numSlots * sizeof *table);
+    for (long long int j=0; j<numSlots; j++)
+        table[j] = -1;
+    
+    for (int i=0; i<numOverrides; i++) {
+        long long int* inds = &overrideInds[i*numRegs];
+        long long int j = hashPhaseInds(inds, numRegs) & *tableMask;
+        
+        // linearly probe until an empty slot, or a repetition of this override
+        while (table[j] != -1 && memcmp(&overrideInds[table[j]*numRegs], inds, numRegs * sizeof *inds) != 0)
+            j = (j + 1) & *tableMask;
+        if (table[j] == -1)
+            table[j] = i;
+    }
+    return table;
+}
+
+/** Returns the position in overrideInds of the override of phaseInds, or -1 if not overriden. 
+ * The table is only read, so may be shared between threads.
+ */
+static inline int getOverrideIndex(
+    int* table, long long int tableMask, long long int* overrideInds, 
+    long long int* phaseInds, int numRegs
+) {
+    if (table == NULL)
+        return -1;
+    
+    long long int j = hashPhaseInds(phaseInds, numRegs) & tableMask;
+    int i, r;
+    while ((i = table[j]) != -1) {
+        for (r=0; r<numRegs && overrideInds[i*numRegs+r] == phaseInds[r]; r++)
+            ;
+        if (r == numRegs)
+            return i;
+        j = (j + 1) & tableMask;
+    }
+    return -1;
+}
+
+/** Returns the phase (before any conjugation) of the phase function at phaseInd */
+static inline qreal getPhaseFuncPhase(
+    long long int phaseInd, qreal* coeffs, qreal* exponents, int numTerms, 
+    long long int* overrideInds, qreal* overridePhases, int* overrideTable, long long int overrideMask
+) {
+    // determine if this phase index has an overriden value
+    int i = getOverrideIndex(overrideTable, overrideMask, overrideInds, &phaseInd, 1);
+    if (i != -1)
+        return overridePhases[i];
+
+    // determine phase from {coeffs}, {exponents}
+    qreal phase = 0;
+    for (int t=0; t<numTerms; t++)
+        phase += coeffs[t] * pow(phaseInd, exponents[t]);
+    return phase;
+}
+
+/** Populates tableRe + i tableIm with exp(i phase) for every one of the 2^numQubits values 
+ * of the targeted sub-register, indexed by its unsigned bit sequence
+ */
+static void populatePhaseTable(
+    qreal* tableRe, qreal* tableIm, int numQubits, enum bitEncoding encoding,
+    qreal* coeffs, qreal* exponents, int numTerms, 
+    long long int* overrideInds, qreal* overridePhases, int* overrideTable, long long int overrideMask
+) {
+    long long int numPhases = 1LL << numQubits;
+    long long int tableInd, phaseInd;
+    qreal phase;
+
+# ifdef _OPENMP
+# pragma omp parallel for schedule (static) \
+    default  (none) \
+    shared   (tableRe,tableIm, numPhases,numQubits,encoding, coeffs,exponents,numTerms, overrideInds,overridePhases,overrideTable,overrideMask) \
+    private  (tableInd, phaseInd, phase)
+# endif
+    for (tableInd=0LL; tableInd<numPhases; tableInd++) {
+        
+        // the final qubit indicates the sign under two's complement
+        phaseInd = tableInd;
+        if (encoding == TWOS_COMPLEMENT && extractBit(numQubits-1, tableInd))
+            phaseInd -= numPhases;
+        
+        phase = getPhaseFuncPhase(phaseInd, coeffs, exponents, numTerms, overrideInds, overridePhases, overrideTable, overrideMask);
+        tableRe[tableInd] = cos(phase);
+        tableIm[tableInd] = sin(phase);
+    }
+}
+
+/** Returns (and sets keyLen to the length of) a malloc'd array which uniquely identifies 
+ * the phase table of the given phase function, for comparison against the cached table
+ */
+static qreal* getPhaseTableKey(
+    long long int* keyLen, int numQubits, enum bitEncoding encoding,
+    qreal* coeffs, qreal* exponents, int numTerms, 
+    long long int* overrideInds, qreal* overridePhases, int numOverrides
+) {
+    *keyLen = 4 + 2*numTerms + 2*numOverrides;
+    qreal* key = malloc(*keyLen * sizeof *key);
+    
+    long long int k = 0;
+    key[k++] = numQubits;
+    key[k++] = encoding;
+    key[k++] = numTerms;
+    key[k++] = numOverrides;
+    for (int t=0; t<numTerms; t++) {
+        key[k++] = coeffs[t];
+        key[k++] = exponents[t];
+    }
+    for (int i=0; i<numOverrides; i++) {
+        key[k++] = overrideInds[i];
+        key[k++] = overridePhases[i];
+    }
+    return key;
+}
+
 void statevec_applyPhaseFuncOverrides(
     Qureg qureg, int* qubits, int numQubits, enum bitEncoding encoding,
     qreal* coeffs, qreal* exponents, int numTerms, 
@@ -4294,16 +6501,48 @@ void statevec_applyPhaseFuncOverrides(
     qreal* stateRe = qureg.stateVec.real;
     qreal* stateIm = qureg.stateVec.imag;
 
+    // index the overrides, to avoid searching them per-amplitude
+    long long int overrideMask;
+    int* overrideTable = createOverrideTable(overrideInds, numOverrides, 1, &overrideMask);
+
+    // the phase depends only on the 2^numQubits values of {qubits}, which are precomputed
+    // when there are fewer of them than local amplitudes (or retrieved from the cache)
+    long long int numPhases = 1LL << numQubits;
+    int useTable = (numPhases <= numAmps);
+    qreal* tableRe = NULL;
+    qreal* tableIm = NULL;
+    qreal* key = NULL;
+    long long int keyLen = 0;
+    if (useTable) {
+        if (phaseTableCachingEnabled)
+            key = getPhaseTableKey(&keyLen, numQubits, encoding, coeffs, exponents, numTerms, overrideInds, overridePhases, numOverrides);
+        
+        if (key != NULL && keyLen == cachedPhaseTableKeyLen && 
+                memcmp(key, cachedPhaseTableKey, keyLen * sizeof *key) == 0) {
+            tableRe = cachedPhaseTableRe;
+            tableIm = cachedPhaseTableIm;
+            free(key);
+            key = NULL;
+        } else {
+            tableRe = malloc(numPhases * sizeof *tableRe);
+            tableIm = malloc(numPhases * sizeof *tableIm);
+            populatePhaseTable(tableRe, tableIm, numQubits, encoding, coeffs, exponents, numTerms, overrideInds, overridePhases, overrideTable, overrideMask);
+        }
+    }
+    
+    // negate phase to conjugate operator
+    qreal conjFac = (conj)? -1 : 1;
+
     // thread private vars
     long long int index, globalAmpInd, phaseInd;
-    int i, t, q;
+    int q;
     qreal phase, c, s, re, im;
 
 # ifdef _OPENMP
 # pragma omp parallel \
     default  (none) \
-    shared   (chunkId,numAmps, stateRe,stateIm, qubits,numQubits,encoding, coeffs,exponents,numTerms, overrideInds,overridePhases,numOverrides, conj) \
-    private  (index, globalAmpInd, phaseInd, i,t,q, phase, c,s,re,im) 
+    shared   (chunkId,numAmps, stateRe,stateIm, qubits,numQubits,encoding, coeffs,exponents,numTerms, overrideInds,overridePhases,overrideTable,overrideMask, conjFac, useTable,tableRe,tableIm) \
+    private  (index, globalAmpInd, phaseInd, q, phase, c,s,re,im) 
 # endif
     {
 # ifdef _OPENMP
@@ -4314,46 +6553,94 @@ void statevec_applyPhaseFuncOverrides(
             // determine global amplitude index 
             globalAmpInd = chunkId * numAmps + index;
 
-            // determine phase index of {qubits}
+            // determine unsigned index of {qubits}, using the significance order specified by {qubits}
             phaseInd = 0LL;
-            if (encoding == UNSIGNED) {
-                for (q=0; q<numQubits; q++) // use significance order specified by {qubits}
-                    phaseInd += (1LL << q) * extractBit(qubits[q], globalAmpInd);
+            for (q=0; q<numQubits; q++)
+                phaseInd += (1LL << q) * extractBit(qubits[q], globalAmpInd);
+
+            if (useTable) {
+                c = tableRe[phaseInd];
+                s = conjFac * tableIm[phaseInd];
             } 
-            else if (encoding == TWOS_COMPLEMENT) {
-                for (q=0; q<numQubits-1; q++) // use final qubit to indicate sign 
-                    phaseInd += (1LL << q) * extractBit(qubits[q], globalAmpInd);
-                if (extractBit(qubits[numQubits-1], globalAmpInd) == 1)
-                    phaseInd -= (1LL << (numQubits-1));
+            else {
+                // use final qubit to indicate sign 
+                if (encoding == TWOS_COMPLEMENT && extractBit(numQubits-1, phaseInd))
+                    phaseInd -= (1LL << numQubits);
+
+                // determine phase from {coeffs}, {exponents} (unless overriden)
+                phase = conjFac * getPhaseFuncPhase(phaseInd, coeffs, exponents, numTerms, overrideInds, overridePhases, overrideTable, overrideMask);
+                c = cos(phase);
+                s = sin(phase);
             }
 
-            // determine if this phase index has an overriden value (i < numOverrides)
-            for (i=0; i<numOverrides; i++)
-                if (phaseInd == overrideInds[i])
-                    break;
-
-            // determine phase from {coeffs}, {exponents} (unless overriden)
-            phase = 0;
-            if (i < numOverrides)
-                phase = overridePhases[i];
-            else
-                for (t=0; t<numTerms; t++)
-                    phase += coeffs[t] * pow(phaseInd, exponents[t]);
-                    
-            // negate phase to conjugate operator 
-            if (conj)
-                phase *= -1;
-
             // modify amp to amp * exp(i phase) 
-            c = cos(phase);
-            s = sin(phase);
-            re = stateRe[index];
-            im = stateIm[index];
+            re = stateRe[AMP_INDEX(index)];
+            im = stateIm[AMP_INDEX(index)];
 
             // = {re[amp] cos(phase) - im[amp] sin(phase)} + i {re[amp] sin(phase) + im[amp] cos(phase)}
-            stateRe[index] = re*c - im*s;
-            stateIm[index] = re*s + im*c;
+            stateRe[AMP_INDEX(index)] = re*c - im*s;
+            stateIm[AMP_INDEX(index)] = re*s + im*c;
+        }
+    }
+    
+    // a newly built table either replaces the cached table, or is discarded
+    if (key != NULL) {
+        freeCachedPhaseTable();
+        cachedPhaseTableKey = key;
+        cachedPhaseTableKeyLen = keyLen;
+        cachedPhaseTableRe = tableRe;
+        cachedPhaseTableIm = tableIm;
+    } 
+    else if (tableRe != cachedPhaseTableRe) {
+        free(tableRe);
+        free(tableIm);
+    }
+    free(overrideTable);
+}
+
+/** Populates factorRe + i factorIm with exp(i f_r(x)) for every value x of every sub-register r, 
+ * where f_r is the r-th register's exponential polynomial, such that the multi-variable phase 
+ * function is the product of per-register factors. The table of register r begins at 
+ * tableOffsets[r], and is indexed by the unsigned bit sequence of its qubits.
+ */
+static void populateMultiVarPhaseTables(
+    qreal* factorRe, qreal* factorIm, long long int* tableOffsets,
+    int* numQubitsPerReg, int numRegs, enum bitEncoding encoding,
+    qreal* coeffs, qreal* exponents, int* numTermsPerReg
+) {
+    long long int numPhases, tableInd, phaseInd, offset;
+    int r, t, termOffset, numTerms, numQubits;
+    qreal phase;
+    
+    termOffset = 0;
+    for (r=0; r<numRegs; r++) {
+        numQubits = numQubitsPerReg[r];
+        numTerms = numTermsPerReg[r];
+        numPhases = 1LL << numQubits;
+        offset = tableOffsets[r];
+
+# ifdef _OPENMP
+# pragma omp parallel for schedule (static) \
+    default  (none) \
+    shared   (factorRe,factorIm, offset,numPhases,numQubits,encoding, coeffs,exponents,numTerms,termOffset) \
+    private  (tableInd, phaseInd, phase, t)
+# endif
+        for (tableInd=0LL; tableInd<numPhases; tableInd++) {
+            
+            // the final qubit indicates the sign under two's complement
+            phaseInd = tableInd;
+            if (encoding == TWOS_COMPLEMENT && extractBit(numQubits-1, tableInd))
+                phaseInd -= numPhases;
+            
+            phase = 0;
+            for (t=0; t<numTerms; t++)
+                phase += coeffs[termOffset+t] * pow(phaseInd, exponents[termOffset+t]);
+            
+            factorRe[offset + tableInd] = cos(phase);
+            factorIm[offset + tableInd] = sin(phase);
         }
+        
+        termOffset += numTerms;
     }
 }
 
@@ -4373,19 +6660,44 @@ void statevec_applyMultiVarPhaseFuncOverrides(
     qreal* stateRe = qureg.stateVec.real;
     qreal* stateIm = qureg.stateVec.imag;
 
+    // index the overrides, to avoid searching them per-amplitude
+    long long int overrideMask;
+    int* overrideTable = createOverrideTable(overrideInds, numOverrides, numRegs, &overrideMask);
+    
+    // exp(i phase) is the product of a factor per register, each of which is precomputed for 
+    // every value of its register, when there are fewer such values than local amplitudes
+    long long int tableOffsets[MAX_NUM_REGS_APPLY_ARBITRARY_PHASE];
+    long long int numFactors = 0;
+    for (int reg=0; reg<numRegs; reg++) {
+        tableOffsets[reg] = numFactors;
+        numFactors += 1LL << numQubitsPerReg[reg];
+    }
+    int useTables = (numFactors <= numAmps);
+    qreal* factorRe = NULL;
+    qreal* factorIm = NULL;
+    if (useTables) {
+        factorRe = malloc(numFactors * sizeof *factorRe);
+        factorIm = malloc(numFactors * sizeof *factorIm);
+        populateMultiVarPhaseTables(factorRe, factorIm, tableOffsets, numQubitsPerReg, numRegs, encoding, coeffs, exponents, numTermsPerReg);
+    }
+    
+    // negate phase to conjugate operator 
+    qreal conjFac = (conj)? -1 : 1;
+
     // thread-private vars
-    long long int index, globalAmpInd;
-    int r, q, i, t, found, flatInd;
-    qreal phase, c, s, re, im;
+    long long int index, globalAmpInd, factorInd;
+    int r, q, i, t, flatInd;
+    qreal phase, c, s, fc, fs, re, im;
 
-    // each thread has a private static array of length >= numRegs (private var-length is illegal)
+    // each thread has private static arrays of length >= numRegs (private var-length is illegal)
     long long int phaseInds[MAX_NUM_REGS_APPLY_ARBITRARY_PHASE];
+    long long int tableInds[MAX_NUM_REGS_APPLY_ARBITRARY_PHASE];
 
 # ifdef _OPENMP
 # pragma omp parallel \
     default  (none) \
-    shared   (chunkId,numAmps, stateRe,stateIm, qubits,numQubitsPerReg,numRegs,encoding, coeffs,exponents,numTermsPerReg, overrideInds,overridePhases,numOverrides, conj) \
-    private  (index,globalAmpInd, r,q,i,t,flatInd, found, phaseInds,phase, c,s,re,im) 
+    shared   (chunkId,numAmps, stateRe,stateIm, qubits,numQubitsPerReg,numRegs,encoding, coeffs,exponents,numTermsPerReg, overrideInds,overridePhases,overrideTable,overrideMask, conjFac, useTables,factorRe,factorIm,tableOffsets) \
+    private  (index,globalAmpInd,factorInd, r,q,i,t,flatInd, phaseInds,tableInds,phase, c,s,fc,fs,re,im) 
 # endif
     {
 # ifdef _OPENMP
@@ -4396,66 +6708,69 @@ void statevec_applyMultiVarPhaseFuncOverrides(
             // determine global amplitude index 
             globalAmpInd = chunkId * numAmps + index;
 
-            // determine phase indices
+            // determine phase indices, and their unsigned bit sequences
             flatInd = 0;
             for (r=0; r<numRegs; r++) {
-                phaseInds[r] = 0LL;
-
-                if (encoding == UNSIGNED) {
-                    for (q=0; q<numQubitsPerReg[r]; q++)
-                        phaseInds[r] += (1LL << q) * extractBit(qubits[flatInd++], globalAmpInd);   // qubits[flatInd] ~ qubits[r][q]
-                }
-                else if (encoding == TWOS_COMPLEMENT) {
-                    for (q=0; q<numQubitsPerReg[r]-1; q++)  
-                        phaseInds[r] += (1LL << q) * extractBit(qubits[flatInd++], globalAmpInd);
-                    // use final qubit to indicate sign
-                    if (extractBit(qubits[flatInd++], globalAmpInd) == 1)
-                        phaseInds[r] -= (1LL << (numQubitsPerReg[r]-1));
-                }
+                tableInds[r] = 0LL;
+                for (q=0; q<numQubitsPerReg[r]; q++)
+                    tableInds[r] += (1LL << q) * extractBit(qubits[flatInd++], globalAmpInd);   // qubits[flatInd] ~ qubits[r][q]
+                
+                // use final qubit to indicate sign
+                phaseInds[r] = tableInds[r];
+                if (encoding == TWOS_COMPLEMENT && extractBit(numQubitsPerReg[r]-1, tableInds[r]))
+                    phaseInds[r] -= (1LL << numQubitsPerReg[r]);
             }
 
-            // determine if this phase index has an overriden value (i < numOverrides)
-            for (i=0; i<numOverrides; i++) {
-                found = 1;
+            // determine if this phase index has an overriden value (i != -1)
+            i = getOverrideIndex(overrideTable, overrideMask, overrideInds, phaseInds, numRegs);
+
+            if (useTables && i == -1) {
+                
+                // multiply the per-register factors
+                c = 1;
+                s = 0;
                 for (r=0; r<numRegs; r++) {
-                    if (phaseInds[r] != overrideInds[i*numRegs+r]) {
-                        found = 0;
-                        break;
-                    }
+                    factorInd = tableOffsets[r] + tableInds[r];
+                    fc = factorRe[factorInd];
+                    fs = factorIm[factorInd];
+                    re = c;
+                    c = re*fc - s*fs;
+                    s = re*fs + s*fc;
                 }
-                if (found)
-                    break;
+                s *= conjFac;
             }
-
-            // compute the phase (unless overriden)
-            phase = 0;
-            if (i < numOverrides)
-                phase = overridePhases[i];
             else {
-                flatInd = 0;
-                for (r=0; r<numRegs; r++) {
-                    for (t=0; t<numTermsPerReg[r]; t++) {
-                        phase += coeffs[flatInd] * pow(phaseInds[r], exponents[flatInd]);
-                        flatInd++;
+                // compute the phase (unless overriden)
+                phase = 0;
+                if (i != -1)
+                    phase = overridePhases[i];
+                else {
+                    flatInd = 0;
+                    for (r=0; r<numRegs; r++) {
+                        for (t=0; t<numTermsPerReg[r]; t++) {
+                            phase += coeffs[flatInd] * pow(phaseInds[r], exponents[flatInd]);
+                            flatInd++;
+                        }
                     }
                 }
+                phase *= conjFac;
+                c = cos(phase);
+                s = sin(phase);
             }
-            
-            // negate phase to conjugate operator 
-            if (conj)
-                phase *= -1;
 
             // modify amp to amp * exp(i phase) 
-            c = cos(phase);
-            s = sin(phase);
-            re = stateRe[index];
-            im = stateIm[index];
+            re = stateRe[AMP_INDEX(index)];
+            im = stateIm[AMP_INDEX(index)];
 
             // = {re[amp] cos(phase) - im[amp] sin(phase)} + i {re[amp] sin(phase) + im[amp] cos(phase)}
-            stateRe[index] = re*c - im*s;
-            stateIm[index] = re*s + im*c;
+            stateRe[AMP_INDEX(index)] = re*c - im*s;
+            stateIm[AMP_INDEX(index)] = re*s + im*c;
         }
     }
+    
+    free(factorRe);
+    free(factorIm);
+    free(overrideTable);
 }
 
 void statevec_applyParamNamedPhaseFuncOverrides(
@@ -4475,9 +6790,13 @@ void statevec_applyParamNamedPhaseFuncOverrides(
     qreal* stateRe = qureg.stateVec.real;
     qreal* stateIm = qureg.stateVec.imag;
 
+    // index the overrides, to avoid searching them per-amplitude
+    long long int overrideMask;
+    int* overrideTable = createOverrideTable(overrideInds, numOverrides, numRegs, &overrideMask);
+
     // thread-private vars
     long long int index, globalAmpInd;
-    int r, q, i, found, flatInd;
+    int r, q, i, flatInd;
     qreal phase, norm, prod, dist, c, s, re, im;
 
     // each thread has a private static array of length >= numRegs (private var-length is illegal)
@@ -4486,8 +6805,8 @@ void statevec_applyParamNamedPhaseFuncOverrides(
 # ifdef _OPENMP
 # pragma omp parallel \
     default  (none) \
-    shared   (chunkId,numAmps, stateRe,stateIm, qubits,numQubitsPerReg,numRegs,encoding, phaseFuncName,params,numParams, overrideInds,overridePhases,numOverrides, conj) \
-    private  (index,globalAmpInd, r,q,i,flatInd, found, phaseInds,phase,norm,prod,dist, c,s,re,im) 
+    shared   (chunkId,numAmps, stateRe,stateIm, qubits,numQubitsPerReg,numRegs,encoding, phaseFuncName,params,numParams, overrideInds,overridePhases,overrideTable,overrideMask, conj) \
+    private  (index,globalAmpInd, r,q,i,flatInd, phaseInds,phase,norm,prod,dist, c,s,re,im) 
 # endif
     {
 # ifdef _OPENMP
@@ -4516,22 +6835,12 @@ void statevec_applyParamNamedPhaseFuncOverrides(
                 }
             }
 
-            // determine if this phase index has an overriden value (i < numOverrides)
-            for (i=0; i<numOverrides; i++) {
-                found = 1;
-                for (r=0; r<numRegs; r++) {
-                    if (phaseInds[r] != overrideInds[i*numRegs+r]) {
-                        found = 0;
-                        break;
-                    }
-                }
-                if (found)
-                    break;
-            }
+            // determine if this phase index has an overriden value (i != -1)
+            i = getOverrideIndex(overrideTable, overrideMask, overrideInds, phaseInds, numRegs);
 
             // compute the phase (unless overriden)
             phase = 0;
-            if (i < numOverrides)
+            if (i != -1)
                 phase = overridePhases[i];
             else {
                 // compute norm related phases
@@ -4608,12 +6917,14 @@ void statevec_applyParamNamedPhaseFuncOverrides(
             // modify amp to amp * exp(i phase) 
             c = cos(phase);
             s = sin(phase);
-            re = stateRe[index];
-            im = stateIm[index];
+            re = stateRe[AMP_INDEX(index)];
+            im = stateIm[AMP_INDEX(index)];
 
             // = {re[amp] cos(phase) - im[amp] sin(phase)} + i {re[amp] sin(phase) + im[amp] cos(phase)}
-            stateRe[index] = re*c - im*s;
-            stateIm[index] = re*s + im*c;
+            stateRe[AMP_INDEX(index)] = re*c - im*s;
+            stateIm[AMP_INDEX(index)] = re*s + im*c;
         }
     }
+    
+    free(overrideTable);
 }
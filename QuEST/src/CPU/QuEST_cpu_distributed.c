@@ -13,6 +13,8 @@
 # include "QuEST_internal.h"
 # include "QuEST_precision.h"
 # include "QuEST_validation.h"
+# include "QuEST_rng.h"
+# include "QuEST_packed.h"
 # include "mt19937ar.h"
 
 # include "QuEST_cpu_internal.h"
@@ -158,6 +160,8 @@ QuESTEnv createQuESTEnv(void) {
     env.numSeeds = 0;
 	seedQuESTDefault(&env);
     
+    selectVectorisedKernels();
+    
     return env;
 }
 
@@ -173,6 +177,7 @@ int syncQuESTSuccess(int successCode){
 
 void destroyQuESTEnv(QuESTEnv env){
     free(env.seeds);
+    agnostic_setPhaseFuncCaching(0);
     
     int finalized;
     MPI_Finalized(&finalized);
@@ -192,6 +197,7 @@ void reportQuESTEnv(QuESTEnv env){
         printf("OpenMP disabled\n");
 # endif 
         printf("Precision: size of qreal is %ld bytes\n", sizeof(qreal) );
+        printf("Vectorised kernels: %s\n", getVectorisedKernelsName());
     }
 }
 
@@ -1045,6 +1051,40 @@ void statevec_multiControlledUnitary(Qureg qureg, long long int ctrlQubitsMask,
         }
     }
 }
+
+void statevec_multiControlledMultiRotatePauliMasks(Qureg qureg, long long int ctrlMask, long long int xMask, long long int zMask, qreal angle, int applyConj)
+{
+    // a string of only Z (and I) is diagonal
+    if (xMask == 0) {
+        statevec_multiControlledMultiRotateZ(qureg, ctrlMask, zMask, (applyConj)? -angle : angle);
+        return;
+    }
+    
+    qreal cosAngle = cos(angle/2);
+    Complex pairFac = getPauliRotationPairFactor(xMask, zMask, angle, applyConj);
+    
+    // the upper bits of xMask identify the chunk holding every amplitude's partner
+    int logNumAmps = 0;
+    while ((1LL << logNumAmps) < qureg.numAmpsPerChunk)
+        logNumAmps++;
+    long long int pairChunkBits = xMask >> logNumAmps;
+    
+    if (pairChunkBits == 0) {
+        statevec_multiControlledMultiRotatePauliLocal(qureg, ctrlMask, xMask, zMask, cosAngle, pairFac);
+        return;
+    }
+    
+    // chunks failing a control upon an upper qubit are unmodified, as are their pairs' (which 
+    // share the control qubits), so need not be exchanged
+    long long int chunkCtrlMask = ctrlMask >> logNumAmps;
+    if ((qureg.chunkId & chunkCtrlMask) != chunkCtrlMask)
+        return;
+    
+    // a single exchange with the pair chunk precedes one pass over the local amplitudes
+    exchangeStateVectors(qureg, (int) (qureg.chunkId ^ pairChunkBits));
+    statevec_multiControlledMultiRotatePauliDistributed(qureg, ctrlMask, xMask, zMask, cosAngle, pairFac, qureg.pairStateVec);
+}
+
 void statevec_pauliX(Qureg qureg, int targetQubit)
 {
     // flag to require memory exchange. 1: an entire block fits on one rank, 0: at most half a block fits on one rank
@@ -1355,6 +1395,202 @@ void densmatr_calcProbOfAllOutcomes(qreal* retProbs, Qureg qureg, int* qubits, i
     MPI_Allreduce(MPI_IN_PLACE, retProbs, 1LL<<numQubits, MPI_QuEST_REAL, MPI_SUM, MPI_COMM_WORLD);
 }
 
+/** Draws every shot as the basis state at which the global cumulative probability first 
+ * exceeds a uniformly random fraction of the total probability. Every node draws the same 
+ * random numbers (from a block reserved from the qureg's random stream), but only the node 
+ * whose chunk contains a shot's basis state resolves it
+ */
+static void sampleOutcomesFromCumulativeProbs(
+    Qureg qureg, qreal* cumProbs, long long int numProbs, long long int firstBasisInd, 
+    int* qubits, int numQubits, int numShots, long long int* outcomes
+) {
+    // gather the running total of the probabilities of every chunk
+    qreal localTotal = (numProbs > 0)? cumProbs[numProbs-1] : 0;
+    qreal* chunkCumProbs = malloc(qureg.numChunks * sizeof *chunkCumProbs);
+    MPI_Allgather(&localTotal, 1, MPI_QuEST_REAL, chunkCumProbs, 1, MPI_QuEST_REAL, MPI_COMM_WORLD);
+    for (int c=1; c<qureg.numChunks; c++)
+        chunkCumProbs[c] += chunkCumProbs[c-1];
+    
+    qreal globalTotal = chunkCumProbs[qureg.numChunks-1];
+    qreal chunkOffset = (qureg.chunkId > 0)? chunkCumProbs[qureg.chunkId-1] : 0;
+    
+    // shots outside this chunk are given a negative probability, and so are left as zero
+    qreal* shotProbs = malloc(numShots * sizeof *shotProbs);
+    unsigned long long int firstDraw = rng_skipAhead(qureg, numShots);
+    for (int s=0; s<numShots; s++) {
+        qreal prob = globalTotal * rng_getUniformAt(qureg, 0, firstDraw + s);
+        long long int chunk = findIndexOfCumulativeProb(chunkCumProbs, qureg.numChunks, prob);
+        shotProbs[s] = (chunk == qureg.chunkId)? prob - chunkOffset : -1;
+    }
+    sampleOutcomesFromCumulativeProbsLocal(outcomes, shotProbs, numShots, cumProbs, numProbs, firstBasisInd, qubits, numQubits);
+    
+    // every shot is resolved by exactly one node
+    MPI_Allreduce(MPI_IN_PLACE, outcomes, numShots, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+    
+    free(chunkCumProbs);
+    free(shotProbs);
+}
+
+void statevec_sampleOutcomes(Qureg qureg, int* qubits, int numQubits, int numShots, long long int* outcomes) {
+    
+    long long int numProbs, firstBasisInd;
+    qreal* cumProbs = statevec_createCumulativeProbsLocal(qureg, &numProbs, &firstBasisInd);
+    sampleOutcomesFromCumulativeProbs(qureg, cumProbs, numProbs, firstBasisInd, qubits, numQubits, numShots, outcomes);
+    free(cumProbs);
+}
+
+void densmatr_sampleOutcomes(Qureg qureg, int* qubits, int numQubits, int numShots, long long int* outcomes) {
+    
+    long long int numProbs, firstBasisInd;
+    qreal* cumProbs = densmatr_createCumulativeProbsLocal(qureg, &numProbs, &firstBasisInd);
+    sampleOutcomesFromCumulativeProbs(qureg, cumProbs, numProbs, firstBasisInd, qubits, numQubits, numShots, outcomes);
+    free(cumProbs);
+}
+
+void statevec_calcQubitCorrelationSums(Qureg qureg, qreal* sums, int calcPairs) {
+    
+    // every node sums its own amplitudes, before all sums are reduced at once
+    int n = qureg.numQubitsRepresented;
+    statevec_calcQubitCorrelationSumsLocal(qureg, sums, calcPairs);
+    MPI_Allreduce(MPI_IN_PLACE, sums, 1 + n + (calcPairs? n*n : 0), MPI_QuEST_REAL, MPI_SUM, MPI_COMM_WORLD);
+}
+
+void densmatr_calcQubitCorrelationSums(Qureg qureg, qreal* sums, int calcPairs) {
+    
+    // every node sums its own diagonal elements, before all sums are reduced at once
+    int n = qureg.numQubitsRepresented;
+    densmatr_calcQubitCorrelationSumsLocal(qureg, sums, calcPairs);
+    MPI_Allreduce(MPI_IN_PLACE, sums, 1 + n + (calcPairs? n*n : 0), MPI_QuEST_REAL, MPI_SUM, MPI_COMM_WORLD);
+}
+
+/** Merges the k most probable outcomes found by every node (in inds and probs, padded with 
+ * index -1) into the k most probable overall, which every node receives
+ */
+static void mergeTopOutcomes(Qureg qureg, int k, long long int* inds, qreal* probs) {
+    
+    long long int numCands = qureg.numChunks * (long long int) k;
+    long long int* candInds = malloc(numCands * sizeof *candInds);
+    qreal* candProbs = malloc(numCands * sizeof *candProbs);
+    
+    MPI_Allgather(inds, k, MPI_LONG_LONG, candInds, k, MPI_LONG_LONG, MPI_COMM_WORLD);
+    MPI_Allgather(probs, k, MPI_QuEST_REAL, candProbs, k, MPI_QuEST_REAL, MPI_COMM_WORLD);
+    selectTopOutcomes(candInds, candProbs, numCands, k, inds, probs);
+    
+    free(candInds);
+    free(candProbs);
+}
+
+void statevec_calcTopKOutcomes(Qureg qureg, int k, long long int* inds, qreal* probs) {
+    
+    statevec_findTopOutcomesLocal(qureg, k, inds, probs);
+    mergeTopOutcomes(qureg, k, inds, probs);
+}
+
+void densmatr_calcTopKOutcomes(Qureg qureg, int k, long long int* inds, qreal* probs) {
+    
+    densmatr_findTopOutcomesLocal(qureg, k, inds, probs);
+    mergeTopOutcomes(qureg, k, inds, probs);
+}
+
+void statevec_calcExpecPauliStrings(Qureg qureg, long long int* xMasks, long long int* zMasks, int numStrings, qreal* expecs) {
+    
+    // strings are grouped by the upper (beyond the chunk) bits of their X and Y targets, which
+    // determine the chunk holding every amplitude's partner, so that each group costs at most
+    // one exchange, and the entire batch a single reduction
+    int logNumAmps = 0;
+    while ((1LL << logNumAmps) < qureg.numAmpsPerChunk)
+        logNumAmps++;
+    
+    long long int* groupXMasks = malloc(numStrings * sizeof *groupXMasks);
+    long long int* groupZMasks = malloc(numStrings * sizeof *groupZMasks);
+    qreal* groupExpecs = malloc(numStrings * sizeof *groupExpecs);
+    int* groupStrings = malloc(numStrings * sizeof *groupStrings);
+    int* isDone = calloc(numStrings, sizeof *isDone);
+    
+    for (int t=0; t<numStrings; t++)
+        expecs[t] = 0;
+    
+    for (int t=0; t<numStrings; t++) {
+        if (isDone[t])
+            continue;
+        
+        long long int upperBits = xMasks[t] >> logNumAmps;
+        int numInGroup = 0;
+        for (int s=t; s<numStrings; s++) {
+            if (isDone[s] || (xMasks[s] >> logNumAmps) != upperBits)
+                continue;
+            isDone[s] = 1;
+            groupXMasks[numInGroup] = xMasks[s];
+            groupZMasks[numInGroup] = zMasks[s];
+            groupExpecs[numInGroup] = 0;
+            groupStrings[numInGroup++] = s;
+        }
+        
+        // every node forms the same groups in the same order, so exchanges always pair up
+        if (upperBits == 0)
+            statevec_calcExpecPauliStringsLocal(
+                qureg, qureg.stateVec.real, qureg.stateVec.imag, 
+                groupXMasks, groupZMasks, numInGroup, groupExpecs);
+        else {
+            exchangeStateVectors(qureg, (int) (qureg.chunkId ^ upperBits));
+            statevec_calcExpecPauliStringsLocal(
+                qureg, qureg.pairStateVec.real, qureg.pairStateVec.imag, 
+                groupXMasks, groupZMasks, numInGroup, groupExpecs);
+        }
+        
+        for (int g=0; g<numInGroup; g++)
+            expecs[groupStrings[g]] = groupExpecs[g];
+    }
+    
+    MPI_Allreduce(MPI_IN_PLACE, expecs, numStrings, MPI_QuEST_REAL, MPI_SUM, MPI_COMM_WORLD);
+    
+    free(groupXMasks);
+    free(groupZMasks);
+    free(groupExpecs);
+    free(groupStrings);
+    free(isDone);
+}
+
+void statevec_applyPauliMaskGroups(Qureg inQureg, long long int* groupXMasks, int* groupStarts, int numGroups, long long int* termZMasks, qreal* termCoeffsRe, qreal* termCoeffsIm, Qureg outQureg) {
+    
+    int logNumAmps = 0;
+    while ((1LL << logNumAmps) < inQureg.numAmpsPerChunk)
+        logNumAmps++;
+    
+    // groups are ordered by X mask, so those gathering from the same chunk are contiguous
+    int start = 0;
+    while (start < numGroups) {
+        long long int upperBits = groupXMasks[start] >> logNumAmps;
+        int end = start + 1;
+        while (end < numGroups && (groupXMasks[end] >> logNumAmps) == upperBits)
+            end++;
+        
+        // every node visits the same runs in the same order, so exchanges always pair up
+        if (upperBits == 0)
+            statevec_applyPauliMaskGroupsLocal(
+                outQureg, inQureg.stateVec.real, inQureg.stateVec.imag, 
+                &groupXMasks[start], &groupStarts[start], end - start, 
+                termZMasks, termCoeffsRe, termCoeffsIm);
+        else {
+            exchangeStateVectors(inQureg, (int) (inQureg.chunkId ^ upperBits));
+            statevec_applyPauliMaskGroupsLocal(
+                outQureg, inQureg.pairStateVec.real, inQureg.pairStateVec.imag, 
+                &groupXMasks[start], &groupStarts[start], end - start, 
+                termZMasks, termCoeffsRe, termCoeffsIm);
+        }
+        start = end;
+    }
+}
+
+void densmatr_calcExpecPauliStrings(Qureg qureg, long long int* xMasks, long long int* zMasks, int numStrings, qreal* expecs) {
+    
+    // every node sums the contributing elements it stores, needing no exchange
+    for (int t=0; t<numStrings; t++)
+        expecs[t] = 0;
+    densmatr_calcExpecPauliStringsLocal(qureg, xMasks, zMasks, numStrings, expecs);
+    MPI_Allreduce(MPI_IN_PLACE, expecs, numStrings, MPI_QuEST_REAL, MPI_SUM, MPI_COMM_WORLD);
+}
+
 qreal densmatr_calcPurity(Qureg qureg) {
     
     qreal localPurity = densmatr_calcPurityLocal(qureg);
@@ -1403,6 +1639,9 @@ void seedQuEST(QuESTEnv *env, unsigned long int* seedArray, int numSeeds) {
     
     // pass keys to Mersenne Twister seeder
     init_by_array(seedArray, numSeeds); 
+    
+    // every Qureg's random stream must be rekeyed by the new seeds
+    rng_resetStreams(seedArray, numSeeds);
 }
 
 /** returns -1 if this node contains no amplitudes where qb1 and qb2 
@@ -1446,6 +1685,89 @@ void statevec_swapQubitAmps(Qureg qureg, int qb1, int qb2) {
     statevec_swapQubitAmpsDistributed(qureg, pairRank, qb1, qb2);
 }
 
+void densmatr_multiControlledUnitary(Qureg qureg, long long int ctrlMask, long long int ctrlFlipMask, int targetQubit, ComplexMatrix2 u)
+{
+    if (qureg.isPackedDensityMatrix) {
+        packed_multiControlledUnitary(qureg, ctrlMask, ctrlFlipMask, targetQubit, u);
+        return;
+    }
+
+    int shift = qureg.numQubitsRepresented;
+    
+    // the row and column are updated in one pass only when the column target is local
+    if (halfMatrixBlockFitsInChunk(qureg.numAmpsPerChunk, targetQubit + shift)) {
+        densmatr_multiControlledUnitaryLocal(qureg, ctrlMask, ctrlFlipMask, targetQubit, u);
+        return;
+    }
+    statevec_multiControlledUnitary(qureg, ctrlMask, ctrlFlipMask, targetQubit, u);
+    statevec_multiControlledUnitary(qureg, ctrlMask<<shift, ctrlFlipMask<<shift, targetQubit+shift, getConjugateMatrix2(u));
+}
+
+void densmatr_multiControlledTwoQubitUnitary(Qureg qureg, long long int ctrlMask, int targetQubit1, int targetQubit2, ComplexMatrix4 u)
+{
+    if (qureg.isPackedDensityMatrix) {
+        packed_multiControlledTwoQubitUnitary(qureg, ctrlMask, targetQubit1, targetQubit2, u);
+        return;
+    }
+
+    int shift = qureg.numQubitsRepresented;
+    int maxTarget = (targetQubit1 > targetQubit2)? targetQubit1 : targetQubit2;
+    
+    if (halfMatrixBlockFitsInChunk(qureg.numAmpsPerChunk, maxTarget + shift)) {
+        densmatr_multiControlledTwoQubitUnitaryLocal(qureg, ctrlMask, targetQubit1, targetQubit2, u);
+        return;
+    }
+    statevec_multiControlledTwoQubitUnitary(qureg, ctrlMask, targetQubit1, targetQubit2, u);
+    statevec_multiControlledTwoQubitUnitary(qureg, ctrlMask<<shift, targetQubit1+shift, targetQubit2+shift, getConjugateMatrix4(u));
+}
+
+void densmatr_mixMultiQubitKrausMap(Qureg qureg, int* targets, int numTargets, ComplexMatrixN* ops, int numOps)
+{
+    int maxTarget = 0;
+    for (int t=0; t<numTargets; t++)
+        if (targets[t] > maxTarget)
+            maxTarget = targets[t];
+    
+    // the map is applied directly (without communication) only when every column target is local
+    if (densityMatrixBlockFitsInChunk(qureg.numAmpsPerChunk, qureg.numQubitsRepresented, maxTarget) &&
+        isKrausMapCheaperWithoutSuperoperator(qureg, numTargets, numOps)) {
+        densmatr_mixMultiQubitKrausMapLocal(qureg, targets, numTargets, ops, numOps);
+        return;
+    }
+    densmatr_mixMultiQubitKrausMapAsSuperoperator(qureg, targets, numTargets, ops, numOps);
+}
+
+void densmatr_mixNoiseLayer(Qureg qureg, NoiseChannel* channels)
+{
+    // packed density matrices are never distributed
+    if (qureg.isPackedDensityMatrix) {
+        for (int q=0; q<qureg.numQubitsRepresented; q++)
+            densmatr_mixNoiseChannel(qureg, q, channels[q]);
+        return;
+    }
+    
+    int targets[64];
+    qreal dephaseFacs[64], popMatrs[4*64], cohMatrs[4*64];
+    int numTargets = getNoiseLayerMatrices(qureg, channels, dephaseFacs, targets, popMatrs, cohMatrs);
+    
+    // channels upon qubits with local columns are batched (with the dephasing), and the rest 
+    // applied individually
+    int numLocal = 0;
+    for (int t=0; t<numTargets; t++) {
+        if (!densityMatrixBlockFitsInChunk(qureg.numAmpsPerChunk, qureg.numQubitsRepresented, targets[t])) {
+            densmatr_mixNoiseChannel(qureg, targets[t], channels[targets[t]]);
+            continue;
+        }
+        targets[numLocal] = targets[t];
+        for (int i=0; i<4; i++) {
+            popMatrs[4*numLocal + i] = popMatrs[4*t + i];
+            cohMatrs[4*numLocal + i] = cohMatrs[4*t + i];
+        }
+        numLocal++;
+    }
+    densmatr_mixOneQubitChannelsLocal(qureg, dephaseFacs, targets, numLocal, popMatrs, cohMatrs);
+}
+
 /** This calls swapQubitAmps only when it would involve a distributed communication;
  * if the qubit chunks already fit in the node, it operates the unitary direct.
  * Note the order of q1 and q2 in the call to twoQubitUnitaryLocal is important.
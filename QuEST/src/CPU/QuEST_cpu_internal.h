@@ -52,6 +52,21 @@ static inline long long int insertTwoZeroBits(const long long int number, const
     return insertZeroBit(insertZeroBit(number, small), big);
 }
 
+static inline long long int insertZeroBits(long long int number, const int* sortedInds, const int numInds) {
+    for (int i=0; i < numInds; i++)
+        number = insertZeroBit(number, sortedInds[i]);
+    return number;
+}
+
+
+/*
+ * vectorised kernel dispatch
+ */
+
+void selectVectorisedKernels(void);
+
+const char* getVectorisedKernelsName(void);
+
 
 /*
  * density matrix operations
@@ -204,5 +219,42 @@ Complex statevec_calcExpecDiagonalOpLocal(Qureg qureg, DiagonalOp op);
 
 void statevec_calcProbOfAllOutcomesLocal(qreal* retProbs, Qureg qureg, int* qubits, int numQubits);
 
+qreal* statevec_createCumulativeProbsLocal(Qureg qureg, long long int* numProbs, long long int* firstBasisInd);
+
+qreal* densmatr_createCumulativeProbsLocal(Qureg qureg, long long int* numProbs, long long int* firstBasisInd);
+
+void statevec_calcQubitCorrelationSumsLocal(Qureg qureg, qreal* sums, int calcPairs);
+
+void densmatr_calcQubitCorrelationSumsLocal(Qureg qureg, qreal* sums, int calcPairs);
+
+void statevec_findTopOutcomesLocal(Qureg qureg, int k, long long int* inds, qreal* probs);
+
+void densmatr_findTopOutcomesLocal(Qureg qureg, int k, long long int* inds, qreal* probs);
+
+void statevec_calcExpecPauliStringsLocal(Qureg qureg, qreal* pairRe, qreal* pairIm, long long int* xMasks, long long int* zMasks, int numStrings, qreal* expecs);
+
+void densmatr_calcExpecPauliStringsLocal(Qureg qureg, long long int* xMasks, long long int* zMasks, int numStrings, qreal* expecs);
+
+void statevec_applyPauliMaskGroupsLocal(Qureg outQureg, qreal* pairRe, qreal* pairIm, long long int* groupXMasks, int* groupStarts, int numGroups, long long int* termZMasks, qreal* termCoeffsRe, qreal* termCoeffsIm);
+
+void densmatr_multiControlledUnitaryLocal(Qureg qureg, long long int ctrlMask, long long int ctrlFlipMask, int targetQubit, ComplexMatrix2 u);
+
+void densmatr_multiControlledTwoQubitUnitaryLocal(Qureg qureg, long long int ctrlMask, int targetQubit1, int targetQubit2, ComplexMatrix4 u);
+
+void densmatr_mixMultiQubitKrausMapLocal(Qureg qureg, int* targets, int numTargets, ComplexMatrixN* ops, int numOps);
+
+void densmatr_mixOneQubitChannelsLocal(Qureg qureg, qreal* dephaseFacs, int* targets, int numTargets, qreal* popMatrs, qreal* cohMatrs);
+
+void statevec_multiControlledMultiRotatePauliLocal(Qureg qureg, long long int ctrlMask, long long int xMask, long long int zMask, qreal cosAngle, Complex pairFac);
+
+void statevec_multiControlledMultiRotatePauliDistributed(Qureg qureg, long long int ctrlMask, long long int xMask, long long int zMask, qreal cosAngle, Complex pairFac, ComplexArray pairStateVec);
+
+long long int findIndexOfCumulativeProb(qreal* cumProbs, long long int numProbs, qreal prob);
+
+void sampleOutcomesFromCumulativeProbsLocal(
+    long long int* outcomes, qreal* shotProbs, int numShots, 
+    qreal* cumProbs, long long int numProbs, long long int firstBasisInd, 
+    int* qubits, int numQubits);
+
 
 # endif // QUEST_CPU_INTERNAL_H
@@ -12,6 +12,8 @@
 # include "QuEST.h"
 # include "QuEST_internal.h"
 # include "QuEST_precision.h"
+# include "QuEST_rng.h"
+# include "QuEST_packed.h"
 # include "mt19937ar.h"
 
 # include "QuEST_cpu_internal.h"
@@ -127,7 +129,7 @@ qreal densmatr_calcTotalProb(Qureg qureg) {
     
     for (int col=0; col< numCols; col++) {
         diagIndex = col*(numCols + 1);
-        y = qureg.stateVec.real[diagIndex] - c;
+        y = qureg.stateVec.real[AMP_INDEX(diagIndex)] - c;
         t = pTotal + y;
         c = ( t - pTotal ) - y; // brackets are important
         pTotal = t;
@@ -147,17 +149,17 @@ qreal statevec_calcTotalProb(Qureg qureg){
     long long int numAmpsPerRank = qureg.numAmpsPerChunk;
     c = 0.0;
     for (index=0; index<numAmpsPerRank; index++){ 
-        // Perform pTotal+=qureg.stateVec.real[index]*qureg.stateVec.real[index]; by Kahan
+        // Perform pTotal+=qureg.stateVec.real[AMP_INDEX(index)]*qureg.stateVec.real[AMP_INDEX(index)]; by Kahan
 
-        y = qureg.stateVec.real[index]*qureg.stateVec.real[index] - c;
+        y = qureg.stateVec.real[AMP_INDEX(index)]*qureg.stateVec.real[AMP_INDEX(index)] - c;
         t = pTotal + y;
         // Don't change the bracketing on the following line
         c = ( t - pTotal ) - y;
         pTotal = t;
 
-        // Perform pTotal+=qureg.stateVec.imag[index]*qureg.stateVec.imag[index]; by Kahan
+        // Perform pTotal+=qureg.stateVec.imag[AMP_INDEX(index)]*qureg.stateVec.imag[AMP_INDEX(index)]; by Kahan
 
-        y = qureg.stateVec.imag[index]*qureg.stateVec.imag[index] - c;
+        y = qureg.stateVec.imag[AMP_INDEX(index)]*qureg.stateVec.imag[AMP_INDEX(index)] - c;
         t = pTotal + y;
         // Don't change the bracketing on the following line
         c = ( t - pTotal ) - y;
@@ -178,6 +180,8 @@ QuESTEnv createQuESTEnv(void) {
     env.numSeeds = 0;
     seedQuESTDefault(&env);
     
+    selectVectorisedKernels();
+    
     return env;
 }
 
@@ -191,6 +195,7 @@ int syncQuESTSuccess(int successCode){
 
 void destroyQuESTEnv(QuESTEnv env){
     free(env.seeds);
+    agnostic_setPhaseFuncCaching(0);
 }
 
 void reportQuESTEnv(QuESTEnv env){
@@ -204,6 +209,7 @@ void reportQuESTEnv(QuESTEnv env){
     printf("OpenMP disabled\n");
 # endif
     printf("Precision: size of qreal is %ld bytes\n", sizeof(qreal));
+    printf("Vectorised kernels: %s\n", getVectorisedKernelsName());
 }
 
 void getEnvironmentString(QuESTEnv env, char str[200]){
@@ -217,11 +223,11 @@ void getEnvironmentString(QuESTEnv env, char str[200]){
 }
 
 qreal statevec_getRealAmp(Qureg qureg, long long int index){
-    return qureg.stateVec.real[index];
+    return qureg.stateVec.real[AMP_INDEX(index)];
 }
 
 qreal statevec_getImagAmp(Qureg qureg, long long int index){
-    return qureg.stateVec.imag[index];
+    return qureg.stateVec.imag[AMP_INDEX(index)];
 }
 
 void statevec_compactUnitary(Qureg qureg, int targetQubit, Complex alpha, Complex beta) 
@@ -249,6 +255,26 @@ void statevec_multiControlledUnitary(Qureg qureg, long long int ctrlQubitsMask,
     statevec_multiControlledUnitaryLocal(qureg, targetQubit, ctrlQubitsMask, ctrlFlipMask, u);
 }
 
+void densmatr_multiControlledUnitary(Qureg qureg, long long int ctrlMask, long long int ctrlFlipMask, int targetQubit, ComplexMatrix2 u) 
+{
+    if (qureg.isPackedDensityMatrix) {
+        packed_multiControlledUnitary(qureg, ctrlMask, ctrlFlipMask, targetQubit, u);
+        return;
+    }
+
+    densmatr_multiControlledUnitaryLocal(qureg, ctrlMask, ctrlFlipMask, targetQubit, u);
+}
+
+void statevec_multiControlledMultiRotatePauliMasks(Qureg qureg, long long int ctrlMask, long long int xMask, long long int zMask, qreal angle, int applyConj)
+{
+    // a string of only Z (and I) is diagonal
+    if (xMask == 0)
+        statevec_multiControlledMultiRotateZ(qureg, ctrlMask, zMask, (applyConj)? -angle : angle);
+    else
+        statevec_multiControlledMultiRotatePauliLocal(
+            qureg, ctrlMask, xMask, zMask, cos(angle/2), getPauliRotationPairFactor(xMask, zMask, angle, applyConj));
+}
+
 void statevec_pauliX(Qureg qureg, int targetQubit) 
 {
     statevec_pauliXLocal(qureg, targetQubit);
@@ -319,6 +345,90 @@ void densmatr_calcProbOfAllOutcomes(qreal* retProbs, Qureg qureg, int* qubits, i
     densmatr_calcProbOfAllOutcomesLocal(retProbs, qureg, qubits, numQubits);
 }
 
+/** Draws every shot as the basis state at which the cumulative probability first exceeds 
+ * a uniformly random fraction of the total probability. The s-th shot uses the s-th number
+ * of a block reserved from the qureg's random stream, so shots are drawn in parallel
+ */
+static void sampleOutcomesFromCumulativeProbs(
+    Qureg qureg, qreal* cumProbs, long long int numProbs, long long int firstBasisInd, 
+    int* qubits, int numQubits, int numShots, long long int* outcomes
+) {
+    qreal total = cumProbs[numProbs-1];
+    qreal* shotProbs = malloc(numShots * sizeof *shotProbs);
+    unsigned long long int firstDraw = rng_skipAhead(qureg, numShots);
+    int s;
+    
+# ifdef _OPENMP
+# pragma omp parallel for \
+    default  (none) \
+    shared   (qureg, shotProbs, numShots, firstDraw, total) \
+    private  (s) \
+    schedule (static)
+# endif
+    for (s=0; s<numShots; s++)
+        shotProbs[s] = total * rng_getUniformAt(qureg, 0, firstDraw + s);
+    
+    sampleOutcomesFromCumulativeProbsLocal(outcomes, shotProbs, numShots, cumProbs, numProbs, firstBasisInd, qubits, numQubits);
+    free(shotProbs);
+}
+
+void statevec_sampleOutcomes(Qureg qureg, int* qubits, int numQubits, int numShots, long long int* outcomes) {
+    
+    long long int numProbs, firstBasisInd;
+    qreal* cumProbs = statevec_createCumulativeProbsLocal(qureg, &numProbs, &firstBasisInd);
+    sampleOutcomesFromCumulativeProbs(qureg, cumProbs, numProbs, firstBasisInd, qubits, numQubits, numShots, outcomes);
+    free(cumProbs);
+}
+
+void densmatr_sampleOutcomes(Qureg qureg, int* qubits, int numQubits, int numShots, long long int* outcomes) {
+    
+    long long int numProbs, firstBasisInd;
+    qreal* cumProbs = densmatr_createCumulativeProbsLocal(qureg, &numProbs, &firstBasisInd);
+    sampleOutcomesFromCumulativeProbs(qureg, cumProbs, numProbs, firstBasisInd, qubits, numQubits, numShots, outcomes);
+    free(cumProbs);
+}
+
+void statevec_calcQubitCorrelationSums(Qureg qureg, qreal* sums, int calcPairs) {
+    
+    statevec_calcQubitCorrelationSumsLocal(qureg, sums, calcPairs);
+}
+
+void densmatr_calcQubitCorrelationSums(Qureg qureg, qreal* sums, int calcPairs) {
+    
+    densmatr_calcQubitCorrelationSumsLocal(qureg, sums, calcPairs);
+}
+
+void statevec_calcTopKOutcomes(Qureg qureg, int k, long long int* inds, qreal* probs) {
+    
+    statevec_findTopOutcomesLocal(qureg, k, inds, probs);
+}
+
+void densmatr_calcTopKOutcomes(Qureg qureg, int k, long long int* inds, qreal* probs) {
+    
+    densmatr_findTopOutcomesLocal(qureg, k, inds, probs);
+}
+
+void statevec_calcExpecPauliStrings(Qureg qureg, long long int* xMasks, long long int* zMasks, int numStrings, qreal* expecs) {
+    
+    for (int t=0; t<numStrings; t++)
+        expecs[t] = 0;
+    statevec_calcExpecPauliStringsLocal(qureg, qureg.stateVec.real, qureg.stateVec.imag, xMasks, zMasks, numStrings, expecs);
+}
+
+void densmatr_calcExpecPauliStrings(Qureg qureg, long long int* xMasks, long long int* zMasks, int numStrings, qreal* expecs) {
+    
+    for (int t=0; t<numStrings; t++)
+        expecs[t] = 0;
+    densmatr_calcExpecPauliStringsLocal(qureg, xMasks, zMasks, numStrings, expecs);
+}
+
+void statevec_applyPauliMaskGroups(Qureg inQureg, long long int* groupXMasks, int* groupStarts, int numGroups, long long int* termZMasks, qreal* termCoeffsRe, qreal* termCoeffsIm, Qureg outQureg) {
+    
+    statevec_applyPauliMaskGroupsLocal(
+        outQureg, inQureg.stateVec.real, inQureg.stateVec.imag, 
+        groupXMasks, groupStarts, numGroups, termZMasks, termCoeffsRe, termCoeffsIm);
+}
+
 void statevec_collapseToKnownProbOutcome(Qureg qureg, int measureQubit, int outcome, qreal stateProb)
 {
     statevec_collapseToKnownProbOutcomeLocal(qureg, measureQubit, outcome, stateProb);
@@ -338,6 +448,9 @@ void seedQuEST(QuESTEnv *env, unsigned long int *seedArray, int numSeeds) {
     
     // pass keys to Mersenne Twister seeder
     init_by_array(seedArray, numSeeds); 
+    
+    // every Qureg's random stream must be rekeyed by the new seeds
+    rng_resetStreams(seedArray, numSeeds);
 }
 
 void statevec_multiControlledTwoQubitUnitary(Qureg qureg, long long int ctrlMask, int q1, int q2, ComplexMatrix4 u)
@@ -345,6 +458,38 @@ void statevec_multiControlledTwoQubitUnitary(Qureg qureg, long long int ctrlMask
     statevec_multiControlledTwoQubitUnitaryLocal(qureg, ctrlMask, q1, q2, u);
 }
 
+void densmatr_multiControlledTwoQubitUnitary(Qureg qureg, long long int ctrlMask, int targetQubit1, int targetQubit2, ComplexMatrix4 u)
+{
+    if (qureg.isPackedDensityMatrix) {
+        packed_multiControlledTwoQubitUnitary(qureg, ctrlMask, targetQubit1, targetQubit2, u);
+        return;
+    }
+
+    densmatr_multiControlledTwoQubitUnitaryLocal(qureg, ctrlMask, targetQubit1, targetQubit2, u);
+}
+
+void densmatr_mixMultiQubitKrausMap(Qureg qureg, int* targets, int numTargets, ComplexMatrixN* ops, int numOps)
+{
+    if (isKrausMapCheaperWithoutSuperoperator(qureg, numTargets, numOps))
+        densmatr_mixMultiQubitKrausMapLocal(qureg, targets, numTargets, ops, numOps);
+    else
+        densmatr_mixMultiQubitKrausMapAsSuperoperator(qureg, targets, numTargets, ops, numOps);
+}
+
+void densmatr_mixNoiseLayer(Qureg qureg, NoiseChannel* channels)
+{
+    if (qureg.isPackedDensityMatrix) {
+        for (int q=0; q<qureg.numQubitsRepresented; q++)
+            densmatr_mixNoiseChannel(qureg, q, channels[q]);
+        return;
+    }
+    
+    int targets[64];
+    qreal dephaseFacs[64], popMatrs[4*64], cohMatrs[4*64];
+    int numTargets = getNoiseLayerMatrices(qureg, channels, dephaseFacs, targets, popMatrs, cohMatrs);
+    densmatr_mixOneQubitChannelsLocal(qureg, dephaseFacs, targets, numTargets, popMatrs, cohMatrs);
+}
+
 void statevec_multiControlledMultiQubitUnitary(Qureg qureg, long long int ctrlMask, int* targs, int numTargs, ComplexMatrixN u)
 {
     statevec_multiControlledMultiQubitUnitaryLocal(qureg, ctrlMask, targs, numTargs, u);
@@ -10,6 +10,8 @@
 # include "QuEST.h"
 # include "QuEST_precision.h"
 # include "QuEST_internal.h"    // purely to resolve getQuESTDefaultSeedKey
+# include "QuEST_rng.h"
+# include "QuEST_packed.h"
 # include "mt19937ar.h"
 
 # include <stdlib.h>
@@ -18,6 +20,7 @@
 
 # define REDUCE_SHARED_SIZE 512
 # define DEBUG 0
+# define TOP_OUTCOMES_BATCH_SIZE (1LL << 20)
 
 
 
@@ -302,6 +305,7 @@ void statevec_createQureg(Qureg *qureg, int numQubits, QuESTEnv env)
     qureg->chunkId = env.rank;
     qureg->numChunks = env.numRanks;
     qureg->isDensityMatrix = 0;
+    qureg->isPackedDensityMatrix = 0;
 
     // allocate GPU memory
     cudaMalloc(&(qureg->deviceStateVec.real), qureg->numAmpsPerChunk*sizeof(*(qureg->deviceStateVec.real)));
@@ -518,6 +522,10 @@ void getEnvironmentString(QuESTEnv env, char str[200]){
 
 void copyStateToGPU(Qureg qureg)
 {
+    // packed density matrices reside only in host memory
+    if (qureg.isPackedDensityMatrix)
+        return;
+    
     if (DEBUG) printf("Copying data to GPU\n");
     cudaMemcpy(qureg.deviceStateVec.real, qureg.stateVec.real, 
             qureg.numAmpsPerChunk*sizeof(*(qureg.deviceStateVec.real)), cudaMemcpyHostToDevice);
@@ -528,6 +536,10 @@ void copyStateToGPU(Qureg qureg)
 
 void copyStateFromGPU(Qureg qureg)
 {
+    // packed density matrices reside only in host memory
+    if (qureg.isPackedDensityMatrix)
+        return;
+    
     cudaDeviceSynchronize();
     if (DEBUG) printf("Copying data from GPU\n");
     cudaMemcpy(qureg.stateVec.real, qureg.deviceStateVec.real, 
@@ -1093,6 +1105,13 @@ void statevec_multiControlledMultiQubitUnitary(Qureg qureg, long long int ctrlMa
     cudaFree(d_imAmps);
 }
 
+void statevec_applyGatesInTiles(Qureg qureg, int numTileQubits, ComplexMatrixN* gates, int** targs, int numGates)
+{
+    // the GPU state is not cache-blocked; each gate is applied to the full state in turn
+    for (int g=0; g < numGates; g++)
+        statevec_multiControlledMultiQubitUnitary(qureg, 0, targs[g], gates[g].numQubits, gates[g]);
+}
+
 __global__ void statevec_multiControlledTwoQubitUnitaryKernel(Qureg qureg, long long int ctrlMask, int q1, int q2, ArgMatrix4 u){
     
     // decide the 4 amplitudes this thread will modify
@@ -1313,6 +1332,241 @@ void statevec_multiControlledUnitary(
         qureg, ctrlQubitsMask, ctrlFlipMask, targetQubit, argifyMatrix2(u));
 }
 
+__forceinline__ __device__ void applyMatrix2ToPair(
+    ComplexMatrix2* u, qreal conjFac, qreal* re0, qreal* im0, qreal* re1, qreal* im1
+) {
+    qreal r0=*re0, i0=*im0, r1=*re1, i1=*im1;
+    *re0 = u->real[0][0]*r0 - conjFac*u->imag[0][0]*i0 + u->real[0][1]*r1 - conjFac*u->imag[0][1]*i1;
+    *im0 = u->real[0][0]*i0 + conjFac*u->imag[0][0]*r0 + u->real[0][1]*i1 + conjFac*u->imag[0][1]*r1;
+    *re1 = u->real[1][0]*r0 - conjFac*u->imag[1][0]*i0 + u->real[1][1]*r1 - conjFac*u->imag[1][1]*i1;
+    *im1 = u->real[1][0]*i0 + conjFac*u->imag[1][0]*r0 + u->real[1][1]*i1 + conjFac*u->imag[1][1]*r1;
+}
+
+__global__ void densmatr_multiControlledUnitaryKernel(
+    Qureg qureg, long long int ctrlMask, long long int ctrlFlipMask, int targetQubit, ComplexMatrix2 u
+) {
+    long long int thisTask = blockIdx.x*blockDim.x + threadIdx.x;
+    long long int numTasks = qureg.numAmpsPerChunk >> 2;
+    if (thisTask>=numTasks) return;
+    
+    int numQubits = qureg.numQubitsRepresented;
+    int rowBit = targetQubit;
+    int colBit = targetQubit + numQubits;
+    
+    // U is left-multiplied when the row satisfies the controls, and U^dagger right-multiplied 
+    // when the column does
+    long long int ind00 = insertTwoZeroBits(thisTask, rowBit, colBit);
+    int rowCtrl = (((ind00 ^ ctrlFlipMask) & ctrlMask) == ctrlMask);
+    int colCtrl = (((ind00 ^ (ctrlFlipMask << numQubits)) & (ctrlMask << numQubits)) == (ctrlMask << numQubits));
+    if (!rowCtrl && !colCtrl)
+        return;
+    
+    qreal *reVec = qureg.deviceStateVec.real;
+    qreal *imVec = qureg.deviceStateVec.imag;
+    long long int ind10 = flipBit(ind00, rowBit);
+    long long int ind01 = flipBit(ind00, colBit);
+    long long int ind11 = flipBit(ind01, rowBit);
+    qreal re00 = reVec[ind00], im00 = imVec[ind00];
+    qreal re01 = reVec[ind01], im01 = imVec[ind01];
+    qreal re10 = reVec[ind10], im10 = imVec[ind10];
+    qreal re11 = reVec[ind11], im11 = imVec[ind11];
+    
+    if (rowCtrl) {
+        applyMatrix2ToPair(&u, 1, &re00, &im00, &re10, &im10);
+        applyMatrix2ToPair(&u, 1, &re01, &im01, &re11, &im11);
+    }
+    if (colCtrl) {
+        applyMatrix2ToPair(&u, -1, &re00, &im00, &re01, &im01);
+        applyMatrix2ToPair(&u, -1, &re10, &im10, &re11, &im11);
+    }
+    
+    reVec[ind00] = re00; imVec[ind00] = im00;
+    reVec[ind01] = re01; imVec[ind01] = im01;
+    reVec[ind10] = re10; imVec[ind10] = im10;
+    reVec[ind11] = re11; imVec[ind11] = im11;
+}
+
+void densmatr_multiControlledUnitary(Qureg qureg, long long int ctrlMask, long long int ctrlFlipMask, int targetQubit, ComplexMatrix2 u)
+{
+    if (qureg.isPackedDensityMatrix) {
+        packed_multiControlledUnitary(qureg, ctrlMask, ctrlFlipMask, targetQubit, u);
+        return;
+    }
+
+    int threadsPerCUDABlock = 128;
+    int CUDABlocks = ceil((qreal)(qureg.numAmpsPerChunk>>2)/threadsPerCUDABlock);
+    densmatr_multiControlledUnitaryKernel<<<CUDABlocks, threadsPerCUDABlock>>>(
+        qureg, ctrlMask, ctrlFlipMask, targetQubit, u);
+}
+
+__forceinline__ __device__ void applyMatrix4ToQuad(ComplexMatrix4* u, qreal conjFac, qreal* re, qreal* im, int first, int stride) {
+    
+    qreal r[4], i[4];
+    for (int k=0; k<4; k++) {
+        r[k] = re[first + k*stride];
+        i[k] = im[first + k*stride];
+    }
+    for (int k=0; k<4; k++) {
+        qreal sumRe = 0;
+        qreal sumIm = 0;
+        for (int l=0; l<4; l++) {
+            sumRe += u->real[k][l]*r[l] - conjFac*u->imag[k][l]*i[l];
+            sumIm += u->real[k][l]*i[l] + conjFac*u->imag[k][l]*r[l];
+        }
+        re[first + k*stride] = sumRe;
+        im[first + k*stride] = sumIm;
+    }
+}
+
+__global__ void densmatr_multiControlledTwoQubitUnitaryKernel(
+    Qureg qureg, long long int ctrlMask, int q1, int q2, ComplexMatrix4 u
+) {
+    long long int thisTask = blockIdx.x*blockDim.x + threadIdx.x;
+    long long int numTasks = qureg.numAmpsPerChunk >> 4;
+    if (thisTask>=numTasks) return;
+    
+    int numQubits = qureg.numQubitsRepresented;
+    long long int ind0 = insertTwoZeroBits(insertTwoZeroBits(thisTask, q1, q2), q1 + numQubits, q2 + numQubits);
+    int rowCtrl = ((ind0 & ctrlMask) == ctrlMask);
+    int colCtrl = ((ind0 & (ctrlMask << numQubits)) == (ctrlMask << numQubits));
+    if (!rowCtrl && !colCtrl)
+        return;
+    
+    // the 16 elements, with row k and column l (whose bit 0 is that of q1) at [4*k + l]
+    qreal *reVec = qureg.deviceStateVec.real;
+    qreal *imVec = qureg.deviceStateVec.imag;
+    long long int inds[16];
+    qreal re[16], im[16];
+    for (int k=0; k<4; k++) {
+        for (int l=0; l<4; l++) {
+            long long int rowOff = ((k & 1LL) << q1) | (((k >> 1) & 1LL) << q2);
+            long long int colOff = (((l & 1LL) << q1) | (((l >> 1) & 1LL) << q2)) << numQubits;
+            inds[4*k+l] = ind0 | rowOff | colOff;
+            re[4*k+l] = reVec[inds[4*k+l]];
+            im[4*k+l] = imVec[inds[4*k+l]];
+        }
+    }
+    
+    // U rho upon every column, then rho U^dagger upon every row
+    if (rowCtrl)
+        for (int l=0; l<4; l++)
+            applyMatrix4ToQuad(&u, 1, re, im, l, 4);
+    if (colCtrl)
+        for (int k=0; k<4; k++)
+            applyMatrix4ToQuad(&u, -1, re, im, 4*k, 1);
+    
+    for (int k=0; k<16; k++) {
+        reVec[inds[k]] = re[k];
+        imVec[inds[k]] = im[k];
+    }
+}
+
+void densmatr_multiControlledTwoQubitUnitary(Qureg qureg, long long int ctrlMask, int targetQubit1, int targetQubit2, ComplexMatrix4 u)
+{
+    if (qureg.isPackedDensityMatrix) {
+        packed_multiControlledTwoQubitUnitary(qureg, ctrlMask, targetQubit1, targetQubit2, u);
+        return;
+    }
+
+    int threadsPerCUDABlock = 128;
+    int CUDABlocks = ceil((qreal)(qureg.numAmpsPerChunk>>4)/threadsPerCUDABlock); // one kernel eval for every 16 amplitudes
+    densmatr_multiControlledTwoQubitUnitaryKernel<<<CUDABlocks, threadsPerCUDABlock>>>(
+        qureg, ctrlMask, targetQubit1, targetQubit2, u);
+}
+
+void densmatr_mixMultiQubitKrausMap(Qureg qureg, int* targets, int numTargets, ComplexMatrixN* ops, int numOps)
+{
+    // each CUDA thread lacks the memory to privately store a 2^numTargets x 2^numTargets block, 
+    // so the map is always applied as a superoperator
+    densmatr_mixMultiQubitKrausMapAsSuperoperator(qureg, targets, numTargets, ops, numOps);
+}
+
+void densmatr_mixNoiseLayer(Qureg qureg, NoiseChannel* channels)
+{
+    for (int q=0; q<qureg.numQubitsRepresented; q++)
+        densmatr_mixNoiseChannel(qureg, q, channels[q]);
+}
+
+__global__ void densmatr_multiControlledPhaseShiftByTermKernel(Qureg qureg, long long int mask, qreal termReal, qreal termImag) {
+    
+    long long int index = blockIdx.x*blockDim.x + threadIdx.x;
+    if (index>=qureg.numAmpsPerChunk) return;
+    
+    // only elements where exactly one of the row and column has every qubit set are modified
+    long long int colMask = mask << qureg.numQubitsRepresented;
+    int rowSet = ((index & mask) == mask);
+    int colSet = ((index & colMask) == colMask);
+    if (rowSet == colSet)
+        return;
+    
+    qreal facImag = (rowSet)? termImag : - termImag;
+    qreal stateReal = qureg.deviceStateVec.real[index];
+    qreal stateImag = qureg.deviceStateVec.imag[index];
+    qureg.deviceStateVec.real[index] = termReal*stateReal - facImag*stateImag;
+    qureg.deviceStateVec.imag[index] = termReal*stateImag + facImag*stateReal;
+}
+
+void densmatr_multiControlledPhaseShiftByTerm(Qureg qureg, long long int mask, Complex term)
+{
+    if (qureg.isPackedDensityMatrix) {
+        packed_multiControlledPhaseShiftByTerm(qureg, mask, term);
+        return;
+    }
+
+    int threadsPerCUDABlock = 128;
+    int CUDABlocks = ceil((qreal)(qureg.numAmpsPerChunk)/threadsPerCUDABlock);
+    densmatr_multiControlledPhaseShiftByTermKernel<<<CUDABlocks, threadsPerCUDABlock>>>(
+        qureg, mask, term.real, term.imag);
+}
+
+__global__ void densmatr_multiControlledMultiRotateZKernel(
+    Qureg qureg, long long int ctrlMask, long long int targMask, qreal angle
+) {
+    long long int index = blockIdx.x*blockDim.x + threadIdx.x;
+    if (index>=qureg.numAmpsPerChunk) return;
+    
+    int shift = qureg.numQubitsRepresented;
+    int rowCtrl = ((index & ctrlMask) == ctrlMask);
+    int colCtrl = ((index & (ctrlMask << shift)) == (ctrlMask << shift));
+    if (!rowCtrl && !colCtrl)
+        return;
+    
+    qreal cosAngle = cos(angle/2);
+    qreal sinAngle = sin(angle/2);
+    qreal stateReal = qureg.deviceStateVec.real[index];
+    qreal stateImag = qureg.deviceStateVec.imag[index];
+    qreal newReal, sinPhase;
+    
+    // the row contributes exp(-+ i angle/2), then the column its conjugate
+    if (rowCtrl) {
+        sinPhase = (2*getBitMaskParity(index & targMask) - 1) * sinAngle;
+        newReal = cosAngle*stateReal - sinPhase*stateImag;
+        stateImag = cosAngle*stateImag + sinPhase*stateReal;
+        stateReal = newReal;
+    }
+    if (colCtrl) {
+        sinPhase = (1 - 2*getBitMaskParity(index & (targMask << shift))) * sinAngle;
+        newReal = cosAngle*stateReal - sinPhase*stateImag;
+        stateImag = cosAngle*stateImag + sinPhase*stateReal;
+        stateReal = newReal;
+    }
+    qureg.deviceStateVec.real[index] = stateReal;
+    qureg.deviceStateVec.imag[index] = stateImag;
+}
+
+void densmatr_multiControlledMultiRotateZ(Qureg qureg, long long int ctrlMask, long long int targMask, qreal angle)
+{
+    if (qureg.isPackedDensityMatrix) {
+        packed_multiControlledMultiRotateZ(qureg, ctrlMask, targMask, angle);
+        return;
+    }
+
+    int threadsPerCUDABlock = 128;
+    int CUDABlocks = ceil((qreal)(qureg.numAmpsPerChunk)/threadsPerCUDABlock);
+    densmatr_multiControlledMultiRotateZKernel<<<CUDABlocks, threadsPerCUDABlock>>>(
+        qureg, ctrlMask, targMask, angle);
+}
+
 __global__ void statevec_pauliXKernel(Qureg qureg, int targetQubit){
     // ----- sizes
     long long int sizeBlock,                                           // size of blocks
@@ -1629,6 +1883,168 @@ void statevec_multiControlledMultiRotateZ(Qureg qureg, long long int ctrlMask, l
     statevec_multiControlledMultiRotateZKernel<<<CUDABlocks, threadsPerCUDABlock>>>(qureg, ctrlMask, targMask, cosAngle, sinAngle);
 }
 
+__global__ void statevec_multiRotateZProductKernel(Qureg qureg, long long int* masks, qreal* angles, int numRotations) {
+    
+    long long int stateVecSize = qureg.numAmpsPerChunk;
+    long long int index = blockIdx.x*blockDim.x + threadIdx.x;
+    if (index>=stateVecSize) return;
+    
+    qreal *stateVecReal = qureg.deviceStateVec.real;
+    qreal *stateVecImag = qureg.deviceStateVec.imag;
+    
+    // odd-parity rotations contribute -angle
+    qreal phase = 0;
+    for (int j=0; j<numRotations; j++)
+        phase += (1-2*getBitMaskParity(masks[j] & index)) * angles[j];
+    qreal cosPhase = cos(phase/2);
+    qreal sinPhase = sin(phase/2);
+    
+    qreal stateReal = stateVecReal[index];
+    qreal stateImag = stateVecImag[index];
+    stateVecReal[index] = cosPhase*stateReal + sinPhase*stateImag;
+    stateVecImag[index] = - sinPhase*stateReal + cosPhase*stateImag;  
+}
+
+void statevec_multiRotateZProduct(Qureg qureg, long long int* masks, qreal* angles, int numRotations)
+{
+    long long int* d_masks;
+    qreal* d_angles;
+    cudaMalloc(&d_masks, numRotations * sizeof *d_masks);
+    cudaMalloc(&d_angles, numRotations * sizeof *d_angles);
+    cudaMemcpy(d_masks, masks, numRotations * sizeof *d_masks, cudaMemcpyHostToDevice);
+    cudaMemcpy(d_angles, angles, numRotations * sizeof *d_angles, cudaMemcpyHostToDevice);
+    
+    int threadsPerCUDABlock, CUDABlocks;
+    threadsPerCUDABlock = 128;
+    CUDABlocks = ceil((qreal)(qureg.numAmpsPerChunk)/threadsPerCUDABlock);
+    statevec_multiRotateZProductKernel<<<CUDABlocks, threadsPerCUDABlock>>>(qureg, d_masks, d_angles, numRotations);
+    
+    cudaFree(d_masks);
+    cudaFree(d_angles);
+}
+
+__global__ void statevec_multiControlledMultiRotatePauliKernel(
+    Qureg qureg, long long int ctrlMask, long long int xMask, long long int zMask, 
+    int pairBit, int pairSign, qreal cosAngle, qreal facReal, qreal facImag
+) {
+    long long int numTasks = qureg.numAmpsPerChunk >> 1;
+    long long int thisTask = blockIdx.x*blockDim.x + threadIdx.x;
+    if (thisTask>=numTasks) return;
+    
+    long long int indA = insertZeroBit(thisTask, pairBit);
+    long long int indB = indA ^ xMask;
+    
+    // pairs with not-all-one control qubits are unmodified (controls and targets are disjoint)
+    if (ctrlMask && ((ctrlMask & indA) != ctrlMask))
+        return;
+    
+    qreal *stateVecReal = qureg.deviceStateVec.real;
+    qreal *stateVecImag = qureg.deviceStateVec.imag;
+    
+    // avoid warp divergence, setting signs = +- 1
+    int signA = 1-2*getBitMaskParity(zMask & indA);
+    int signB = signA * pairSign;
+    qreal reA = stateVecReal[indA];
+    qreal imA = stateVecImag[indA];
+    qreal reB = stateVecReal[indB];
+    qreal imB = stateVecImag[indB];
+    
+    stateVecReal[indA] = cosAngle*reA + signA*(facReal*reB - facImag*imB);
+    stateVecImag[indA] = cosAngle*imA + signA*(facReal*imB + facImag*reB);
+    stateVecReal[indB] = cosAngle*reB + signB*(facReal*reA - facImag*imA);
+    stateVecImag[indB] = cosAngle*imB + signB*(facReal*imA + facImag*reA);
+}
+
+void statevec_multiControlledMultiRotatePauliMasks(Qureg qureg, long long int ctrlMask, long long int xMask, long long int zMask, qreal angle, int applyConj)
+{
+    // a string of only Z (and I) is diagonal
+    if (xMask == 0) {
+        statevec_multiControlledMultiRotateZ(qureg, ctrlMask, zMask, (applyConj)? -angle : angle);
+        return;
+    }
+    
+    qreal cosAngle = cos(angle/2.0);
+    Complex pairFac = getPauliRotationPairFactor(xMask, zMask, angle, applyConj);
+    
+    // each pair is indexed by the task with a zero inserted at the highest bit of xMask,
+    // and the sign of its second amplitude differs from the first by (-1)^|xMask & zMask|
+    int pairBit = 0;
+    while (xMask >> (pairBit+1))
+        pairBit++;
+    int pairSign = 1;
+    for (long long int mask = xMask & zMask; mask; mask &= mask-1)
+        pairSign = -pairSign;
+    
+    int threadsPerCUDABlock, CUDABlocks;
+    threadsPerCUDABlock = 128;
+    CUDABlocks = ceil((qreal)(qureg.numAmpsPerChunk>>1)/threadsPerCUDABlock);
+    statevec_multiControlledMultiRotatePauliKernel<<<CUDABlocks, threadsPerCUDABlock>>>(
+        qureg, ctrlMask, xMask, zMask, pairBit, pairSign, cosAngle, pairFac.real, pairFac.imag);
+}
+
+__global__ void statevec_applyPauliMaskGroupsKernel(
+    Qureg inQureg, Qureg outQureg, long long int* groupXMasks, int* groupStarts, int numGroups, 
+    long long int* termZMasks, qreal* termCoeffsRe, qreal* termCoeffsIm
+) {
+    long long int stateVecSize = outQureg.numAmpsPerChunk;
+    long long int index = blockIdx.x*blockDim.x + threadIdx.x;
+    if (index>=stateVecSize) return;
+    
+    qreal *inReal = inQureg.deviceStateVec.real;
+    qreal *inImag = inQureg.deviceStateVec.imag;
+    
+    // out_a = sum_g d_g(a) psi_{a ^ xMask_g}, avoiding warp divergence with signs = +- 1
+    qreal outReal = 0;
+    qreal outImag = 0;
+    for (int g=0; g<numGroups; g++) {
+        qreal diagReal = 0;
+        qreal diagImag = 0;
+        for (int t=groupStarts[g]; t<groupStarts[g+1]; t++) {
+            int sign = 1-2*getBitMaskParity(termZMasks[t] & index);
+            diagReal += sign * termCoeffsRe[t];
+            diagImag += sign * termCoeffsIm[t];
+        }
+        long long int pairInd = index ^ groupXMasks[g];
+        qreal pairReal = inReal[pairInd];
+        qreal pairImag = inImag[pairInd];
+        outReal += diagReal*pairReal - diagImag*pairImag;
+        outImag += diagReal*pairImag + diagImag*pairReal;
+    }
+    outQureg.deviceStateVec.real[index] += outReal;
+    outQureg.deviceStateVec.imag[index] += outImag;
+}
+
+void statevec_applyPauliMaskGroups(Qureg inQureg, long long int* groupXMasks, int* groupStarts, int numGroups, long long int* termZMasks, qreal* termCoeffsRe, qreal* termCoeffsIm, Qureg outQureg)
+{
+    int numTerms = groupStarts[numGroups];
+    long long int *d_groupXMasks, *d_termZMasks;
+    int* d_groupStarts;
+    qreal *d_termCoeffsRe, *d_termCoeffsIm;
+    cudaMalloc(&d_groupXMasks, numGroups * sizeof *d_groupXMasks);
+    cudaMalloc(&d_groupStarts, (numGroups + 1) * sizeof *d_groupStarts);
+    cudaMalloc(&d_termZMasks, numTerms * sizeof *d_termZMasks);
+    cudaMalloc(&d_termCoeffsRe, numTerms * sizeof *d_termCoeffsRe);
+    cudaMalloc(&d_termCoeffsIm, numTerms * sizeof *d_termCoeffsIm);
+    cudaMemcpy(d_groupXMasks, groupXMasks, numGroups * sizeof *d_groupXMasks, cudaMemcpyHostToDevice);
+    cudaMemcpy(d_groupStarts, groupStarts, (numGroups + 1) * sizeof *d_groupStarts, cudaMemcpyHostToDevice);
+    cudaMemcpy(d_termZMasks, termZMasks, numTerms * sizeof *d_termZMasks, cudaMemcpyHostToDevice);
+    cudaMemcpy(d_termCoeffsRe, termCoeffsRe, numTerms * sizeof *d_termCoeffsRe, cudaMemcpyHostToDevice);
+    cudaMemcpy(d_termCoeffsIm, termCoeffsIm, numTerms * sizeof *d_termCoeffsIm, cudaMemcpyHostToDevice);
+    
+    int threadsPerCUDABlock, CUDABlocks;
+    threadsPerCUDABlock = 128;
+    CUDABlocks = ceil((qreal)(outQureg.numAmpsPerChunk)/threadsPerCUDABlock);
+    statevec_applyPauliMaskGroupsKernel<<<CUDABlocks, threadsPerCUDABlock>>>(
+        inQureg, outQureg, d_groupXMasks, d_groupStarts, numGroups, 
+        d_termZMasks, d_termCoeffsRe, d_termCoeffsIm);
+    
+    cudaFree(d_groupXMasks);
+    cudaFree(d_groupStarts);
+    cudaFree(d_termZMasks);
+    cudaFree(d_termCoeffsRe);
+    cudaFree(d_termCoeffsIm);
+}
+
 qreal densmatr_calcTotalProb(Qureg qureg) {
     
     // computes the trace using Kahan summation
@@ -2299,6 +2715,315 @@ void densmatr_calcProbOfAllOutcomes(qreal* outcomeProbs, Qureg qureg, int* qubit
     cudaFree(d_outcomeProbs);
 }
 
+__global__ void statevec_calcProbsKernel(qreal* probs, Qureg qureg) {
+    
+    // each thread handles one amplitude
+    long long int ampInd = blockIdx.x*blockDim.x + threadIdx.x;
+    if (ampInd >= qureg.numAmpsPerChunk) return;
+    
+    probs[ampInd] = (
+        qureg.deviceStateVec.real[ampInd]*qureg.deviceStateVec.real[ampInd] + 
+        qureg.deviceStateVec.imag[ampInd]*qureg.deviceStateVec.imag[ampInd]);
+}
+
+__global__ void densmatr_calcProbsKernel(qreal* probs, Qureg qureg) {
+    
+    // each thread handles one diagonal amplitude
+    long long int diagInd = blockIdx.x*blockDim.x + threadIdx.x;
+    long long int numDiags = (1LL << qureg.numQubitsRepresented);
+    if (diagInd >= numDiags) return;
+    
+    probs[diagInd] = qureg.deviceStateVec.real[(1 + numDiags)*diagInd];   // im[flatInd] assumed ~ 0
+}
+
+/** Draws every shot as the basis state at which the cumulative probability first exceeds 
+ * a uniformly random fraction of the total probability. The numProbs probabilities in the 
+ * GPU array d_probs are copied to, and summed upon, the host, where shots are drawn by binary search 
+ */
+static void sampleOutcomesFromProbs(
+    Qureg qureg, qreal* d_probs, long long int numProbs, 
+    int* qubits, int numQubits, int numShots, long long int* outcomes
+) {
+    qreal* cumProbs = (qreal*) malloc(numProbs * sizeof *cumProbs);
+    cudaMemcpy(cumProbs, d_probs, numProbs * sizeof *cumProbs, cudaMemcpyDeviceToHost);
+    for (long long int i=1; i<numProbs; i++)
+        cumProbs[i] += cumProbs[i-1];
+    qreal total = cumProbs[numProbs-1];
+    
+    unsigned long long int firstDraw = rng_skipAhead(qureg, numShots);
+    for (int s=0; s<numShots; s++) {
+        qreal prob = total * rng_getUniformAt(qureg, 0, firstDraw + s);
+        
+        // find the first cumulative probability exceeding prob (or the final non-zero probability)
+        long long int lo = 0;
+        long long int hi = numProbs - 1;
+        while (lo < hi) {
+            long long int mid = lo + (hi - lo)/2;
+            if (cumProbs[mid] > prob || cumProbs[mid] >= total)
+                hi = mid;
+            else
+                lo = mid + 1;
+        }
+        
+        long long int outcomeInd = 0;
+        for (int q=0; q<numQubits; q++)
+            outcomeInd += ((lo >> qubits[q]) & 1LL) << q;
+        outcomes[s] = outcomeInd;
+    }
+    
+    free(cumProbs);
+}
+
+void statevec_sampleOutcomes(Qureg qureg, int* qubits, int numQubits, int numShots, long long int* outcomes) {
+    
+    // create one thread for every amplitude
+    int numThreadsPerBlock = 128;
+    int numBlocks = ceil(qureg.numAmpsPerChunk / (qreal) numThreadsPerBlock);
+    
+    qreal* d_probs;
+    cudaMalloc(&d_probs, qureg.numAmpsPerChunk * sizeof *d_probs);
+    statevec_calcProbsKernel<<<numBlocks, numThreadsPerBlock>>>(d_probs, qureg);
+    
+    sampleOutcomesFromProbs(qureg, d_probs, qureg.numAmpsPerChunk, qubits, numQubits, numShots, outcomes);
+    cudaFree(d_probs);
+}
+
+void densmatr_sampleOutcomes(Qureg qureg, int* qubits, int numQubits, int numShots, long long int* outcomes) {
+    
+    // create one thread for every diagonal amplitude
+    int numThreadsPerBlock = 128;
+    long long int numDiags = (1LL << qureg.numQubitsRepresented);
+    int numBlocks = ceil(numDiags / (qreal) numThreadsPerBlock);
+    
+    qreal* d_probs;
+    cudaMalloc(&d_probs, numDiags * sizeof *d_probs);
+    densmatr_calcProbsKernel<<<numBlocks, numThreadsPerBlock>>>(d_probs, qureg);
+    
+    sampleOutcomesFromProbs(qureg, d_probs, numDiags, qubits, numQubits, numShots, outcomes);
+    cudaFree(d_probs);
+}
+
+/** Populates sums with the total of the numProbs probabilities in GPU array d_probs (sums[0]), 
+ * the total where each qubit q is 1 (sums[1+q]) and, if calcPairs, where qubits q1 and q2 
+ * are both 1 (sums[1+numQubits + q1*numQubits + q2]). The probabilities are copied to, and 
+ * summed upon, the host, in a single pass
+ */
+static void calcQubitCorrelationSumsFromProbs(
+    qreal* d_probs, long long int numProbs, int numQubits, int calcPairs, qreal* sums
+) {
+    qreal* probs = (qreal*) malloc(numProbs * sizeof *probs);
+    cudaMemcpy(probs, d_probs, numProbs * sizeof *probs, cudaMemcpyDeviceToHost);
+    
+    int numSums = 1 + numQubits + (calcPairs? numQubits*numQubits : 0);
+    for (int s=0; s<numSums; s++)
+        sums[s] = 0;
+    qreal* pairSums = &sums[1+numQubits];
+    
+    for (long long int i=0; i<numProbs; i++) {
+        sums[0] += probs[i];
+        for (int q1=0; q1<numQubits; q1++) {
+            if (!((i >> q1) & 1LL))
+                continue;
+            sums[1+q1] += probs[i];
+            if (!calcPairs)
+                continue;
+            for (int q2=q1; q2<numQubits; q2++)
+                if ((i >> q2) & 1LL)
+                    pairSums[q1*numQubits + q2] += probs[i];
+        }
+    }
+    
+    // only the upper triangle was populated
+    if (calcPairs)
+        for (int q1=0; q1<numQubits; q1++)
+            for (int q2=0; q2<q1; q2++)
+                pairSums[q1*numQubits + q2] = pairSums[q2*numQubits + q1];
+    
+    free(probs);
+}
+
+/** Populates inds and probs with the k most probable of the numAmps basis states, whose
+ * amplitudes are stride apart in GPU arrays d_real and d_imag (or which have probability d_real 
+ * alone, when d_imag is NULL). The amplitudes are copied to the host in bounded batches, and 
+ * offered to a min-heap of the k most probable
+ */
+static void findTopOutcomesOfDeviceAmps(
+    qreal* d_real, qreal* d_imag, long long int numAmps, long long int stride, 
+    int k, long long int* inds, qreal* probs
+) {
+    long long int batchSize = (numAmps < TOP_OUTCOMES_BATCH_SIZE)? numAmps : TOP_OUTCOMES_BATCH_SIZE;
+    qreal* re = (qreal*) malloc(batchSize * sizeof *re);
+    qreal* im = (d_imag == NULL)? NULL : (qreal*) malloc(batchSize * sizeof *im);
+    size_t pitch = stride * sizeof(qreal);
+    int heapSize = 0;
+    
+    for (long long int start=0; start<numAmps; start+=batchSize) {
+        long long int num = (numAmps - start < batchSize)? numAmps - start : batchSize;
+        cudaMemcpy2D(re, sizeof *re, &d_real[start*stride], pitch, sizeof *re, num, cudaMemcpyDeviceToHost);
+        if (im != NULL)
+            cudaMemcpy2D(im, sizeof *im, &d_imag[start*stride], pitch, sizeof *im, num, cudaMemcpyDeviceToHost);
+        
+        for (long long int i=0; i<num; i++) {
+            qreal prob = (im == NULL)? re[i] : re[i]*re[i] + im[i]*im[i];
+            
+            // since indices increase, a full heap rejects any outcome no more probable than its least
+            if (heapSize == k && prob <= probs[0])
+                continue;
+            offerTopOutcome(inds, probs, &heapSize, k, start + i, prob);
+        }
+    }
+    sortTopOutcomes(inds, probs, heapSize);
+    
+    free(re);
+    if (im != NULL)
+        free(im);
+}
+
+void statevec_calcTopKOutcomes(Qureg qureg, int k, long long int* inds, qreal* probs) {
+    
+    findTopOutcomesOfDeviceAmps(
+        qureg.deviceStateVec.real, qureg.deviceStateVec.imag, qureg.numAmpsPerChunk, 1, k, inds, probs);
+}
+
+void densmatr_calcTopKOutcomes(Qureg qureg, int k, long long int* inds, qreal* probs) {
+    
+    // only the real components of the diagonal elements are consulted
+    long long int numDiags = (1LL << qureg.numQubitsRepresented);
+    findTopOutcomesOfDeviceAmps(
+        qureg.deviceStateVec.real, NULL, numDiags, 1 + numDiags, k, inds, probs);
+}
+
+/** Each thread contributes Re[(-i)^numY (-1)^|a & zMask| conj(psi_a) psi_{a ^ xMask}] to the 
+ * expected value of a Pauli string, for a state-vector, or Re[(-i)^numY (-1)^|c & zMask| 
+ * rho_{c ^ xMask, c}] for column c of a density matrix, which are then reduced
+ */
+__global__ void agnostic_calcExpecPauliStringKernel(
+    int isDensMatr, long long int xMask, long long int zMask, int numY, int numQubits,
+    qreal* stateRe, qreal* stateIm, long long int numTermsToSum, qreal* reducedArray) 
+{
+    long long int index = blockIdx.x*blockDim.x + threadIdx.x;
+    if (index >= numTermsToSum) return;
+    
+    qreal termRe, termIm;
+    long long int pairInd = index ^ xMask;
+    if (isDensMatr) {
+        long long int ind = pairInd + (index << numQubits);
+        termRe = stateRe[ind];
+        termIm = stateIm[ind];
+    } else {
+        termRe = stateRe[index]*stateRe[pairInd] + stateIm[index]*stateIm[pairInd];
+        termIm = stateRe[index]*stateIm[pairInd] - stateIm[index]*stateRe[pairInd];
+    }
+    
+    // the real component after multiplication by (-i)^numY
+    qreal term;
+    switch (numY % 4) {
+        case 0: term =  termRe; break;
+        case 1: term =  termIm; break;
+        case 2: term = -termRe; break;
+        default: term = -termIm;
+    }
+    if (getBitMaskParity(zMask & index))
+        term = -term;
+    
+    // array of each thread's collected sum term, to be summed
+    extern __shared__ qreal tempReductionArray[];
+    tempReductionArray[threadIdx.x] = term;
+    __syncthreads();
+    
+    // every second thread reduces
+    if (threadIdx.x<blockDim.x/2)
+        reduceBlock(tempReductionArray, reducedArray, blockDim.x);
+}
+
+/** Each Pauli string is evaluated by one read-only reduction, needing no workspace */
+void agnostic_calcExpecPauliStringsOnDevice(
+    Qureg qureg, long long int* xMasks, long long int* zMasks, int numStrings, qreal* expecs
+) {
+    int numQubits = qureg.numQubitsRepresented;
+    long long int numTerms = (qureg.isDensityMatrix)? (1LL << numQubits) : qureg.numAmpsPerChunk;
+    
+    long long int numValuesToReduce;
+    int valuesPerCUDABlock, numCUDABlocks, sharedMemSize;
+    int maxReducedPerLevel = REDUCE_SHARED_SIZE;
+    int firstTime;
+    
+    for (int t=0; t<numStrings; t++) {
+        int numY = 0;
+        for (long long int yMask = xMasks[t] & zMasks[t]; yMask; yMask &= yMask-1)
+            numY++;
+        
+        numValuesToReduce = numTerms;
+        firstTime = 1;
+        while (numValuesToReduce > 1) {
+            if (numValuesToReduce < maxReducedPerLevel) {
+                valuesPerCUDABlock = numValuesToReduce;
+                numCUDABlocks = 1;
+            }
+            else {
+                valuesPerCUDABlock = maxReducedPerLevel;
+                numCUDABlocks = ceil((qreal)numValuesToReduce/valuesPerCUDABlock);
+            }
+            sharedMemSize = valuesPerCUDABlock*sizeof(qreal);
+            if (firstTime) {
+                agnostic_calcExpecPauliStringKernel<<<numCUDABlocks, valuesPerCUDABlock, sharedMemSize>>>(
+                    qureg.isDensityMatrix, xMasks[t], zMasks[t], numY, numQubits,
+                    qureg.deviceStateVec.real, qureg.deviceStateVec.imag, 
+                    numValuesToReduce, qureg.firstLevelReduction);
+                firstTime = 0;
+            } else {
+                cudaDeviceSynchronize();    
+                copySharedReduceBlock<<<numCUDABlocks, valuesPerCUDABlock/2, sharedMemSize>>>(
+                        qureg.firstLevelReduction, 
+                        qureg.secondLevelReduction, valuesPerCUDABlock); 
+                cudaDeviceSynchronize();    
+                swapDouble(&(qureg.firstLevelReduction), &(qureg.secondLevelReduction));
+            }
+            numValuesToReduce = numValuesToReduce/maxReducedPerLevel;
+        }
+        cudaMemcpy(&expecs[t], qureg.firstLevelReduction, sizeof(qreal), cudaMemcpyDeviceToHost);
+    }
+}
+
+void statevec_calcExpecPauliStrings(Qureg qureg, long long int* xMasks, long long int* zMasks, int numStrings, qreal* expecs) {
+    
+    agnostic_calcExpecPauliStringsOnDevice(qureg, xMasks, zMasks, numStrings, expecs);
+}
+
+void densmatr_calcExpecPauliStrings(Qureg qureg, long long int* xMasks, long long int* zMasks, int numStrings, qreal* expecs) {
+    
+    agnostic_calcExpecPauliStringsOnDevice(qureg, xMasks, zMasks, numStrings, expecs);
+}
+
+void statevec_calcQubitCorrelationSums(Qureg qureg, qreal* sums, int calcPairs) {
+    
+    // create one thread for every amplitude
+    int numThreadsPerBlock = 128;
+    int numBlocks = ceil(qureg.numAmpsPerChunk / (qreal) numThreadsPerBlock);
+    
+    qreal* d_probs;
+    cudaMalloc(&d_probs, qureg.numAmpsPerChunk * sizeof *d_probs);
+    statevec_calcProbsKernel<<<numBlocks, numThreadsPerBlock>>>(d_probs, qureg);
+    
+    calcQubitCorrelationSumsFromProbs(d_probs, qureg.numAmpsPerChunk, qureg.numQubitsRepresented, calcPairs, sums);
+    cudaFree(d_probs);
+}
+
+void densmatr_calcQubitCorrelationSums(Qureg qureg, qreal* sums, int calcPairs) {
+    
+    // create one thread for every diagonal amplitude
+    int numThreadsPerBlock = 128;
+    long long int numDiags = (1LL << qureg.numQubitsRepresented);
+    int numBlocks = ceil(numDiags / (qreal) numThreadsPerBlock);
+    
+    qreal* d_probs;
+    cudaMalloc(&d_probs, numDiags * sizeof *d_probs);
+    densmatr_calcProbsKernel<<<numBlocks, numThreadsPerBlock>>>(d_probs, qureg);
+    
+    calcQubitCorrelationSumsFromProbs(d_probs, numDiags, qureg.numQubitsRepresented, calcPairs, sums);
+    cudaFree(d_probs);
+}
+
 /** computes Tr(conjTrans(a) b) = sum of (a_ij^* b_ij), which is a real number */
 __global__ void densmatr_calcInnerProductKernel(
     Qureg a, Qureg b, long long int numTermsToSum, qreal* reducedArray
@@ -2842,6 +3567,50 @@ void densmatr_collapseToKnownProbOutcome(Qureg qureg, int measureQubit, int outc
         part1, part2, part3, rowBit, colBit, desired, undesired);
 }
 
+/** Multiplies every amplitude satisfying (index & mask) == maskedOutcome by factor, and zeroes all others */
+__global__ void agnostic_collapseToMaskedOutcomeKernel(Qureg qureg, long long int mask, long long int maskedOutcome, qreal factor) {
+    
+    long long int index = blockIdx.x*blockDim.x + threadIdx.x;
+    if (index >= qureg.numAmpsPerChunk) return;
+    
+    qreal fac = ((index & mask) == maskedOutcome)? factor : 0;
+    qureg.deviceStateVec.real[index] *= fac;
+    qureg.deviceStateVec.imag[index] *= fac;
+}
+
+void statevec_collapseToKnownProbMultiOutcome(Qureg qureg, int* qubits, int numQubits, long long int outcome, qreal outcomeProb) {
+    
+    long long int mask = 0;
+    long long int maskedOutcome = 0;
+    for (int q=0; q<numQubits; q++) {
+        mask |= 1LL << qubits[q];
+        maskedOutcome |= ((outcome >> q) & 1LL) << qubits[q];
+    }
+    
+    int threadsPerCUDABlock = 128;
+    int CUDABlocks = ceil(qureg.numAmpsPerChunk / (qreal) threadsPerCUDABlock);
+    agnostic_collapseToMaskedOutcomeKernel<<<CUDABlocks, threadsPerCUDABlock>>>(
+        qureg, mask, maskedOutcome, 1/sqrt(outcomeProb));
+}
+
+void densmatr_collapseToKnownProbMultiOutcome(Qureg qureg, int* qubits, int numQubits, long long int outcome, qreal outcomeProb) {
+    
+    // the qubits must be in outcome in both the row and column index of each element
+    int shift = qureg.numQubitsRepresented;
+    long long int mask = 0;
+    long long int maskedOutcome = 0;
+    for (int q=0; q<numQubits; q++) {
+        long long int bit = (outcome >> q) & 1LL;
+        mask |= (1LL << qubits[q]) | (1LL << (qubits[q] + shift));
+        maskedOutcome |= (bit << qubits[q]) | (bit << (qubits[q] + shift));
+    }
+    
+    int threadsPerCUDABlock = 128;
+    int CUDABlocks = ceil(qureg.numAmpsPerChunk / (qreal) threadsPerCUDABlock);
+    agnostic_collapseToMaskedOutcomeKernel<<<CUDABlocks, threadsPerCUDABlock>>>(
+        qureg, mask, maskedOutcome, 1/outcomeProb);
+}
+
 __global__ void densmatr_mixDensityMatrixKernel(Qureg combineQureg, qreal otherProb, Qureg otherQureg, long long int numAmpsToVisit) {
     
     long long int ampInd = blockIdx.x*blockDim.x + threadIdx.x;
@@ -3619,6 +4388,11 @@ __global__ void statevec_applyPhaseFuncOverridesKernel(
     cudaFree(d_overridePhases);
 }
 
+void agnostic_setPhaseFuncCaching(int cacheTables) {
+    
+    // the GPU kernel evaluates each phase directly, so retains no table to cache
+}
+
 __global__ void statevec_applyMultiVarPhaseFuncOverridesKernel(
     Qureg qureg, int* qubits, int* numQubitsPerReg, int numRegs, enum bitEncoding encoding,
     qreal* coeffs, qreal* exponents, int* numTermsPerReg, 
@@ -3987,6 +4761,9 @@ void seedQuEST(QuESTEnv *env, unsigned long int *seedArray, int numSeeds) {
     
     // pass keys to Mersenne Twister seeder
     init_by_array(seedArray, numSeeds); 
+    
+    // every Qureg's random stream must be rekeyed by the new seeds
+    rng_resetStreams(seedArray, numSeeds);
 }
 
 
@@ -20,6 +20,10 @@
 # include "QuEST_internal.h"
 # include "QuEST_validation.h"
 # include "QuEST_qasm.h"
+# include "QuEST_fusion.h"
+# include "QuEST_rng.h"
+# include "QuEST_packed.h"
+# include "QuEST_noise.h"
 
 # include <stdlib.h>
 # include <string.h>
@@ -43,11 +47,17 @@ Qureg createQureg(int numQubits, QuESTEnv env) {
     qureg.numQubitsInStateVec = numQubits;
     
     qasm_setup(&qureg);
+    fusion_setup(&qureg);
+    rng_setup(&qureg);
+    noise_setup(&qureg);
     initZeroState(qureg); // safe call to public function
     return qureg;
 }
 
 void dumpQuregStateToFile(Qureg qureg, char *filename) {
+    validateUnpackedQureg(qureg, __func__);
+
+    fusion_applyDeferred(qureg);
     statevec_dump_to_file(qureg, filename);
 }
 
@@ -61,6 +71,24 @@ Qureg createDensityQureg(int numQubits, QuESTEnv env) {
     qureg.numQubitsInStateVec = 2*numQubits;
     
     qasm_setup(&qureg);
+    fusion_setup(&qureg);
+    rng_setup(&qureg);
+    noise_setup(&qureg);
+    initZeroState(qureg); // safe call to public function
+    return qureg;
+}
+
+Qureg createPackedDensityQureg(int numQubits, QuESTEnv env) {
+    validateNumQubitsInQureg(2*numQubits, env.numRanks, __func__);
+    validateNumRanksOfPackedQureg(env.numRanks, __func__);
+    
+    Qureg qureg;
+    packed_createQureg(&qureg, numQubits, env);
+    
+    qasm_setup(&qureg);
+    fusion_setup(&qureg);
+    rng_setup(&qureg);
+    noise_setup(&qureg);
     initZeroState(qureg); // safe call to public function
     return qureg;
 }
@@ -68,19 +96,35 @@ Qureg createDensityQureg(int numQubits, QuESTEnv env) {
 Qureg createCloneQureg(Qureg qureg, QuESTEnv env) {
 
     Qureg newQureg;
-    statevec_createQureg(&newQureg, qureg.numQubitsInStateVec, env);
+    if (qureg.isPackedDensityMatrix)
+        packed_createQureg(&newQureg, qureg.numQubitsRepresented, env);
+    else
+        statevec_createQureg(&newQureg, qureg.numQubitsInStateVec, env);
     newQureg.isDensityMatrix = qureg.isDensityMatrix;
     newQureg.numQubitsRepresented = qureg.numQubitsRepresented;
     newQureg.numQubitsInStateVec = qureg.numQubitsInStateVec;
     
     qasm_setup(&newQureg);
-    statevec_cloneQureg(newQureg, qureg);
+    fusion_setup(&newQureg);
+    rng_setup(&newQureg);
+    noise_setup(&newQureg);
+    fusion_applyDeferred(qureg);
+    if (qureg.isPackedDensityMatrix)
+        packed_cloneQureg(newQureg, qureg);
+    else
+        statevec_cloneQureg(newQureg, qureg);
     return newQureg;
 }
 
 void destroyQureg(Qureg qureg, QuESTEnv env) {
-    statevec_destroyQureg(qureg, env);
+    if (qureg.isPackedDensityMatrix)
+        packed_destroyQureg(qureg);
+    else
+        statevec_destroyQureg(qureg, env);
     qasm_free(qureg);
+    fusion_free(qureg);
+    rng_free(qureg);
+    noise_free(qureg);
 }
 
 
@@ -110,24 +154,70 @@ void writeRecordedQASMToFile(Qureg qureg, char* filename) {
 }
 
 
+/*
+ * gate fusion
+ */
+
+void startDeferringGates(Qureg qureg, int maxNumQubits) {
+    validateUnpackedQureg(qureg, __func__);
+    validateNumFusedQubits(qureg, maxNumQubits, __func__);
+    validateMultiQubitMatrixFitsInNode(qureg, maxNumQubits, __func__);
+    validateNoNoiseModel(qureg, __func__);
+    
+    fusion_startDeferring(qureg, maxNumQubits, 0);
+}
+
+void startDeferringGatesInTiles(Qureg qureg, int maxNumQubits, int numTileQubits) {
+    validateStateVecQureg(qureg, __func__);
+    validateNumFusedQubits(qureg, maxNumQubits, __func__);
+    validateMultiQubitMatrixFitsInNode(qureg, maxNumQubits, __func__);
+    validateNumTileQubits(qureg, maxNumQubits, numTileQubits, __func__);
+    
+    fusion_startDeferring(qureg, maxNumQubits, numTileQubits);
+}
+
+void stopDeferringGates(Qureg qureg) {
+    validateNoNoiseModel(qureg, __func__);
+    
+    fusion_stopDeferring(qureg);
+}
+
+void applyDeferredGates(Qureg qureg) {
+    validateNoNoiseModel(qureg, __func__);
+    
+    fusion_applyDeferred(qureg);
+}
+
+
 /*
  * state initialisation
  */
 
 void initZeroState(Qureg qureg) {
-    statevec_initZeroState(qureg); // valid for both statevec and density matrices
+    fusion_applyDeferred(qureg);
+    if (qureg.isPackedDensityMatrix)
+        packed_initZeroState(qureg);
+    else
+        statevec_initZeroState(qureg); // valid for both statevec and density matrices
     
     qasm_recordInitZero(qureg);
 }
 
 void initBlankState(Qureg qureg) {
-    statevec_initBlankState(qureg);
+    fusion_applyDeferred(qureg);
+    if (qureg.isPackedDensityMatrix)
+        packed_initBlankState(qureg);
+    else
+        statevec_initBlankState(qureg);
     
     qasm_recordComment(qureg, "Here, the register was initialised to an unphysical all-zero-amplitudes 'state'.");
 }
 
 void initPlusState(Qureg qureg) {
-    if (qureg.isDensityMatrix)
+    fusion_applyDeferred(qureg);
+    if (qureg.isPackedDensityMatrix)
+        packed_initPlusState(qureg);
+    else if (qureg.isDensityMatrix)
         densmatr_initPlusState(qureg);
     else
         statevec_initPlusState(qureg);
@@ -138,7 +228,10 @@ void initPlusState(Qureg qureg) {
 void initClassicalState(Qureg qureg, long long int stateInd) {
     validateStateIndex(qureg, stateInd, __func__);
     
-    if (qureg.isDensityMatrix)
+    fusion_applyDeferred(qureg);
+    if (qureg.isPackedDensityMatrix)
+        packed_initClassicalState(qureg, stateInd);
+    else if (qureg.isDensityMatrix)
         densmatr_initClassicalState(qureg, stateInd);
     else
         statevec_initClassicalState(qureg, stateInd);
@@ -150,7 +243,11 @@ void initPureState(Qureg qureg, Qureg pure) {
     validateSecondQuregStateVec(pure, __func__);
     validateMatchingQuregDims(qureg, pure, __func__);
 
-    if (qureg.isDensityMatrix)
+    fusion_applyDeferred(qureg);
+    fusion_applyDeferred(pure);
+    if (qureg.isPackedDensityMatrix)
+        packed_initPureState(qureg, pure);
+    else if (qureg.isDensityMatrix)
         densmatr_initPureState(qureg, pure);
     else
         statevec_cloneQureg(qureg, pure);
@@ -159,6 +256,9 @@ void initPureState(Qureg qureg, Qureg pure) {
 }
 
 void initStateFromAmps(Qureg qureg, qreal* reals, qreal* imags) {
+    validateUnpackedQureg(qureg, __func__);
+
+    fusion_applyDeferred(qureg);
     
     statevec_setAmps(qureg, 0, reals, imags, qureg.numAmpsTotal);
     
@@ -167,9 +267,15 @@ void initStateFromAmps(Qureg qureg, qreal* reals, qreal* imags) {
 
 void cloneQureg(Qureg targetQureg, Qureg copyQureg) {
     validateMatchingQuregTypes(targetQureg, copyQureg, __func__);
+    validateMatchingQuregPacking(targetQureg, copyQureg, __func__);
     validateMatchingQuregDims(targetQureg, copyQureg, __func__);
     
-    statevec_cloneQureg(targetQureg, copyQureg);
+    fusion_applyDeferred(targetQureg);
+    fusion_applyDeferred(copyQureg);
+    if (targetQureg.isPackedDensityMatrix)
+        packed_cloneQureg(targetQureg, copyQureg);
+    else
+        statevec_cloneQureg(targetQureg, copyQureg);
 }
 
 
@@ -180,10 +286,13 @@ void cloneQureg(Qureg targetQureg, Qureg copyQureg) {
 void hadamard(Qureg qureg, int targetQubit) {
     validateTarget(qureg, targetQubit, __func__);
     
-    statevec_hadamard(qureg, targetQubit);
-    if (qureg.isDensityMatrix) {
-        statevec_hadamard(qureg, targetQubit+qureg.numQubitsRepresented);
+    if (!fusion_deferGate(qureg, GATE_HADAMARD, 0, NULL, 0, (int[]) {targetQubit}, 1)) {
+        if (qureg.isDensityMatrix)
+            densmatr_hadamard(qureg, targetQubit);
+        else
+            statevec_hadamard(qureg, targetQubit);
     }
+    noise_applyGateNoise(qureg, NULL, 0, (int[]) {targetQubit}, 1);
     
     qasm_recordGate(qureg, GATE_HADAMARD, targetQubit);
 }
@@ -191,10 +300,13 @@ void hadamard(Qureg qureg, int targetQubit) {
 void rotateX(Qureg qureg, int targetQubit, qreal angle) {
     validateTarget(qureg, targetQubit, __func__);
     
-    statevec_rotateX(qureg, targetQubit, angle);
-    if (qureg.isDensityMatrix) {
-        statevec_rotateX(qureg, targetQubit+qureg.numQubitsRepresented, -angle);
+    if (!fusion_deferGate(qureg, GATE_ROTATE_X, angle, NULL, 0, (int[]) {targetQubit}, 1)) {
+        if (qureg.isDensityMatrix)
+            densmatr_rotateAroundAxis(qureg, 0, targetQubit, angle, (Vector) {1, 0, 0});
+        else
+            statevec_rotateX(qureg, targetQubit, angle);
     }
+    noise_applyGateNoise(qureg, NULL, 0, (int[]) {targetQubit}, 1);
     
     qasm_recordParamGate(qureg, GATE_ROTATE_X, targetQubit, angle);
 }
@@ -202,10 +314,13 @@ void rotateX(Qureg qureg, int targetQubit, qreal angle) {
 void rotateY(Qureg qureg, int targetQubit, qreal angle) {
     validateTarget(qureg, targetQubit, __func__);
     
-    statevec_rotateY(qureg, targetQubit, angle);
-    if (qureg.isDensityMatrix) {
-        statevec_rotateY(qureg, targetQubit+qureg.numQubitsRepresented, angle);
+    if (!fusion_deferGate(qureg, GATE_ROTATE_Y, angle, NULL, 0, (int[]) {targetQubit}, 1)) {
+        if (qureg.isDensityMatrix)
+            densmatr_rotateAroundAxis(qureg, 0, targetQubit, angle, (Vector) {0, 1, 0});
+        else
+            statevec_rotateY(qureg, targetQubit, angle);
     }
+    noise_applyGateNoise(qureg, NULL, 0, (int[]) {targetQubit}, 1);
     
     qasm_recordParamGate(qureg, GATE_ROTATE_Y, targetQubit, angle);
 }
@@ -213,10 +328,13 @@ void rotateY(Qureg qureg, int targetQubit, qreal angle) {
 void rotateZ(Qureg qureg, int targetQubit, qreal angle) {
     validateTarget(qureg, targetQubit, __func__);
     
-    statevec_rotateZ(qureg, targetQubit, angle);
-    if (qureg.isDensityMatrix) {
-        statevec_rotateZ(qureg, targetQubit+qureg.numQubitsRepresented, -angle);
+    if (!fusion_deferGate(qureg, GATE_ROTATE_Z, angle, NULL, 0, (int[]) {targetQubit}, 1)) {
+        if (qureg.isDensityMatrix)
+            densmatr_multiControlledMultiRotateZ(qureg, 0, 1LL << targetQubit, angle);
+        else
+            statevec_rotateZ(qureg, targetQubit, angle);
     }
+    noise_applyGateNoise(qureg, NULL, 0, (int[]) {targetQubit}, 1);
     
     qasm_recordParamGate(qureg, GATE_ROTATE_Z, targetQubit, angle);
 }
@@ -224,11 +342,13 @@ void rotateZ(Qureg qureg, int targetQubit, qreal angle) {
 void controlledRotateX(Qureg qureg, int controlQubit, int targetQubit, qreal angle) {
     validateControlTarget(qureg, controlQubit, targetQubit, __func__);
     
-    statevec_controlledRotateX(qureg, controlQubit, targetQubit, angle);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_controlledRotateX(qureg, controlQubit+shift, targetQubit+shift, -angle);
+    if (!fusion_deferGate(qureg, GATE_ROTATE_X, angle, (int[]) {controlQubit}, 1, (int[]) {targetQubit}, 1)) {
+        if (qureg.isDensityMatrix)
+            densmatr_rotateAroundAxis(qureg, 1LL << controlQubit, targetQubit, angle, (Vector) {1, 0, 0});
+        else
+            statevec_controlledRotateX(qureg, controlQubit, targetQubit, angle);
     }
+    noise_applyGateNoise(qureg, (int[]) {controlQubit}, 1, (int[]) {targetQubit}, 1);
     
     qasm_recordControlledParamGate(qureg, GATE_ROTATE_X, controlQubit, targetQubit, angle);
 }
@@ -236,11 +356,13 @@ void controlledRotateX(Qureg qureg, int controlQubit, int targetQubit, qreal ang
 void controlledRotateY(Qureg qureg, int controlQubit, int targetQubit, qreal angle) {
     validateControlTarget(qureg, controlQubit, targetQubit, __func__);
     
-    statevec_controlledRotateY(qureg, controlQubit, targetQubit, angle);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_controlledRotateY(qureg, controlQubit+shift, targetQubit+shift, angle); // rotateY is real
+    if (!fusion_deferGate(qureg, GATE_ROTATE_Y, angle, (int[]) {controlQubit}, 1, (int[]) {targetQubit}, 1)) {
+        if (qureg.isDensityMatrix)
+            densmatr_rotateAroundAxis(qureg, 1LL << controlQubit, targetQubit, angle, (Vector) {0, 1, 0});
+        else
+            statevec_controlledRotateY(qureg, controlQubit, targetQubit, angle);
     }
+    noise_applyGateNoise(qureg, (int[]) {controlQubit}, 1, (int[]) {targetQubit}, 1);
 
     qasm_recordControlledParamGate(qureg, GATE_ROTATE_Y, controlQubit, targetQubit, angle);
 }
@@ -248,11 +370,13 @@ void controlledRotateY(Qureg qureg, int controlQubit, int targetQubit, qreal ang
 void controlledRotateZ(Qureg qureg, int controlQubit, int targetQubit, qreal angle) {
     validateControlTarget(qureg, controlQubit, targetQubit, __func__);
     
-    statevec_controlledRotateZ(qureg, controlQubit, targetQubit, angle);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_controlledRotateZ(qureg, controlQubit+shift, targetQubit+shift, -angle);
+    if (!fusion_deferGate(qureg, GATE_ROTATE_Z, angle, (int[]) {controlQubit}, 1, (int[]) {targetQubit}, 1)) {
+        if (qureg.isDensityMatrix)
+            densmatr_multiControlledMultiRotateZ(qureg, 1LL << controlQubit, 1LL << targetQubit, angle);
+        else
+            statevec_controlledRotateZ(qureg, controlQubit, targetQubit, angle);
     }
+    noise_applyGateNoise(qureg, (int[]) {controlQubit}, 1, (int[]) {targetQubit}, 1);
     
     qasm_recordControlledParamGate(qureg, GATE_ROTATE_Z, controlQubit, targetQubit, angle);
 }
@@ -261,11 +385,13 @@ void twoQubitUnitary(Qureg qureg, int targetQubit1, int targetQubit2, ComplexMat
     validateMultiTargets(qureg, (int []) {targetQubit1, targetQubit2}, 2, __func__);
     validateTwoQubitUnitaryMatrix(qureg, u, __func__);
     
-    statevec_twoQubitUnitary(qureg, targetQubit1, targetQubit2, u);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_twoQubitUnitary(qureg, targetQubit1+shift, targetQubit2+shift, getConjugateMatrix4(u));
+    if (!fusion_deferTwoQubitUnitary(qureg, u, NULL, 0, targetQubit1, targetQubit2)) {
+        if (qureg.isDensityMatrix)
+            densmatr_multiControlledTwoQubitUnitary(qureg, 0, targetQubit1, targetQubit2, u);
+        else
+            statevec_twoQubitUnitary(qureg, targetQubit1, targetQubit2, u);
     }
+    noise_applyGateNoise(qureg, NULL, 0, (int[]) {targetQubit1, targetQubit2}, 2);
     
     qasm_recordComment(qureg, "Here, an undisclosed 2-qubit unitary was applied.");
 }
@@ -274,11 +400,13 @@ void controlledTwoQubitUnitary(Qureg qureg, int controlQubit, int targetQubit1,
     validateMultiControlsMultiTargets(qureg, (int[]) {controlQubit}, 1, (int[]) {targetQubit1, targetQubit2}, 2, __func__);
     validateTwoQubitUnitaryMatrix(qureg, u, __func__);
     
-    statevec_controlledTwoQubitUnitary(qureg, controlQubit, targetQubit1, targetQubit2, u);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_controlledTwoQubitUnitary(qureg, controlQubit+shift, targetQubit1+shift, targetQubit2+shift, getConjugateMatrix4(u));
+    if (!fusion_deferTwoQubitUnitary(qureg, u, (int[]) {controlQubit}, 1, targetQubit1, targetQubit2)) {
+        if (qureg.isDensityMatrix)
+            densmatr_multiControlledTwoQubitUnitary(qureg, 1LL << controlQubit, targetQubit1, targetQubit2, u);
+        else
+            statevec_controlledTwoQubitUnitary(qureg, controlQubit, targetQubit1, targetQubit2, u);
     }
+    noise_applyGateNoise(qureg, (int[]) {controlQubit}, 1, (int[]) {targetQubit1, targetQubit2}, 2);
 
     qasm_recordComment(qureg, "Here, an undisclosed controlled 2-qubit unitary was applied.");
 }
@@ -287,64 +415,78 @@ void multiControlledTwoQubitUnitary(Qureg qureg, int* controlQubits, int numCont
     validateMultiControlsMultiTargets(qureg, controlQubits, numControlQubits, (int[]) {targetQubit1, targetQubit2}, 2, __func__);
     validateTwoQubitUnitaryMatrix(qureg, u, __func__);
     
-    long long int ctrlQubitsMask = getQubitBitMask(controlQubits, numControlQubits);
-    statevec_multiControlledTwoQubitUnitary(qureg, ctrlQubitsMask, targetQubit1, targetQubit2, u);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_multiControlledTwoQubitUnitary(qureg, ctrlQubitsMask<<shift, targetQubit1+shift, targetQubit2+shift, getConjugateMatrix4(u));
+    if (!fusion_deferTwoQubitUnitary(qureg, u, controlQubits, numControlQubits, targetQubit1, targetQubit2)) {
+        long long int ctrlQubitsMask = getQubitBitMask(controlQubits, numControlQubits);
+        if (qureg.isDensityMatrix)
+            densmatr_multiControlledTwoQubitUnitary(qureg, ctrlQubitsMask, targetQubit1, targetQubit2, u);
+        else
+            statevec_multiControlledTwoQubitUnitary(qureg, ctrlQubitsMask, targetQubit1, targetQubit2, u);
     }
+    noise_applyGateNoise(qureg, controlQubits, numControlQubits, (int[]) {targetQubit1, targetQubit2}, 2);
     
     qasm_recordComment(qureg, "Here, an undisclosed multi-controlled 2-qubit unitary was applied.");
 }
 
 void multiQubitUnitary(Qureg qureg, int* targs, int numTargs, ComplexMatrixN u) {
+    validateUnpackedQureg(qureg, __func__);
     validateMultiTargets(qureg, targs, numTargs, __func__);
     validateMultiQubitUnitaryMatrix(qureg, u, numTargs, __func__);
     
-    statevec_multiQubitUnitary(qureg, targs, numTargs, u);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        shiftIndices(targs, numTargs, shift);
-        setConjugateMatrixN(u);
+    if (!fusion_deferMultiQubitUnitary(qureg, u, NULL, 0, targs, numTargs)) {
         statevec_multiQubitUnitary(qureg, targs, numTargs, u);
-        shiftIndices(targs, numTargs, -shift);
-        setConjugateMatrixN(u);
+        if (qureg.isDensityMatrix) {
+            int shift = qureg.numQubitsRepresented;
+            shiftIndices(targs, numTargs, shift);
+            setConjugateMatrixN(u);
+            statevec_multiQubitUnitary(qureg, targs, numTargs, u);
+            shiftIndices(targs, numTargs, -shift);
+            setConjugateMatrixN(u);
+        }
     }
+    noise_applyGateNoise(qureg, NULL, 0, targs, numTargs);
     
     qasm_recordComment(qureg, "Here, an undisclosed multi-qubit unitary was applied.");
 }
 
 void controlledMultiQubitUnitary(Qureg qureg, int ctrl, int* targs, int numTargs, ComplexMatrixN u) {
+    validateUnpackedQureg(qureg, __func__);
     validateMultiControlsMultiTargets(qureg, (int[]) {ctrl}, 1, targs, numTargs, __func__);
     validateMultiQubitUnitaryMatrix(qureg, u, numTargs, __func__);
     
-    statevec_controlledMultiQubitUnitary(qureg, ctrl, targs, numTargs, u);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        shiftIndices(targs, numTargs, shift);
-        setConjugateMatrixN(u);
-        statevec_controlledMultiQubitUnitary(qureg, ctrl+shift, targs, numTargs, u);
-        shiftIndices(targs, numTargs, -shift);
-        setConjugateMatrixN(u);
+    if (!fusion_deferMultiQubitUnitary(qureg, u, (int[]) {ctrl}, 1, targs, numTargs)) {
+        statevec_controlledMultiQubitUnitary(qureg, ctrl, targs, numTargs, u);
+        if (qureg.isDensityMatrix) {
+            int shift = qureg.numQubitsRepresented;
+            shiftIndices(targs, numTargs, shift);
+            setConjugateMatrixN(u);
+            statevec_controlledMultiQubitUnitary(qureg, ctrl+shift, targs, numTargs, u);
+            shiftIndices(targs, numTargs, -shift);
+            setConjugateMatrixN(u);
+        }
     }
+    noise_applyGateNoise(qureg, (int[]) {ctrl}, 1, targs, numTargs);
     
     qasm_recordComment(qureg, "Here, an undisclosed controlled multi-qubit unitary was applied.");
 }
 
 void multiControlledMultiQubitUnitary(Qureg qureg, int* ctrls, int numCtrls, int* targs, int numTargs, ComplexMatrixN u) {
+    validateUnpackedQureg(qureg, __func__);
     validateMultiControlsMultiTargets(qureg, ctrls, numCtrls, targs, numTargs, __func__);
     validateMultiQubitUnitaryMatrix(qureg, u, numTargs, __func__);
     
-    long long int ctrlMask = getQubitBitMask(ctrls, numCtrls);
-    statevec_multiControlledMultiQubitUnitary(qureg, ctrlMask, targs, numTargs, u);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        shiftIndices(targs, numTargs, shift);
-        setConjugateMatrixN(u);
-        statevec_multiControlledMultiQubitUnitary(qureg, ctrlMask<<shift, targs, numTargs, u);
-        shiftIndices(targs, numTargs, -shift);
-        setConjugateMatrixN(u);
+    if (!fusion_deferMultiQubitUnitary(qureg, u, ctrls, numCtrls, targs, numTargs)) {
+        long long int ctrlMask = getQubitBitMask(ctrls, numCtrls);
+        statevec_multiControlledMultiQubitUnitary(qureg, ctrlMask, targs, numTargs, u);
+        if (qureg.isDensityMatrix) {
+            int shift = qureg.numQubitsRepresented;
+            shiftIndices(targs, numTargs, shift);
+            setConjugateMatrixN(u);
+            statevec_multiControlledMultiQubitUnitary(qureg, ctrlMask<<shift, targs, numTargs, u);
+            shiftIndices(targs, numTargs, -shift);
+            setConjugateMatrixN(u);
+        }
     }
+    noise_applyGateNoise(qureg, ctrls, numCtrls, targs, numTargs);
     
     qasm_recordComment(qureg, "Here, an undisclosed multi-controlled multi-qubit unitary was applied.");
 }
@@ -353,10 +495,13 @@ void unitary(Qureg qureg, int targetQubit, ComplexMatrix2 u) {
     validateTarget(qureg, targetQubit, __func__);
     validateOneQubitUnitaryMatrix(u, __func__);
     
-    statevec_unitary(qureg, targetQubit, u);
-    if (qureg.isDensityMatrix) {
-        statevec_unitary(qureg, targetQubit+qureg.numQubitsRepresented, getConjugateMatrix2(u));
+    if (!fusion_deferUnitary(qureg, u, NULL, NULL, 0, targetQubit)) {
+        if (qureg.isDensityMatrix)
+            densmatr_multiControlledUnitary(qureg, 0, 0, targetQubit, u);
+        else
+            statevec_unitary(qureg, targetQubit, u);
     }
+    noise_applyGateNoise(qureg, NULL, 0, (int[]) {targetQubit}, 1);
     
     qasm_recordUnitary(qureg, u, targetQubit);
 }
@@ -365,11 +510,13 @@ void controlledUnitary(Qureg qureg, int controlQubit, int targetQubit, ComplexMa
     validateControlTarget(qureg, controlQubit, targetQubit, __func__);
     validateOneQubitUnitaryMatrix(u, __func__);
     
-    statevec_controlledUnitary(qureg, controlQubit, targetQubit, u);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_controlledUnitary(qureg, controlQubit+shift, targetQubit+shift, getConjugateMatrix2(u));
+    if (!fusion_deferUnitary(qureg, u, (int[]) {controlQubit}, NULL, 1, targetQubit)) {
+        if (qureg.isDensityMatrix)
+            densmatr_multiControlledUnitary(qureg, 1LL << controlQubit, 0, targetQubit, u);
+        else
+            statevec_controlledUnitary(qureg, controlQubit, targetQubit, u);
     }
+    noise_applyGateNoise(qureg, (int[]) {controlQubit}, 1, (int[]) {targetQubit}, 1);
     
     qasm_recordControlledUnitary(qureg, u, controlQubit, targetQubit);
 }
@@ -378,13 +525,15 @@ void multiControlledUnitary(Qureg qureg, int* controlQubits, int numControlQubit
     validateMultiControlsTarget(qureg, controlQubits, numControlQubits, targetQubit, __func__);
     validateOneQubitUnitaryMatrix(u, __func__);
     
-    long long int ctrlQubitsMask = getQubitBitMask(controlQubits, numControlQubits);
-    long long int ctrlFlipMask = 0;
-    statevec_multiControlledUnitary(qureg, ctrlQubitsMask, ctrlFlipMask, targetQubit, u);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_multiControlledUnitary(qureg, ctrlQubitsMask<<shift, ctrlFlipMask<<shift, targetQubit+shift, getConjugateMatrix2(u));
+    if (!fusion_deferUnitary(qureg, u, controlQubits, NULL, numControlQubits, targetQubit)) {
+        long long int ctrlQubitsMask = getQubitBitMask(controlQubits, numControlQubits);
+        long long int ctrlFlipMask = 0;
+        if (qureg.isDensityMatrix)
+            densmatr_multiControlledUnitary(qureg, ctrlQubitsMask, ctrlFlipMask, targetQubit, u);
+        else
+            statevec_multiControlledUnitary(qureg, ctrlQubitsMask, ctrlFlipMask, targetQubit, u);
     }
+    noise_applyGateNoise(qureg, controlQubits, numControlQubits, (int[]) {targetQubit}, 1);
     
     qasm_recordMultiControlledUnitary(qureg, u, controlQubits, numControlQubits, targetQubit);
 }
@@ -394,13 +543,15 @@ void multiStateControlledUnitary(Qureg qureg, int* controlQubits, int* controlSt
     validateOneQubitUnitaryMatrix(u, __func__);
     validateControlState(controlState, numControlQubits, __func__);
 
-    long long int ctrlQubitsMask = getQubitBitMask(controlQubits, numControlQubits);
-    long long int ctrlFlipMask = getControlFlipMask(controlQubits, controlState, numControlQubits);
-    statevec_multiControlledUnitary(qureg, ctrlQubitsMask, ctrlFlipMask, targetQubit, u);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_multiControlledUnitary(qureg, ctrlQubitsMask<<shift, ctrlFlipMask<<shift, targetQubit+shift, getConjugateMatrix2(u));
+    if (!fusion_deferUnitary(qureg, u, controlQubits, controlState, numControlQubits, targetQubit)) {
+        long long int ctrlQubitsMask = getQubitBitMask(controlQubits, numControlQubits);
+        long long int ctrlFlipMask = getControlFlipMask(controlQubits, controlState, numControlQubits);
+        if (qureg.isDensityMatrix)
+            densmatr_multiControlledUnitary(qureg, ctrlQubitsMask, ctrlFlipMask, targetQubit, u);
+        else
+            statevec_multiControlledUnitary(qureg, ctrlQubitsMask, ctrlFlipMask, targetQubit, u);
     }
+    noise_applyGateNoise(qureg, controlQubits, numControlQubits, (int[]) {targetQubit}, 1);
     
     qasm_recordMultiStateControlledUnitary(qureg, u, controlQubits, controlState, numControlQubits, targetQubit);
 }
@@ -409,11 +560,13 @@ void compactUnitary(Qureg qureg, int targetQubit, Complex alpha, Complex beta) {
     validateTarget(qureg, targetQubit, __func__);
     validateUnitaryComplexPair(alpha, beta, __func__);
     
-    statevec_compactUnitary(qureg, targetQubit, alpha, beta);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_compactUnitary(qureg, targetQubit+shift, getConjugateScalar(alpha), getConjugateScalar(beta));
+    if (!fusion_deferCompactUnitary(qureg, alpha, beta, NULL, 0, targetQubit)) {
+        if (qureg.isDensityMatrix)
+            densmatr_compactUnitary(qureg, 0, targetQubit, alpha, beta);
+        else
+            statevec_compactUnitary(qureg, targetQubit, alpha, beta);
     }
+    noise_applyGateNoise(qureg, NULL, 0, (int[]) {targetQubit}, 1);
 
     qasm_recordCompactUnitary(qureg, alpha, beta, targetQubit);
 }
@@ -422,13 +575,13 @@ void controlledCompactUnitary(Qureg qureg, int controlQubit, int targetQubit, Co
     validateControlTarget(qureg, controlQubit, targetQubit, __func__);
     validateUnitaryComplexPair(alpha, beta, __func__);
     
-    statevec_controlledCompactUnitary(qureg, controlQubit, targetQubit, alpha, beta);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_controlledCompactUnitary(qureg, 
-            controlQubit+shift, targetQubit+shift, 
-            getConjugateScalar(alpha), getConjugateScalar(beta));
+    if (!fusion_deferCompactUnitary(qureg, alpha, beta, (int[]) {controlQubit}, 1, targetQubit)) {
+        if (qureg.isDensityMatrix)
+            densmatr_compactUnitary(qureg, 1LL << controlQubit, targetQubit, alpha, beta);
+        else
+            statevec_controlledCompactUnitary(qureg, controlQubit, targetQubit, alpha, beta);
     }
+    noise_applyGateNoise(qureg, (int[]) {controlQubit}, 1, (int[]) {targetQubit}, 1);
     
     qasm_recordControlledCompactUnitary(qureg, alpha, beta, controlQubit, targetQubit);
 }
@@ -436,10 +589,17 @@ void controlledCompactUnitary(Qureg qureg, int controlQubit, int targetQubit, Co
 void pauliX(Qureg qureg, int targetQubit) {
     validateTarget(qureg, targetQubit, __func__);
     
-    statevec_pauliX(qureg, targetQubit);
-    if (qureg.isDensityMatrix) {
-        statevec_pauliX(qureg, targetQubit+qureg.numQubitsRepresented);
+    if (!fusion_deferGate(qureg, GATE_SIGMA_X, 0, NULL, 0, (int[]) {targetQubit}, 1)) {
+        if (qureg.isPackedDensityMatrix)
+            densmatr_multiControlledMultiQubitNot(qureg, 0, 1LL << targetQubit);
+        else {
+            statevec_pauliX(qureg, targetQubit);
+            if (qureg.isDensityMatrix) {
+                statevec_pauliX(qureg, targetQubit+qureg.numQubitsRepresented);
+            }
+        }
     }
+    noise_applyGateNoise(qureg, NULL, 0, (int[]) {targetQubit}, 1);
     
     qasm_recordGate(qureg, GATE_SIGMA_X, targetQubit);
 }
@@ -447,10 +607,17 @@ void pauliX(Qureg qureg, int targetQubit) {
 void pauliY(Qureg qureg, int targetQubit) {
     validateTarget(qureg, targetQubit, __func__);
     
-    statevec_pauliY(qureg, targetQubit);
-    if (qureg.isDensityMatrix) {
-        statevec_pauliYConj(qureg, targetQubit + qureg.numQubitsRepresented);
+    if (!fusion_deferGate(qureg, GATE_SIGMA_Y, 0, NULL, 0, (int[]) {targetQubit}, 1)) {
+        if (qureg.isPackedDensityMatrix)
+            densmatr_multiControlledPauliY(qureg, 0, targetQubit);
+        else {
+            statevec_pauliY(qureg, targetQubit);
+            if (qureg.isDensityMatrix) {
+                statevec_pauliYConj(qureg, targetQubit + qureg.numQubitsRepresented);
+            }
+        }
     }
+    noise_applyGateNoise(qureg, NULL, 0, (int[]) {targetQubit}, 1);
     
     qasm_recordGate(qureg, GATE_SIGMA_Y, targetQubit);
 }
@@ -458,10 +625,13 @@ void pauliY(Qureg qureg, int targetQubit) {
 void pauliZ(Qureg qureg, int targetQubit) {
     validateTarget(qureg, targetQubit, __func__);
     
-    statevec_pauliZ(qureg, targetQubit);
-    if (qureg.isDensityMatrix) {
-        statevec_pauliZ(qureg, targetQubit+qureg.numQubitsRepresented);
+    if (!fusion_deferGate(qureg, GATE_SIGMA_Z, 0, NULL, 0, (int[]) {targetQubit}, 1)) {
+        if (qureg.isDensityMatrix)
+            densmatr_multiControlledPhaseFlip(qureg, 1LL << targetQubit);
+        else
+            statevec_pauliZ(qureg, targetQubit);
     }
+    noise_applyGateNoise(qureg, NULL, 0, (int[]) {targetQubit}, 1);
     
     qasm_recordGate(qureg, GATE_SIGMA_Z, targetQubit);
 }
@@ -469,10 +639,13 @@ void pauliZ(Qureg qureg, int targetQubit) {
 void sGate(Qureg qureg, int targetQubit) {
     validateTarget(qureg, targetQubit, __func__);
     
-    statevec_sGate(qureg, targetQubit);
-    if (qureg.isDensityMatrix) {
-        statevec_sGateConj(qureg, targetQubit+qureg.numQubitsRepresented);
+    if (!fusion_deferGate(qureg, GATE_S, 0, NULL, 0, (int[]) {targetQubit}, 1)) {
+        if (qureg.isDensityMatrix)
+            densmatr_sGate(qureg, targetQubit);
+        else
+            statevec_sGate(qureg, targetQubit);
     }
+    noise_applyGateNoise(qureg, NULL, 0, (int[]) {targetQubit}, 1);
     
     qasm_recordGate(qureg, GATE_S, targetQubit);
 }
@@ -480,10 +653,13 @@ void sGate(Qureg qureg, int targetQubit) {
 void tGate(Qureg qureg, int targetQubit) {
     validateTarget(qureg, targetQubit, __func__);
     
-    statevec_tGate(qureg, targetQubit);
-    if (qureg.isDensityMatrix) {
-        statevec_tGateConj(qureg, targetQubit+qureg.numQubitsRepresented);
+    if (!fusion_deferGate(qureg, GATE_T, 0, NULL, 0, (int[]) {targetQubit}, 1)) {
+        if (qureg.isDensityMatrix)
+            densmatr_tGate(qureg, targetQubit);
+        else
+            statevec_tGate(qureg, targetQubit);
     }
+    noise_applyGateNoise(qureg, NULL, 0, (int[]) {targetQubit}, 1);
     
     qasm_recordGate(qureg, GATE_T, targetQubit);
 }
@@ -491,10 +667,13 @@ void tGate(Qureg qureg, int targetQubit) {
 void phaseShift(Qureg qureg, int targetQubit, qreal angle) {
     validateTarget(qureg, targetQubit, __func__);
     
-    statevec_phaseShift(qureg, targetQubit, angle);
-    if (qureg.isDensityMatrix) {
-        statevec_phaseShift(qureg, targetQubit+qureg.numQubitsRepresented, -angle);
+    if (!fusion_deferGate(qureg, GATE_PHASE_SHIFT, angle, NULL, 0, (int[]) {targetQubit}, 1)) {
+        if (qureg.isDensityMatrix)
+            densmatr_multiControlledPhaseShift(qureg, 1LL << targetQubit, angle);
+        else
+            statevec_phaseShift(qureg, targetQubit, angle);
     }
+    noise_applyGateNoise(qureg, NULL, 0, (int[]) {targetQubit}, 1);
     
     qasm_recordParamGate(qureg, GATE_PHASE_SHIFT, targetQubit, angle);
 }
@@ -502,11 +681,13 @@ void phaseShift(Qureg qureg, int targetQubit, qreal angle) {
 void controlledPhaseShift(Qureg qureg, int idQubit1, int idQubit2, qreal angle) {
     validateControlTarget(qureg, idQubit1, idQubit2, __func__);
     
-    statevec_controlledPhaseShift(qureg, idQubit1, idQubit2, angle);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_controlledPhaseShift(qureg, idQubit1+shift, idQubit2+shift, -angle);
+    if (!fusion_deferGate(qureg, GATE_PHASE_SHIFT, angle, (int[]) {idQubit1}, 1, (int[]) {idQubit2}, 1)) {
+        if (qureg.isDensityMatrix)
+            densmatr_multiControlledPhaseShift(qureg, (1LL << idQubit1) | (1LL << idQubit2), angle);
+        else
+            statevec_controlledPhaseShift(qureg, idQubit1, idQubit2, angle);
     }
+    noise_applyGateNoise(qureg, (int[]) {idQubit1}, 1, (int[]) {idQubit2}, 1);
     
     qasm_recordControlledParamGate(qureg, GATE_PHASE_SHIFT, idQubit1, idQubit2, angle);
 }
@@ -514,13 +695,13 @@ void controlledPhaseShift(Qureg qureg, int idQubit1, int idQubit2, qreal angle)
 void multiControlledPhaseShift(Qureg qureg, int *controlQubits, int numControlQubits, qreal angle) {
     validateMultiQubits(qureg, controlQubits, numControlQubits, __func__);
     
-    statevec_multiControlledPhaseShift(qureg, controlQubits, numControlQubits, angle);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        shiftIndices(controlQubits, numControlQubits, shift);
-        statevec_multiControlledPhaseShift(qureg, controlQubits, numControlQubits, -angle);
-        shiftIndices(controlQubits, numControlQubits, -shift);
+    if (!fusion_deferGate(qureg, GATE_PHASE_SHIFT, angle, controlQubits, numControlQubits-1, &controlQubits[numControlQubits-1], 1)) {
+        if (qureg.isDensityMatrix)
+            densmatr_multiControlledPhaseShift(qureg, getQubitBitMask(controlQubits, numControlQubits), angle);
+        else
+            statevec_multiControlledPhaseShift(qureg, controlQubits, numControlQubits, angle);
     }
+    noise_applyGateNoise(qureg, controlQubits, numControlQubits-1, &controlQubits[numControlQubits-1], 1);
     
     qasm_recordMultiControlledParamGate(qureg, GATE_PHASE_SHIFT, controlQubits, numControlQubits-1, controlQubits[numControlQubits-1], angle);
 }
@@ -528,11 +709,18 @@ void multiControlledPhaseShift(Qureg qureg, int *controlQubits, int numControlQu
 void controlledNot(Qureg qureg, int controlQubit, int targetQubit) {
     validateControlTarget(qureg, controlQubit, targetQubit, __func__);
     
-    statevec_controlledNot(qureg, controlQubit, targetQubit);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_controlledNot(qureg, controlQubit+shift, targetQubit+shift);
+    if (!fusion_deferGate(qureg, GATE_SIGMA_X, 0, (int[]) {controlQubit}, 1, (int[]) {targetQubit}, 1)) {
+        if (qureg.isPackedDensityMatrix)
+            densmatr_multiControlledMultiQubitNot(qureg, 1LL << controlQubit, 1LL << targetQubit);
+        else {
+            statevec_controlledNot(qureg, controlQubit, targetQubit);
+            if (qureg.isDensityMatrix) {
+                int shift = qureg.numQubitsRepresented;
+                statevec_controlledNot(qureg, controlQubit+shift, targetQubit+shift);
+            }
+        }
     }
+    noise_applyGateNoise(qureg, (int[]) {controlQubit}, 1, (int[]) {targetQubit}, 1);
     
     qasm_recordControlledGate(qureg, GATE_SIGMA_X, controlQubit, targetQubit);
 }
@@ -540,12 +728,19 @@ void controlledNot(Qureg qureg, int controlQubit, int targetQubit) {
 void multiQubitNot(Qureg qureg, int* targs, int numTargs) {
     validateMultiTargets(qureg, targs, numTargs, __func__);
     
-    long long int targMask = getQubitBitMask(targs, numTargs);
-    statevec_multiControlledMultiQubitNot(qureg, 0, targMask);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_multiControlledMultiQubitNot(qureg, 0, targMask<<shift);
+    if (!fusion_deferGate(qureg, GATE_SIGMA_X, 0, NULL, 0, targs, numTargs)) {
+        long long int targMask = getQubitBitMask(targs, numTargs);
+        if (qureg.isPackedDensityMatrix)
+            densmatr_multiControlledMultiQubitNot(qureg, 0, targMask);
+        else {
+            statevec_multiControlledMultiQubitNot(qureg, 0, targMask);
+            if (qureg.isDensityMatrix) {
+                int shift = qureg.numQubitsRepresented;
+                statevec_multiControlledMultiQubitNot(qureg, 0, targMask<<shift);
+            }
+        }
     }
+    noise_applyGateNoise(qureg, NULL, 0, targs, numTargs);
     
     qasm_recordMultiControlledMultiQubitNot(qureg, NULL, 0, targs, numTargs);
 }
@@ -553,13 +748,20 @@ void multiQubitNot(Qureg qureg, int* targs, int numTargs) {
 void multiControlledMultiQubitNot(Qureg qureg, int* ctrls, int numCtrls, int* targs, int numTargs) {
     validateMultiControlsMultiTargets(qureg, ctrls, numCtrls, targs, numTargs, __func__);
     
-    long long int ctrlMask = getQubitBitMask(ctrls, numCtrls);
-    long long int targMask = getQubitBitMask(targs, numTargs);
-    statevec_multiControlledMultiQubitNot(qureg, ctrlMask, targMask);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_multiControlledMultiQubitNot(qureg, ctrlMask<<shift, targMask<<shift);
+    if (!fusion_deferGate(qureg, GATE_SIGMA_X, 0, ctrls, numCtrls, targs, numTargs)) {
+        long long int ctrlMask = getQubitBitMask(ctrls, numCtrls);
+        long long int targMask = getQubitBitMask(targs, numTargs);
+        if (qureg.isPackedDensityMatrix)
+            densmatr_multiControlledMultiQubitNot(qureg, ctrlMask, targMask);
+        else {
+            statevec_multiControlledMultiQubitNot(qureg, ctrlMask, targMask);
+            if (qureg.isDensityMatrix) {
+                int shift = qureg.numQubitsRepresented;
+                statevec_multiControlledMultiQubitNot(qureg, ctrlMask<<shift, targMask<<shift);
+            }
+        }
     }
+    noise_applyGateNoise(qureg, ctrls, numCtrls, targs, numTargs);
     
     qasm_recordMultiControlledMultiQubitNot(qureg, ctrls, numCtrls, targs, numTargs);
 }
@@ -567,11 +769,18 @@ void multiControlledMultiQubitNot(Qureg qureg, int* ctrls, int numCtrls, int* ta
 void controlledPauliY(Qureg qureg, int controlQubit, int targetQubit) {
     validateControlTarget(qureg, controlQubit, targetQubit, __func__);
     
-    statevec_controlledPauliY(qureg, controlQubit, targetQubit);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_controlledPauliYConj(qureg, controlQubit+shift, targetQubit+shift);
+    if (!fusion_deferGate(qureg, GATE_SIGMA_Y, 0, (int[]) {controlQubit}, 1, (int[]) {targetQubit}, 1)) {
+        if (qureg.isPackedDensityMatrix)
+            densmatr_multiControlledPauliY(qureg, 1LL << controlQubit, targetQubit);
+        else {
+            statevec_controlledPauliY(qureg, controlQubit, targetQubit);
+            if (qureg.isDensityMatrix) {
+                int shift = qureg.numQubitsRepresented;
+                statevec_controlledPauliYConj(qureg, controlQubit+shift, targetQubit+shift);
+            }
+        }
     }
+    noise_applyGateNoise(qureg, (int[]) {controlQubit}, 1, (int[]) {targetQubit}, 1);
     
     qasm_recordControlledGate(qureg, GATE_SIGMA_Y, controlQubit, targetQubit);
 }
@@ -579,11 +788,13 @@ void controlledPauliY(Qureg qureg, int controlQubit, int targetQubit) {
 void controlledPhaseFlip(Qureg qureg, int idQubit1, int idQubit2) {
     validateControlTarget(qureg, idQubit1, idQubit2, __func__);
     
-    statevec_controlledPhaseFlip(qureg, idQubit1, idQubit2);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_controlledPhaseFlip(qureg, idQubit1+shift, idQubit2+shift);
+    if (!fusion_deferGate(qureg, GATE_SIGMA_Z, 0, (int[]) {idQubit1}, 1, (int[]) {idQubit2}, 1)) {
+        if (qureg.isDensityMatrix)
+            densmatr_multiControlledPhaseFlip(qureg, (1LL << idQubit1) | (1LL << idQubit2));
+        else
+            statevec_controlledPhaseFlip(qureg, idQubit1, idQubit2);
     }
+    noise_applyGateNoise(qureg, (int[]) {idQubit1}, 1, (int[]) {idQubit2}, 1);
     
     qasm_recordControlledGate(qureg, GATE_SIGMA_Z, idQubit1, idQubit2);
 }
@@ -591,13 +802,13 @@ void controlledPhaseFlip(Qureg qureg, int idQubit1, int idQubit2) {
 void multiControlledPhaseFlip(Qureg qureg, int *controlQubits, int numControlQubits) {
     validateMultiQubits(qureg, controlQubits, numControlQubits, __func__);
     
-    statevec_multiControlledPhaseFlip(qureg, controlQubits, numControlQubits);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        shiftIndices(controlQubits, numControlQubits, shift);
-        statevec_multiControlledPhaseFlip(qureg, controlQubits, numControlQubits);
-        shiftIndices(controlQubits, numControlQubits, -shift);
+    if (!fusion_deferGate(qureg, GATE_SIGMA_Z, 0, controlQubits, numControlQubits-1, &controlQubits[numControlQubits-1], 1)) {
+        if (qureg.isDensityMatrix)
+            densmatr_multiControlledPhaseFlip(qureg, getQubitBitMask(controlQubits, numControlQubits));
+        else
+            statevec_multiControlledPhaseFlip(qureg, controlQubits, numControlQubits);
     }
+    noise_applyGateNoise(qureg, controlQubits, numControlQubits-1, &controlQubits[numControlQubits-1], 1);
     
     qasm_recordMultiControlledGate(qureg, GATE_SIGMA_Z, controlQubits, numControlQubits-1, controlQubits[numControlQubits-1]);
 }
@@ -606,11 +817,13 @@ void rotateAroundAxis(Qureg qureg, int rotQubit, qreal angle, Vector axis) {
     validateTarget(qureg, rotQubit, __func__);
     validateVector(axis, __func__);
     
-    statevec_rotateAroundAxis(qureg, rotQubit, angle, axis);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_rotateAroundAxisConj(qureg, rotQubit+shift, angle, axis);
+    if (!fusion_deferAxisRotation(qureg, angle, axis, NULL, 0, rotQubit)) {
+        if (qureg.isDensityMatrix)
+            densmatr_rotateAroundAxis(qureg, 0, rotQubit, angle, axis);
+        else
+            statevec_rotateAroundAxis(qureg, rotQubit, angle, axis);
     }
+    noise_applyGateNoise(qureg, NULL, 0, (int[]) {rotQubit}, 1);
     
     qasm_recordAxisRotation(qureg, angle, axis, rotQubit);
 }
@@ -619,11 +832,13 @@ void controlledRotateAroundAxis(Qureg qureg, int controlQubit, int targetQubit,
     validateControlTarget(qureg, controlQubit, targetQubit, __func__);
     validateVector(axis, __func__);
     
-    statevec_controlledRotateAroundAxis(qureg, controlQubit, targetQubit, angle, axis);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_controlledRotateAroundAxisConj(qureg, controlQubit+shift, targetQubit+shift, angle, axis);
+    if (!fusion_deferAxisRotation(qureg, angle, axis, (int[]) {controlQubit}, 1, targetQubit)) {
+        if (qureg.isDensityMatrix)
+            densmatr_rotateAroundAxis(qureg, 1LL << controlQubit, targetQubit, angle, axis);
+        else
+            statevec_controlledRotateAroundAxis(qureg, controlQubit, targetQubit, angle, axis);
     }
+    noise_applyGateNoise(qureg, (int[]) {controlQubit}, 1, (int[]) {targetQubit}, 1);
     
     qasm_recordControlledAxisRotation(qureg, angle, axis, controlQubit, targetQubit);
 }
@@ -631,11 +846,18 @@ void controlledRotateAroundAxis(Qureg qureg, int controlQubit, int targetQubit,
 void swapGate(Qureg qureg, int qb1, int qb2) {
     validateUniqueTargets(qureg, qb1, qb2, __func__);
 
-    statevec_swapQubitAmps(qureg, qb1, qb2);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_swapQubitAmps(qureg, qb1+shift, qb2+shift);
+    if (!fusion_deferGate(qureg, GATE_SWAP, 0, NULL, 0, (int[]) {qb1, qb2}, 2)) {
+        if (qureg.isPackedDensityMatrix)
+            densmatr_swapGate(qureg, qb1, qb2);
+        else {
+            statevec_swapQubitAmps(qureg, qb1, qb2);
+            if (qureg.isDensityMatrix) {
+                int shift = qureg.numQubitsRepresented;
+                statevec_swapQubitAmps(qureg, qb1+shift, qb2+shift);
+            }
+        }
     }
+    noise_applyGateNoise(qureg, NULL, 0, (int[]) {qb1, qb2}, 2);
 
     qasm_recordControlledGate(qureg, GATE_SWAP, qb1, qb2);
 }
@@ -644,11 +866,18 @@ void sqrtSwapGate(Qureg qureg, int qb1, int qb2) {
     validateUniqueTargets(qureg, qb1, qb2, __func__);
     validateMultiQubitMatrixFitsInNode(qureg, 2, __func__); // uses 2qb unitary in QuEST_common
 
-    statevec_sqrtSwapGate(qureg, qb1, qb2);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_sqrtSwapGateConj(qureg, qb1+shift, qb2+shift);
+    if (!fusion_deferGate(qureg, GATE_SQRT_SWAP, 0, NULL, 0, (int[]) {qb1, qb2}, 2)) {
+        if (qureg.isPackedDensityMatrix)
+            densmatr_sqrtSwapGate(qureg, qb1, qb2);
+        else {
+            statevec_sqrtSwapGate(qureg, qb1, qb2);
+            if (qureg.isDensityMatrix) {
+                int shift = qureg.numQubitsRepresented;
+                statevec_sqrtSwapGateConj(qureg, qb1+shift, qb2+shift);
+            }
+        }
     }
+    noise_applyGateNoise(qureg, NULL, 0, (int[]) {qb1, qb2}, 2);
 
     qasm_recordControlledGate(qureg, GATE_SQRT_SWAP, qb1, qb2);
 }
@@ -656,12 +885,14 @@ void sqrtSwapGate(Qureg qureg, int qb1, int qb2) {
 void multiRotateZ(Qureg qureg, int* qubits, int numQubits, qreal angle) {
     validateMultiTargets(qureg, qubits, numQubits, __func__);
     
-    long long int mask = getQubitBitMask(qubits, numQubits);
-    statevec_multiRotateZ(qureg, mask, angle);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_multiRotateZ(qureg, mask << shift, -angle);
+    if (!fusion_deferGate(qureg, GATE_ROTATE_Z, angle, NULL, 0, qubits, numQubits)) {
+        long long int mask = getQubitBitMask(qubits, numQubits);
+        if (qureg.isDensityMatrix)
+            densmatr_multiControlledMultiRotateZ(qureg, 0, mask, angle);
+        else
+            statevec_multiRotateZ(qureg, mask, angle);
     }
+    noise_applyGateNoise(qureg, NULL, 0, qubits, numQubits);
     
     // @TODO: create actual QASM
     qasm_recordComment(qureg, 
@@ -672,13 +903,15 @@ void multiRotateZ(Qureg qureg, int* qubits, int numQubits, qreal angle) {
 void multiControlledMultiRotateZ(Qureg qureg, int* controlQubits, int numControls, int* targetQubits, int numTargets, qreal angle) {
     validateMultiControlsMultiTargets(qureg, controlQubits, numControls, targetQubits, numTargets, __func__);
     
-    long long int ctrlMask = getQubitBitMask(controlQubits, numControls);
-    long long int targMask = getQubitBitMask(targetQubits, numTargets);
-    statevec_multiControlledMultiRotateZ(qureg, ctrlMask, targMask, angle);
-    if (qureg.isDensityMatrix) {
-        int shift = qureg.numQubitsRepresented;
-        statevec_multiControlledMultiRotateZ(qureg, ctrlMask<<shift, targMask<<shift, - angle);
+    if (!fusion_deferGate(qureg, GATE_ROTATE_Z, angle, controlQubits, numControls, targetQubits, numTargets)) {
+        long long int ctrlMask = getQubitBitMask(controlQubits, numControls);
+        long long int targMask = getQubitBitMask(targetQubits, numTargets);
+        if (qureg.isDensityMatrix)
+            densmatr_multiControlledMultiRotateZ(qureg, ctrlMask, targMask, angle);
+        else
+            statevec_multiControlledMultiRotateZ(qureg, ctrlMask, targMask, angle);
     }
+    noise_applyGateNoise(qureg, controlQubits, numControls, targetQubits, numTargets);
     
     // @TODO: create actual QASM
     qasm_recordComment(qureg, 
@@ -687,9 +920,11 @@ void multiControlledMultiRotateZ(Qureg qureg, int* controlQubits, int numControl
 }
 
 void multiRotatePauli(Qureg qureg, int* targetQubits, enum pauliOpType* targetPaulis, int numTargets, qreal angle) {
+    validateUnpackedQureg(qureg, __func__);
     validateMultiTargets(qureg, targetQubits, numTargets, __func__);
     validatePauliCodes(targetPaulis, numTargets, __func__);
     
+    fusion_applyDeferred(qureg);
     int conj=0;
     statevec_multiRotatePauli(qureg, targetQubits, targetPaulis, numTargets, angle, conj);
     if (qureg.isDensityMatrix) {
@@ -699,6 +934,7 @@ void multiRotatePauli(Qureg qureg, int* targetQubits, enum pauliOpType* targetPa
         statevec_multiRotatePauli(qureg, targetQubits, targetPaulis, numTargets, angle, conj);
         shiftIndices(targetQubits, numTargets, -shift);
     }
+    noise_applyGateNoise(qureg, NULL, 0, targetQubits, numTargets);
     
     // @TODO: create actual QASM
     qasm_recordComment(qureg, 
@@ -707,9 +943,11 @@ void multiRotatePauli(Qureg qureg, int* targetQubits, enum pauliOpType* targetPa
 }
 
 void multiControlledMultiRotatePauli(Qureg qureg, int* controlQubits, int numControls, int* targetQubits, enum pauliOpType* targetPaulis, int numTargets, qreal angle) {
+    validateUnpackedQureg(qureg, __func__);
     validateMultiControlsMultiTargets(qureg, controlQubits, numControls, targetQubits, numTargets, __func__);
     validatePauliCodes(targetPaulis, numTargets, __func__);
     
+    fusion_applyDeferred(qureg);
     int conj=0;
     long long int ctrlMask = getQubitBitMask(controlQubits, numControls);
     statevec_multiControlledMultiRotatePauli(qureg, ctrlMask, targetQubits, targetPaulis, numTargets, angle, conj);
@@ -720,6 +958,7 @@ void multiControlledMultiRotatePauli(Qureg qureg, int* controlQubits, int numCon
         statevec_multiControlledMultiRotatePauli(qureg, ctrlMask<<shift, targetQubits, targetPaulis, numTargets, angle, conj);
         shiftIndices(targetQubits, numTargets, -shift);
     }
+    noise_applyGateNoise(qureg, controlQubits, numControls, targetQubits, numTargets);
     
     // @TODO: create actual QASM
     qasm_recordComment(qureg, 
@@ -728,10 +967,12 @@ void multiControlledMultiRotatePauli(Qureg qureg, int* controlQubits, int numCon
 }
 
 void applyPhaseFunc(Qureg qureg, int* qubits, int numQubits, enum bitEncoding encoding, qreal* coeffs, qreal* exponents, int numTerms) {
+    validateUnpackedQureg(qureg, __func__);
     validateMultiQubits(qureg, qubits, numQubits, __func__);
     validateBitEncoding(numQubits, encoding, __func__);
     validatePhaseFuncTerms(numQubits, encoding, coeffs, exponents, numTerms, NULL, 0, __func__);
 
+    fusion_applyDeferred(qureg);
     int conj = 0;
     statevec_applyPhaseFuncOverrides(qureg, qubits, numQubits, encoding, coeffs, exponents, numTerms, NULL, NULL, 0, conj);
     if (qureg.isDensityMatrix) {
@@ -745,11 +986,13 @@ void applyPhaseFunc(Qureg qureg, int* qubits, int numQubits, enum bitEncoding en
 }
 
 void applyPhaseFuncOverrides(Qureg qureg, int* qubits, int numQubits, enum bitEncoding encoding, qreal* coeffs, qreal* exponents, int numTerms, long long int* overrideInds, qreal* overridePhases, int numOverrides) {
+    validateUnpackedQureg(qureg, __func__);
     validateMultiQubits(qureg, qubits, numQubits, __func__);
     validateBitEncoding(numQubits, encoding, __func__);
     validatePhaseFuncOverrides(numQubits, encoding, overrideInds, numOverrides, __func__);
     validatePhaseFuncTerms(numQubits, encoding, coeffs, exponents, numTerms, overrideInds, numOverrides, __func__);
 
+    fusion_applyDeferred(qureg);
     int conj = 0;
     statevec_applyPhaseFuncOverrides(qureg, qubits, numQubits, encoding, coeffs, exponents, numTerms, overrideInds, overridePhases, numOverrides, conj);
     if (qureg.isDensityMatrix) {
@@ -762,11 +1005,20 @@ void applyPhaseFuncOverrides(Qureg qureg, int* qubits, int numQubits, enum bitEn
     qasm_recordPhaseFunc(qureg, qubits, numQubits, encoding, coeffs, exponents, numTerms, overrideInds, overridePhases, numOverrides);
 }
 
+void setPhaseFuncCaching(QuESTEnv env, int cacheTables) {
+    // env accepted for API consistency, since the table is cached per process
+    (void) env;
+    
+    agnostic_setPhaseFuncCaching(cacheTables);
+}
+
 void applyMultiVarPhaseFunc(Qureg qureg, int* qubits, int* numQubitsPerReg, int numRegs, enum bitEncoding encoding, qreal* coeffs, qreal* exponents, int* numTermsPerReg) {
+    validateUnpackedQureg(qureg, __func__);
     validateQubitSubregs(qureg, qubits, numQubitsPerReg, numRegs, __func__);
     validateMultiRegBitEncoding(numQubitsPerReg, numRegs, encoding, __func__);
     validateMultiVarPhaseFuncTerms(numQubitsPerReg, numRegs, encoding, exponents, numTermsPerReg, __func__);
 
+    fusion_applyDeferred(qureg);
     int conj = 0;
     statevec_applyMultiVarPhaseFuncOverrides(qureg, qubits, numQubitsPerReg, numRegs, encoding, coeffs, exponents, numTermsPerReg, NULL, NULL, 0, conj);
     if (qureg.isDensityMatrix) {
@@ -780,11 +1032,13 @@ void applyMultiVarPhaseFunc(Qureg qureg, int* qubits, int* numQubitsPerReg, int
 }
 
 void applyMultiVarPhaseFuncOverrides(Qureg qureg, int* qubits, int* numQubitsPerReg, int numRegs, enum bitEncoding encoding, qreal* coeffs, qreal* exponents, int* numTermsPerReg, long long int* overrideInds, qreal* overridePhases, int numOverrides) {
+    validateUnpackedQureg(qureg, __func__);
     validateQubitSubregs(qureg, qubits, numQubitsPerReg, numRegs, __func__);
     validateMultiRegBitEncoding(numQubitsPerReg, numRegs, encoding, __func__);
     validateMultiVarPhaseFuncTerms(numQubitsPerReg, numRegs, encoding, exponents, numTermsPerReg, __func__);
     validateMultiVarPhaseFuncOverrides(numQubitsPerReg, numRegs, encoding, overrideInds, numOverrides, __func__);
 
+    fusion_applyDeferred(qureg);
     int conj = 0;
     statevec_applyMultiVarPhaseFuncOverrides(qureg, qubits, numQubitsPerReg, numRegs, encoding, coeffs, exponents, numTermsPerReg, overrideInds, overridePhases, numOverrides, conj);
     if (qureg.isDensityMatrix) {
@@ -798,10 +1052,12 @@ void applyMultiVarPhaseFuncOverrides(Qureg qureg, int* qubits, int* numQubitsPer
 }
 
 void applyNamedPhaseFunc(Qureg qureg, int* qubits, int* numQubitsPerReg, int numRegs, enum bitEncoding encoding, enum phaseFunc functionNameCode) {
+    validateUnpackedQureg(qureg, __func__);
     validateQubitSubregs(qureg, qubits, numQubitsPerReg, numRegs, __func__);
     validateMultiRegBitEncoding(numQubitsPerReg, numRegs, encoding, __func__);
     validatePhaseFuncName(functionNameCode, numRegs, 0, __func__);
 
+    fusion_applyDeferred(qureg);
     int conj = 0;
     statevec_applyParamNamedPhaseFuncOverrides(qureg, qubits, numQubitsPerReg, numRegs, encoding, functionNameCode, NULL, 0, NULL, NULL, 0, conj);
     if (qureg.isDensityMatrix) {
@@ -815,11 +1071,13 @@ void applyNamedPhaseFunc(Qureg qureg, int* qubits, int* numQubitsPerReg, int num
 }
 
 void applyNamedPhaseFuncOverrides(Qureg qureg, int* qubits, int* numQubitsPerReg, int numRegs, enum bitEncoding encoding, enum phaseFunc functionNameCode, long long int* overrideInds, qreal* overridePhases, int numOverrides) {
+    validateUnpackedQureg(qureg, __func__);
     validateQubitSubregs(qureg, qubits, numQubitsPerReg, numRegs, __func__);
     validateMultiRegBitEncoding(numQubitsPerReg, numRegs, encoding, __func__);
     validatePhaseFuncName(functionNameCode, numRegs, 0, __func__);
     validateMultiVarPhaseFuncOverrides(numQubitsPerReg, numRegs, encoding, overrideInds, numOverrides, __func__);
 
+    fusion_applyDeferred(qureg);
     int conj = 0;
     statevec_applyParamNamedPhaseFuncOverrides(qureg, qubits, numQubitsPerReg, numRegs, encoding, functionNameCode, NULL, 0, overrideInds, overridePhases, numOverrides, conj);
     if (qureg.isDensityMatrix) {
@@ -833,10 +1091,12 @@ void applyNamedPhaseFuncOverrides(Qureg qureg, int* qubits, int* numQubitsPerReg
 }
 
 void applyParamNamedPhaseFunc(Qureg qureg, int* qubits, int* numQubitsPerReg, int numRegs, enum bitEncoding encoding, enum phaseFunc functionNameCode, qreal* params, int numParams) {
+    validateUnpackedQureg(qureg, __func__);
     validateQubitSubregs(qureg, qubits, numQubitsPerReg, numRegs, __func__);
     validateMultiRegBitEncoding(numQubitsPerReg, numRegs, encoding, __func__);
     validatePhaseFuncName(functionNameCode, numRegs, numParams, __func__);
 
+    fusion_applyDeferred(qureg);
     int conj = 0;
     statevec_applyParamNamedPhaseFuncOverrides(qureg, qubits, numQubitsPerReg, numRegs, encoding, functionNameCode, params, numParams, NULL, NULL, 0, conj);
     if (qureg.isDensityMatrix) {
@@ -850,11 +1110,13 @@ void applyParamNamedPhaseFunc(Qureg qureg, int* qubits, int* numQubitsPerReg, in
 }
 
 void applyParamNamedPhaseFuncOverrides(Qureg qureg, int* qubits, int* numQubitsPerReg, int numRegs, enum bitEncoding encoding, enum phaseFunc functionNameCode, qreal* params, int numParams, long long int* overrideInds, qreal* overridePhases, int numOverrides) {
+    validateUnpackedQureg(qureg, __func__);
     validateQubitSubregs(qureg, qubits, numQubitsPerReg, numRegs, __func__);
     validateMultiRegBitEncoding(numQubitsPerReg, numRegs, encoding, __func__);
     validatePhaseFuncName(functionNameCode, numRegs, numParams, __func__);
     validateMultiVarPhaseFuncOverrides(numQubitsPerReg, numRegs, encoding, overrideInds, numOverrides, __func__);
 
+    fusion_applyDeferred(qureg);
     int conj = 0;
     statevec_applyParamNamedPhaseFuncOverrides(qureg, qubits, numQubitsPerReg, numRegs, encoding, functionNameCode, params, numParams, overrideInds, overridePhases, numOverrides, conj);
     if (qureg.isDensityMatrix) {
@@ -868,8 +1130,10 @@ void applyParamNamedPhaseFuncOverrides(Qureg qureg, int* qubits, int* numQubitsP
 }
 
 void applyQFT(Qureg qureg, int* qubits, int numQubits) {
+    validateUnpackedQureg(qureg, __func__);
     validateMultiTargets(qureg, qubits, numQubits, __func__);
     
+    fusion_applyDeferred(qureg);
     qasm_recordComment(qureg, "Beginning of QFT circuit");
         
     agnostic_applyQFT(qureg, qubits, numQubits);
@@ -878,6 +1142,9 @@ void applyQFT(Qureg qureg, int* qubits, int numQubits) {
 }
 
 void applyFullQFT(Qureg qureg) {
+    validateUnpackedQureg(qureg, __func__);
+
+    fusion_applyDeferred(qureg);
 
     qasm_recordComment(qureg, "Beginning of QFT circuit");
         
@@ -893,9 +1160,12 @@ void applyProjector(Qureg qureg, int qubit, int outcome) {
     validateTarget(qureg, qubit, __func__);
     validateOutcome(outcome, __func__);
      
+    fusion_applyDeferred(qureg);
     qreal renorm = 1;
     
-    if (qureg.isDensityMatrix)
+    if (qureg.isPackedDensityMatrix)
+        packed_collapseToKnownProbOutcome(qureg, qubit, outcome, renorm);
+    else if (qureg.isDensityMatrix)
         densmatr_collapseToKnownProbOutcome(qureg, qubit, outcome, renorm);
     else
         statevec_collapseToKnownProbOutcome(qureg, qubit, outcome, renorm);
@@ -903,6 +1173,22 @@ void applyProjector(Qureg qureg, int qubit, int outcome) {
     qasm_recordComment(qureg, "Here, qubit %d was un-physically projected into outcome %d", qubit, outcome);
 }
 
+void applyMultiQubitProjector(Qureg qureg, int* qubits, int numQubits, long long int outcome) {
+    validateUnpackedQureg(qureg, __func__);
+    validateMultiTargets(qureg, qubits, numQubits, __func__);
+    validateMultiQubitOutcome(outcome, numQubits, __func__);
+    
+    fusion_applyDeferred(qureg);
+    qreal renorm = 1;
+    
+    if (qureg.isDensityMatrix)
+        densmatr_collapseToKnownProbMultiOutcome(qureg, qubits, numQubits, outcome, renorm);
+    else
+        statevec_collapseToKnownProbMultiOutcome(qureg, qubits, numQubits, outcome, renorm);
+    
+    qasm_recordComment(qureg, "Here, %d qubits were un-physically projected into outcome %lld", numQubits, outcome);
+}
+
 
 
 /*
@@ -923,6 +1209,7 @@ qreal getRealAmp(Qureg qureg, long long int index) {
     validateStateVecQureg(qureg, __func__);
     validateAmpIndex(qureg, index, __func__);
     
+    fusion_applyDeferred(qureg);
     return statevec_getRealAmp(qureg, index);
 }
 
@@ -930,6 +1217,7 @@ qreal getImagAmp(Qureg qureg, long long int index) {
     validateStateVecQureg(qureg, __func__);
     validateAmpIndex(qureg, index, __func__);
     
+    fusion_applyDeferred(qureg);
     return statevec_getImagAmp(qureg, index);
 }
 
@@ -937,6 +1225,7 @@ qreal getProbAmp(Qureg qureg, long long int index) {
     validateStateVecQureg(qureg, __func__);
     validateAmpIndex(qureg, index, __func__);
     
+    fusion_applyDeferred(qureg);
     return statevec_getProbAmp(qureg, index);
 }
 
@@ -944,6 +1233,7 @@ Complex getAmp(Qureg qureg, long long int index) {
     validateStateVecQureg(qureg, __func__);
     validateAmpIndex(qureg, index, __func__);
     
+    fusion_applyDeferred(qureg);
     Complex amp;
     amp.real = statevec_getRealAmp(qureg, index);
     amp.imag = statevec_getImagAmp(qureg, index);
@@ -955,6 +1245,10 @@ Complex getDensityAmp(Qureg qureg, long long int row, long long int col) {
     validateAmpIndex(qureg, row, __func__);
     validateAmpIndex(qureg, col, __func__);
     
+    fusion_applyDeferred(qureg);
+    if (qureg.isPackedDensityMatrix)
+        return packed_getDensityAmp(qureg, row, col);
+    
     long long ind = row + col*(1LL << qureg.numQubitsRepresented);
     Complex amp;
     amp.real = statevec_getRealAmp(qureg, ind);
@@ -971,8 +1265,13 @@ qreal collapseToOutcome(Qureg qureg, int measureQubit, int outcome) {
     validateTarget(qureg, measureQubit, __func__);
     validateOutcome(outcome, __func__);
     
+    fusion_applyDeferred(qureg);
     qreal outcomeProb;
-    if (qureg.isDensityMatrix) {
+    if (qureg.isPackedDensityMatrix) {
+        outcomeProb = packed_calcProbOfOutcome(qureg, measureQubit, outcome);
+        validateMeasurementProb(outcomeProb, __func__);
+        packed_collapseToKnownProbOutcome(qureg, measureQubit, outcome, outcomeProb);
+    } else if (qureg.isDensityMatrix) {
         outcomeProb = densmatr_calcProbOfOutcome(qureg, measureQubit, outcome);
         validateMeasurementProb(outcomeProb, __func__);
         densmatr_collapseToKnownProbOutcome(qureg, measureQubit, outcome, outcomeProb);
@@ -989,8 +1288,12 @@ qreal collapseToOutcome(Qureg qureg, int measureQubit, int outcome) {
 int measureWithStats(Qureg qureg, int measureQubit, qreal *outcomeProb) {
     validateTarget(qureg, measureQubit, __func__);
 
+    fusion_applyDeferred(qureg);
+    noise_applyReadoutNoise(qureg, measureQubit);
     int outcome;
-    if (qureg.isDensityMatrix)
+    if (qureg.isPackedDensityMatrix)
+        outcome = packed_measureWithStats(qureg, measureQubit, outcomeProb);
+    else if (qureg.isDensityMatrix)
         outcome = densmatr_measureWithStats(qureg, measureQubit, outcomeProb);
     else
         outcome = statevec_measureWithStats(qureg, measureQubit, outcomeProb);
@@ -1002,9 +1305,13 @@ int measureWithStats(Qureg qureg, int measureQubit, qreal *outcomeProb) {
 int measure(Qureg qureg, int measureQubit) {
     validateTarget(qureg, measureQubit, __func__);
     
+    fusion_applyDeferred(qureg);
+    noise_applyReadoutNoise(qureg, measureQubit);
     int outcome;
     qreal discardedProb;
-    if (qureg.isDensityMatrix)
+    if (qureg.isPackedDensityMatrix)
+        outcome = packed_measureWithStats(qureg, measureQubit, &discardedProb);
+    else if (qureg.isDensityMatrix)
         outcome = densmatr_measureWithStats(qureg, measureQubit, &discardedProb);
     else
         outcome = statevec_measureWithStats(qureg, measureQubit, &discardedProb);
@@ -1013,12 +1320,58 @@ int measure(Qureg qureg, int measureQubit) {
     return outcome;
 }
 
+qreal collapseToMultiOutcome(Qureg qureg, int* qubits, int numQubits, long long int outcome) {
+    validateUnpackedQureg(qureg, __func__);
+    validateMultiTargets(qureg, qubits, numQubits, __func__);
+    validateMultiQubitOutcome(outcome, numQubits, __func__);
+    
+    fusion_applyDeferred(qureg);
+    qreal* outcomeProbs = malloc((1LL << numQubits) * sizeof *outcomeProbs);
+    if (qureg.isDensityMatrix)
+        densmatr_calcProbOfAllOutcomes(outcomeProbs, qureg, qubits, numQubits);
+    else
+        statevec_calcProbOfAllOutcomes(outcomeProbs, qureg, qubits, numQubits);
+    qreal outcomeProb = outcomeProbs[outcome];
+    free(outcomeProbs);
+    
+    validateMeasurementProb(outcomeProb, __func__);
+    if (qureg.isDensityMatrix)
+        densmatr_collapseToKnownProbMultiOutcome(qureg, qubits, numQubits, outcome, outcomeProb);
+    else
+        statevec_collapseToKnownProbMultiOutcome(qureg, qubits, numQubits, outcome, outcomeProb);
+    
+    for (int q=0; q<numQubits; q++)
+        qasm_recordMeasurement(qureg, qubits[q]);
+    return outcomeProb;
+}
+
+long long int measureMultiple(Qureg qureg, int* qubits, int numQubits) {
+    validateUnpackedQureg(qureg, __func__);
+    validateMultiTargets(qureg, qubits, numQubits, __func__);
+    
+    fusion_applyDeferred(qureg);
+    long long int outcome;
+    qreal discardedProb;
+    if (qureg.isDensityMatrix)
+        outcome = densmatr_measureMultipleWithStats(qureg, qubits, numQubits, &discardedProb);
+    else
+        outcome = statevec_measureMultipleWithStats(qureg, qubits, numQubits, &discardedProb);
+    
+    for (int q=0; q<numQubits; q++)
+        qasm_recordMeasurement(qureg, qubits[q]);
+    return outcome;
+}
+
 void mixDensityMatrix(Qureg combineQureg, qreal otherProb, Qureg otherQureg) {
+    validateUnpackedQureg(combineQureg, __func__);
+    validateUnpackedQureg(otherQureg, __func__);
     validateDensityMatrQureg(combineQureg, __func__);
     validateDensityMatrQureg(otherQureg, __func__);
     validateMatchingQuregDims(combineQureg, otherQureg, __func__);
     validateProb(otherProb, __func__);
     
+    fusion_applyDeferred(combineQureg);
+    fusion_applyDeferred(otherQureg);
     densmatr_mixDensityMatrix(combineQureg, otherProb, otherQureg);
 }
 
@@ -1026,12 +1379,16 @@ void setAmps(Qureg qureg, long long int startInd, qreal* reals, qreal* imags, lo
     validateStateVecQureg(qureg, __func__);
     validateNumAmps(qureg, startInd, numAmps, __func__);
     
+    fusion_applyDeferred(qureg);
     statevec_setAmps(qureg, startInd, reals, imags, numAmps);
     
     qasm_recordComment(qureg, "Here, some amplitudes in the statevector were manually edited.");
 }
 
 void setDensityAmps(Qureg qureg, qreal* reals, qreal* imags) {
+    validateUnpackedQureg(qureg, __func__);
+
+    fusion_applyDeferred(qureg);
     long long int numAmps = qureg.numAmpsTotal; 
     statevec_setAmps(qureg, 0, reals, imags, numAmps);
     
@@ -1039,43 +1396,59 @@ void setDensityAmps(Qureg qureg, qreal* reals, qreal* imags) {
 }
 
 void setWeightedQureg(Complex fac1, Qureg qureg1, Complex fac2, Qureg qureg2, Complex facOut, Qureg out) {
+    validateUnpackedQureg(qureg1, __func__);
+    validateUnpackedQureg(qureg2, __func__);
+    validateUnpackedQureg(out, __func__);
     validateMatchingQuregTypes(qureg1, qureg2, __func__);
     validateMatchingQuregTypes(qureg1, out, __func__);
     validateMatchingQuregDims(qureg1, qureg2,  __func__);
     validateMatchingQuregDims(qureg1, out, __func__);
 
+    fusion_applyDeferred(qureg1);
+    fusion_applyDeferred(qureg2);
+    fusion_applyDeferred(out);
     statevec_setWeightedQureg(fac1, qureg1, fac2, qureg2, facOut, out);
 
     qasm_recordComment(out, "Here, the register was modified to an undisclosed and possibly unphysical state (setWeightedQureg).");
 } 
 
 void applyPauliSum(Qureg inQureg, enum pauliOpType* allPauliCodes, qreal* termCoeffs, int numSumTerms, Qureg outQureg) {
+    validateUnpackedQureg(inQureg, __func__);
+    validateUnpackedQureg(outQureg, __func__);
     validateMatchingQuregTypes(inQureg, outQureg, __func__);
     validateMatchingQuregDims(inQureg, outQureg, __func__);
     validateNumPauliSumTerms(numSumTerms, __func__);
     validatePauliCodes(allPauliCodes, numSumTerms*inQureg.numQubitsRepresented, __func__);
     
+    fusion_applyDeferred(inQureg);
+    fusion_applyDeferred(outQureg);
     statevec_applyPauliSum(inQureg, allPauliCodes, termCoeffs, numSumTerms, outQureg);
     
     qasm_recordComment(outQureg, "Here, the register was modified to an undisclosed and possibly unphysical state (applyPauliSum).");
 }
 
 void applyPauliHamil(Qureg inQureg, PauliHamil hamil, Qureg outQureg) {
+    validateUnpackedQureg(inQureg, __func__);
+    validateUnpackedQureg(outQureg, __func__);
     validateMatchingQuregTypes(inQureg, outQureg, __func__);
     validateMatchingQuregDims(inQureg, outQureg, __func__);
     validatePauliHamil(hamil, __func__);
     validateMatchingQuregPauliHamilDims(inQureg, hamil, __func__);
     
+    fusion_applyDeferred(inQureg);
+    fusion_applyDeferred(outQureg);
     statevec_applyPauliSum(inQureg, hamil.pauliCodes, hamil.termCoeffs, hamil.numSumTerms, outQureg);
     
     qasm_recordComment(outQureg, "Here, the register was modified to an undisclosed and possibly unphysical state (applyPauliHamil).");
 }
 
 void applyTrotterCircuit(Qureg qureg, PauliHamil hamil, qreal time, int order, int reps) {
+    validateUnpackedQureg(qureg, __func__);
     validateTrotterParams(order, reps, __func__);
     validatePauliHamil(hamil, __func__);
     validateMatchingQuregPauliHamilDims(qureg, hamil, __func__);
     
+    fusion_applyDeferred(qureg);
     qasm_recordComment(qureg, 
         "Beginning of Trotter circuit (time %g, order %d, %d repetitions).",
         time, order, reps);
@@ -1086,8 +1459,10 @@ void applyTrotterCircuit(Qureg qureg, PauliHamil hamil, qreal time, int order, i
 }
 
 void applyMatrix2(Qureg qureg, int targetQubit, ComplexMatrix2 u) {
+    validateUnpackedQureg(qureg, __func__);
     validateTarget(qureg, targetQubit, __func__);
     
+    fusion_applyDeferred(qureg);
     // actually just left-multiplies any complex matrix
     statevec_unitary(qureg, targetQubit, u);
 
@@ -1095,9 +1470,11 @@ void applyMatrix2(Qureg qureg, int targetQubit, ComplexMatrix2 u) {
 }
 
 void applyMatrix4(Qureg qureg, int targetQubit1, int targetQubit2, ComplexMatrix4 u) {
+    validateUnpackedQureg(qureg, __func__);
     validateMultiTargets(qureg, (int []) {targetQubit1, targetQubit2}, 2, __func__);
     validateMultiQubitMatrixFitsInNode(qureg, 2, __func__);
     
+    fusion_applyDeferred(qureg);
     // actually just left-multiplies any complex matrix
     statevec_twoQubitUnitary(qureg, targetQubit1, targetQubit2, u);
 
@@ -1105,9 +1482,11 @@ void applyMatrix4(Qureg qureg, int targetQubit1, int targetQubit2, ComplexMatrix
 }
 
 void applyMatrixN(Qureg qureg, int* targs, int numTargs, ComplexMatrixN u) {
+    validateUnpackedQureg(qureg, __func__);
     validateMultiTargets(qureg, targs, numTargs, __func__);
     validateMultiQubitMatrix(qureg, u, numTargs, __func__);
     
+    fusion_applyDeferred(qureg);
     // actually just left-multiplies any complex matrix
     statevec_multiQubitUnitary(qureg, targs, numTargs, u);
     
@@ -1116,9 +1495,11 @@ void applyMatrixN(Qureg qureg, int* targs, int numTargs, ComplexMatrixN u) {
 }
 
 void applyMultiControlledMatrixN(Qureg qureg, int* ctrls, int numCtrls, int* targs, int numTargs, ComplexMatrixN u) {
+    validateUnpackedQureg(qureg, __func__);
     validateMultiControlsMultiTargets(qureg, ctrls, numCtrls, targs, numTargs, __func__);
     validateMultiQubitMatrix(qureg, u, numTargs, __func__);
     
+    fusion_applyDeferred(qureg);
     // actually just left-multiplies any complex matrix
     long long int ctrlMask = getQubitBitMask(ctrls, numCtrls);
     statevec_multiControlledMultiQubitUnitary(qureg, ctrlMask, targs, numTargs, u);
@@ -1129,8 +1510,10 @@ void applyMultiControlledMatrixN(Qureg qureg, int* ctrls, int numCtrls, int* tar
 }
 
 void applyDiagonalOp(Qureg qureg, DiagonalOp op) {
+    validateUnpackedQureg(qureg, __func__);
     validateDiagonalOp(qureg, op, __func__);
 
+    fusion_applyDeferred(qureg);
     if (qureg.isDensityMatrix)
         densmatr_applyDiagonalOp(qureg, op);
     else
@@ -1145,10 +1528,13 @@ void applyDiagonalOp(Qureg qureg, DiagonalOp op) {
  */
 
 qreal calcTotalProb(Qureg qureg) {
-    if (qureg.isDensityMatrix)  
-            return densmatr_calcTotalProb(qureg);
-        else
-            return statevec_calcTotalProb(qureg);
+    fusion_applyDeferred(qureg);
+    if (qureg.isPackedDensityMatrix)
+        return packed_calcTotalProb(qureg);
+    else if (qureg.isDensityMatrix)
+        return densmatr_calcTotalProb(qureg);
+    else
+        return statevec_calcTotalProb(qureg);
 }
 
 Complex calcInnerProduct(Qureg bra, Qureg ket) {
@@ -1156,14 +1542,20 @@ Complex calcInnerProduct(Qureg bra, Qureg ket) {
     validateStateVecQureg(ket, __func__);
     validateMatchingQuregDims(bra, ket,  __func__);
     
+    fusion_applyDeferred(bra);
+    fusion_applyDeferred(ket);
     return statevec_calcInnerProduct(bra, ket);
 }
 
 qreal calcDensityInnerProduct(Qureg rho1, Qureg rho2) {
+    validateUnpackedQureg(rho1, __func__);
+    validateUnpackedQureg(rho2, __func__);
     validateDensityMatrQureg(rho1, __func__);
     validateDensityMatrQureg(rho2, __func__);
     validateMatchingQuregDims(rho1, rho2, __func__);
     
+    fusion_applyDeferred(rho1);
+    fusion_applyDeferred(rho2);
     return densmatr_calcInnerProduct(rho1, rho2);
 }
 
@@ -1171,24 +1563,92 @@ qreal calcProbOfOutcome(Qureg qureg, int measureQubit, int outcome) {
     validateTarget(qureg, measureQubit, __func__);
     validateOutcome(outcome, __func__);
     
-    if (qureg.isDensityMatrix)
+    fusion_applyDeferred(qureg);
+    if (qureg.isPackedDensityMatrix)
+        return packed_calcProbOfOutcome(qureg, measureQubit, outcome);
+    else if (qureg.isDensityMatrix)
         return densmatr_calcProbOfOutcome(qureg, measureQubit, outcome);
     else
         return statevec_calcProbOfOutcome(qureg, measureQubit, outcome);
 }
 
 void calcProbOfAllOutcomes(qreal* retProbs, Qureg qureg, int* qubits, int numQubits) {
+    validateUnpackedQureg(qureg, __func__);
     validateMultiTargets(qureg, qubits, numQubits, __func__);
 
+    fusion_applyDeferred(qureg);
     if (qureg.isDensityMatrix)
         densmatr_calcProbOfAllOutcomes(retProbs, qureg, qubits, numQubits);
     else
         statevec_calcProbOfAllOutcomes(retProbs, qureg, qubits, numQubits);
 }
 
+void sampleOutcomes(Qureg qureg, int* qubits, int numQubits, int numShots, long long int* outcomes) {
+    validateUnpackedQureg(qureg, __func__);
+    validateMultiTargets(qureg, qubits, numQubits, __func__);
+    validateNumShots(numShots, __func__);
+
+    fusion_applyDeferred(qureg);
+    if (qureg.isDensityMatrix)
+        densmatr_sampleOutcomes(qureg, qubits, numQubits, numShots, outcomes);
+    else
+        statevec_sampleOutcomes(qureg, qubits, numQubits, numShots, outcomes);
+}
+
+void calcTopKOutcomes(Qureg qureg, int k, long long int* inds, qreal* probs) {
+    validateUnpackedQureg(qureg, __func__);
+    validateNumTopOutcomes(qureg, k, __func__);
+    
+    fusion_applyDeferred(qureg);
+    if (qureg.isDensityMatrix)
+        densmatr_calcTopKOutcomes(qureg, k, inds, probs);
+    else
+        statevec_calcTopKOutcomes(qureg, k, inds, probs);
+}
+
+void calcAllQubitMarginals(Qureg qureg, qreal* probs) {
+    validateUnpackedQureg(qureg, __func__);
+    
+    fusion_applyDeferred(qureg);
+    int numQubits = qureg.numQubitsRepresented;
+    qreal* sums = malloc((1 + numQubits) * sizeof *sums);
+    if (qureg.isDensityMatrix)
+        densmatr_calcQubitCorrelationSums(qureg, sums, 0);
+    else
+        statevec_calcQubitCorrelationSums(qureg, sums, 0);
+    
+    for (int q=0; q<numQubits; q++)
+        probs[q] = sums[1+q];
+    free(sums);
+}
+
+void calcZZCorrelationMatrix(Qureg qureg, qreal* correlations) {
+    validateUnpackedQureg(qureg, __func__);
+    
+    fusion_applyDeferred(qureg);
+    int numQubits = qureg.numQubitsRepresented;
+    qreal* sums = malloc((1 + numQubits + numQubits*numQubits) * sizeof *sums);
+    if (qureg.isDensityMatrix)
+        densmatr_calcQubitCorrelationSums(qureg, sums, 1);
+    else
+        statevec_calcQubitCorrelationSums(qureg, sums, 1);
+    
+    // <Z_i Z_j> = P(both 0) + P(both 1) - P(differ) = total - 2 P(i=1) - 2 P(j=1) + 4 P(i=j=1)
+    qreal total = sums[0];
+    qreal* pairSums = &sums[1+numQubits];
+    for (int i=0; i<numQubits; i++)
+        for (int j=0; j<numQubits; j++)
+            correlations[i*numQubits + j] = (
+                total - 2*sums[1+i] - 2*sums[1+j] + 4*pairSums[i*numQubits + j]);
+    free(sums);
+}
+
 qreal calcPurity(Qureg qureg) {
     validateDensityMatrQureg(qureg, __func__);
     
+    fusion_applyDeferred(qureg);
+    if (qureg.isPackedDensityMatrix)
+        return packed_calcPurity(qureg);
     return densmatr_calcPurity(qureg);
 }
 
@@ -1196,7 +1656,11 @@ qreal calcFidelity(Qureg qureg, Qureg pureState) {
     validateSecondQuregStateVec(pureState, __func__);
     validateMatchingQuregDims(qureg, pureState, __func__);
     
-    if (qureg.isDensityMatrix)
+    fusion_applyDeferred(qureg);
+    fusion_applyDeferred(pureState);
+    if (qureg.isPackedDensityMatrix)
+        return packed_calcFidelity(qureg, pureState);
+    else if (qureg.isDensityMatrix)
         return densmatr_calcFidelity(qureg, pureState);
     else
         return statevec_calcFidelity(qureg, pureState);
@@ -1208,7 +1672,8 @@ qreal calcExpecPauliProd(Qureg qureg, int* targetQubits, enum pauliOpType* pauli
     validateMatchingQuregTypes(qureg, workspace, __func__);
     validateMatchingQuregDims(qureg, workspace, __func__);
     
-    return statevec_calcExpecPauliProd(qureg, targetQubits, pauliCodes, numTargets, workspace);
+    fusion_applyDeferred(qureg);
+    return statevec_calcExpecPauliProd(qureg, targetQubits, pauliCodes, numTargets);
 }
 
 qreal calcExpecPauliSum(Qureg qureg, enum pauliOpType* allPauliCodes, qreal* termCoeffs, int numSumTerms, Qureg workspace) {
@@ -1217,7 +1682,16 @@ qreal calcExpecPauliSum(Qureg qureg, enum pauliOpType* allPauliCodes, qreal* ter
     validateMatchingQuregTypes(qureg, workspace, __func__);
     validateMatchingQuregDims(qureg, workspace, __func__);
     
-    return statevec_calcExpecPauliSum(qureg, allPauliCodes, termCoeffs, numSumTerms, workspace);
+    fusion_applyDeferred(qureg);
+    return statevec_calcExpecPauliSum(qureg, allPauliCodes, termCoeffs, numSumTerms);
+}
+
+void calcExpecPauliStrings(Qureg qureg, enum pauliOpType* allPauliCodes, int numStrings, qreal* expecs) {
+    validateNumPauliSumTerms(numStrings, __func__);
+    validatePauliCodes(allPauliCodes, numStrings*qureg.numQubitsRepresented, __func__);
+    
+    fusion_applyDeferred(qureg);
+    agnostic_calcExpecPauliStrings(qureg, allPauliCodes, numStrings, expecs);
 }
 
 qreal calcExpecPauliHamil(Qureg qureg, PauliHamil hamil, Qureg workspace) {
@@ -1226,12 +1700,15 @@ qreal calcExpecPauliHamil(Qureg qureg, PauliHamil hamil, Qureg workspace) {
     validatePauliHamil(hamil, __func__);
     validateMatchingQuregPauliHamilDims(qureg, hamil, __func__);
     
-    return statevec_calcExpecPauliSum(qureg, hamil.pauliCodes, hamil.termCoeffs, hamil.numSumTerms, workspace);
+    fusion_applyDeferred(qureg);
+    return agnostic_calcExpecPauliHamil(qureg, hamil);
 }
 
 Complex calcExpecDiagonalOp(Qureg qureg, DiagonalOp op) {
+    validateUnpackedQureg(qureg, __func__);
     validateDiagonalOp(qureg, op, __func__);
     
+    fusion_applyDeferred(qureg);
     if (qureg.isDensityMatrix)
         return densmatr_calcExpecDiagonalOp(qureg, op);
     else
@@ -1239,10 +1716,14 @@ Complex calcExpecDiagonalOp(Qureg qureg, DiagonalOp op) {
 }
 
 qreal calcHilbertSchmidtDistance(Qureg a, Qureg b) {
+    validateUnpackedQureg(a, __func__);
+    validateUnpackedQureg(b, __func__);
     validateDensityMatrQureg(a, __func__);
     validateDensityMatrQureg(b, __func__);
     validateMatchingQuregDims(a, b, __func__);
     
+    fusion_applyDeferred(a);
+    fusion_applyDeferred(b);
     return densmatr_calcHilbertSchmidtDistance(a, b);
 }
 
@@ -1256,7 +1737,11 @@ void mixDephasing(Qureg qureg, int targetQubit, qreal prob) {
     validateTarget(qureg, targetQubit, __func__);
     validateOneQubitDephaseProb(prob, __func__);
     
-    densmatr_mixDephasing(qureg, targetQubit, 2*prob);
+    fusion_applyDeferred(qureg);
+    if (qureg.isPackedDensityMatrix)
+        packed_mixDephasing(qureg, targetQubit, prob);
+    else
+        densmatr_mixDephasing(qureg, targetQubit, 2*prob);
     qasm_recordComment(qureg, 
         "Here, a phase (Z) error occured on qubit %d with probability %g", targetQubit, prob);
 }
@@ -1266,8 +1751,12 @@ void mixTwoQubitDephasing(Qureg qureg, int qubit1, int qubit2, qreal prob) {
     validateUniqueTargets(qureg, qubit1, qubit2, __func__);
     validateTwoQubitDephaseProb(prob, __func__);
 
+    fusion_applyDeferred(qureg);
     ensureIndsIncrease(&qubit1, &qubit2);
-    densmatr_mixTwoQubitDephasing(qureg, qubit1, qubit2, (4*prob)/3.0);
+    if (qureg.isPackedDensityMatrix)
+        packed_mixTwoQubitDephasing(qureg, qubit1, qubit2, prob);
+    else
+        densmatr_mixTwoQubitDephasing(qureg, qubit1, qubit2, (4*prob)/3.0);
     qasm_recordComment(qureg,
         "Here, a phase (Z) error occured on either or both of qubits "
         "%d and %d with total probability %g", qubit1, qubit2, prob);
@@ -1278,7 +1767,11 @@ void mixDepolarising(Qureg qureg, int targetQubit, qreal prob) {
     validateTarget(qureg, targetQubit, __func__);
     validateOneQubitDepolProb(prob, __func__);
     
-    densmatr_mixDepolarising(qureg, targetQubit, (4*prob)/3.0);
+    fusion_applyDeferred(qureg);
+    if (qureg.isPackedDensityMatrix)
+        packed_mixDepolarising(qureg, targetQubit, prob);
+    else
+        densmatr_mixDepolarising(qureg, targetQubit, (4*prob)/3.0);
     qasm_recordComment(qureg,
         "Here, a homogeneous depolarising error (X, Y, or Z) occured on "
         "qubit %d with total probability %g", targetQubit, prob);
@@ -1289,7 +1782,11 @@ void mixDamping(Qureg qureg, int targetQubit, qreal prob) {
     validateTarget(qureg, targetQubit, __func__);
     validateOneQubitDampingProb(prob, __func__);
     
-    densmatr_mixDamping(qureg, targetQubit, prob);
+    fusion_applyDeferred(qureg);
+    if (qureg.isPackedDensityMatrix)
+        packed_mixDamping(qureg, targetQubit, prob);
+    else
+        densmatr_mixDamping(qureg, targetQubit, prob);
 }
 
 void mixTwoQubitDepolarising(Qureg qureg, int qubit1, int qubit2, qreal prob) {
@@ -1297,8 +1794,12 @@ void mixTwoQubitDepolarising(Qureg qureg, int qubit1, int qubit2, qreal prob) {
     validateUniqueTargets(qureg, qubit1, qubit2, __func__);
     validateTwoQubitDepolProb(prob, __func__);
     
+    fusion_applyDeferred(qureg);
     ensureIndsIncrease(&qubit1, &qubit2);
-    densmatr_mixTwoQubitDepolarising(qureg, qubit1, qubit2, (16*prob)/15.0);
+    if (qureg.isPackedDensityMatrix)
+        packed_mixTwoQubitDepolarising(qureg, qubit1, qubit2, prob);
+    else
+        densmatr_mixTwoQubitDepolarising(qureg, qubit1, qubit2, (16*prob)/15.0);
     qasm_recordComment(qureg,
         "Here, a homogeneous depolarising error occured on qubits %d and %d "
         "with total probability %g", qubit1, qubit2, prob);
@@ -1309,17 +1810,29 @@ void mixPauli(Qureg qureg, int qubit, qreal probX, qreal probY, qreal probZ) {
     validateTarget(qureg, qubit, __func__);
     validateOneQubitPauliProbs(probX, probY, probZ, __func__);
     
+    fusion_applyDeferred(qureg);
     densmatr_mixPauli(qureg, qubit, probX, probY, probZ);
     qasm_recordComment(qureg,
         "Here, X, Y and Z errors occured on qubit %d with probabilities "
         "%g, %g and %g respectively", qubit, probX, probY, probZ);
 }
 
+void mixNoiseLayer(Qureg qureg, NoiseChannel* channels) {
+    validateDensityMatrQureg(qureg, __func__);
+    validateNoiseLayer(qureg, channels, __func__);
+    
+    fusion_applyDeferred(qureg);
+    densmatr_mixNoiseLayer(qureg, channels);
+    qasm_recordComment(qureg,
+        "Here, a layer of independent single-qubit noise channels occured on every qubit");
+}
+
 void mixKrausMap(Qureg qureg, int target, ComplexMatrix2 *ops, int numOps) {
     validateDensityMatrQureg(qureg, __func__);
     validateTarget(qureg, target, __func__);
     validateOneQubitKrausMap(qureg, ops, numOps, __func__);
     
+    fusion_applyDeferred(qureg);
     densmatr_mixKrausMap(qureg, target, ops, numOps);
     qasm_recordComment(qureg, 
         "Here, an undisclosed Kraus map was effected on qubit %d", target);
@@ -1330,21 +1843,35 @@ void mixTwoQubitKrausMap(Qureg qureg, int target1, int target2, ComplexMatrix4 *
     validateMultiTargets(qureg, (int[]) {target1,target2}, 2, __func__);
     validateTwoQubitKrausMap(qureg, ops, numOps, __func__);
     
+    fusion_applyDeferred(qureg);
     densmatr_mixTwoQubitKrausMap(qureg, target1, target2, ops, numOps);
     qasm_recordComment(qureg, 
         "Here, an undisclosed two-qubit Kraus map was effected on qubits %d and %d", target1, target2);
 }
 
 void mixMultiQubitKrausMap(Qureg qureg, int* targets, int numTargets, ComplexMatrixN* ops, int numOps) {
+    validateUnpackedQureg(qureg, __func__);
     validateDensityMatrQureg(qureg, __func__);
     validateMultiTargets(qureg, targets, numTargets, __func__);
     validateMultiQubitKrausMap(qureg, numTargets, ops, numOps, __func__);
     
+    fusion_applyDeferred(qureg);
     densmatr_mixMultiQubitKrausMap(qureg, targets, numTargets, ops, numOps);
     qasm_recordComment(qureg,
         "Here, an undisclosed %d-qubit Kraus map was applied to undisclosed qubits", numTargets);
 }
 
+void attachNoiseModel(Qureg qureg, NoiseModel model) {
+    validateNoiseModelAttachment(qureg, model, __func__);
+    
+    noise_attach(qureg, model);
+}
+
+void detachNoiseModel(Qureg qureg) {
+    
+    noise_detach(qureg);
+}
+
 /*
  * other data structures 
  */
@@ -1570,20 +2097,97 @@ DiagonalOp createDiagonalOpFromPauliHamilFile(char* fn, QuESTEnv env) {
     return op;
 }
 
+NoiseModel createNoiseModel(int numQubits) {
+    validateNumQubitsInNoiseModel(numQubits, __func__);
+    
+    int numSlots = NUM_NOISY_GATE_TYPES * numQubits;
+    NoiseModel model;
+    model.numQubits = numQubits;
+    model.channels = malloc(numSlots * sizeof *model.channels);
+    model.numKrausOps = malloc(numSlots * sizeof *model.numKrausOps);
+    model.krausOps = malloc(numSlots * sizeof *model.krausOps);
+    model.readoutErrorProbs = malloc(numQubits * sizeof *model.readoutErrorProbs);
+    
+    // initialise to a noiseless model
+    for (int i=0; i<numSlots; i++) {
+        model.channels[i] = (NoiseChannel) {.type=NO_NOISE};
+        model.numKrausOps[i] = 0;
+        model.krausOps[i] = NULL;
+    }
+    for (int q=0; q<numQubits; q++)
+        model.readoutErrorProbs[q] = 0;
+    
+    return model;
+}
+
+void destroyNoiseModel(NoiseModel model) {
+    
+    for (int i=0; i<NUM_NOISY_GATE_TYPES * model.numQubits; i++)
+        free(model.krausOps[i]);
+    
+    free(model.channels);
+    free(model.numKrausOps);
+    free(model.krausOps);
+    free(model.readoutErrorProbs);
+}
+
+void setGateNoise(NoiseModel model, enum noisyGateType gateType, int qubit, NoiseChannel channel) {
+    validateNoisyGateType(gateType, __func__);
+    validateNoiseModelQubit(model, qubit, __func__);
+    validateNoiseChannel(channel, __func__);
+    
+    int slot = gateType * model.numQubits + qubit;
+    free(model.krausOps[slot]);
+    model.krausOps[slot] = NULL;
+    model.numKrausOps[slot] = 0;
+    model.channels[slot] = channel;
+}
+
+void setGateKrausNoise(NoiseModel model, enum noisyGateType gateType, int qubit, ComplexMatrix2* ops, int numOps) {
+    validateNoisyGateType(gateType, __func__);
+    validateNoiseModelQubit(model, qubit, __func__);
+    validateNoiseModelKrausMap(ops, numOps, __func__);
+    
+    int slot = gateType * model.numQubits + qubit;
+    free(model.krausOps[slot]);
+    model.krausOps[slot] = malloc(numOps * sizeof *ops);
+    for (int n=0; n<numOps; n++)
+        model.krausOps[slot][n] = ops[n];
+    model.numKrausOps[slot] = numOps;
+    model.channels[slot] = (NoiseChannel) {.type=NO_NOISE};
+}
+
+void setReadoutNoise(NoiseModel model, int qubit, qreal prob) {
+    validateNoiseModelQubit(model, qubit, __func__);
+    validateReadoutErrorProb(prob, __func__);
+    
+    model.readoutErrorProbs[qubit] = prob;
+}
+
 /*
  * debug
  */
 
 int compareStates(Qureg qureg1, Qureg qureg2, qreal precision) {
+    validateUnpackedQureg(qureg1, __func__);
+    validateUnpackedQureg(qureg2, __func__);
     validateMatchingQuregDims(qureg1, qureg2, __func__);
+    fusion_applyDeferred(qureg1);
+    fusion_applyDeferred(qureg2);
     return statevec_compareStates(qureg1, qureg2, precision);
 }
 
 void initDebugState(Qureg qureg) {
+    validateUnpackedQureg(qureg, __func__);
+
+    fusion_applyDeferred(qureg);
     statevec_initDebugState(qureg);
 }
 
 void initStateFromSingleFile(Qureg *qureg, char filename[200], QuESTEnv env) {
+    validateUnpackedQureg(*qureg, __func__);
+
+    fusion_applyDeferred(*qureg);
     int success = statevec_initStateFromSingleFile(qureg, filename, env);
     validateFileOpened(success, filename, __func__);
 }
@@ -1592,10 +2196,14 @@ void initStateOfSingleQubit(Qureg *qureg, int qubitId, int outcome) {
     validateStateVecQureg(*qureg, __func__);
     validateTarget(*qureg, qubitId, __func__);
     validateOutcome(outcome, __func__);
+    fusion_applyDeferred(*qureg);
     statevec_initStateOfSingleQubit(qureg, qubitId, outcome);
 }
 
 void reportStateToScreen(Qureg qureg, QuESTEnv env, int reportRank)  {
+    validateUnpackedQureg(qureg, __func__);
+
+    fusion_applyDeferred(qureg);
     statevec_reportStateToScreen(qureg, env, reportRank);
 }
 
@@ -1627,6 +2235,10 @@ void getQuESTSeeds(QuESTEnv env, unsigned long int** seeds, int* numSeeds) {
     *seeds = env.seeds;
     *numSeeds = env.numSeeds;
 }
+
+void seedQuregRNG(Qureg qureg, unsigned long int seed) {
+    rng_seed(qureg, seed);
+}
   
 
 #ifdef __cplusplus
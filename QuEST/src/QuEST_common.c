@@ -20,6 +20,8 @@
 # include "QuEST_precision.h"
 # include "QuEST_validation.h"
 # include "QuEST_qasm.h"
+# include "QuEST_rng.h"
+# include "QuEST_packed.h"
 # include "mt19937ar.h"
 
 #if defined(_WIN32) && ! defined(__MINGW32__)
@@ -34,6 +36,7 @@
 # include <sys/types.h> 
 # include <stdio.h>
 # include <stdlib.h>
+# include <string.h>
 
 
 // expose PI on GPU build
@@ -126,6 +129,17 @@ void getComplexPairFromRotation(qreal angle, Vector axis, Complex* alpha, Comple
     beta->imag  = - sin(angle/2.0)*unitAxis.x;
 }
 
+ComplexMatrix2 getMatrixFromComplexPair(Complex alpha, Complex beta) {
+
+    // U(alpha, beta) = {{alpha, -conj(beta)}, {beta, conj(alpha)}}
+    ComplexMatrix2 u;
+    u.real[0][0] =   alpha.real; u.imag[0][0] =   alpha.imag;
+    u.real[0][1] = - beta.real;  u.imag[0][1] =   beta.imag;
+    u.real[1][0] =   beta.real;  u.imag[1][0] =   beta.imag;
+    u.real[1][1] =   alpha.real; u.imag[1][1] = - alpha.imag;
+    return u;
+}
+
 /** maps U(alpha, beta) to Rz(rz2) Ry(ry) Rz(rz1) */
 void getZYZRotAnglesFromComplexPair(Complex alpha, Complex beta, qreal* rz2, qreal* ry, qreal* rz1) {
     
@@ -165,7 +179,7 @@ void shiftSubregIndices(int* allInds, int* numIndsPerReg, int numRegs, int shift
             allInds[i++] += shift;
 }
 
-int generateMeasurementOutcome(qreal zeroProb, qreal *outcomeProb) {
+int generateMeasurementOutcome(Qureg qureg, qreal zeroProb, qreal *outcomeProb) {
     
     // randomly choose outcome
     int outcome;
@@ -174,7 +188,7 @@ int generateMeasurementOutcome(qreal zeroProb, qreal *outcomeProb) {
     else if (1-zeroProb < REAL_EPS) 
         outcome = 0;
     else
-        outcome = (genrand_real1() > zeroProb);
+        outcome = (rng_drawUniform(qureg) > zeroProb);
     
     // set probability of outcome
     *outcomeProb = (outcome==0)? zeroProb : 1-zeroProb;
@@ -182,6 +196,127 @@ int generateMeasurementOutcome(qreal zeroProb, qreal *outcomeProb) {
     return outcome;
 }
 
+/** Randomly chooses an outcome of multiple qubits, given the probabilities of all 
+ * 2^numQubits outcomes, and sets outcomeProb to its probability. Outcomes with a 
+ * near-zero probability are never chosen.
+ */
+static long long int generateMultiMeasurementOutcome(Qureg qureg, qreal* outcomeProbs, int numQubits, qreal *outcomeProb) {
+    
+    long long int numOutcomes = 1LL << numQubits;
+    long long int outcome;
+    
+    // the total (non-negligible) probability, which may differ from 1 through finite precision
+    qreal total = 0;
+    long long int lastOutcome = 0;
+    for (outcome=0; outcome<numOutcomes; outcome++) {
+        if (outcomeProbs[outcome] >= REAL_EPS) {
+            total += outcomeProbs[outcome];
+            lastOutcome = outcome;
+        }
+    }
+    
+    // randomly choose outcome
+    qreal prob = total * rng_drawUniform(qureg);
+    qreal cumProb = 0;
+    for (outcome=0; outcome<lastOutcome; outcome++) {
+        if (outcomeProbs[outcome] < REAL_EPS)
+            continue;
+        cumProb += outcomeProbs[outcome];
+        if (cumProb > prob)
+            break;
+    }
+    
+    // set probability of outcome
+    *outcomeProb = outcomeProbs[outcome];
+    
+    return outcome;
+}
+
+/** Whether outcome ind1 (with probability prob1) ranks below ind2, i.e. is less probable, or 
+ * is equally probable but has a greater index, so that the most probable outcomes are unique 
+ */
+static int isLesserOutcome(long long int ind1, qreal prob1, long long int ind2, qreal prob2) {
+    
+    return (prob1 < prob2) || (prob1 == prob2 && ind1 > ind2);
+}
+
+/** Places outcome ind (with probability prob) into the vacant position pos of the min-heap of 
+ * heapSize outcomes, and sifts it down to restore the heap 
+ */
+static void siftDownTopOutcome(long long int* heapInds, qreal* heapProbs, int heapSize, int pos, long long int ind, qreal prob) {
+    
+    while (1) {
+        int child = 2*pos + 1;
+        if (child >= heapSize)
+            break;
+        if (child+1 < heapSize && isLesserOutcome(heapInds[child+1], heapProbs[child+1], heapInds[child], heapProbs[child]))
+            child++;
+        if (!isLesserOutcome(heapInds[child], heapProbs[child], ind, prob))
+            break;
+        heapInds[pos] = heapInds[child];
+        heapProbs[pos] = heapProbs[child];
+        pos = child;
+    }
+    heapInds[pos] = ind;
+    heapProbs[pos] = prob;
+}
+
+/** Offers outcome ind (with probability prob) to a min-heap of at most k outcomes, the root of 
+ * which is the lesser of those retained, such that the heap retains the k greatest outcomes offered
+ */
+void offerTopOutcome(long long int* heapInds, qreal* heapProbs, int* heapSize, int k, long long int ind, qreal prob) {
+    
+    // when full, replace the root, unless the outcome is lesser than it
+    if (*heapSize == k) {
+        if (isLesserOutcome(heapInds[0], heapProbs[0], ind, prob))
+            siftDownTopOutcome(heapInds, heapProbs, k, 0, ind, prob);
+        return;
+    }
+    
+    // otherwise sift the outcome up from the end of the heap
+    int pos = (*heapSize)++;
+    while (pos > 0) {
+        int parent = (pos-1)/2;
+        if (!isLesserOutcome(ind, prob, heapInds[parent], heapProbs[parent]))
+            break;
+        heapInds[pos] = heapInds[parent];
+        heapProbs[pos] = heapProbs[parent];
+        pos = parent;
+    }
+    heapInds[pos] = ind;
+    heapProbs[pos] = prob;
+}
+
+/** Sorts a min-heap (populated by offerTopOutcome()) in-place into decreasing rank */
+void sortTopOutcomes(long long int* heapInds, qreal* heapProbs, int heapSize) {
+    
+    // repeatedly swap the lesser outcome (the root) to the end of the shrinking heap
+    for (int size=heapSize; size>1; size--) {
+        long long int leastInd = heapInds[0];
+        qreal leastProb = heapProbs[0];
+        siftDownTopOutcome(heapInds, heapProbs, size-1, 0, heapInds[size-1], heapProbs[size-1]);
+        heapInds[size-1] = leastInd;
+        heapProbs[size-1] = leastProb;
+    }
+}
+
+/** Populates inds and probs with the k greatest of numCands candidate outcomes (ignoring those 
+ * with negative indices), in decreasing rank, padding with index -1 if there are fewer than k 
+ */
+void selectTopOutcomes(long long int* candInds, qreal* candProbs, long long int numCands, int k, long long int* inds, qreal* probs) {
+    
+    int heapSize = 0;
+    for (long long int c=0; c<numCands; c++)
+        if (candInds[c] >= 0)
+            offerTopOutcome(inds, probs, &heapSize, k, candInds[c], candProbs[c]);
+    
+    sortTopOutcomes(inds, probs, heapSize);
+    for (int i=heapSize; i<k; i++) {
+        inds[i] = -1;
+        probs[i] = 0;
+    }
+}
+
 unsigned long int hashString(char *str){
     unsigned long int hash = 5381;
     int c;
@@ -226,9 +361,9 @@ void reportState(Qureg qureg){
 
     for(index=0; index<qureg.numAmpsPerChunk; index++){
         # if QuEST_PREC==1 || QuEST_PREC==2
-        fprintf(state, "%.12f, %.12f\n", qureg.stateVec.real[index], qureg.stateVec.imag[index]);
+        fprintf(state, "%.12f, %.12f\n", qureg.stateVec.real[AMP_INDEX(index)], qureg.stateVec.imag[AMP_INDEX(index)]);
         # elif QuEST_PREC == 4
-        fprintf(state, "%.12Lf, %.12Lf\n", qureg.stateVec.real[index], qureg.stateVec.imag[index]);
+        fprintf(state, "%.12Lf, %.12Lf\n", qureg.stateVec.real[AMP_INDEX(index)], qureg.stateVec.imag[AMP_INDEX(index)]);
         #endif
     }
     fclose(state);
@@ -327,6 +462,93 @@ void statevec_rotateAroundAxisConj(Qureg qureg, int rotQubit, qreal angle, Vecto
     statevec_compactUnitary(qureg, rotQubit, alpha, beta);
 }
 
+void densmatr_multiControlledPhaseShift(Qureg qureg, long long int mask, qreal angle) {
+    Complex term; 
+    term.real = cos(angle); 
+    term.imag = sin(angle);
+    densmatr_multiControlledPhaseShiftByTerm(qureg, mask, term);
+}
+
+void densmatr_multiControlledPhaseFlip(Qureg qureg, long long int mask) {
+    Complex term; 
+    term.real = -1;
+    term.imag =  0;
+    densmatr_multiControlledPhaseShiftByTerm(qureg, mask, term);
+}
+
+void densmatr_sGate(Qureg qureg, int targetQubit) {
+    Complex term; 
+    term.real = 0;
+    term.imag = 1;
+    densmatr_multiControlledPhaseShiftByTerm(qureg, 1LL << targetQubit, term);
+}
+
+void densmatr_tGate(Qureg qureg, int targetQubit) {
+    Complex term; 
+    term.real = 1/sqrt(2);
+    term.imag = 1/sqrt(2);
+    densmatr_multiControlledPhaseShiftByTerm(qureg, 1LL << targetQubit, term);
+}
+
+void densmatr_hadamard(Qureg qureg, int targetQubit) {
+    
+    qreal fac = 1/sqrt(2);
+    ComplexMatrix2 u = {.real={{fac, fac}, {fac, -fac}}, .imag={{0}}};
+    densmatr_multiControlledUnitary(qureg, 0, 0, targetQubit, u);
+}
+
+void densmatr_compactUnitary(Qureg qureg, long long int ctrlMask, int targetQubit, Complex alpha, Complex beta) {
+    
+    densmatr_multiControlledUnitary(qureg, ctrlMask, 0, targetQubit, getMatrixFromComplexPair(alpha, beta));
+}
+
+void densmatr_rotateAroundAxis(Qureg qureg, long long int ctrlMask, int rotQubit, qreal angle, Vector axis) {
+    
+    Complex alpha, beta;
+    getComplexPairFromRotation(angle, axis, &alpha, &beta);
+    densmatr_compactUnitary(qureg, ctrlMask, rotQubit, alpha, beta);
+}
+
+/* The below effect permutation gates through the generic U rho U^dagger kernels, for density 
+ * matrices (namely packed ones) which cannot apply them as a pair of state-vector permutations
+ */
+
+void densmatr_multiControlledMultiQubitNot(Qureg qureg, long long int ctrlMask, long long int targMask) {
+    
+    ComplexMatrix2 u = {.real={{0, 1}, {1, 0}}, .imag={{0}}};
+    for (int t=0; t < qureg.numQubitsRepresented; t++)
+        if (targMask & (1LL << t))
+            densmatr_multiControlledUnitary(qureg, ctrlMask, 0, t, u);
+}
+
+void densmatr_multiControlledPauliY(Qureg qureg, long long int ctrlMask, int targetQubit) {
+    
+    ComplexMatrix2 u = {.real={{0}}, .imag={{0, -1}, {1, 0}}};
+    densmatr_multiControlledUnitary(qureg, ctrlMask, 0, targetQubit, u);
+}
+
+void densmatr_swapGate(Qureg qureg, int qb1, int qb2) {
+    
+    ComplexMatrix4 u = (ComplexMatrix4) {.real={{0}}, .imag={{0}}};
+    u.real[0][0]=1;
+    u.real[1][2]=1;
+    u.real[2][1]=1;
+    u.real[3][3]=1;
+    densmatr_multiControlledTwoQubitUnitary(qureg, 0, qb1, qb2, u);
+}
+
+void densmatr_sqrtSwapGate(Qureg qureg, int qb1, int qb2) {
+    
+    ComplexMatrix4 u = (ComplexMatrix4) {.real={{0}}, .imag={{0}}};
+    u.real[0][0]=1;
+    u.real[3][3]=1;
+    u.real[1][1] = .5; u.imag[1][1] = .5;
+    u.real[1][2] = .5; u.imag[1][2] =-.5;
+    u.real[2][1] = .5; u.imag[2][1] =-.5;
+    u.real[2][2] = .5; u.imag[2][2] = .5;
+    densmatr_multiControlledTwoQubitUnitary(qureg, 0, qb1, qb2, u);
+}
+
 void statevec_controlledRotateAroundAxis(Qureg qureg, int controlQubit, int targetQubit, qreal angle, Vector axis){
 
     Complex alpha, beta;
@@ -364,7 +586,7 @@ void statevec_controlledRotateZ(Qureg qureg, int controlQubit, int targetQubit,
 int statevec_measureWithStats(Qureg qureg, int measureQubit, qreal *outcomeProb) {
     
     qreal zeroProb = statevec_calcProbOfOutcome(qureg, measureQubit, 0);
-    int outcome = generateMeasurementOutcome(zeroProb, outcomeProb);
+    int outcome = generateMeasurementOutcome(qureg, zeroProb, outcomeProb);
     statevec_collapseToKnownProbOutcome(qureg, measureQubit, outcome, *outcomeProb);
     return outcome;
 }
@@ -372,11 +594,33 @@ int statevec_measureWithStats(Qureg qureg, int measureQubit, qreal *outcomeProb)
 int densmatr_measureWithStats(Qureg qureg, int measureQubit, qreal *outcomeProb) {
     
     qreal zeroProb = densmatr_calcProbOfOutcome(qureg, measureQubit, 0);
-    int outcome = generateMeasurementOutcome(zeroProb, outcomeProb);
+    int outcome = generateMeasurementOutcome(qureg, zeroProb, outcomeProb);
     densmatr_collapseToKnownProbOutcome(qureg, measureQubit, outcome, *outcomeProb);
     return outcome;
 }
 
+long long int statevec_measureMultipleWithStats(Qureg qureg, int* qubits, int numQubits, qreal *outcomeProb) {
+    
+    qreal* outcomeProbs = malloc((1LL << numQubits) * sizeof *outcomeProbs);
+    statevec_calcProbOfAllOutcomes(outcomeProbs, qureg, qubits, numQubits);
+    long long int outcome = generateMultiMeasurementOutcome(qureg, outcomeProbs, numQubits, outcomeProb);
+    free(outcomeProbs);
+    
+    statevec_collapseToKnownProbMultiOutcome(qureg, qubits, numQubits, outcome, *outcomeProb);
+    return outcome;
+}
+
+long long int densmatr_measureMultipleWithStats(Qureg qureg, int* qubits, int numQubits, qreal *outcomeProb) {
+    
+    qreal* outcomeProbs = malloc((1LL << numQubits) * sizeof *outcomeProbs);
+    densmatr_calcProbOfAllOutcomes(outcomeProbs, qureg, qubits, numQubits);
+    long long int outcome = generateMultiMeasurementOutcome(qureg, outcomeProbs, numQubits, outcomeProb);
+    free(outcomeProbs);
+    
+    densmatr_collapseToKnownProbMultiOutcome(qureg, qubits, numQubits, outcome, *outcomeProb);
+    return outcome;
+}
+
 qreal statevec_calcFidelity(Qureg qureg, Qureg pureState) {
     
     Complex innerProd = statevec_calcInnerProduct(qureg, pureState);
@@ -410,152 +654,310 @@ void statevec_sqrtSwapGateConj(Qureg qureg, int qb1, int qb2) {
     statevec_twoQubitUnitary(qureg, qb1, qb2, u);
 }
 
+/** Sets xMask to the qubits upon which the Pauli product acts as X or Y, and zMask to those 
+ * as Y or Z, such that it maps basis state |a> to (-i)^numY (-1)^|a & zMask| |a ^ xMask>
+ */
+static void getPauliProdMasks(int* targetQubits, enum pauliOpType* pauliCodes, int numTargets, long long int* xMask, long long int* zMask) {
+    
+    *xMask = 0;
+    *zMask = 0;
+    for (int i=0; i < numTargets; i++) {
+        if (pauliCodes[i] == PAULI_X || pauliCodes[i] == PAULI_Y)
+            *xMask |= 1LL << targetQubits[i];
+        if (pauliCodes[i] == PAULI_Y || pauliCodes[i] == PAULI_Z)
+            *zMask |= 1LL << targetQubits[i];
+    }
+}
+
+/** Returns the factor c for which exp(-i angle/2 P) (or its conjugate, if applyConj) maps 
+ * amplitude psi_a to cos(angle/2) psi_a + c (-1)^|a & zMask| psi_{a ^ xMask}, where the Pauli 
+ * string P has X or Y upon the qubits of xMask, and Y or Z upon zMask. This is 
+ * c = -i sin(angle/2) (-i)^numY, since P|a ^ xMask> = (-i)^numY (-1)^|a & zMask| |a> 
+ */
+Complex getPauliRotationPairFactor(long long int xMask, long long int zMask, qreal angle, int applyConj) {
+    
+    int numY = 0;
+    for (long long int yMask = xMask & zMask; yMask; yMask &= yMask-1)
+        numY++;
+    
+    qreal sinAngle = sin(angle/2);
+    Complex fac;
+    switch (numY % 4) {
+        case 0: fac = (Complex) {.real = 0,         .imag = -sinAngle}; break;
+        case 1: fac = (Complex) {.real = -sinAngle, .imag = 0};         break;
+        case 2: fac = (Complex) {.real = 0,         .imag = sinAngle};  break;
+        default: fac = (Complex) {.real = sinAngle, .imag = 0};
+    }
+    return (applyConj)? getConjugateScalar(fac) : fac;
+}
+
 /** applyConj=1 will apply conjugate operation, else applyConj=0 */
 void statevec_multiRotatePauli(
     Qureg qureg, int* targetQubits, enum pauliOpType* targetPaulis, int numTargets, qreal angle,
     int applyConj
 ) {
-    qreal fac = 1/sqrt(2);
-    Complex uRxAlpha = {.real = fac, .imag = 0}; // Rx(pi/2)* rotates Z -> Y
-    Complex uRxBeta = {.real = 0, .imag = (applyConj)? fac : -fac};
-    Complex uRyAlpha = {.real = fac, .imag = 0}; // Ry(-pi/2) rotates Z -> X
-    Complex uRyBeta = {.real = -fac, .imag = 0};
-    
-    // mask may be modified to remove superfluous Identity ops
-    long long int mask = getQubitBitMask(targetQubits, numTargets);
-    
-    // rotate basis so that exp(Z) will effect exp(Y) and exp(X)
-    for (int t=0; t < numTargets; t++) {
-        if (targetPaulis[t] == PAULI_I)
-            mask -= 1LL << targetQubits[t]; // remove target from mask
-        if (targetPaulis[t] == PAULI_X)
-            statevec_compactUnitary(qureg, targetQubits[t], uRyAlpha, uRyBeta);
-        if (targetPaulis[t] == PAULI_Y)
-            statevec_compactUnitary(qureg, targetQubits[t], uRxAlpha, uRxBeta);
-        // (targetPaulis[t] == 3) is Z basis
-    }
+    // identity targets are excluded from both masks
+    long long int xMask, zMask;
+    getPauliProdMasks(targetQubits, targetPaulis, numTargets, &xMask, &zMask);
     
     // does nothing if there are no qubits to 'rotate'
-    if (mask != 0)
-        statevec_multiRotateZ(qureg, mask, (applyConj)? -angle : angle);
-    
-    // undo X and Y basis rotations
-    uRxBeta.imag *= -1;
-    uRyBeta.real *= -1;
-    for (int t=0; t < numTargets; t++) {
-        if (targetPaulis[t] == PAULI_X)
-            statevec_compactUnitary(qureg, targetQubits[t], uRyAlpha, uRyBeta);
-        if (targetPaulis[t] == PAULI_Y)
-            statevec_compactUnitary(qureg, targetQubits[t], uRxAlpha, uRxBeta);
-    }
+    if (xMask | zMask)
+        statevec_multiControlledMultiRotatePauliMasks(qureg, 0, xMask, zMask, angle, applyConj);
 }
 
 void statevec_multiControlledMultiRotatePauli(
     Qureg qureg, long long int ctrlMask, int* targetQubits, enum pauliOpType* targetPaulis, int numTargets, qreal angle,
     int applyConj
 ) {
-    qreal fac = 1/sqrt(2);
-    qreal sgn = (applyConj)? 1 : -1;
-    ComplexMatrix2 uRx = {.real={{fac,0},{0,fac}}, .imag={{0,sgn*fac},{sgn*fac,0}}}; // Rx(pi/2)* rotates Z -> Y
-    ComplexMatrix2 uRy = {.real={{fac,fac},{-fac,fac}}, .imag={{0,0},{0,0}}};        // Ry(-pi/2) rotates Z -> X
-    
-    // this function is controlled on the all-one state, so no ctrl flips
-    long long int ctrlFlipMask = 0;
+    long long int xMask, zMask;
+    getPauliProdMasks(targetQubits, targetPaulis, numTargets, &xMask, &zMask);
     
-    // mask may be modified to remove superfluous Identity ops
-    long long int targMask = getQubitBitMask(targetQubits, numTargets);
-    
-    // rotate basis so that exp(Z) will effect exp(Y) and exp(X)
-    for (int t=0; t < numTargets; t++) {
-        if (targetPaulis[t] == PAULI_I)
-            targMask -= 1LL << targetQubits[t]; // remove target from mask
-        if (targetPaulis[t] == PAULI_X)
-            statevec_multiControlledUnitary(qureg, ctrlMask, ctrlFlipMask, targetQubits[t], uRy);
-        if (targetPaulis[t] == PAULI_Y)
-            statevec_multiControlledUnitary(qureg, ctrlMask, ctrlFlipMask, targetQubits[t], uRx);
-        // (targetPaulis[t] == 3) is Z basis
-    }
-    
-    // does nothing if there are no qubits to 'rotate'
-    if (targMask != 0)
-        statevec_multiControlledMultiRotateZ(qureg, ctrlMask, targMask, (applyConj)? -angle : angle);
-        
-    // undo X and Y basis rotations
-    uRx.imag[0][1] *= -1; uRx.imag[1][0] *= -1;
-    uRy.real[0][1] *= -1; uRy.real[1][0] *= -1;
-    for (int t=0; t < numTargets; t++) {
-        if (targetPaulis[t] == PAULI_X)
-            statevec_multiControlledUnitary(qureg, ctrlMask, ctrlFlipMask, targetQubits[t], uRy);
-        if (targetPaulis[t] == PAULI_Y)
-            statevec_multiControlledUnitary(qureg, ctrlMask, ctrlFlipMask, targetQubits[t], uRx);
-    }
+    if (xMask | zMask)
+        statevec_multiControlledMultiRotatePauliMasks(qureg, ctrlMask, xMask, zMask, angle, applyConj);
 }
 
-/* produces both pauli|qureg> or pauli * qureg (as a density matrix) */
-void statevec_applyPauliProd(Qureg workspace, int* targetQubits, enum pauliOpType* pauliCodes, int numTargets) {
+/* <pauli> = <qureg|pauli|qureg> or Trace(pauli qureg), evaluated without modifying any state */
+static void calcExpecPauliMasks(Qureg qureg, long long int* xMasks, long long int* zMasks, int numStrings, qreal* expecs) {
     
-    for (int i=0; i < numTargets; i++) {
-        // (pauliCodes[i] == PAULI_I) applies no operation
-        if (pauliCodes[i] == PAULI_X)
-            statevec_pauliX(workspace, targetQubits[i]);
-        if (pauliCodes[i] == PAULI_Y)
-            statevec_pauliY(workspace, targetQubits[i]);
-        if (pauliCodes[i] == PAULI_Z)
-            statevec_pauliZ(workspace, targetQubits[i]);
-    }
+    if (qureg.isPackedDensityMatrix)
+        packed_calcExpecPauliStrings(qureg, xMasks, zMasks, numStrings, expecs);
+    else if (qureg.isDensityMatrix)
+        densmatr_calcExpecPauliStrings(qureg, xMasks, zMasks, numStrings, expecs);
+    else
+        statevec_calcExpecPauliStrings(qureg, xMasks, zMasks, numStrings, expecs);
 }
 
-// <pauli> = <qureg|pauli|qureg> = qureg . pauli(qureg)
-qreal statevec_calcExpecPauliProd(Qureg qureg, int* targetQubits, enum pauliOpType* pauliCodes, int numTargets, Qureg workspace) {
+qreal statevec_calcExpecPauliProd(Qureg qureg, int* targetQubits, enum pauliOpType* pauliCodes, int numTargets) {
     
-    statevec_cloneQureg(workspace, qureg);
-    statevec_applyPauliProd(workspace, targetQubits, pauliCodes, numTargets);
+    long long int xMask, zMask;
+    getPauliProdMasks(targetQubits, pauliCodes, numTargets, &xMask, &zMask);
     
-    // compute the expected value
     qreal value;
-    if (qureg.isDensityMatrix)
-        value = densmatr_calcTotalProb(workspace); // Trace(ops qureg)
-    else
-        value = statevec_calcInnerProduct(workspace, qureg).real; // <qureg|ops|qureg>
-                
+    calcExpecPauliMasks(qureg, &xMask, &zMask, 1, &value);
     return value;
 }
 
-qreal statevec_calcExpecPauliSum(Qureg qureg, enum pauliOpType* allCodes, qreal* termCoeffs, int numSumTerms, Qureg workspace) {
+void agnostic_calcExpecPauliStrings(Qureg qureg, enum pauliOpType* allCodes, int numStrings, qreal* expecs) {
     
     int numQb = qureg.numQubitsRepresented;
     int targs[100]; // [numQb];
     for (int q=0; q < numQb; q++)
         targs[q] = q;
-        
+    
+    // all strings are evaluated together, in a single pass over the state
+    long long int* xMasks = malloc(numStrings * sizeof *xMasks);
+    long long int* zMasks = malloc(numStrings * sizeof *zMasks);
+    for (int t=0; t < numStrings; t++)
+        getPauliProdMasks(targs, &allCodes[t*numQb], numQb, &xMasks[t], &zMasks[t]);
+    
+    calcExpecPauliMasks(qureg, xMasks, zMasks, numStrings, expecs);
+    free(xMasks);
+    free(zMasks);
+}
+
+qreal statevec_calcExpecPauliSum(Qureg qureg, enum pauliOpType* allCodes, qreal* termCoeffs, int numSumTerms) {
+    
+    qreal* expecs = malloc(numSumTerms * sizeof *expecs);
+    agnostic_calcExpecPauliStrings(qureg, allCodes, numSumTerms, expecs);
+    
     qreal value = 0;
     for (int t=0; t < numSumTerms; t++)
-        value += termCoeffs[t] * statevec_calcExpecPauliProd(qureg, targs, &allCodes[t*numQb], numQb, workspace);
+        value += termCoeffs[t] * expecs[t];
+    
+    free(expecs);
+    return value;
+}
+
+/** the maximum number of qubits spanned by the diagonal terms grouped by agnostic_calcExpecPauliHamil(), 
+ * bounding the memory of (and any reduction over) their outcome probabilities to 2^20 reals
+ */
+# define MAX_NUM_DIAGONAL_GROUP_QUBITS 20
+
+static int getBitMaskNumBits(long long int mask) {
+    
+    int numBits = 0;
+    for (; mask; mask &= mask-1)
+        numBits++;
+    return numBits;
+}
+
+/** Overwrites probs (of length 2^numBits) with its Walsh-Hadamard transform, so that 
+ * probs[m] becomes the sum of the original probs[o] weighted by (-1)^|o & m|
+ */
+static void applyWalshHadamardTransform(qreal* probs, int numBits) {
+    
+    long long int numProbs = 1LL << numBits;
+    for (long long int len=1; len < numProbs; len <<= 1)
+        for (long long int i=0; i < numProbs; i += 2*len)
+            for (long long int j=i; j < i+len; j++) {
+                qreal a = probs[j];
+                qreal b = probs[j+len];
+                probs[j] = a + b;
+                probs[j+len] = a - b;
+            }
+}
+
+/** The terms of hamil which act only as PAULI_I or PAULI_Z commute qubit-wise, and are grouped 
+ * (while their combined support spans at most MAX_NUM_DIAGONAL_GROUP_QUBITS qubits) to be evaluated 
+ * together from the probabilities of all outcomes of their s qubits, found in one pass and then 
+ * transformed in O(s 2^s) to yield every term's parity sum at once. All remaining terms are 
+ * evaluated by the batched single pass of agnostic_calcExpecPauliStrings(), as is every term 
+ * when fewer than two would be grouped. Neither approach modifies any state.
+ */
+qreal agnostic_calcExpecPauliHamil(Qureg qureg, PauliHamil hamil) {
+    
+    int numQb = hamil.numQubits;
+    int numTerms = hamil.numSumTerms;
+    int targs[100]; // [numQb];
+    for (int q=0; q < numQb; q++)
+        targs[q] = q;
+    
+    // assign each diagonal term to the group, while its support remains small
+    int* isGrouped = calloc(numTerms, sizeof *isGrouped);
+    long long int* zMasks = malloc(numTerms * sizeof *zMasks);
+    long long int groupMask = 0;
+    int numGrouped = 0;
+    for (int t=0; t < numTerms && !qureg.isPackedDensityMatrix; t++) {
+        long long int xMask;
+        getPauliProdMasks(targs, &hamil.pauliCodes[t*numQb], numQb, &xMask, &zMasks[t]);
+        if (xMask != 0 || getBitMaskNumBits(groupMask | zMasks[t]) > MAX_NUM_DIAGONAL_GROUP_QUBITS)
+            continue;
+        groupMask |= zMasks[t];
+        isGrouped[t] = 1;
+        numGrouped++;
+    }
+    if (numGrouped < 2 || groupMask == 0)
+        numGrouped = 0;
+    
+    qreal value = 0;
+    if (numGrouped > 0) {
+        int qubits[100]; // [numQb];
+        int numGroupQubits = 0;
+        for (int q=0; q < numQb; q++)
+            if ((groupMask >> q) & 1)
+                qubits[numGroupQubits++] = q;
+        
+        qreal* probs = malloc((1LL << numGroupQubits) * sizeof *probs);
+        if (qureg.isDensityMatrix)
+            densmatr_calcProbOfAllOutcomes(probs, qureg, qubits, numGroupQubits);
+        else
+            statevec_calcProbOfAllOutcomes(probs, qureg, qubits, numGroupQubits);
+        applyWalshHadamardTransform(probs, numGroupQubits);
         
+        // compress each term's support onto the group's qubits
+        for (int t=0; t < numTerms; t++) {
+            if (!isGrouped[t])
+                continue;
+            long long int mask = 0;
+            for (int k=0; k < numGroupQubits; k++)
+                if ((zMasks[t] >> qubits[k]) & 1)
+                    mask |= 1LL << k;
+            value += hamil.termCoeffs[t] * probs[mask];
+        }
+        free(probs);
+    }
+    
+    // the remaining terms are evaluated together in a single pass
+    int numRemaining = numTerms - numGrouped;
+    if (numRemaining > 0) {
+        enum pauliOpType* codes = malloc(numRemaining*numQb * sizeof *codes);
+        qreal* coeffs = malloc(numRemaining * sizeof *coeffs);
+        int i = 0;
+        for (int t=0; t < numTerms; t++) {
+            if (numGrouped > 0 && isGrouped[t])
+                continue;
+            memcpy(&codes[i*numQb], &hamil.pauliCodes[t*numQb], numQb * sizeof *codes);
+            coeffs[i++] = hamil.termCoeffs[t];
+        }
+        value += statevec_calcExpecPauliSum(qureg, codes, coeffs, numRemaining);
+        free(codes);
+        free(coeffs);
+    }
+    
+    free(isGrouped);
+    free(zMasks);
     return value;
 }
 
+/* a term index, ordered by ascending X mask, then ascending index */
+typedef struct {
+    long long int xMask;
+    int term;
+} MaskedTerm;
+
+static int compareMaskedTerms(const void* a, const void* b) {
+    
+    const MaskedTerm* termA = a;
+    const MaskedTerm* termB = b;
+    if (termA->xMask != termB->xMask)
+        return (termA->xMask < termB->xMask)? -1 : 1;
+    return termA->term - termB->term;
+}
+
+/** outQureg = sum_t termCoeffs[t] paulis_t(inQureg), where terms sharing an X mask form a group 
+ * acting as a single diagonal-times-permutation. The coefficient (-i)^numY termCoeffs[t] of 
+ * each term is found here once, so that the backend accumulates every group in a single 
+ * read-only gather pass over inQureg
+ */
 void statevec_applyPauliSum(Qureg inQureg, enum pauliOpType* allCodes, qreal* termCoeffs, int numSumTerms, Qureg outQureg) {
     
     int numQb = inQureg.numQubitsRepresented;
     int targs[100]; // [numQb];
     for (int q=0; q < numQb; q++)
         targs[q] = q;
-        
-    statevec_initBlankState(outQureg);
     
+    MaskedTerm* order = malloc(numSumTerms * sizeof *order);
+    long long int* zMasks = malloc(numSumTerms * sizeof *zMasks);
     for (int t=0; t < numSumTerms; t++) {
-        Complex coef = (Complex) {.real=termCoeffs[t], .imag=0};
-        Complex iden = (Complex) {.real=1, .imag=0};
-        Complex zero = (Complex) {.real=0, .imag=0};
+        getPauliProdMasks(targs, &allCodes[t*numQb], numQb, &order[t].xMask, &zMasks[t]);
+        order[t].term = t;
+    }
+    qsort(order, numSumTerms, sizeof *order, compareMaskedTerms);
+    
+    long long int* groupXMasks = malloc(numSumTerms * sizeof *groupXMasks);
+    int* groupStarts = malloc((numSumTerms + 1) * sizeof *groupStarts);
+    long long int* termZMasks = malloc(numSumTerms * sizeof *termZMasks);
+    qreal* termCoeffsRe = malloc(numSumTerms * sizeof *termCoeffsRe);
+    qreal* termCoeffsIm = malloc(numSumTerms * sizeof *termCoeffsIm);
+    int numGroups = 0;
+    
+    for (int i=0; i < numSumTerms; i++) {
+        long long int xMask = order[i].xMask;
+        long long int zMask = zMasks[order[i].term];
+        qreal coeff = termCoeffs[order[i].term];
         
-        // outQureg += coef paulis(inQureg)
-        statevec_applyPauliProd(inQureg, targs, &allCodes[t*numQb], numQb);
-        statevec_setWeightedQureg(coef, inQureg, iden, outQureg, zero, outQureg); 
+        if (i == 0 || xMask != groupXMasks[numGroups-1]) {
+            groupXMasks[numGroups] = xMask;
+            groupStarts[numGroups++] = i;
+        }
         
-        // undero paulis(inQureg), exploiting XX=YY=ZZ=I
-        statevec_applyPauliProd(inQureg, targs, &allCodes[t*numQb], numQb);
+        int numY = 0;
+        for (long long int yMask = xMask & zMask; yMask; yMask &= yMask-1)
+            numY++;
+        
+        // <a|P|a ^ xMask> = (-i)^numY (-1)^|a & zMask|
+        termZMasks[i] = zMask;
+        switch (numY % 4) {
+            case 0: termCoeffsRe[i] =  coeff; termCoeffsIm[i] = 0;      break;
+            case 1: termCoeffsRe[i] = 0;      termCoeffsIm[i] = -coeff; break;
+            case 2: termCoeffsRe[i] = -coeff; termCoeffsIm[i] = 0;      break;
+            default: termCoeffsRe[i] = 0;     termCoeffsIm[i] = coeff;
+        }
     }
+    groupStarts[numGroups] = numSumTerms;
+    
+    statevec_initBlankState(outQureg);
+    statevec_applyPauliMaskGroups(
+        inQureg, groupXMasks, groupStarts, numGroups, 
+        termZMasks, termCoeffsRe, termCoeffsIm, outQureg);
+    
+    free(order);
+    free(zMasks);
+    free(groupXMasks);
+    free(groupStarts);
+    free(termZMasks);
+    free(termCoeffsRe);
+    free(termCoeffsIm);
 }
 
 void statevec_twoQubitUnitary(Qureg qureg, int targetQubit1, int targetQubit2, ComplexMatrix4 u) {
@@ -618,12 +1020,22 @@ void populateKrausSuperOperatorN(ComplexMatrixN* superOp, ComplexMatrixN* ops, i
 }
 
 void densmatr_applyKrausSuperoperator(Qureg qureg, int target, ComplexMatrix4 superOp) {
-        
+    
+    if (qureg.isPackedDensityMatrix) {
+        packed_applyKrausSuperoperator(qureg, target, superOp);
+        return;
+    }
+    
     long long int ctrlMask = 0;
     statevec_multiControlledTwoQubitUnitary(qureg, ctrlMask, target, target + qureg.numQubitsRepresented, superOp);
 }
 
 void densmatr_applyTwoQubitKrausSuperoperator(Qureg qureg, int target1, int target2, ComplexMatrixN superOp) {
+    
+    if (qureg.isPackedDensityMatrix) {
+        packed_applyTwoQubitKrausSuperoperator(qureg, target1, target2, superOp);
+        return;
+    }
 
     long long int ctrlMask = 0;
     int numQb = qureg.numQubitsRepresented;
@@ -698,7 +1110,19 @@ void densmatr_mixTwoQubitKrausMap(Qureg qureg, int target1, int target2, Complex
   #endif
 }
 
-void densmatr_mixMultiQubitKrausMap(Qureg qureg, int* targets, int numTargets, ComplexMatrixN* ops, int numOps) {
+/** Whether the numOps Kraus operators upon k = numTargets qubits are cheaper applied directly to 
+ * each 2^k x 2^k block of the chunk (costing 2 numOps 8^k flops per block) than as a 4^k x 4^k 
+ * superoperator (costing 16^k flops per block, and numOps 16^k flops to populate).
+ */
+int isKrausMapCheaperWithoutSuperoperator(Qureg qureg, int numTargets, int numOps) {
+    
+    // both costs are divided by 8^k
+    double numBlocks = (double) (qureg.numAmpsPerChunk >> (2*numTargets));
+    double dim = (double) (1LL << numTargets);
+    return 2*numOps*numBlocks <= (numBlocks + numOps)*dim;
+}
+
+void densmatr_mixMultiQubitKrausMapAsSuperoperator(Qureg qureg, int* targets, int numTargets, ComplexMatrixN* ops, int numOps) {
 
     ComplexMatrixN superOp;
     
@@ -762,59 +1186,225 @@ void densmatr_mixPauli(Qureg qureg, int qubit, qreal probX, qreal probY, qreal p
     densmatr_mixKrausMap(qureg, qubit, ops, numOps);
 }
 
+void densmatr_mixNoiseChannel(Qureg qureg, int qubit, NoiseChannel channel) {
+    
+    // packed density matrices are passed the unscaled probabilities, as by the API
+    int isPacked = qureg.isPackedDensityMatrix;
+    switch (channel.type) {
+        case DEPHASING_NOISE:
+            if (isPacked)
+                packed_mixDephasing(qureg, qubit, channel.prob);
+            else
+                densmatr_mixDephasing(qureg, qubit, 2*channel.prob);
+            break;
+        case DEPOLARISING_NOISE:
+            if (isPacked)
+                packed_mixDepolarising(qureg, qubit, channel.prob);
+            else
+                densmatr_mixDepolarising(qureg, qubit, (4*channel.prob)/3.0);
+            break;
+        case DAMPING_NOISE:
+            if (isPacked)
+                packed_mixDamping(qureg, qubit, channel.prob);
+            else
+                densmatr_mixDamping(qureg, qubit, channel.prob);
+            break;
+        case PAULI_NOISE:
+            densmatr_mixPauli(qureg, qubit, channel.probX, channel.probY, channel.probZ);
+            break;
+        case NO_NOISE:
+            break;
+    }
+}
+
+/** Populates the real 2x2 matrices popMatr and cohMatr (row-major), which the channel applies to 
+ * the populations (rho_00, rho_11) and the coherences (rho_01, rho_10) respectively of every 
+ * 2x2 block of elements which differ only in the channel's qubit. For example, the Pauli channel 
+ * maps rho_01 -> (1 - pX - pY - 2pZ) rho_01 + (pX - pY) rho_10, and damping maps 
+ * rho_00 -> rho_00 + prob rho_11.
+ */
+static void getNoiseChannelMatrices(NoiseChannel channel, qreal popMatr[4], qreal cohMatr[4]) {
+    
+    qreal pX=0, pY=0, pZ=0;
+    switch (channel.type) {
+        case DEPHASING_NOISE:
+            pZ = channel.prob;
+            break;
+        case DEPOLARISING_NOISE:
+            pX = pY = pZ = channel.prob/3;
+            break;
+        case PAULI_NOISE:
+            pX = channel.probX; 
+            pY = channel.probY; 
+            pZ = channel.probZ;
+            break;
+        case DAMPING_NOISE:
+            popMatr[0] = 1; popMatr[1] = channel.prob; 
+            popMatr[2] = 0; popMatr[3] = 1 - channel.prob;
+            cohMatr[0] = cohMatr[3] = sqrt(1 - channel.prob);
+            cohMatr[1] = cohMatr[2] = 0;
+            return;
+        case NO_NOISE:
+            break;
+    }
+    popMatr[0] = popMatr[3] = 1 - pX - pY;
+    popMatr[1] = popMatr[2] = pX + pY;
+    cohMatr[0] = cohMatr[3] = 1 - pX - pY - 2*pZ;
+    cohMatr[1] = cohMatr[2] = pX - pY;
+}
+
+/** Returns the superoperator of a single-qubit channel, with the same ordering as those of 
+ * populateKrausSuperOperator2(), where element (r, c) of the qubit's density matrix has index r + 2c.
+ */
+ComplexMatrix4 getNoiseChannelSuperoperator(NoiseChannel channel) {
+    
+    qreal pop[4], coh[4];
+    getNoiseChannelMatrices(channel, pop, coh);
+    
+    // pop mixes elements (0,0) and (1,1), while coh mixes (0,1) and (1,0)
+    ComplexMatrix4 superOp = {.real={{0}}, .imag={{0}}};
+    superOp.real[0][0] = pop[0]; superOp.real[0][3] = pop[1];
+    superOp.real[3][0] = pop[2]; superOp.real[3][3] = pop[3];
+    superOp.real[2][2] = coh[0]; superOp.real[2][1] = coh[1];
+    superOp.real[1][2] = coh[2]; superOp.real[1][1] = coh[3];
+    return superOp;
+}
+
+/** Separates the channels of a noise layer into the dephasing channels, which merely scale 
+ * the coherences of their qubit by dephaseFacs[qubit] (else 1), and the remainder. Returns 
+ * the number of the latter, populating the ascending targets with their qubits, and popMatrs 
+ * and cohMatrs with the four elements of each one's population and coherence matrices.
+ */
+int getNoiseLayerMatrices(
+    Qureg qureg, NoiseChannel* channels, qreal* dephaseFacs, int* targets, qreal* popMatrs, qreal* cohMatrs
+) {
+    int numTargets = 0;
+    for (int q=0; q<qureg.numQubitsRepresented; q++) {
+        dephaseFacs[q] = 1;
+        if (channels[q].type == NO_NOISE)
+            continue;
+        
+        qreal pop[4], coh[4];
+        getNoiseChannelMatrices(channels[q], pop, coh);
+        
+        // channels which preserve populations and uniformly scale coherences are dephasing
+        if (pop[0] == 1 && pop[1] == 0 && pop[2] == 0 && pop[3] == 1 && coh[1] == 0 && coh[2] == 0 && coh[0] == coh[3]) {
+            dephaseFacs[q] = coh[0];
+            continue;
+        }
+        targets[numTargets] = q;
+        for (int i=0; i<4; i++) {
+            popMatrs[4*numTargets + i] = pop[i];
+            cohMatrs[4*numTargets + i] = coh[i];
+        }
+        numTargets++;
+    }
+    return numTargets;
+}
+
+static void recordPauliHamilTermRotation(Qureg qureg, PauliHamil hamil, int t, qreal angle) {
+    
+    char buff[1024];
+    int b=0;
+    for (int q=0; q<hamil.numQubits; q++) {
+        enum pauliOpType op = hamil.pauliCodes[q + t*hamil.numQubits];
+        
+        char p = 'I';
+        if (op == PAULI_X) p = 'X';
+        if (op == PAULI_Y) p = 'Y';
+        if (op == PAULI_Z) p = 'Z';
+        buff[b++] = p;
+        buff[b++] = ' ';
+    }
+    buff[b] = '\0';
+    
+    qasm_recordComment(qureg, 
+        "Here, a multiRotatePauli with angle %g and paulis %s was applied.",
+        angle, buff);
+}
+
+static void applyGatheredDiagonalTerms(
+    Qureg qureg, PauliHamil hamil, qreal fac, long long int* xMasks,
+    long long int* diagMasks, qreal* diagAngles, int numDiagRots
+) {
+    if (numDiagRots > 0)
+        statevec_multiRotateZProduct(qureg, diagMasks, diagAngles, numDiagRots);
+    
+    // every diagonal term is recorded, though applied together
+    for (int t=0; t<hamil.numSumTerms; t++)
+        if (xMasks[t] == 0)
+            recordPauliHamilTermRotation(qureg, hamil, t, 2*fac*hamil.termCoeffs[t]);
+}
+
 void applyExponentiatedPauliHamil(Qureg qureg, PauliHamil hamil, qreal fac, int reverse) {
     
     /* applies a first-order one-repetition approximation of exp(-i fac H)
      * to qureg. Letting H = sum_j c_j h_j, it does this via 
      * exp(-i fac H) ~ prod_j exp(-i fac c_j h_j), where each inner exp 
      * is performed with multiRotatePauli (with pre-factor 2).
+     *
+     * The diagonal (Z-only) terms commute, so are gathered and applied exactly 
+     * as one diagonal phase, before (or after, when reversed) the remaining terms, 
+     * which preserves the symmetry of the higher-order Suzuki decompositions. 
+     * All-identity terms (a global phase) are skipped, as by multiRotatePauli.
      */
-     
-    // prepare targets for multiRotatePauli 
-    // (all qubits; actual targets are determined by Pauli codes)
-    int vecTargs[100]; // [hamil.numQubits];
-    int densTargs[100]; // [hamil.numQubits];
-    for (int q=0; q<hamil.numQubits; q++) {
-        vecTargs[q] = q;
-        densTargs[q] = q + hamil.numQubits;
+    
+    int numQb = hamil.numQubits;
+    int targs[100]; // [hamil.numQubits];
+    for (int q=0; q<numQb; q++)
+        targs[q] = q;
+    
+    // the masks of every term, and the phases of the diagonal terms upon both the row and 
+    // (conjugated) column qubits of density matrices
+    long long int* xMasks = malloc(hamil.numSumTerms * sizeof *xMasks);
+    long long int* zMasks = malloc(hamil.numSumTerms * sizeof *zMasks);
+    long long int* diagMasks = malloc(2*hamil.numSumTerms * sizeof *diagMasks);
+    qreal* diagAngles = malloc(2*hamil.numSumTerms * sizeof *diagAngles);
+    int numDiagRots = 0;
+    
+    for (int t=0; t<hamil.numSumTerms; t++) {
+        getPauliProdMasks(targs, &(hamil.pauliCodes[t*numQb]), numQb, &xMasks[t], &zMasks[t]);
+        if (xMasks[t] != 0 || zMasks[t] == 0)
+            continue;
+        
+        qreal angle = 2*fac*hamil.termCoeffs[t];
+        diagMasks[numDiagRots] = zMasks[t];
+        diagAngles[numDiagRots++] = angle;
+        if (qureg.isDensityMatrix) {
+            diagMasks[numDiagRots] = zMasks[t] << numQb;
+            diagAngles[numDiagRots++] = - angle;
+        }
     }
-
+    
+    // the diagonal terms are applied first, or last when reversed
+    if (!reverse)
+        applyGatheredDiagonalTerms(qureg, hamil, fac, xMasks, diagMasks, diagAngles, numDiagRots);
+    
     for (int i=0; i<hamil.numSumTerms; i++) {
         
         int t=i;
         if (reverse)
             t=hamil.numSumTerms-1-i;
-            
-        qreal angle = 2*fac*hamil.termCoeffs[t];
         
-        statevec_multiRotatePauli(
-            qureg, vecTargs, &(hamil.pauliCodes[t*hamil.numQubits]), 
-            hamil.numQubits, angle, 0);
+        if (xMasks[t] == 0)
+            continue;
         
+        qreal angle = 2*fac*hamil.termCoeffs[t];
+        statevec_multiControlledMultiRotatePauliMasks(qureg, 0, xMasks[t], zMasks[t], angle, 0);
         if (qureg.isDensityMatrix)
-            statevec_multiRotatePauli(
-                qureg, densTargs, &(hamil.pauliCodes[t*hamil.numQubits]), 
-                hamil.numQubits, angle, 1);
-        
-        // record qasm      
-        char buff[1024];
-        int b=0;
-        for (int q=0; q<hamil.numQubits; q++) {
-            enum pauliOpType op = hamil.pauliCodes[q + t*hamil.numQubits];
-            
-            char p = 'I';
-            if (op == PAULI_X) p = 'X';
-            if (op == PAULI_Y) p = 'Y';
-            if (op == PAULI_Z) p = 'Z';
-            buff[b++] = p;
-            buff[b++] = ' ';
-        }
-        buff[b] = '\0';
+            statevec_multiControlledMultiRotatePauliMasks(
+                qureg, 0, xMasks[t] << numQb, zMasks[t] << numQb, angle, 1);
         
-        qasm_recordComment(qureg, 
-            "Here, a multiRotatePauli with angle %g and paulis %s was applied.",
-            angle, buff);
+        recordPauliHamilTermRotation(qureg, hamil, t, angle);
     }
+    
+    if (reverse)
+        applyGatheredDiagonalTerms(qureg, hamil, fac, xMasks, diagMasks, diagAngles, numDiagRots);
+    
+    free(xMasks);
+    free(zMasks);
+    free(diagMasks);
+    free(diagAngles);
 }
 
 void applySymmetrizedTrotterCircuit(Qureg qureg, PauliHamil hamil, qreal time, int order) {
@@ -0,0 +1,703 @@
+// Distributed under MIT licence. See https://github.com/QuEST-Kit/QuEST/blob/master/LICENCE.txt for details
+
+/** @file
+ * Functions for deferring gates upon a Qureg and fusing them into a single dense
+ * matrix, which is applied to the state in one pass only when needed.
+ *
+ * The fused gate is a 2^numQubits by 2^numQubits matrix upon the qubits in
+ * GateQueue.qubits, where qubits[0] is the least significant. Each arriving gate
+ * is left-multiplied onto the fused matrix, after extending the fused matrix
+ * (as the identity) to act upon any of the gate's qubits it did not yet include.
+ * Controls of arriving gates become qubits of the fused gate, so that the fused
+ * gate is always applied without controls, via statevec_multiQubitUnitary().
+ *
+ * When cache-blocking (numTileQubits > 0), a full fused gate is instead queued in
+ * tiledGates, and the queue is applied tile-by-tile via statevec_applyGatesInTiles().
+ * Every queued gate must act only upon the lowest numTileQubits qubits, so gates 
+ * upon higher qubits first swap them with tile qubits. The fused and queued gates
+ * are hence expressed in terms of "physical" qubits of the state, which differ from
+ * the "circuit" qubits passed by the user until the swaps are undone.
+ */
+
+# include "QuEST.h"
+# include "QuEST_precision.h"
+# include "QuEST_internal.h"
+# include "QuEST_fusion.h"
+
+# include <math.h>
+# include <stdlib.h>
+
+
+static qreal** allocFusionMatrix(int dim) {
+
+    qreal** matr = malloc(dim * sizeof *matr);
+    for (int r=0; r<dim; r++)
+        matr[r] = malloc(dim * sizeof **matr);
+    return matr;
+}
+
+static void freeFusionMatrix(qreal** matr, int dim) {
+
+    for (int r=0; r<dim; r++)
+        free(matr[r]);
+    free(matr);
+}
+
+static void freeFusionWorkspace(GateQueue* queue) {
+
+    if (queue->maxNumQubits == 0)
+        return;
+
+    int dim = 1 << queue->maxNumQubits;
+    freeFusionMatrix(queue->fusedReal, dim);
+    freeFusionMatrix(queue->fusedImag, dim);
+    freeFusionMatrix(queue->gateReal, dim);
+    freeFusionMatrix(queue->gateImag, dim);
+    free(queue->ampsReal);
+    free(queue->ampsImag);
+    free(queue->qubits);
+    queue->maxNumQubits = 0;
+
+    if (queue->numTileQubits == 0)
+        return;
+
+    free(queue->tiledGates);
+    free(queue->tiledTargs);
+    free(queue->physicalQubits);
+    free(queue->circuitQubits);
+    free(queue->lastUsed);
+    queue->numTileQubits = 0;
+    queue->maxNumTiledGates = 0;
+}
+
+void fusion_setup(Qureg* qureg) {
+
+    GateQueue* queue = malloc(sizeof *queue);
+    qureg->gateQueue = queue;
+
+    queue->isDeferring = 0;
+    queue->maxNumQubits = 0;
+    queue->numQubits = 0;
+    queue->numGates = 0;
+    queue->numTileQubits = 0;
+    queue->numTiledGates = 0;
+    queue->maxNumTiledGates = 0;
+}
+
+void fusion_startDeferring(Qureg qureg, int maxNumQubits, int numTileQubits) {
+
+    GateQueue* queue = qureg.gateQueue;
+
+    // apply gates pending from a previous deferral (which may have had a different max)
+    fusion_applyDeferred(qureg);
+    freeFusionWorkspace(queue);
+
+    int dim = 1 << maxNumQubits;
+    queue->maxNumQubits = maxNumQubits;
+    queue->qubits = malloc(maxNumQubits * sizeof *(queue->qubits));
+    queue->fusedReal = allocFusionMatrix(dim);
+    queue->fusedImag = allocFusionMatrix(dim);
+    queue->gateReal = allocFusionMatrix(dim);
+    queue->gateImag = allocFusionMatrix(dim);
+    queue->ampsReal = malloc(dim * sizeof *(queue->ampsReal));
+    queue->ampsImag = malloc(dim * sizeof *(queue->ampsImag));
+
+    // the fused gate begins as the zero-qubit identity
+    queue->fusedReal[0][0] = 1;
+    queue->fusedImag[0][0] = 0;
+    queue->numQubits = 0;
+    queue->numGates = 0;
+    queue->isDeferring = 1;
+
+    queue->numTileQubits = numTileQubits;
+    if (numTileQubits == 0)
+        return;
+
+    // the tiled queue grows as needed
+    queue->numTiledGates = 0;
+    queue->maxNumTiledGates = 0;
+    queue->tiledGates = NULL;
+    queue->tiledTargs = NULL;
+
+    // circuit and physical qubits begin identical
+    int numQubits = qureg.numQubitsInStateVec;
+    queue->physicalQubits = malloc(numQubits * sizeof *(queue->physicalQubits));
+    queue->circuitQubits = malloc(numQubits * sizeof *(queue->circuitQubits));
+    queue->lastUsed = malloc(numQubits * sizeof *(queue->lastUsed));
+    for (int q=0; q<numQubits; q++) {
+        queue->physicalQubits[q] = q;
+        queue->circuitQubits[q] = q;
+        queue->lastUsed[q] = 0;
+    }
+    queue->gateCount = 0;
+}
+
+void fusion_stopDeferring(Qureg qureg) {
+
+    fusion_applyDeferred(qureg);
+    freeFusionWorkspace(qureg.gateQueue);
+    qureg.gateQueue->isDeferring = 0;
+}
+
+/** Restores the fused gate to the zero-qubit identity */
+static void clearFusedGate(GateQueue* queue) {
+
+    queue->fusedReal[0][0] = 1;
+    queue->fusedImag[0][0] = 0;
+    queue->numQubits = 0;
+    queue->numGates = 0;
+}
+
+/** Applies the fused gate directly to the full state */
+static void applyFusedGate(Qureg qureg) {
+
+    GateQueue* queue = qureg.gateQueue;
+    if (queue->numGates == 0)
+        return;
+
+    int numQubits = queue->numQubits;
+    int* qubits = queue->qubits;
+    ComplexMatrixN u = {.numQubits=numQubits, .real=queue->fusedReal, .imag=queue->fusedImag};
+
+    // fused gates of one or two qubits use the bespoke (faster) backend kernels
+    if (numQubits == 1 || numQubits == 2) {
+        ComplexMatrix2 u2;
+        ComplexMatrix4 u4;
+        int dim = 1 << numQubits;
+        for (int r=0; r<dim; r++) {
+            for (int c=0; c<dim; c++) {
+                if (numQubits == 1) {
+                    u2.real[r][c] = u.real[r][c];
+                    u2.imag[r][c] = u.imag[r][c];
+                } else {
+                    u4.real[r][c] = u.real[r][c];
+                    u4.imag[r][c] = u.imag[r][c];
+                }
+            }
+        }
+        if (numQubits == 1) {
+            if (qureg.isDensityMatrix)
+                densmatr_multiControlledUnitary(qureg, 0, 0, qubits[0], u2);
+            else
+                statevec_unitary(qureg, qubits[0], u2);
+        } else {
+            if (qureg.isDensityMatrix)
+                densmatr_multiControlledTwoQubitUnitary(qureg, 0, qubits[0], qubits[1], u4);
+            else
+                statevec_twoQubitUnitary(qureg, qubits[0], qubits[1], u4);
+        }
+    }
+    else {
+        statevec_multiQubitUnitary(qureg, qubits, numQubits, u);
+        if (qureg.isDensityMatrix) {
+            // the fused matrix and qubits are about to be discarded, so are modified in-place
+            shiftIndices(qubits, numQubits, qureg.numQubitsRepresented);
+            setConjugateMatrixN(u);
+            statevec_multiQubitUnitary(qureg, qubits, numQubits, u);
+        }
+    }
+
+    clearFusedGate(queue);
+}
+
+/** Moves a copy of the fused gate into the queue of gates awaiting application to every tile */
+static void queueFusedGate(GateQueue* queue) {
+
+    if (queue->numGates == 0)
+        return;
+
+    if (queue->numTiledGates == queue->maxNumTiledGates) {
+        queue->maxNumTiledGates = (queue->maxNumTiledGates == 0)? 8 : 2*queue->maxNumTiledGates;
+        queue->tiledGates = realloc(queue->tiledGates, queue->maxNumTiledGates * sizeof *(queue->tiledGates));
+        queue->tiledTargs = realloc(queue->tiledTargs, queue->maxNumTiledGates * sizeof *(queue->tiledTargs));
+    }
+
+    int numQubits = queue->numQubits;
+    int dim = 1 << numQubits;
+    ComplexMatrixN u = {
+        .numQubits = numQubits,
+        .real = allocFusionMatrix(dim),
+        .imag = allocFusionMatrix(dim)};
+    int* targs = malloc(numQubits * sizeof *targs);
+
+    for (int r=0; r<dim; r++) {
+        for (int c=0; c<dim; c++) {
+            u.real[r][c] = queue->fusedReal[r][c];
+            u.imag[r][c] = queue->fusedImag[r][c];
+        }
+    }
+    for (int q=0; q<numQubits; q++)
+        targs[q] = queue->qubits[q];
+
+    queue->tiledGates[queue->numTiledGates] = u;
+    queue->tiledTargs[queue->numTiledGates] = targs;
+    queue->numTiledGates++;
+
+    clearFusedGate(queue);
+}
+
+/** Applies the fused gate and all queued gates to the state, without undoing 
+ * any qubit swaps made for cache-blocking
+ */
+static void applyPendingGates(Qureg qureg) {
+
+    GateQueue* queue = qureg.gateQueue;
+    if (queue->numTileQubits == 0) {
+        applyFusedGate(qureg);
+        return;
+    }
+
+    queueFusedGate(queue);
+    if (queue->numTiledGates == 0)
+        return;
+
+    statevec_applyGatesInTiles(qureg, queue->numTileQubits, queue->tiledGates, queue->tiledTargs, queue->numTiledGates);
+
+    for (int g=0; g<queue->numTiledGates; g++) {
+        int dim = 1 << queue->tiledGates[g].numQubits;
+        freeFusionMatrix(queue->tiledGates[g].real, dim);
+        freeFusionMatrix(queue->tiledGates[g].imag, dim);
+        free(queue->tiledTargs[g]);
+    }
+    queue->numTiledGates = 0;
+}
+
+/** Swaps the physical qubits storing the circuit qubits at physical positions p1 and p2 */
+static void swapPhysicalQubits(Qureg qureg, int p1, int p2) {
+
+    GateQueue* queue = qureg.gateQueue;
+    statevec_swapQubitAmps(qureg, p1, p2);
+
+    int c1 = queue->circuitQubits[p1];
+    int c2 = queue->circuitQubits[p2];
+    queue->circuitQubits[p1] = c2;
+    queue->circuitQubits[p2] = c1;
+    queue->physicalQubits[c1] = p2;
+    queue->physicalQubits[c2] = p1;
+}
+
+/** Undoes all qubit swaps made for cache-blocking, so that circuit and physical qubits agree.
+ * Assumes no gates are pending.
+ */
+static void restoreQubitOrder(Qureg qureg) {
+
+    GateQueue* queue = qureg.gateQueue;
+    if (queue->numTileQubits == 0)
+        return;
+
+    for (int q=0; q<qureg.numQubitsInStateVec; q++)
+        if (queue->physicalQubits[q] != q)
+            swapPhysicalQubits(qureg, q, queue->physicalQubits[q]);
+}
+
+void fusion_applyDeferred(Qureg qureg) {
+
+    applyPendingGates(qureg);
+    restoreQubitOrder(qureg);
+}
+
+/** Overwrites qubits (of the circuit) with the physical qubits which store them, first 
+ * swapping any outside of the tile with the least recently used tile qubits. This 
+ * applies all pending gates if a swap is necessary.
+ */
+static void mapToTileQubits(Qureg qureg, int* qubits, int numQubits) {
+
+    GateQueue* queue = qureg.gateQueue;
+    int numTileQubits = queue->numTileQubits;
+
+    for (int i=0; i<numQubits; i++) {
+        int phys = queue->physicalQubits[qubits[i]];
+        if (phys >= numTileQubits) {
+
+            // swaps act upon the full state, so must follow all pending gates
+            applyPendingGates(qureg);
+
+            // choose the least recently used tile qubit which this gate does not use
+            int victim = -1;
+            for (int t=0; t<numTileQubits; t++) {
+                int isGateQubit = 0;
+                for (int j=0; j<numQubits; j++)
+                    if (queue->physicalQubits[qubits[j]] == t)
+                        isGateQubit = 1;
+                if (!isGateQubit && (victim == -1 || queue->lastUsed[t] < queue->lastUsed[victim]))
+                    victim = t;
+            }
+            swapPhysicalQubits(qureg, phys, victim);
+            queue->lastUsed[phys] = queue->lastUsed[victim];
+        }
+    }
+
+    queue->gateCount++;
+    for (int i=0; i<numQubits; i++) {
+        qubits[i] = queue->physicalQubits[qubits[i]];
+        queue->lastUsed[qubits[i]] = queue->gateCount;
+    }
+}
+
+/** Returns whether a gate upon numGateQubits qubits (including controls) can be
+ * deferred. When it cannot, any pending gates are applied so that the caller
+ * can apply the gate immediately, in order.
+ */
+static int canDeferGate(Qureg qureg, int numGateQubits) {
+
+    GateQueue* queue = qureg.gateQueue;
+    if (!queue->isDeferring)
+        return 0;
+
+    if (numGateQubits > queue->maxNumQubits) {
+        fusion_applyDeferred(qureg);
+        return 0;
+    }
+
+    return 1;
+}
+
+/** Returns the position of qubit in the fused gate, or -1 if it is not yet included */
+static int getFusedQubitIndex(GateQueue* queue, int qubit) {
+
+    for (int i=0; i<queue->numQubits; i++)
+        if (queue->qubits[i] == qubit)
+            return i;
+    return -1;
+}
+
+/** Extends the fused matrix M to act as the identity upon the additional (most
+ * significant) qubit, producing Id (x) M. The existing leading block is unchanged.
+ */
+static void addQubitToFusedGate(GateQueue* queue, int qubit) {
+
+    int oldDim = 1 << queue->numQubits;
+    int newDim = 2 * oldDim;
+    qreal** re = queue->fusedReal;
+    qreal** im = queue->fusedImag;
+
+    for (int r=0; r<newDim; r++) {
+        for (int c=0; c<newDim; c++) {
+            if (r < oldDim && c < oldDim)
+                continue;
+
+            if ((r < oldDim) == (c < oldDim)) {
+                re[r][c] = re[r % oldDim][c % oldDim];
+                im[r][c] = im[r % oldDim][c % oldDim];
+            } else {
+                re[r][c] = 0;
+                im[r][c] = 0;
+            }
+        }
+    }
+
+    queue->qubits[queue->numQubits++] = qubit;
+}
+
+/** Returns the fused-matrix index offset corresponding to the bits of gateInd,
+ * which index the 2^numTargs dimensional gate upon targets at positions inds
+ */
+static int getFusedIndexOffset(int gateInd, int* inds, int numTargs) {
+
+    int offset = 0;
+    for (int t=0; t<numTargs; t++)
+        offset |= ((gateInd >> t) & 1) << inds[t];
+    return offset;
+}
+
+/** Left-multiplies the gate matrix populated in queue->gateReal/Imag (upon targs,
+ * conditioned on ctrls being in ctrlState, or all 1 if NULL) onto the fused matrix.
+ * Assumes the gate's qubits fit within queue->maxNumQubits.
+ */
+static void fuseGate(Qureg qureg, int* ctrls, int* ctrlState, int numCtrls, int* targs, int numTargs) {
+
+    GateQueue* queue = qureg.gateQueue;
+
+    // when cache-blocking, the fused gate acts upon the (tile-local) physical qubits
+    int gateQubits[100]; // [numCtrls + numTargs];
+    if (queue->numTileQubits > 0) {
+        for (int i=0; i<numCtrls; i++)
+            gateQubits[i] = ctrls[i];
+        for (int i=0; i<numTargs; i++)
+            gateQubits[numCtrls + i] = targs[i];
+        mapToTileQubits(qureg, gateQubits, numCtrls + numTargs);
+        ctrls = gateQubits;
+        targs = &gateQubits[numCtrls];
+    }
+
+    // count the gate's qubits which the fused gate does not yet act upon
+    int numNewQubits = 0;
+    for (int i=0; i<numCtrls; i++)
+        numNewQubits += (getFusedQubitIndex(queue, ctrls[i]) == -1);
+    for (int i=0; i<numTargs; i++)
+        numNewQubits += (getFusedQubitIndex(queue, targs[i]) == -1);
+
+    // apply (or queue) the pending gate if it cannot grow to include the new qubits
+    if (queue->numQubits + numNewQubits > queue->maxNumQubits) {
+        if (queue->numTileQubits > 0)
+            queueFusedGate(queue);
+        else
+            applyFusedGate(qureg);
+    }
+
+    for (int i=0; i<numCtrls; i++)
+        if (getFusedQubitIndex(queue, ctrls[i]) == -1)
+            addQubitToFusedGate(queue, ctrls[i]);
+    for (int i=0; i<numTargs; i++)
+        if (getFusedQubitIndex(queue, targs[i]) == -1)
+            addQubitToFusedGate(queue, targs[i]);
+
+    // locate the gate's qubits within the fused matrix
+    int targInds[100]; // [numTargs];
+    int targMask = 0;
+    for (int t=0; t<numTargs; t++) {
+        targInds[t] = getFusedQubitIndex(queue, targs[t]);
+        targMask |= 1 << targInds[t];
+    }
+    int ctrlMask = 0;
+    int ctrlStateMask = 0;
+    for (int c=0; c<numCtrls; c++) {
+        int ind = getFusedQubitIndex(queue, ctrls[c]);
+        ctrlMask |= 1 << ind;
+        if (ctrlState == NULL || ctrlState[c] == 1)
+            ctrlStateMask |= 1 << ind;
+    }
+
+    int dim = 1 << queue->numQubits;
+    int numGateAmps = 1 << numTargs;
+    qreal** fusedRe = queue->fusedReal;
+    qreal** fusedIm = queue->fusedImag;
+    qreal** gateRe = queue->gateReal;
+    qreal** gateIm = queue->gateImag;
+    qreal* ampsRe = queue->ampsReal;
+    qreal* ampsIm = queue->ampsImag;
+
+    // multiply the gate onto each column of the fused matrix, like onto a state-vector
+    for (int col=0; col<dim; col++) {
+        for (int row=0; row<dim; row++) {
+
+            // visit each satisfied group of rows once, via its member with zero targets
+            if ((row & targMask) || (row & ctrlMask) != ctrlStateMask)
+                continue;
+
+            for (int i=0; i<numGateAmps; i++) {
+                int ind = row | getFusedIndexOffset(i, targInds, numTargs);
+                ampsRe[i] = fusedRe[ind][col];
+                ampsIm[i] = fusedIm[ind][col];
+            }
+            for (int i=0; i<numGateAmps; i++) {
+                int ind = row | getFusedIndexOffset(i, targInds, numTargs);
+                qreal re = 0;
+                qreal im = 0;
+                for (int j=0; j<numGateAmps; j++) {
+                    re += gateRe[i][j]*ampsRe[j] - gateIm[i][j]*ampsIm[j];
+                    im += gateRe[i][j]*ampsIm[j] + gateIm[i][j]*ampsRe[j];
+                }
+                fusedRe[ind][col] = re;
+                fusedIm[ind][col] = im;
+            }
+        }
+    }
+
+    queue->numGates++;
+}
+
+static void setGateMatrixToZero(GateQueue* queue, int numTargs) {
+
+    int dim = 1 << numTargs;
+    for (int r=0; r<dim; r++) {
+        for (int c=0; c<dim; c++) {
+            queue->gateReal[r][c] = 0;
+            queue->gateImag[r][c] = 0;
+        }
+    }
+}
+
+static void setGateMatrix2(GateQueue* queue, ComplexMatrix2 u) {
+
+    for (int r=0; r<2; r++) {
+        for (int c=0; c<2; c++) {
+            queue->gateReal[r][c] = u.real[r][c];
+            queue->gateImag[r][c] = u.imag[r][c];
+        }
+    }
+}
+
+static ComplexMatrix2 getOneQubitGateMatrix(TargetGate gate, qreal param) {
+
+    ComplexMatrix2 u = {.real={{0}}, .imag={{0}}};
+    qreal fac = 1/sqrt(2);
+    Vector axis = {0, 0, 0};
+    Complex alpha, beta;
+
+    switch (gate) {
+        case GATE_SIGMA_X:
+            u.real[0][1] = 1; u.real[1][0] = 1;
+            break;
+        case GATE_SIGMA_Y:
+            u.imag[0][1] = -1; u.imag[1][0] = 1;
+            break;
+        case GATE_SIGMA_Z:
+            u.real[0][0] = 1; u.real[1][1] = -1;
+            break;
+        case GATE_S:
+            u.real[0][0] = 1; u.imag[1][1] = 1;
+            break;
+        case GATE_T:
+            u.real[0][0] = 1; u.real[1][1] = fac; u.imag[1][1] = fac;
+            break;
+        case GATE_HADAMARD:
+            u.real[0][0] = fac; u.real[0][1] = fac;
+            u.real[1][0] = fac; u.real[1][1] = -fac;
+            break;
+        case GATE_PHASE_SHIFT:
+            u.real[0][0] = 1; u.real[1][1] = cos(param); u.imag[1][1] = sin(param);
+            break;
+        case GATE_ROTATE_X:
+        case GATE_ROTATE_Y:
+        case GATE_ROTATE_Z:
+            axis.x = (gate == GATE_ROTATE_X);
+            axis.y = (gate == GATE_ROTATE_Y);
+            axis.z = (gate == GATE_ROTATE_Z);
+            getComplexPairFromRotation(param, axis, &alpha, &beta);
+            u = getMatrixFromComplexPair(alpha, beta);
+            break;
+        default:
+            break;
+    }
+    return u;
+}
+
+int fusion_deferGate(Qureg qureg, TargetGate gate, qreal param, int* ctrls, int numCtrls, int* targs, int numTargs) {
+
+    if (!canDeferGate(qureg, numCtrls + numTargs))
+        return 0;
+
+    GateQueue* queue = qureg.gateQueue;
+    int dim = 1 << numTargs;
+    setGateMatrixToZero(queue, numTargs);
+
+    // X upon every target flips all target bits
+    if (gate == GATE_SIGMA_X) {
+        for (int i=0; i<dim; i++)
+            queue->gateReal[i ^ (dim-1)][i] = 1;
+    }
+    // exp(-i param/2 Z (x) ... (x) Z) is diagonal, informed by the parity of the targets
+    else if (gate == GATE_ROTATE_Z) {
+        for (int i=0; i<dim; i++) {
+            int parity = 0;
+            for (int t=0; t<numTargs; t++)
+                parity ^= (i >> t) & 1;
+            queue->gateReal[i][i] = cos(param/2);
+            queue->gateImag[i][i] = (parity)? sin(param/2) : - sin(param/2);
+        }
+    }
+    else if (gate == GATE_SWAP) {
+        queue->gateReal[0][0] = 1;
+        queue->gateReal[1][2] = 1;
+        queue->gateReal[2][1] = 1;
+        queue->gateReal[3][3] = 1;
+    }
+    else if (gate == GATE_SQRT_SWAP) {
+        queue->gateReal[0][0] = 1;
+        queue->gateReal[3][3] = 1;
+        queue->gateReal[1][1] = .5; queue->gateImag[1][1] = .5;
+        queue->gateReal[1][2] = .5; queue->gateImag[1][2] =-.5;
+        queue->gateReal[2][1] = .5; queue->gateImag[2][1] =-.5;
+        queue->gateReal[2][2] = .5; queue->gateImag[2][2] = .5;
+    }
+    else
+        setGateMatrix2(queue, getOneQubitGateMatrix(gate, param));
+
+    fuseGate(qureg, ctrls, NULL, numCtrls, targs, numTargs);
+    return 1;
+}
+
+int fusion_deferCompactUnitary(Qureg qureg, Complex alpha, Complex beta, int* ctrls, int numCtrls, int targ) {
+
+    return fusion_deferUnitary(qureg, getMatrixFromComplexPair(alpha, beta), ctrls, NULL, numCtrls, targ);
+}
+
+int fusion_deferAxisRotation(Qureg qureg, qreal angle, Vector axis, int* ctrls, int numCtrls, int targ) {
+
+    Complex alpha, beta;
+    getComplexPairFromRotation(angle, axis, &alpha, &beta);
+    return fusion_deferCompactUnitary(qureg, alpha, beta, ctrls, numCtrls, targ);
+}
+
+int fusion_deferUnitary(Qureg qureg, ComplexMatrix2 u, int* ctrls, int* ctrlState, int numCtrls, int targ) {
+
+    if (!canDeferGate(qureg, numCtrls + 1))
+        return 0;
+
+    setGateMatrix2(qureg.gateQueue, u);
+    fuseGate(qureg, ctrls, ctrlState, numCtrls, (int[]) {targ}, 1);
+    return 1;
+}
+
+int fusion_deferTwoQubitUnitary(Qureg qureg, ComplexMatrix4 u, int* ctrls, int numCtrls, int targ1, int targ2) {
+
+    if (!canDeferGate(qureg, numCtrls + 2))
+        return 0;
+
+    GateQueue* queue = qureg.gateQueue;
+    for (int r=0; r<4; r++) {
+        for (int c=0; c<4; c++) {
+            queue->gateReal[r][c] = u.real[r][c];
+            queue->gateImag[r][c] = u.imag[r][c];
+        }
+    }
+
+    fuseGate(qureg, ctrls, NULL, numCtrls, (int[]) {targ1, targ2}, 2);
+    return 1;
+}
+
+int fusion_deferMultiQubitUnitary(Qureg qureg, ComplexMatrixN u, int* ctrls, int numCtrls, int* targs, int numTargs) {
+
+    if (!canDeferGate(qureg, numCtrls + numTargs))
+        return 0;
+
+    GateQueue* queue = qureg.gateQueue;
+    int dim = 1 << numTargs;
+    for (int r=0; r<dim; r++) {
+        for (int c=0; c<dim; c++) {
+            queue->gateReal[r][c] = u.real[r][c];
+            queue->gateImag[r][c] = u.imag[r][c];
+        }
+    }
+
+    fuseGate(qureg, ctrls, NULL, numCtrls, targs, numTargs);
+    return 1;
+}
+
+/** Removes the pending fused gate without applying it, when it acts upon at most two qubits, 
+ * populating its qubits (where qubits[0] is the least significant) and the leading 2x2 or 4x4 
+ * block of u. Returns the number of its qubits, or 0 if no gate was removed, in which case any 
+ * larger pending gate is instead applied.
+ */
+int fusion_popFusedGate(Qureg qureg, int* qubits, ComplexMatrix4* u) {
+
+    GateQueue* queue = qureg.gateQueue;
+    if (queue->numGates == 0)
+        return 0;
+
+    int numQubits = queue->numQubits;
+    if (numQubits > 2 || queue->numTileQubits > 0) {
+        fusion_applyDeferred(qureg);
+        return 0;
+    }
+
+    int dim = 1 << numQubits;
+    for (int r=0; r<dim; r++) {
+        for (int c=0; c<dim; c++) {
+            u->real[r][c] = queue->fusedReal[r][c];
+            u->imag[r][c] = queue->fusedImag[r][c];
+        }
+    }
+    for (int q=0; q<numQubits; q++)
+        qubits[q] = queue->qubits[q];
+
+    clearFusedGate(queue);
+    return numQubits;
+}
+
+void fusion_free(Qureg qureg) {
+
+    freeFusionWorkspace(qureg.gateQueue);
+    free(qureg.gateQueue);
+}
@@ -0,0 +1,49 @@
+// Distributed under MIT licence. See https://github.com/QuEST-Kit/QuEST/blob/master/LICENCE.txt for details
+
+/** @file
+ * Functions for deferring gates upon a Qureg and fusing them into a single dense matrix.
+ * The fusion functions (fusion_defer*) return 1 if the given gate was absorbed into
+ * the pending fused gate, in which case the caller must not apply it, and otherwise
+ * return 0 after applying any pending gates, so that the caller can apply it immediately.
+ */
+
+# ifndef QUEST_FUSION_H
+# define QUEST_FUSION_H
+
+# include "QuEST.h"
+# include "QuEST_precision.h"
+# include "QuEST_qasm.h"
+
+# ifdef __cplusplus
+extern "C" {
+# endif
+
+void fusion_setup(Qureg* qureg);
+
+void fusion_startDeferring(Qureg qureg, int maxNumQubits, int numTileQubits);
+
+void fusion_stopDeferring(Qureg qureg);
+
+void fusion_applyDeferred(Qureg qureg);
+
+int fusion_deferGate(Qureg qureg, TargetGate gate, qreal param, int* ctrls, int numCtrls, int* targs, int numTargs);
+
+int fusion_deferCompactUnitary(Qureg qureg, Complex alpha, Complex beta, int* ctrls, int numCtrls, int targ);
+
+int fusion_deferAxisRotation(Qureg qureg, qreal angle, Vector axis, int* ctrls, int numCtrls, int targ);
+
+int fusion_deferUnitary(Qureg qureg, ComplexMatrix2 u, int* ctrls, int* ctrlState, int numCtrls, int targ);
+
+int fusion_deferTwoQubitUnitary(Qureg qureg, ComplexMatrix4 u, int* ctrls, int numCtrls, int targ1, int targ2);
+
+int fusion_deferMultiQubitUnitary(Qureg qureg, ComplexMatrixN u, int* ctrls, int numCtrls, int* targs, int numTargs);
+
+int fusion_popFusedGate(Qureg qureg, int* qubits, ComplexMatrix4* u);
+
+void fusion_free(Qureg qureg);
+
+# ifdef __cplusplus
+}
+# endif
+
+# endif // QUEST_FUSION_H
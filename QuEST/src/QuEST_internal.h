@@ -43,6 +43,10 @@ void ensureIndsIncrease(int* ind1, int* ind2);
 
 void getComplexPairFromRotation(qreal angle, Vector axis, Complex* alpha, Complex* beta);
 
+ComplexMatrix2 getMatrixFromComplexPair(Complex alpha, Complex beta);
+
+Complex getPauliRotationPairFactor(long long int xMask, long long int zMask, qreal angle, int applyConj);
+
 void getZYZRotAnglesFromComplexPair(Complex alpha, Complex beta, qreal* rz2, qreal* ry, qreal* rz1);
 
 void getComplexPairAndPhaseFromUnitary(ComplexMatrix2 u, Complex* alpha, Complex* beta, qreal* globalPhase);
@@ -55,6 +59,18 @@ void conjugateMatrixN(ComplexMatrixN u);
 
 void getQuESTDefaultSeedKey(unsigned long int *key);
 
+void offerTopOutcome(long long int* heapInds, qreal* heapProbs, int* heapSize, int k, long long int ind, qreal prob);
+
+void sortTopOutcomes(long long int* heapInds, qreal* heapProbs, int heapSize);
+
+void selectTopOutcomes(long long int* candInds, qreal* candProbs, long long int numCands, int k, long long int* inds, qreal* probs);
+
+int generateMeasurementOutcome(Qureg qureg, qreal zeroProb, qreal *outcomeProb);
+
+void populateKrausSuperOperator2(ComplexMatrix4* superOp, ComplexMatrix2* ops, int numOps);
+
+void populateKrausSuperOperator4(ComplexMatrixN* superOp, ComplexMatrix4* ops, int numOps);
+
 
 /*
  * operations upon density matrices 
@@ -80,10 +96,22 @@ qreal densmatr_calcProbOfOutcome(Qureg qureg, int measureQubit, int outcome);
 
 void densmatr_calcProbOfAllOutcomes(qreal* retProbs, Qureg qureg, int* qubits, int numQubits);
 
+void densmatr_sampleOutcomes(Qureg qureg, int* qubits, int numQubits, int numShots, long long int* outcomes);
+
+void densmatr_calcQubitCorrelationSums(Qureg qureg, qreal* sums, int calcPairs);
+
+void densmatr_calcTopKOutcomes(Qureg qureg, int k, long long int* inds, qreal* probs);
+
+void densmatr_calcExpecPauliStrings(Qureg qureg, long long int* xMasks, long long int* zMasks, int numStrings, qreal* expecs);
+
 void densmatr_collapseToKnownProbOutcome(Qureg qureg, int measureQubit, int outcome, qreal outcomeProb);
     
 int densmatr_measureWithStats(Qureg qureg, int measureQubit, qreal *outcomeProb);
 
+void densmatr_collapseToKnownProbMultiOutcome(Qureg qureg, int* qubits, int numQubits, long long int outcome, qreal outcomeProb);
+
+long long int densmatr_measureMultipleWithStats(Qureg qureg, int* qubits, int numQubits, qreal *outcomeProb);
+
 void densmatr_mixDephasing(Qureg qureg, int targetQubit, qreal dephase);
 
 void densmatr_mixTwoQubitDephasing(Qureg qureg, int qubit1, int qubit2, qreal dephase);
@@ -96,18 +124,65 @@ void densmatr_mixTwoQubitDepolarising(Qureg qureg, int qubit1, int qubit2, qreal
 
 void densmatr_mixPauli(Qureg qureg, int qubit, qreal pX, qreal pY, qreal pZ);
 
+void densmatr_mixNoiseChannel(Qureg qureg, int qubit, NoiseChannel channel);
+
+void densmatr_mixNoiseLayer(Qureg qureg, NoiseChannel* channels);
+
+int getNoiseLayerMatrices(
+    Qureg qureg, NoiseChannel* channels, qreal* dephaseFacs, int* targets, qreal* popMatrs, qreal* cohMatrs);
+
+ComplexMatrix4 getNoiseChannelSuperoperator(NoiseChannel channel);
+
 void densmatr_mixDensityMatrix(Qureg combineQureg, qreal otherProb, Qureg otherQureg);
 
+void densmatr_applyKrausSuperoperator(Qureg qureg, int target, ComplexMatrix4 superOp);
+
+void densmatr_applyTwoQubitKrausSuperoperator(Qureg qureg, int target1, int target2, ComplexMatrixN superOp);
+
 void densmatr_mixKrausMap(Qureg qureg, int target, ComplexMatrix2 *ops, int numOps);
 
 void densmatr_mixTwoQubitKrausMap(Qureg qureg, int target1, int target2, ComplexMatrix4 *ops, int numOps);
 
 void densmatr_mixMultiQubitKrausMap(Qureg qureg, int* targets, int numTargets, ComplexMatrixN* ops, int numOps);
 
+void densmatr_mixMultiQubitKrausMapAsSuperoperator(Qureg qureg, int* targets, int numTargets, ComplexMatrixN* ops, int numOps);
+
+int isKrausMapCheaperWithoutSuperoperator(Qureg qureg, int numTargets, int numOps);
+
 void densmatr_applyDiagonalOp(Qureg qureg, DiagonalOp op);
 
 Complex densmatr_calcExpecDiagonalOp(Qureg qureg, DiagonalOp op);
 
+void densmatr_multiControlledUnitary(Qureg qureg, long long int ctrlMask, long long int ctrlFlipMask, int targetQubit, ComplexMatrix2 u);
+
+void densmatr_multiControlledTwoQubitUnitary(Qureg qureg, long long int ctrlMask, int targetQubit1, int targetQubit2, ComplexMatrix4 u);
+
+void densmatr_multiControlledPhaseShiftByTerm(Qureg qureg, long long int mask, Complex term);
+
+void densmatr_multiControlledMultiRotateZ(Qureg qureg, long long int ctrlMask, long long int targMask, qreal angle);
+
+void densmatr_multiControlledPhaseShift(Qureg qureg, long long int mask, qreal angle);
+
+void densmatr_multiControlledPhaseFlip(Qureg qureg, long long int mask);
+
+void densmatr_sGate(Qureg qureg, int targetQubit);
+
+void densmatr_tGate(Qureg qureg, int targetQubit);
+
+void densmatr_hadamard(Qureg qureg, int targetQubit);
+
+void densmatr_compactUnitary(Qureg qureg, long long int ctrlMask, int targetQubit, Complex alpha, Complex beta);
+
+void densmatr_rotateAroundAxis(Qureg qureg, long long int ctrlMask, int rotQubit, qreal angle, Vector axis);
+
+void densmatr_multiControlledMultiQubitNot(Qureg qureg, long long int ctrlMask, long long int targMask);
+
+void densmatr_multiControlledPauliY(Qureg qureg, long long int ctrlMask, int targetQubit);
+
+void densmatr_swapGate(Qureg qureg, int qb1, int qb2);
+
+void densmatr_sqrtSwapGate(Qureg qureg, int qb1, int qb2);
+
 
 /* 
  * operations upon state vectors
@@ -185,9 +260,9 @@ qreal statevec_calcFidelity(Qureg qureg, Qureg pureState);
 
 Complex statevec_calcInnerProduct(Qureg bra, Qureg ket);
 
-qreal statevec_calcExpecPauliProd(Qureg qureg, int* targetQubits, enum pauliOpType* pauliCodes, int numTargets, Qureg workspace);
+qreal statevec_calcExpecPauliProd(Qureg qureg, int* targetQubits, enum pauliOpType* pauliCodes, int numTargets);
 
-qreal statevec_calcExpecPauliSum(Qureg qureg, enum pauliOpType* allCodes, qreal* termCoeffs, int numSumTerms, Qureg workspace);
+qreal statevec_calcExpecPauliSum(Qureg qureg, enum pauliOpType* allCodes, qreal* termCoeffs, int numSumTerms);
 
 void statevec_compactUnitary(Qureg qureg, int targetQubit, Complex alpha, Complex beta);
 
@@ -205,6 +280,8 @@ void statevec_controlledMultiQubitUnitary(Qureg qureg, int ctrl, int* targets, i
 
 void statevec_multiControlledMultiQubitUnitary(Qureg qureg, long long int ctrlMask, int* targs, int numTargs, ComplexMatrixN u);
 
+void statevec_applyGatesInTiles(Qureg qureg, int numTileQubits, ComplexMatrixN* gates, int** targs, int numGates);
+
 void statevec_rotateX(Qureg qureg, int rotQubit, qreal angle);
 
 void statevec_rotateY(Qureg qureg, int rotQubit, qreal angle);
@@ -241,10 +318,22 @@ qreal statevec_calcProbOfOutcome(Qureg qureg, int measureQubit, int outcome);
 
 void statevec_calcProbOfAllOutcomes(qreal* retProbs, Qureg qureg, int* qubits, int numQubits);
 
+void statevec_sampleOutcomes(Qureg qureg, int* qubits, int numQubits, int numShots, long long int* outcomes);
+
+void statevec_calcQubitCorrelationSums(Qureg qureg, qreal* sums, int calcPairs);
+
+void statevec_calcTopKOutcomes(Qureg qureg, int k, long long int* inds, qreal* probs);
+
+void statevec_calcExpecPauliStrings(Qureg qureg, long long int* xMasks, long long int* zMasks, int numStrings, qreal* expecs);
+
 void statevec_collapseToKnownProbOutcome(Qureg qureg, int measureQubit, int outcome, qreal outcomeProb);
 
 int statevec_measureWithStats(Qureg qureg, int measureQubit, qreal *outcomeProb);
 
+void statevec_collapseToKnownProbMultiOutcome(Qureg qureg, int* qubits, int numQubits, long long int outcome, qreal outcomeProb);
+
+long long int statevec_measureMultipleWithStats(Qureg qureg, int* qubits, int numQubits, qreal *outcomeProb);
+
 void statevec_swapQubitAmps(Qureg qureg, int qb1, int qb2);
 
 void statevec_sqrtSwapGate(Qureg qureg, int qb1, int qb2);
@@ -255,6 +344,10 @@ void statevec_multiRotateZ(Qureg qureg, long long int mask, qreal angle);
 
 void statevec_multiControlledMultiRotateZ(Qureg qureg, long long int ctrlMask, long long int targMask, qreal angle);
 
+void statevec_multiRotateZProduct(Qureg qureg, long long int* masks, qreal* angles, int numRotations);
+
+void statevec_multiControlledMultiRotatePauliMasks(Qureg qureg, long long int ctrlMask, long long int xMask, long long int zMask, qreal angle, int applyConj);
+
 void statevec_multiRotatePauli(Qureg qureg, int* targetQubits, enum pauliOpType* targetPaulis, int numTargets, qreal angle, int applyConj);
 
 void statevec_multiControlledMultiRotatePauli(Qureg qureg, long long int ctrlMask, int* targetQubits, enum pauliOpType* targetPaulis, int numTargets, qreal angle, int applyConj);
@@ -263,6 +356,8 @@ void statevec_setWeightedQureg(Complex fac1, Qureg qureg1, Complex fac2, Qureg q
 
 void statevec_applyPauliSum(Qureg inQureg, enum pauliOpType* allCodes, qreal* termCoeffs, int numSumTerms, Qureg outQureg);
 
+void statevec_applyPauliMaskGroups(Qureg inQureg, long long int* groupXMasks, int* groupStarts, int numGroups, long long int* termZMasks, qreal* termCoeffsRe, qreal* termCoeffsIm, Qureg outQureg);
+
 void statevec_applyDiagonalOp(Qureg qureg, DiagonalOp op);
 
 Complex statevec_calcExpecDiagonalOp(Qureg qureg, DiagonalOp op);
@@ -283,6 +378,10 @@ void agnostic_applyTrotterCircuit(Qureg qureg, PauliHamil hamil, qreal time, int
 
 void agnostic_applyQFT(Qureg qureg, int* qubits, int numQubits);
 
+void agnostic_calcExpecPauliStrings(Qureg qureg, enum pauliOpType* allCodes, int numStrings, qreal* expecs);
+
+qreal agnostic_calcExpecPauliHamil(Qureg qureg, PauliHamil hamil);
+
 DiagonalOp agnostic_createDiagonalOp(int numQubits, QuESTEnv env);
 
 void agnostic_destroyDiagonalOp(DiagonalOp op);
@@ -293,6 +392,8 @@ void agnostic_setDiagonalOpElems(DiagonalOp op, long long int startInd, qreal* r
 
 void agnostic_initDiagonalOpFromPauliHamil(DiagonalOp op, PauliHamil hamil);
 
+void agnostic_setPhaseFuncCaching(int cacheTables);
+
 # ifdef __cplusplus
 }
 # endif
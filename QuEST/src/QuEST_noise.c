@@ -0,0 +1,237 @@
+// Distributed under MIT licence. See https://github.com/QuEST-Kit/QuEST/blob/master/LICENCE.txt for details
+
+/** @file
+ * Functions for inducing the channels of the NoiseModel attached to a density matrix after each
+ * of its gates, and before each of its measurements.
+ *
+ * While a model is attached, the Qureg's gate queue defers gates upon at most two qubits, so
+ * that each such gate is still pending when noise_applyGateNoise() is called. The gate U is
+ * then removed from the queue and applied together with the channels E of its qubits as the
+ * single superoperator E (conj(U) (x) U), in one pass over the density matrix. Larger gates are
+ * applied immediately by the caller, and their channels follow in separate passes. The model's
+ * arrays are shared with the user, so that its later modification affects the Qureg.
+ */
+
+# include "QuEST.h"
+# include "QuEST_precision.h"
+# include "QuEST_internal.h"
+# include "QuEST_fusion.h"
+# include "QuEST_noise.h"
+
+# include <stdlib.h>
+
+
+void noise_setup(Qureg* qureg) {
+
+    // a model of zero qubits is never attached
+    qureg->noiseModel = malloc(sizeof *(qureg->noiseModel));
+    qureg->noiseModel->numQubits = 0;
+}
+
+int noise_isAttached(Qureg qureg) {
+
+    return qureg.noiseModel->numQubits > 0;
+}
+
+void noise_attach(Qureg qureg, NoiseModel model) {
+
+    if (!noise_isAttached(qureg))
+        fusion_startDeferring(qureg, 2, 0);
+
+    *(qureg.noiseModel) = model;
+}
+
+void noise_detach(Qureg qureg) {
+
+    if (!noise_isAttached(qureg))
+        return;
+
+    fusion_stopDeferring(qureg);
+    qureg.noiseModel->numQubits = 0;
+}
+
+/** Returns the type of a gate acting upon numGateQubits qubits (including controls) */
+static enum noisyGateType getNoisyGateType(int numGateQubits) {
+
+    if (numGateQubits == 1)
+        return ONE_QUBIT_GATES;
+    if (numGateQubits == 2)
+        return TWO_QUBIT_GATES;
+    return MULTI_QUBIT_GATES;
+}
+
+/** Returns whether the channel at index slot of the model changes the state */
+static int isNoisySlot(NoiseModel* model, int slot) {
+
+    return model->numKrausOps[slot] > 0 || model->channels[slot].type != NO_NOISE;
+}
+
+/** Populates the superoperator of the channel at index slot of the model, upon the row
+ * (least significant) and column bits of its qubit
+ */
+static void getSlotSuperoperator(NoiseModel* model, int slot, ComplexMatrix4* superOp) {
+
+    if (model->numKrausOps[slot] > 0)
+        populateKrausSuperOperator2(superOp, model->krausOps[slot], model->numKrausOps[slot]);
+    else
+        *superOp = getNoiseChannelSuperoperator(model->channels[slot]);
+}
+
+/** Applies the gate u upon numQubits (one or two) qubits, where qubits[0] is the least
+ * significant in u, followed by the channel of each qubit at index offset + qubit of the
+ * model. Element (r, c) of the density matrix restricted to the qubits has index r + c 2^numQubits
+ * in the superoperator, so that its ordering matches densmatr_applyKrausSuperoperator().
+ */
+static void applyGateWithChannels(Qureg qureg, int offset, int* qubits, int numQubits, ComplexMatrix4 u) {
+
+    NoiseModel* model = qureg.noiseModel;
+
+    // a gate whose qubits undergo no noise is applied as usual
+    int isNoisy = 0;
+    for (int q=0; q<numQubits; q++)
+        isNoisy |= isNoisySlot(model, offset + qubits[q]);
+
+    if (!isNoisy) {
+        if (numQubits == 1) {
+            ComplexMatrix2 u2 = {
+                .real = {{u.real[0][0], u.real[0][1]}, {u.real[1][0], u.real[1][1]}},
+                .imag = {{u.imag[0][0], u.imag[0][1]}, {u.imag[1][0], u.imag[1][1]}}};
+            densmatr_multiControlledUnitary(qureg, 0, 0, qubits[0], u2);
+        }
+        else
+            densmatr_multiControlledTwoQubitUnitary(qureg, 0, qubits[0], qubits[1], u);
+        return;
+    }
+
+    ComplexMatrix4 chanOps[2];
+    for (int q=0; q<numQubits; q++)
+        getSlotSuperoperator(model, offset + qubits[q], &chanOps[q]);
+
+    int dim = 1 << numQubits;
+    int superDim = dim * dim;
+
+    // gate = conj(u) (x) u, with element [r + dim c][r' + dim c'] = u[r][r'] conj(u[c][c'])
+    qreal gateRe[16][16], gateIm[16][16];
+    for (int i=0; i<superDim; i++) {
+        for (int j=0; j<superDim; j++) {
+            int r = i % dim, c = i / dim;
+            int r_ = j % dim, c_ = j / dim;
+            gateRe[i][j] = u.real[r][r_]*u.real[c][c_] + u.imag[r][r_]*u.imag[c][c_];
+            gateIm[i][j] = u.imag[r][r_]*u.real[c][c_] - u.real[r][r_]*u.imag[c][c_];
+        }
+    }
+
+    // chan = the product of each qubit's channel upon its row and column bits
+    qreal chanRe[16][16], chanIm[16][16];
+    for (int i=0; i<superDim; i++) {
+        for (int j=0; j<superDim; j++) {
+            qreal re = 1, im = 0;
+            for (int q=0; q<numQubits; q++) {
+                int k = ((i >> q) & 1) | (((i >> (numQubits + q)) & 1) << 1);
+                int l = ((j >> q) & 1) | (((j >> (numQubits + q)) & 1) << 1);
+                qreal opRe = chanOps[q].real[k][l];
+                qreal opIm = chanOps[q].imag[k][l];
+                qreal newRe = re*opRe - im*opIm;
+                im = re*opIm + im*opRe;
+                re = newRe;
+            }
+            chanRe[i][j] = re;
+            chanIm[i][j] = im;
+        }
+    }
+
+    // superOp = chan gate
+    qreal superRe[16][16], superIm[16][16];
+    for (int i=0; i<superDim; i++) {
+        for (int j=0; j<superDim; j++) {
+            superRe[i][j] = 0;
+            superIm[i][j] = 0;
+            for (int k=0; k<superDim; k++) {
+                superRe[i][j] += chanRe[i][k]*gateRe[k][j] - chanIm[i][k]*gateIm[k][j];
+                superIm[i][j] += chanRe[i][k]*gateIm[k][j] + chanIm[i][k]*gateRe[k][j];
+            }
+        }
+    }
+
+    if (numQubits == 1) {
+        ComplexMatrix4 superOp;
+        for (int i=0; i<4; i++) {
+            for (int j=0; j<4; j++) {
+                superOp.real[i][j] = superRe[i][j];
+                superOp.imag[i][j] = superIm[i][j];
+            }
+        }
+        densmatr_applyKrausSuperoperator(qureg, qubits[0], superOp);
+        return;
+    }
+
+    // the two-qubit superoperator is a 4-qubit matrix upon the rows of superRe and superIm
+    qreal* superRows[2][16];
+    for (int i=0; i<16; i++) {
+        superRows[0][i] = superRe[i];
+        superRows[1][i] = superIm[i];
+    }
+    ComplexMatrixN superOp = {.numQubits=4, .real=superRows[0], .imag=superRows[1]};
+    densmatr_applyTwoQubitKrausSuperoperator(qureg, qubits[0], qubits[1], superOp);
+}
+
+void noise_applyGateNoise(Qureg qureg, int* ctrls, int numCtrls, int* targs, int numTargs) {
+
+    if (!noise_isAttached(qureg))
+        return;
+
+    NoiseModel* model = qureg.noiseModel;
+    int offset = getNoisyGateType(numCtrls + numTargs) * model->numQubits;
+
+    // a gate of one or two qubits is still pending, to be applied with its channels
+    int qubits[2];
+    ComplexMatrix4 u;
+    int numQubits = fusion_popFusedGate(qureg, qubits, &u);
+    if (numQubits > 0) {
+        applyGateWithChannels(qureg, offset, qubits, numQubits, u);
+        return;
+    }
+
+    // otherwise the gate was already applied; its custom maps follow one at a time, and its
+    // remaining channels together as a noise layer
+    NoiseChannel* layer = NULL;
+    for (int i=0; i<numCtrls + numTargs; i++) {
+        int qubit = (i < numCtrls)? ctrls[i] : targs[i - numCtrls];
+        int slot = offset + qubit;
+
+        if (model->numKrausOps[slot] > 0)
+            densmatr_mixKrausMap(qureg, qubit, model->krausOps[slot], model->numKrausOps[slot]);
+
+        else if (model->channels[slot].type != NO_NOISE) {
+            if (layer == NULL) {
+                layer = malloc(model->numQubits * sizeof *layer);
+                for (int q=0; q<model->numQubits; q++)
+                    layer[q].type = NO_NOISE;
+            }
+            layer[qubit] = model->channels[slot];
+        }
+    }
+
+    if (layer != NULL) {
+        densmatr_mixNoiseLayer(qureg, layer);
+        free(layer);
+    }
+}
+
+void noise_applyReadoutNoise(Qureg qureg, int measureQubit) {
+
+    if (!noise_isAttached(qureg))
+        return;
+
+    qreal prob = qureg.noiseModel->readoutErrorProbs[measureQubit];
+    if (prob == 0)
+        return;
+
+    NoiseChannel flip = {.type=PAULI_NOISE, .prob=0, .probX=prob, .probY=0, .probZ=0};
+    densmatr_mixNoiseChannel(qureg, measureQubit, flip);
+}
+
+void noise_free(Qureg qureg) {
+
+    free(qureg.noiseModel);
+}
@@ -0,0 +1,41 @@
+// Distributed under MIT licence. See https://github.com/QuEST-Kit/QuEST/blob/master/LICENCE.txt for details
+
+/** @file
+ * Functions for inducing the channels of the NoiseModel attached to a density matrix after each
+ * of its gates, and before each of its measurements. Gates report their qubits through
+ * noise_applyGateNoise() after being applied (or deferred), and noise_applyReadoutNoise() is
+ * called before measuring.
+ */
+
+# ifndef QUEST_NOISE_H
+# define QUEST_NOISE_H
+
+# include "QuEST.h"
+# include "QuEST_precision.h"
+
+# ifdef __cplusplus
+extern "C" {
+# endif
+
+/** the number of values of enum noisyGateType */
+# define NUM_NOISY_GATE_TYPES 3
+
+void noise_setup(Qureg* qureg);
+
+void noise_attach(Qureg qureg, NoiseModel model);
+
+void noise_detach(Qureg qureg);
+
+int noise_isAttached(Qureg qureg);
+
+void noise_applyGateNoise(Qureg qureg, int* ctrls, int numCtrls, int* targs, int numTargs);
+
+void noise_applyReadoutNoise(Qureg qureg, int measureQubit);
+
+void noise_free(Qureg qureg);
+
+# ifdef __cplusplus
+}
+# endif
+
+# endif // QUEST_NOISE_H
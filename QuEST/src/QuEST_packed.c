@@ -0,0 +1,1032 @@
+// Distributed under MIT licence. See https://github.com/QuEST-Kit/QuEST/blob/master/LICENCE.txt for details
+
+/** @file
+ * Packed (upper-triangular) storage of Hermitian density matrices, which halves the memory
+ * of a density Qureg. The packed state lives in host memory (qureg.stateVec) and is never
+ * distributed, so these functions serve every backend.
+ *
+ * Only operations which map Hermitian matrices to Hermitian matrices are supported; each
+ * is effected upon the stored triangle alone. An operation upon a block of elements (r, c)
+ * which differ only in target bits is performed once per block with r <= c (excluding target
+ * bits), reading any element of the lower triangle as the conjugate of its stored mirror,
+ * and writing it back as such. Triangular loops over columns are performed in
+ * pairs of columns (c, numCols-1-c), which together contain numCols+1 rows, so that a static
+ * OpenMP schedule remains balanced.
+ */
+
+# include "QuEST.h"
+# include "QuEST_precision.h"
+# include "QuEST_internal.h"
+# include "QuEST_packed.h"
+
+# include <math.h>
+# include <stdio.h>
+# include <stdint.h>
+# include <stdlib.h>
+# include <string.h>
+
+
+/* the index of element (row, col) with row <= col in the packed triangle */
+static inline long long int getPackedIndex(long long int row, long long int col) {
+    return (col*(col+1))/2 + row;
+}
+
+static inline long long int insertZeroBit(long long int number, int index) {
+    long long int left = (number >> index) << index;
+    return (left << 1) ^ (number - left);
+}
+
+static inline long long int insertTwoZeroBits(long long int number, int bit1, int bit2) {
+    int small = (bit1 < bit2)? bit1 : bit2;
+    int big = (bit1 < bit2)? bit2 : bit1;
+    return insertZeroBit(insertZeroBit(number, small), big);
+}
+
+static inline int getBitMaskParity(long long int mask) {
+    int parity = 0;
+    while (mask) {
+        parity = !parity;
+        mask = mask & (mask-1);
+    }
+    return parity;
+}
+
+/* the column processed by side (0 or 1) of the given column pair, or -1 if the central
+ * column (when numCols is odd) was already processed by side 0 */
+static inline long long int getPairedColumn(long long int pair, int side, long long int numCols) {
+    long long int col = (side == 0)? pair : numCols - 1 - pair;
+    return (side == 1 && col == pair)? -1 : col;
+}
+
+static inline void loadAmp(
+    qreal* vecRe, qreal* vecIm, long long int row, long long int col, qreal* re, qreal* im
+) {
+    if (row <= col) {
+        long long int ind = getPackedIndex(row, col);
+        *re = vecRe[AMP_INDEX(ind)];
+        *im = vecIm[AMP_INDEX(ind)];
+    } else {
+        long long int ind = getPackedIndex(col, row);
+        *re = vecRe[AMP_INDEX(ind)];
+        *im = - vecIm[AMP_INDEX(ind)];
+    }
+}
+
+/* an element of the lower triangle is stored as the conjugate of its mirror, unless skipLower
+ * (when the mirror is itself stored by the caller) */
+static inline void storeAmp(
+    qreal* vecRe, qreal* vecIm, long long int row, long long int col, qreal re, qreal im, int skipLower
+) {
+    long long int ind;
+    if (row <= col) {
+        ind = getPackedIndex(row, col);
+        vecRe[AMP_INDEX(ind)] = re;
+        vecIm[AMP_INDEX(ind)] = im;
+    } else if (!skipLower) {
+        ind = getPackedIndex(col, row);
+        vecRe[AMP_INDEX(ind)] = re;
+        vecIm[AMP_INDEX(ind)] = - im;
+    }
+}
+
+/** Overwrites the amplitude pair (re0,im0), (re1,im1) with u (or conj(u), if conjFac=-1)
+ * multiplied upon it */
+static inline void applyMatrix2ToPair(
+    ComplexMatrix2* u, qreal conjFac, qreal* re0, qreal* im0, qreal* re1, qreal* im1
+) {
+    qreal r0=*re0, i0=*im0, r1=*re1, i1=*im1;
+    *re0 = u->real[0][0]*r0 - conjFac*u->imag[0][0]*i0 + u->real[0][1]*r1 - conjFac*u->imag[0][1]*i1;
+    *im0 = u->real[0][0]*i0 + conjFac*u->imag[0][0]*r0 + u->real[0][1]*i1 + conjFac*u->imag[0][1]*r1;
+    *re1 = u->real[1][0]*r0 - conjFac*u->imag[1][0]*i0 + u->real[1][1]*r1 - conjFac*u->imag[1][1]*i1;
+    *im1 = u->real[1][0]*i0 + conjFac*u->imag[1][0]*r0 + u->real[1][1]*i1 + conjFac*u->imag[1][1]*r1;
+}
+
+/** Overwrites the four amplitudes re[inds[k]], im[inds[k]] with u (or conj(u), if conjFac=-1)
+ * multiplied upon them */
+static inline void applyMatrix4ToQuad(ComplexMatrix4* u, qreal conjFac, qreal* re, qreal* im, int* inds) {
+
+    qreal r[4], i[4];
+    for (int k=0; k<4; k++) {
+        r[k] = re[inds[k]];
+        i[k] = im[inds[k]];
+    }
+    for (int k=0; k<4; k++) {
+        qreal sumRe = 0;
+        qreal sumIm = 0;
+        for (int l=0; l<4; l++) {
+            sumRe += u->real[k][l]*r[l] - conjFac*u->imag[k][l]*i[l];
+            sumIm += u->real[k][l]*i[l] + conjFac*u->imag[k][l]*r[l];
+        }
+        re[inds[k]] = sumRe;
+        im[inds[k]] = sumIm;
+    }
+}
+
+
+/*
+ * management
+ */
+
+void packed_createQureg(Qureg* qureg, int numQubits, QuESTEnv env) {
+
+    long long int dim = 1LL << numQubits;
+    long long int numAmps = getPackedIndex(0, dim); // dim(dim+1)/2
+
+    if ((unsigned long long int) numAmps > SIZE_MAX) {
+        printf("Could not allocate memory (cannot fit numAmps into size_t)!");
+        exit (EXIT_FAILURE);
+    }
+
+    size_t arrSize = (size_t) (numAmps * sizeof(*(qureg->stateVec.real)));
+# ifdef INTERLEAVED_AMPS
+    qureg->stateVec.real = malloc(2 * arrSize);
+    qureg->stateVec.imag = (qureg->stateVec.real)? qureg->stateVec.real + 1 : NULL;
+# else
+    qureg->stateVec.real = malloc(arrSize);
+    qureg->stateVec.imag = malloc(arrSize);
+# endif
+    if (!(qureg->stateVec.real) || !(qureg->stateVec.imag)) {
+        printf("Could not allocate memory!");
+        exit (EXIT_FAILURE);
+    }
+
+    // the packed state is never exchanged nor copied to an accelerator
+    qureg->pairStateVec.real = NULL;
+    qureg->pairStateVec.imag = NULL;
+    qureg->deviceStateVec.real = NULL;
+    qureg->deviceStateVec.imag = NULL;
+    qureg->firstLevelReduction = NULL;
+    qureg->secondLevelReduction = NULL;
+
+    qureg->isDensityMatrix = 1;
+    qureg->isPackedDensityMatrix = 1;
+    qureg->numQubitsRepresented = numQubits;
+    qureg->numQubitsInStateVec = 2*numQubits;
+    qureg->numAmpsTotal = numAmps;
+    qureg->numAmpsPerChunk = numAmps;
+    qureg->chunkId = env.rank;
+    qureg->numChunks = 1;
+}
+
+void packed_destroyQureg(Qureg qureg) {
+
+    free(qureg.stateVec.real);
+# ifndef INTERLEAVED_AMPS
+    free(qureg.stateVec.imag);
+# endif
+}
+
+void packed_cloneQureg(Qureg targetQureg, Qureg copyQureg) {
+
+    size_t arrSize = (size_t) (copyQureg.numAmpsPerChunk * sizeof(*(copyQureg.stateVec.real)));
+# ifdef INTERLEAVED_AMPS
+    memcpy(targetQureg.stateVec.real, copyQureg.stateVec.real, 2 * arrSize);
+# else
+    memcpy(targetQureg.stateVec.real, copyQureg.stateVec.real, arrSize);
+    memcpy(targetQureg.stateVec.imag, copyQureg.stateVec.imag, arrSize);
+# endif
+}
+
+
+/*
+ * initialisation
+ */
+
+static void setAllPackedAmps(Qureg qureg, qreal re, qreal im) {
+
+    long long int numAmps = qureg.numAmpsPerChunk;
+    qreal *vecRe = qureg.stateVec.real;
+    qreal *vecIm = qureg.stateVec.imag;
+    long long int index;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (numAmps, vecRe,vecIm, re,im) \
+    private  (index)
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (index=0; index<numAmps; index++) {
+            vecRe[AMP_INDEX(index)] = re;
+            vecIm[AMP_INDEX(index)] = im;
+        }
+    }
+}
+
+void packed_initBlankState(Qureg qureg) {
+
+    setAllPackedAmps(qureg, 0, 0);
+}
+
+void packed_initClassicalState(Qureg qureg, long long int stateInd) {
+
+    setAllPackedAmps(qureg, 0, 0);
+    storeAmp(qureg.stateVec.real, qureg.stateVec.imag, stateInd, stateInd, 1, 0, 0);
+}
+
+void packed_initZeroState(Qureg qureg) {
+
+    packed_initClassicalState(qureg, 0);
+}
+
+void packed_initPlusState(Qureg qureg) {
+
+    qreal prob = 1.0/((qreal) (1LL << qureg.numQubitsRepresented));
+    setAllPackedAmps(qureg, prob, 0);
+}
+
+void packed_initPureState(Qureg qureg, Qureg pureState) {
+
+    copyStateFromGPU(pureState);
+
+    long long int numCols = 1LL << qureg.numQubitsRepresented;
+    long long int numPairs = (numCols + 1)/2;
+    qreal *vecRe = qureg.stateVec.real;
+    qreal *vecIm = qureg.stateVec.imag;
+    qreal *pureRe = pureState.stateVec.real;
+    qreal *pureIm = pureState.stateVec.imag;
+
+    long long int pair, col, row, ind;
+    int side;
+    qreal colRe, colIm, rowRe, rowIm;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (numCols,numPairs, vecRe,vecIm, pureRe,pureIm) \
+    private  (pair,side,col,row,ind, colRe,colIm,rowRe,rowIm)
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (pair=0; pair<numPairs; pair++) {
+            for (side=0; side<2; side++) {
+                col = getPairedColumn(pair, side, numCols);
+                if (col < 0)
+                    continue;
+
+                // rho_rc = psi_r conj(psi_c)
+                colRe = pureRe[AMP_INDEX(col)];
+                colIm = pureIm[AMP_INDEX(col)];
+                for (row=0; row<=col; row++) {
+                    rowRe = pureRe[AMP_INDEX(row)];
+                    rowIm = pureIm[AMP_INDEX(row)];
+                    ind = getPackedIndex(row, col);
+                    vecRe[AMP_INDEX(ind)] = rowRe*colRe + rowIm*colIm;
+                    vecIm[AMP_INDEX(ind)] = rowIm*colRe - rowRe*colIm;
+                }
+            }
+        }
+    }
+}
+
+Complex packed_getDensityAmp(Qureg qureg, long long int row, long long int col) {
+
+    Complex amp;
+    loadAmp(qureg.stateVec.real, qureg.stateVec.imag, row, col, &amp.real, &amp.imag);
+    return amp;
+}
+
+
+/*
+ * unitaries
+ */
+
+/** Effects rho -> U rho U^dagger as densmatr_multiControlledUnitaryLocal(), but upon only the
+ * quads of elements whose row is not greater than their column (ignoring the target bit).
+ * Every other quad is the conjugate transpose of a processed one, so its stored elements are
+ * written as conjugates of the lower-triangle elements of the processed quad.
+ */
+void packed_multiControlledUnitary(
+    Qureg qureg, long long int ctrlMask, long long int ctrlFlipMask, int targetQubit, ComplexMatrix2 u
+) {
+    long long int numCols = 1LL << (qureg.numQubitsRepresented - 1);
+    long long int numPairs = (numCols + 1)/2;
+    long long int targMask = 1LL << targetQubit;
+    qreal *vecRe = qureg.stateVec.real;
+    qreal *vecIm = qureg.stateVec.imag;
+
+    long long int pair, col, row, rows[2], cols[2];
+    int side, i, j, rowCtrl, colCtrl;
+    qreal re[2][2], im[2][2];
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (numCols,numPairs, targetQubit,targMask,ctrlMask,ctrlFlipMask, vecRe,vecIm, u) \
+    private  (pair,side,col,row,rows,cols, i,j, rowCtrl,colCtrl, re,im)
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (pair=0; pair<numPairs; pair++) {
+            for (side=0; side<2; side++) {
+                col = getPairedColumn(pair, side, numCols);
+                if (col < 0)
+                    continue;
+
+                cols[0] = insertZeroBit(col, targetQubit);
+                cols[1] = cols[0] | targMask;
+                colCtrl = (((cols[0] ^ ctrlFlipMask) & ctrlMask) == ctrlMask);
+
+                for (row=0; row<=col; row++) {
+                    rows[0] = insertZeroBit(row, targetQubit);
+                    rows[1] = rows[0] | targMask;
+                    rowCtrl = (((rows[0] ^ ctrlFlipMask) & ctrlMask) == ctrlMask);
+                    if (!rowCtrl && !colCtrl)
+                        continue;
+
+                    for (i=0; i<2; i++)
+                        for (j=0; j<2; j++)
+                            loadAmp(vecRe, vecIm, rows[i], cols[j], &re[i][j], &im[i][j]);
+
+                    // U rho, upon both columns, then rho U^dagger, upon both rows
+                    if (rowCtrl)
+                        for (j=0; j<2; j++)
+                            applyMatrix2ToPair(&u, 1, &re[0][j], &im[0][j], &re[1][j], &im[1][j]);
+                    if (colCtrl)
+                        for (i=0; i<2; i++)
+                            applyMatrix2ToPair(&u, -1, &re[i][0], &im[i][0], &re[i][1], &im[i][1]);
+
+                    for (i=0; i<2; i++)
+                        for (j=0; j<2; j++)
+                            storeAmp(vecRe, vecIm, rows[i], cols[j], re[i][j], im[i][j], row==col);
+                }
+            }
+        }
+    }
+}
+
+/** Effects rho -> U rho U^dagger as densmatr_multiControlledTwoQubitUnitaryLocal(), but upon
+ * only the blocks of 16 elements whose row is not greater than their column (ignoring target bits).
+ */
+void packed_multiControlledTwoQubitUnitary(
+    Qureg qureg, long long int ctrlMask, int targetQubit1, int targetQubit2, ComplexMatrix4 u
+) {
+    long long int numCols = 1LL << (qureg.numQubitsRepresented - 2);
+    long long int numPairs = (numCols + 1)/2;
+    qreal *vecRe = qureg.stateVec.real;
+    qreal *vecIm = qureg.stateVec.imag;
+
+    // the basis state k of the targets (where bit 0 is targetQubit1) has offset offs[k]
+    long long int offs[4];
+    for (int k=0; k<4; k++)
+        offs[k] = ((k & 1LL) << targetQubit1) | (((k >> 1) & 1LL) << targetQubit2);
+
+    // the 16 elements, with row k and column l at [4*k + l]
+    int rowInds[4][4] = {{0,4,8,12}, {1,5,9,13}, {2,6,10,14}, {3,7,11,15}}; // [l][k]
+    int colInds[4][4] = {{0,1,2,3}, {4,5,6,7}, {8,9,10,11}, {12,13,14,15}}; // [k][l]
+
+    long long int pair, col, row, row0, col0;
+    int side, k, l, rowCtrl, colCtrl;
+    qreal re[16], im[16];
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (numCols,numPairs, targetQubit1,targetQubit2,ctrlMask, vecRe,vecIm, u, offs,rowInds,colInds) \
+    private  (pair,side,col,row,row0,col0, k,l, rowCtrl,colCtrl, re,im)
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (pair=0; pair<numPairs; pair++) {
+            for (side=0; side<2; side++) {
+                col = getPairedColumn(pair, side, numCols);
+                if (col < 0)
+                    continue;
+
+                col0 = insertTwoZeroBits(col, targetQubit1, targetQubit2);
+                colCtrl = ((col0 & ctrlMask) == ctrlMask);
+
+                for (row=0; row<=col; row++) {
+                    row0 = insertTwoZeroBits(row, targetQubit1, targetQubit2);
+                    rowCtrl = ((row0 & ctrlMask) == ctrlMask);
+                    if (!rowCtrl && !colCtrl)
+                        continue;
+
+                    for (k=0; k<4; k++)
+                        for (l=0; l<4; l++)
+                            loadAmp(vecRe, vecIm, row0 | offs[k], col0 | offs[l], &re[4*k+l], &im[4*k+l]);
+
+                    if (rowCtrl)
+                        for (l=0; l<4; l++)
+                            applyMatrix4ToQuad(&u, 1, re, im, rowInds[l]);
+                    if (colCtrl)
+                        for (k=0; k<4; k++)
+                            applyMatrix4ToQuad(&u, -1, re, im, colInds[k]);
+
+                    for (k=0; k<4; k++)
+                        for (l=0; l<4; l++)
+                            storeAmp(vecRe, vecIm, row0 | offs[k], col0 | offs[l], re[4*k+l], im[4*k+l], row==col);
+                }
+            }
+        }
+    }
+}
+
+/** Effects rho -> D rho D^dagger as densmatr_multiControlledPhaseShiftByTerm(), upon the
+ * stored triangle */
+void packed_multiControlledPhaseShiftByTerm(Qureg qureg, long long int mask, Complex term) {
+
+    long long int numCols = 1LL << qureg.numQubitsRepresented;
+    long long int numPairs = (numCols + 1)/2;
+    qreal *vecRe = qureg.stateVec.real;
+    qreal *vecIm = qureg.stateVec.imag;
+    qreal termReal = term.real;
+    qreal termImag = term.imag;
+
+    long long int pair, col, row, ind;
+    int side, rowSet, colSet;
+    qreal stateReal, stateImag, facImag;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (numCols,numPairs, mask, vecRe,vecIm, termReal,termImag) \
+    private  (pair,side,col,row,ind, rowSet,colSet, stateReal,stateImag,facImag)
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (pair=0; pair<numPairs; pair++) {
+            for (side=0; side<2; side++) {
+                col = getPairedColumn(pair, side, numCols);
+                if (col < 0)
+                    continue;
+
+                colSet = ((col & mask) == mask);
+                for (row=0; row<=col; row++) {
+                    rowSet = ((row & mask) == mask);
+                    if (rowSet == colSet)
+                        continue;
+
+                    // multiply by term (when only the row is set) else conj(term)
+                    facImag = (rowSet)? termImag : - termImag;
+                    ind = getPackedIndex(row, col);
+                    stateReal = vecRe[AMP_INDEX(ind)];
+                    stateImag = vecIm[AMP_INDEX(ind)];
+                    vecRe[AMP_INDEX(ind)] = termReal*stateReal - facImag*stateImag;
+                    vecIm[AMP_INDEX(ind)] = termReal*stateImag + facImag*stateReal;
+                }
+            }
+        }
+    }
+}
+
+/** Effects rho -> R rho R^dagger as densmatr_multiControlledMultiRotateZ(), upon the stored
+ * triangle */
+void packed_multiControlledMultiRotateZ(Qureg qureg, long long int ctrlMask, long long int targMask, qreal angle) {
+
+    long long int numCols = 1LL << qureg.numQubitsRepresented;
+    long long int numPairs = (numCols + 1)/2;
+    qreal *vecRe = qureg.stateVec.real;
+    qreal *vecIm = qureg.stateVec.imag;
+    qreal cosAngle = cos(angle/2);
+    qreal sinAngle = sin(angle/2);
+
+    long long int pair, col, row, ind;
+    int side, rowCtrl, colCtrl;
+    qreal stateReal, stateImag, newReal, sinPhase, colSinPhase;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (numCols,numPairs, ctrlMask,targMask, vecRe,vecIm, cosAngle,sinAngle) \
+    private  (pair,side,col,row,ind, rowCtrl,colCtrl, stateReal,stateImag,newReal,sinPhase,colSinPhase)
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (pair=0; pair<numPairs; pair++) {
+            for (side=0; side<2; side++) {
+                col = getPairedColumn(pair, side, numCols);
+                if (col < 0)
+                    continue;
+
+                // the column contributes the conjugate of its phase
+                colCtrl = ((col & ctrlMask) == ctrlMask);
+                colSinPhase = (getBitMaskParity(col & targMask))? - sinAngle : sinAngle;
+
+                for (row=0; row<=col; row++) {
+                    rowCtrl = ((row & ctrlMask) == ctrlMask);
+                    if (!rowCtrl && !colCtrl)
+                        continue;
+
+                    ind = getPackedIndex(row, col);
+                    stateReal = vecRe[AMP_INDEX(ind)];
+                    stateImag = vecIm[AMP_INDEX(ind)];
+
+                    // the row contributes exp(-i angle/2) when of even parity, else exp(i angle/2)
+                    if (rowCtrl) {
+                        sinPhase = (getBitMaskParity(row & targMask))? sinAngle : - sinAngle;
+                        newReal = cosAngle*stateReal - sinPhase*stateImag;
+                        stateImag = cosAngle*stateImag + sinPhase*stateReal;
+                        stateReal = newReal;
+                    }
+                    if (colCtrl) {
+                        newReal = cosAngle*stateReal - colSinPhase*stateImag;
+                        stateImag = cosAngle*stateImag + colSinPhase*stateReal;
+                        stateReal = newReal;
+                    }
+                    vecRe[AMP_INDEX(ind)] = stateReal;
+                    vecIm[AMP_INDEX(ind)] = stateImag;
+                }
+            }
+        }
+    }
+}
+
+
+/*
+ * decoherence
+ */
+
+/** Effects the Kraus map with the given superoperator (as populated by
+ * populateKrausSuperOperator2()) upon each quad of elements differing in the target bits
+ * of their row and column. The superoperator acts upon the quad as a vector with index
+ * (row bit) + 2 (column bit).
+ */
+void packed_applyKrausSuperoperator(Qureg qureg, int target, ComplexMatrix4 superOp) {
+
+    long long int numCols = 1LL << (qureg.numQubitsRepresented - 1);
+    long long int numPairs = (numCols + 1)/2;
+    long long int targMask = 1LL << target;
+    qreal *vecRe = qureg.stateVec.real;
+    qreal *vecIm = qureg.stateVec.imag;
+    int quadInds[4] = {0, 1, 2, 3};
+
+    long long int pair, col, row, rows[2], cols[2];
+    int side, i, j;
+    qreal re[4], im[4];
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (numCols,numPairs, target,targMask, vecRe,vecIm, superOp,quadInds) \
+    private  (pair,side,col,row,rows,cols, i,j, re,im)
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (pair=0; pair<numPairs; pair++) {
+            for (side=0; side<2; side++) {
+                col = getPairedColumn(pair, side, numCols);
+                if (col < 0)
+                    continue;
+
+                cols[0] = insertZeroBit(col, target);
+                cols[1] = cols[0] | targMask;
+
+                for (row=0; row<=col; row++) {
+                    rows[0] = insertZeroBit(row, target);
+                    rows[1] = rows[0] | targMask;
+
+                    for (i=0; i<2; i++)
+                        for (j=0; j<2; j++)
+                            loadAmp(vecRe, vecIm, rows[i], cols[j], &re[i + 2*j], &im[i + 2*j]);
+
+                    applyMatrix4ToQuad(&superOp, 1, re, im, quadInds);
+
+                    for (i=0; i<2; i++)
+                        for (j=0; j<2; j++)
+                            storeAmp(vecRe, vecIm, rows[i], cols[j], re[i + 2*j], im[i + 2*j], row==col);
+                }
+            }
+        }
+    }
+}
+
+/** Effects the two-qubit Kraus map with the given 16x16 superoperator (as populated by
+ * populateKrausSuperOperator4()) upon each block of 16 elements differing in the target bits
+ * of their row and column, treated as a vector with index (row targets) + 4 (column targets).
+ */
+void packed_applyTwoQubitKrausSuperoperator(Qureg qureg, int target1, int target2, ComplexMatrixN superOp) {
+
+    long long int numCols = 1LL << (qureg.numQubitsRepresented - 2);
+    long long int numPairs = (numCols + 1)/2;
+    qreal *vecRe = qureg.stateVec.real;
+    qreal *vecIm = qureg.stateVec.imag;
+    qreal **opRe = superOp.real;
+    qreal **opIm = superOp.imag;
+
+    long long int offs[4];
+    for (int k=0; k<4; k++)
+        offs[k] = ((k & 1LL) << target1) | (((k >> 1) & 1LL) << target2);
+
+    long long int pair, col, row, row0, col0;
+    int side, k, l, m, n;
+    qreal re[16], im[16], sumRe, sumIm;
+    qreal newRe[16], newIm[16];
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (numCols,numPairs, target1,target2, vecRe,vecIm, opRe,opIm, offs) \
+    private  (pair,side,col,row,row0,col0, k,l,m,n, re,im,newRe,newIm,sumRe,sumIm)
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (pair=0; pair<numPairs; pair++) {
+            for (side=0; side<2; side++) {
+                col = getPairedColumn(pair, side, numCols);
+                if (col < 0)
+                    continue;
+
+                col0 = insertTwoZeroBits(col, target1, target2);
+                for (row=0; row<=col; row++) {
+                    row0 = insertTwoZeroBits(row, target1, target2);
+
+                    for (k=0; k<4; k++)
+                        for (l=0; l<4; l++)
+                            loadAmp(vecRe, vecIm, row0 | offs[k], col0 | offs[l], &re[k + 4*l], &im[k + 4*l]);
+
+                    for (m=0; m<16; m++) {
+                        sumRe = 0;
+                        sumIm = 0;
+                        for (n=0; n<16; n++) {
+                            sumRe += opRe[m][n]*re[n] - opIm[m][n]*im[n];
+                            sumIm += opRe[m][n]*im[n] + opIm[m][n]*re[n];
+                        }
+                        newRe[m] = sumRe;
+                        newIm[m] = sumIm;
+                    }
+
+                    for (k=0; k<4; k++)
+                        for (l=0; l<4; l++)
+                            storeAmp(vecRe, vecIm, row0 | offs[k], col0 | offs[l], newRe[k + 4*l], newIm[k + 4*l], row==col);
+                }
+            }
+        }
+    }
+}
+
+/* populates op with fac times the given Pauli matrix */
+static void setPauliMatrix(ComplexMatrix2* op, enum pauliOpType code, qreal fac) {
+
+    *op = (ComplexMatrix2) {.real={{0}}, .imag={{0}}};
+    switch (code) {
+        case PAULI_I: op->real[0][0] =  fac; op->real[1][1] =  fac; break;
+        case PAULI_X: op->real[0][1] =  fac; op->real[1][0] =  fac; break;
+        case PAULI_Y: op->imag[0][1] = -fac; op->imag[1][0] =  fac; break;
+        case PAULI_Z: op->real[0][0] =  fac; op->real[1][1] = -fac; break;
+    }
+}
+
+/* the Kraus map of Pauli errors, each with the given probability, upon a single qubit */
+static void mixOneQubitPauliErrors(Qureg qureg, int targetQubit, qreal probX, qreal probY, qreal probZ) {
+
+    ComplexMatrix2 ops[4];
+    setPauliMatrix(&ops[0], PAULI_I, sqrt(1 - (probX + probY + probZ)));
+    setPauliMatrix(&ops[1], PAULI_X, sqrt(probX));
+    setPauliMatrix(&ops[2], PAULI_Y, sqrt(probY));
+    setPauliMatrix(&ops[3], PAULI_Z, sqrt(probZ));
+
+    ComplexMatrix4 superOp;
+    populateKrausSuperOperator2(&superOp, ops, 4);
+    packed_applyKrausSuperoperator(qureg, targetQubit, superOp);
+}
+
+/* the Kraus map of the two-qubit Pauli products in codes (each pair {code of qubit1, code of
+ * qubit2}), each with probability prob, alongside the identity */
+static void mixTwoQubitPauliErrors(Qureg qureg, int qubit1, int qubit2, int codes[][2], int numCodes, qreal prob) {
+
+    ComplexMatrix4 ops[16];
+    ComplexMatrix2 p1, p2;
+    for (int n=0; n <= numCodes; n++) {
+        if (n == 0) {
+            setPauliMatrix(&p1, PAULI_I, sqrt(1 - numCodes*prob));
+            setPauliMatrix(&p2, PAULI_I, 1);
+        } else {
+            setPauliMatrix(&p1, codes[n-1][0], sqrt(prob));
+            setPauliMatrix(&p2, codes[n-1][1], 1);
+        }
+
+        // qubit1 is the least significant of the 4x4 operator
+        for (int k=0; k<4; k++)
+            for (int l=0; l<4; l++) {
+                int k1=k&1, l1=l&1, k2=k>>1, l2=l>>1;
+                ops[n].real[k][l] = p1.real[k1][l1]*p2.real[k2][l2] - p1.imag[k1][l1]*p2.imag[k2][l2];
+                ops[n].imag[k][l] = p1.real[k1][l1]*p2.imag[k2][l2] + p1.imag[k1][l1]*p2.real[k2][l2];
+            }
+    }
+
+    ComplexMatrixN superOp = createComplexMatrixN(4);
+    populateKrausSuperOperator4(&superOp, ops, numCodes + 1);
+    packed_applyTwoQubitKrausSuperoperator(qureg, qubit1, qubit2, superOp);
+    destroyComplexMatrixN(superOp);
+}
+
+void packed_mixDephasing(Qureg qureg, int targetQubit, qreal prob) {
+
+    mixOneQubitPauliErrors(qureg, targetQubit, 0, 0, prob);
+}
+
+void packed_mixDepolarising(Qureg qureg, int targetQubit, qreal prob) {
+
+    mixOneQubitPauliErrors(qureg, targetQubit, prob/3, prob/3, prob/3);
+}
+
+void packed_mixDamping(Qureg qureg, int targetQubit, qreal prob) {
+
+    ComplexMatrix2 ops[2] = {
+        {.real={{1,0},{0,sqrt(1-prob)}}, .imag={{0}}},
+        {.real={{0,sqrt(prob)},{0,0}}, .imag={{0}}}
+    };
+
+    ComplexMatrix4 superOp;
+    populateKrausSuperOperator2(&superOp, ops, 2);
+    packed_applyKrausSuperoperator(qureg, targetQubit, superOp);
+}
+
+void packed_mixTwoQubitDephasing(Qureg qureg, int qubit1, int qubit2, qreal prob) {
+
+    int codes[3][2] = {{PAULI_Z,PAULI_I}, {PAULI_I,PAULI_Z}, {PAULI_Z,PAULI_Z}};
+    mixTwoQubitPauliErrors(qureg, qubit1, qubit2, codes, 3, prob/3);
+}
+
+void packed_mixTwoQubitDepolarising(Qureg qureg, int qubit1, int qubit2, qreal prob) {
+
+    // every Pauli product but the identity
+    int codes[15][2];
+    for (int n=1; n<16; n++) {
+        codes[n-1][0] = n % 4;
+        codes[n-1][1] = n / 4;
+    }
+    mixTwoQubitPauliErrors(qureg, qubit1, qubit2, codes, 15, prob/15);
+}
+
+
+/*
+ * calculations
+ */
+
+qreal packed_calcTotalProb(Qureg qureg) {
+
+    long long int dim = 1LL << qureg.numQubitsRepresented;
+    qreal *vecRe = qureg.stateVec.real;
+    qreal total = 0;
+    long long int index;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (dim, vecRe) \
+    private  (index) \
+    reduction ( +:total )
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (index=0; index<dim; index++)
+            total += vecRe[AMP_INDEX(getPackedIndex(index, index))];
+    }
+    return total;
+}
+
+/* Tr(rho^2) = sum_rc |rho_rc|^2, where each strictly upper element appears twice */
+qreal packed_calcPurity(Qureg qureg) {
+
+    long long int numCols = 1LL << qureg.numQubitsRepresented;
+    long long int numPairs = (numCols + 1)/2;
+    qreal *vecRe = qureg.stateVec.real;
+    qreal *vecIm = qureg.stateVec.imag;
+    qreal purity = 0;
+
+    long long int pair, col, row, ind;
+    int side;
+    qreal re, im, offDiagSum;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (numCols,numPairs, vecRe,vecIm) \
+    private  (pair,side,col,row,ind, re,im,offDiagSum) \
+    reduction ( +:purity )
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (pair=0; pair<numPairs; pair++) {
+            for (side=0; side<2; side++) {
+                col = getPairedColumn(pair, side, numCols);
+                if (col < 0)
+                    continue;
+
+                offDiagSum = 0;
+                for (row=0; row<col; row++) {
+                    ind = getPackedIndex(row, col);
+                    re = vecRe[AMP_INDEX(ind)];
+                    im = vecIm[AMP_INDEX(ind)];
+                    offDiagSum += re*re + im*im;
+                }
+                ind = getPackedIndex(col, col);
+                re = vecRe[AMP_INDEX(ind)];
+                im = vecIm[AMP_INDEX(ind)];
+                purity += 2*offDiagSum + re*re + im*im;
+            }
+        }
+    }
+    return purity;
+}
+
+/* <psi|rho|psi> = sum_c rho_cc |psi_c|^2 + 2 Re sum_{r<c} conj(psi_r) rho_rc psi_c */
+qreal packed_calcFidelity(Qureg qureg, Qureg pureState) {
+
+    copyStateFromGPU(pureState);
+
+    long long int numCols = 1LL << qureg.numQubitsRepresented;
+    long long int numPairs = (numCols + 1)/2;
+    qreal *vecRe = qureg.stateVec.real;
+    qreal *vecIm = qureg.stateVec.imag;
+    qreal *pureRe = pureState.stateVec.real;
+    qreal *pureIm = pureState.stateVec.imag;
+    qreal fidelity = 0;
+
+    long long int pair, col, row, ind;
+    int side;
+    qreal rhoRe, rhoIm, rowRe, rowIm, colRe, colIm, sumRe, sumIm;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (numCols,numPairs, vecRe,vecIm, pureRe,pureIm) \
+    private  (pair,side,col,row,ind, rhoRe,rhoIm,rowRe,rowIm,colRe,colIm,sumRe,sumIm) \
+    reduction ( +:fidelity )
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (pair=0; pair<numPairs; pair++) {
+            for (side=0; side<2; side++) {
+                col = getPairedColumn(pair, side, numCols);
+                if (col < 0)
+                    continue;
+
+                // sum_{r<c} conj(psi_r) rho_rc
+                sumRe = 0;
+                sumIm = 0;
+                for (row=0; row<col; row++) {
+                    ind = getPackedIndex(row, col);
+                    rhoRe = vecRe[AMP_INDEX(ind)];
+                    rhoIm = vecIm[AMP_INDEX(ind)];
+                    rowRe = pureRe[AMP_INDEX(row)];
+                    rowIm = pureIm[AMP_INDEX(row)];
+                    sumRe += rowRe*rhoRe + rowIm*rhoIm;
+                    sumIm += rowRe*rhoIm - rowIm*rhoRe;
+                }
+                colRe = pureRe[AMP_INDEX(col)];
+                colIm = pureIm[AMP_INDEX(col)];
+                rhoRe = vecRe[AMP_INDEX(getPackedIndex(col, col))];
+                fidelity += 2*(sumRe*colRe - sumIm*colIm) + rhoRe*(colRe*colRe + colIm*colIm);
+            }
+        }
+    }
+    return fidelity;
+}
+
+qreal packed_calcProbOfOutcome(Qureg qureg, int measureQubit, int outcome) {
+
+    long long int dim = 1LL << qureg.numQubitsRepresented;
+    qreal *vecRe = qureg.stateVec.real;
+    qreal prob = 0;
+    long long int index;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (dim, vecRe, measureQubit,outcome) \
+    private  (index) \
+    reduction ( +:prob )
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (index=0; index<dim; index++)
+            if (((index >> measureQubit) & 1) == outcome)
+                prob += vecRe[AMP_INDEX(getPackedIndex(index, index))];
+    }
+    return prob;
+}
+
+/* elements (r, c) are renormalised when both r and c agree with the outcome, else zeroed */
+void packed_collapseToKnownProbOutcome(Qureg qureg, int measureQubit, int outcome, qreal outcomeProb) {
+
+    long long int numCols = 1LL << qureg.numQubitsRepresented;
+    long long int numPairs = (numCols + 1)/2;
+    qreal *vecRe = qureg.stateVec.real;
+    qreal *vecIm = qureg.stateVec.imag;
+    qreal renorm = 1/outcomeProb;
+
+    long long int pair, col, row, ind;
+    int side, colMatches;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (numCols,numPairs, measureQubit,outcome, vecRe,vecIm, renorm) \
+    private  (pair,side,col,row,ind, colMatches)
+# endif
+    {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+        for (pair=0; pair<numPairs; pair++) {
+            for (side=0; side<2; side++) {
+                col = getPairedColumn(pair, side, numCols);
+                if (col < 0)
+                    continue;
+
+                colMatches = (((col >> measureQubit) & 1) == outcome);
+                for (row=0; row<=col; row++) {
+                    ind = getPackedIndex(row, col);
+                    if (colMatches && ((row >> measureQubit) & 1) == outcome) {
+                        vecRe[AMP_INDEX(ind)] *= renorm;
+                        vecIm[AMP_INDEX(ind)] *= renorm;
+                    } else {
+                        vecRe[AMP_INDEX(ind)] = 0;
+                        vecIm[AMP_INDEX(ind)] = 0;
+                    }
+                }
+            }
+        }
+    }
+}
+
+int packed_measureWithStats(Qureg qureg, int measureQubit, qreal *outcomeProb) {
+
+    qreal zeroProb = packed_calcProbOfOutcome(qureg, measureQubit, 0);
+    int outcome = generateMeasurementOutcome(qureg, zeroProb, outcomeProb);
+    packed_collapseToKnownProbOutcome(qureg, measureQubit, outcome, *outcomeProb);
+    return outcome;
+}
+
+/** Tr(P rho) = Re[ (-i)^numY sum_a (-1)^|a & zMask| rho(a ^ xMask, a) ] reads only the 2^N
+ * elements of each string's anti-diagonal pattern, reading those below the diagonal as the
+ * conjugates of their stored mirrors
+ */
+void packed_calcExpecPauliStrings(Qureg qureg, long long int* xMasks, long long int* zMasks, int numStrings, qreal* expecs) {
+
+    long long int dim = 1LL << qureg.numQubitsRepresented;
+    qreal *vecRe = qureg.stateVec.real;
+    qreal *vecIm = qureg.stateVec.imag;
+
+    long long int index, xMask, zMask;
+    qreal re, im, sumRe, sumIm;
+
+    for (int s=0; s < numStrings; s++) {
+        xMask = xMasks[s];
+        zMask = zMasks[s];
+        sumRe = 0;
+        sumIm = 0;
+
+# ifdef _OPENMP
+# pragma omp parallel \
+    default  (none) \
+    shared   (dim, vecRe,vecIm, xMask,zMask) \
+    private  (index, re,im) \
+    reduction ( +:sumRe,sumIm )
+# endif
+        {
+# ifdef _OPENMP
+# pragma omp for schedule (static)
+# endif
+            for (index=0; index<dim; index++) {
+                loadAmp(vecRe, vecIm, index ^ xMask, index, &re, &im);
+                if (getBitMaskParity(index & zMask)) {
+                    sumRe -= re;
+                    sumIm -= im;
+                } else {
+                    sumRe += re;
+                    sumIm += im;
+                }
+            }
+        }
+
+        // the real component of (-i)^numY (sumRe + i sumIm)
+        int numY = 0;
+        for (long long int y = xMask & zMask; y; y &= y-1)
+            numY++;
+        switch (numY % 4) {
+            case 0: expecs[s] =   sumRe; break;
+            case 1: expecs[s] =   sumIm; break;
+            case 2: expecs[s] = - sumRe; break;
+            case 3: expecs[s] = - sumIm; break;
+        }
+    }
+}
@@ -0,0 +1,78 @@
+// Distributed under MIT licence. See https://github.com/QuEST-Kit/QuEST/blob/master/LICENCE.txt for details
+
+/** @file
+ * Functions upon packed density matrices (created by createPackedDensityQureg()), which store
+ * only the upper triangle of the Hermitian matrix rho. Element (r, c) with r <= c is stored at
+ * index c(c+1)/2 + r of stateVec, in host memory and on a single node, for every backend.
+ * The lower triangle is never stored, and is read as the conjugate of its mirror element.
+ */
+
+# ifndef QUEST_PACKED_H
+# define QUEST_PACKED_H
+
+# include "QuEST.h"
+# include "QuEST_precision.h"
+
+# ifdef __cplusplus
+extern "C" {
+# endif
+
+void packed_createQureg(Qureg* qureg, int numQubits, QuESTEnv env);
+
+void packed_destroyQureg(Qureg qureg);
+
+void packed_cloneQureg(Qureg targetQureg, Qureg copyQureg);
+
+void packed_initBlankState(Qureg qureg);
+
+void packed_initZeroState(Qureg qureg);
+
+void packed_initPlusState(Qureg qureg);
+
+void packed_initClassicalState(Qureg qureg, long long int stateInd);
+
+void packed_initPureState(Qureg qureg, Qureg pureState);
+
+Complex packed_getDensityAmp(Qureg qureg, long long int row, long long int col);
+
+void packed_multiControlledUnitary(Qureg qureg, long long int ctrlMask, long long int ctrlFlipMask, int targetQubit, ComplexMatrix2 u);
+
+void packed_multiControlledTwoQubitUnitary(Qureg qureg, long long int ctrlMask, int targetQubit1, int targetQubit2, ComplexMatrix4 u);
+
+void packed_multiControlledPhaseShiftByTerm(Qureg qureg, long long int mask, Complex term);
+
+void packed_multiControlledMultiRotateZ(Qureg qureg, long long int ctrlMask, long long int targMask, qreal angle);
+
+void packed_applyKrausSuperoperator(Qureg qureg, int target, ComplexMatrix4 superOp);
+
+void packed_applyTwoQubitKrausSuperoperator(Qureg qureg, int target1, int target2, ComplexMatrixN superOp);
+
+void packed_mixDephasing(Qureg qureg, int targetQubit, qreal prob);
+
+void packed_mixDepolarising(Qureg qureg, int targetQubit, qreal prob);
+
+void packed_mixDamping(Qureg qureg, int targetQubit, qreal prob);
+
+void packed_mixTwoQubitDephasing(Qureg qureg, int qubit1, int qubit2, qreal prob);
+
+void packed_mixTwoQubitDepolarising(Qureg qureg, int qubit1, int qubit2, qreal prob);
+
+qreal packed_calcTotalProb(Qureg qureg);
+
+qreal packed_calcPurity(Qureg qureg);
+
+qreal packed_calcFidelity(Qureg qureg, Qureg pureState);
+
+qreal packed_calcProbOfOutcome(Qureg qureg, int measureQubit, int outcome);
+
+void packed_collapseToKnownProbOutcome(Qureg qureg, int measureQubit, int outcome, qreal outcomeProb);
+
+int packed_measureWithStats(Qureg qureg, int measureQubit, qreal *outcomeProb);
+
+void packed_calcExpecPauliStrings(Qureg qureg, long long int* xMasks, long long int* zMasks, int numStrings, qreal* expecs);
+
+# ifdef __cplusplus
+}
+# endif
+
+# endif // QUEST_PACKED_H
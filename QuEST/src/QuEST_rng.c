@@ -0,0 +1,142 @@
+// Distributed under MIT licence. See https://github.com/QuEST-Kit/QuEST/blob/master/LICENCE.txt for details
+
+/** @file
+ * Functions for drawing random numbers from the counter-based stream owned by each Qureg.
+ *
+ * Numbers are generated by Philox4x32-10 (Salmon et al, "Parallel random numbers: as 
+ * easy as 1, 2, 3", SC11), which bijectively scrambles a 128-bit counter under a 64-bit 
+ * key. The counter holds a 64-bit index and a 64-bit sub-stream, so the index-th number 
+ * of any sub-stream is computed directly, without generating those before it. Serial 
+ * callers draw consecutive numbers of sub-stream 0 via rng_drawUniform(), while parallel
+ * callers reserve a block of indices via rng_skipAhead() and compute each number within
+ * it (thread-safely) via rng_getUniformAt(). The numbers are hence independent of the 
+ * number of threads or nodes which draw them.
+ */
+
+# include "QuEST.h"
+# include "QuEST_precision.h"
+# include "QuEST_rng.h"
+
+# include <stdint.h>
+# include <stdlib.h>
+
+# define PHILOX_M0 0xD2511F53U
+# define PHILOX_M1 0xCD9E8D57U
+# define PHILOX_W0 0x9E3779B9U
+# define PHILOX_W1 0xBB67AE85U
+# define PHILOX_NUM_ROUNDS 10
+
+/* the number of times QuEST has been seeded, against which each stream checks whether 
+ * its key is stale */
+static long long int globalSeedEpoch = 0;
+
+/* a hash of the seeds most recently passed to seedQuEST(), from which every key is derived */
+static unsigned long long int globalSeedHash = 0;
+
+/* the number of streams ever created, which indexes the next */
+static unsigned long long int numStreamsCreated = 0;
+
+
+static void philox4x32(uint32_t ctr[4], uint32_t key[2]) {
+    
+    uint32_t k0 = key[0];
+    uint32_t k1 = key[1];
+    for (int r=0; r<PHILOX_NUM_ROUNDS; r++) {
+        uint64_t prod0 = (uint64_t) PHILOX_M0 * ctr[0];
+        uint64_t prod1 = (uint64_t) PHILOX_M1 * ctr[2];
+        uint32_t hi0 = (uint32_t) (prod0 >> 32);
+        uint32_t lo0 = (uint32_t) prod0;
+        uint32_t hi1 = (uint32_t) (prod1 >> 32);
+        uint32_t lo1 = (uint32_t) prod1;
+        
+        ctr[0] = hi1 ^ ctr[1] ^ k0;
+        ctr[1] = lo1;
+        ctr[2] = hi0 ^ ctr[3] ^ k1;
+        ctr[3] = lo0;
+        
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+}
+
+/* the SplitMix64 finaliser, which bijectively scrambles the bits of x */
+static unsigned long long int mixBits(unsigned long long int x) {
+    
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/* keys the stream by hashing the global seeds with the stream's creation index, so that 
+ * the key is independent of which Quregs draw first, and is agreed upon by every node */
+static void keyStream(RandomStream* stream) {
+    
+    stream->key = mixBits(globalSeedHash ^ mixBits(stream->index + 0x9E3779B97F4A7C15ULL));
+    stream->numDrawn = 0;
+    stream->epoch = globalSeedEpoch;
+}
+
+/* rekeys the stream if QuEST has been reseeded since it was last keyed. This reads only 
+ * the global seed hash (written solely by seedQuEST()), so is safe upon concurrent Quregs */
+static void updateStreamKey(RandomStream* stream) {
+    
+    if (stream->epoch != globalSeedEpoch)
+        keyStream(stream);
+}
+
+void rng_setup(Qureg* qureg) {
+    
+    qureg->randStream = malloc(sizeof *(qureg->randStream));
+    qureg->randStream->index = numStreamsCreated++;
+    keyStream(qureg->randStream);
+}
+
+void rng_resetStreams(unsigned long int* seeds, int numSeeds) {
+    
+    unsigned long long int hash = mixBits((unsigned long long int) numSeeds);
+    for (int i=0; i<numSeeds; i++)
+        hash = mixBits(hash ^ seeds[i]);
+    
+    globalSeedHash = hash;
+    globalSeedEpoch++;
+}
+
+void rng_seed(Qureg qureg, unsigned long long int seed) {
+    
+    qureg.randStream->key = seed;
+    qureg.randStream->numDrawn = 0;
+    qureg.randStream->epoch = globalSeedEpoch;
+}
+
+qreal rng_getUniformAt(Qureg qureg, unsigned long long int subStream, unsigned long long int index) {
+    
+    unsigned long long int key = qureg.randStream->key;
+    uint32_t keyWords[2] = {(uint32_t) key, (uint32_t) (key >> 32)};
+    uint32_t ctr[4] = {
+        (uint32_t) index,     (uint32_t) (index >> 32), 
+        (uint32_t) subStream, (uint32_t) (subStream >> 32)};
+    philox4x32(ctr, keyWords);
+    
+    // combine 27 and 26 random bits into a double in [0,1), as does genrand_res53()
+    double uniform = ((ctr[0] >> 5) * 67108864.0 + (ctr[1] >> 6)) * (1.0 / 9007199254740992.0);
+    return (qreal) uniform;
+}
+
+unsigned long long int rng_skipAhead(Qureg qureg, unsigned long long int numDraws) {
+    
+    updateStreamKey(qureg.randStream);
+    unsigned long long int firstIndex = qureg.randStream->numDrawn;
+    qureg.randStream->numDrawn += numDraws;
+    return firstIndex;
+}
+
+qreal rng_drawUniform(Qureg qureg) {
+    
+    unsigned long long int index = rng_skipAhead(qureg, 1);
+    return rng_getUniformAt(qureg, 0, index);
+}
+
+void rng_free(Qureg qureg) {
+    
+    free(qureg.randStream);
+}
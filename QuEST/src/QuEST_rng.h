@@ -0,0 +1,39 @@
+// Distributed under MIT licence. See https://github.com/QuEST-Kit/QuEST/blob/master/LICENCE.txt for details
+
+/** @file
+ * Functions for drawing random numbers from the counter-based stream owned by each Qureg.
+ * A Qureg's stream is keyed by a hash of the seeds passed to seedQuEST() and the Qureg's 
+ * creation index, unless explicitly keyed by seedQuregRNG(), so that every node agrees upon 
+ * the key, and reseeding QuEST reproduces the outcomes of every Qureg, regardless of the 
+ * order in which the Quregs are measured.
+ */
+
+# ifndef QUEST_RNG_H
+# define QUEST_RNG_H
+
+# include "QuEST.h"
+# include "QuEST_precision.h"
+
+# ifdef __cplusplus
+extern "C" {
+# endif
+
+void rng_setup(Qureg* qureg);
+
+void rng_resetStreams(unsigned long int* seeds, int numSeeds);
+
+void rng_seed(Qureg qureg, unsigned long long int seed);
+
+qreal rng_drawUniform(Qureg qureg);
+
+unsigned long long int rng_skipAhead(Qureg qureg, unsigned long long int numDraws);
+
+qreal rng_getUniformAt(Qureg qureg, unsigned long long int subStream, unsigned long long int index);
+
+void rng_free(Qureg qureg);
+
+# ifdef __cplusplus
+}
+# endif
+
+# endif // QUEST_RNG_H
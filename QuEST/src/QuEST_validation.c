@@ -18,6 +18,7 @@ extern "C" {
 # include "QuEST_precision.h"
 # include "QuEST_internal.h"
 # include "QuEST_validation.h"
+# include "QuEST_noise.h"
  
 # include <stdio.h>
 # include <stdlib.h>
@@ -58,6 +59,7 @@ typedef enum {
     E_SYS_TOO_BIG_TO_PRINT,
     E_COLLAPSE_STATE_ZERO_PROB,
     E_INVALID_QUBIT_OUTCOME,
+    E_INVALID_MULTI_QUBIT_OUTCOME,
     E_CANNOT_OPEN_FILE,
     E_SECOND_ARG_MUST_BE_STATEVEC,
     E_MISMATCHING_QUREG_DIMENSIONS,
@@ -110,7 +112,19 @@ typedef enum {
     E_FRACTIONAL_EXPONENT_WITHOUT_NEG_OVERRIDE,
     E_NEGATIVE_EXPONENT_MULTI_VAR,
     E_FRACTIONAL_EXPONENT_MULTI_VAR,
-    E_INVALID_NUM_REGS_DISTANCE_PHASE_FUNC
+    E_INVALID_NUM_REGS_DISTANCE_PHASE_FUNC,
+    E_INVALID_NUM_FUSED_QUBITS,
+    E_INVALID_NUM_TILE_QUBITS,
+    E_INVALID_NUM_SHOTS,
+    E_INVALID_NUM_TOP_OUTCOMES,
+    E_NOT_SUPPORTED_BY_PACKED_DENSMATRS,
+    E_MISMATCHING_QUREG_PACKING,
+    E_DISTRIB_PACKED_DENSMATR,
+    E_INVALID_NOISE_CHANNEL_TYPE,
+    E_INVALID_NOISY_GATE_TYPE,
+    E_INVALID_READOUT_ERROR_PROB,
+    E_MISMATCHING_NOISE_MODEL_QUREG_NUM_QUBITS,
+    E_DEFERRING_GATES_WITH_NOISE_MODEL
 } ErrorCode;
 
 static const char* errorMessages[] = {
@@ -141,6 +155,7 @@ static const char* errorMessages[] = {
     [E_SYS_TOO_BIG_TO_PRINT] = "Invalid system size. Cannot print output for systems greater than 5 qubits.",
     [E_COLLAPSE_STATE_ZERO_PROB] = "Can't collapse to state with zero probability.",
     [E_INVALID_QUBIT_OUTCOME] = "Invalid measurement outcome -- must be either 0 or 1.",
+    [E_INVALID_MULTI_QUBIT_OUTCOME] = "Invalid measurement outcome of multiple qubits -- must be >=0 and <2^numQubits.",
     [E_CANNOT_OPEN_FILE] = "Could not open file (%s).",
     [E_SECOND_ARG_MUST_BE_STATEVEC] = "Second argument must be a state-vector.",
     [E_MISMATCHING_QUREG_DIMENSIONS] = "Dimensions of the qubit registers don't match.",
@@ -193,7 +208,19 @@ static const char* errorMessages[] = {
     [E_FRACTIONAL_EXPONENT_WITHOUT_NEG_OVERRIDE] = "The phase function contained a fractional exponent, which in TWOS_COMPLEMENT encoding, requires all negative indices are overriden. However, one or more negative indices were not overriden.",
     [E_NEGATIVE_EXPONENT_MULTI_VAR] = "The phase function contained an illegal negative exponent. One must instead call applyPhaseFuncOverrides() once for each register, so that the zero index of each register is overriden, independent of the indices of all other registers.",
     [E_FRACTIONAL_EXPONENT_MULTI_VAR] = "The phase function contained a fractional exponent, which is illegal in TWOS_COMPLEMENT encoding, since it cannot be (efficiently) checked that all negative indices were overriden. One must instead call applyPhaseFuncOverrides() once for each register, so that each register's negative indices can be overriden, independent of the indices of all other registers.",
-    [E_INVALID_NUM_REGS_DISTANCE_PHASE_FUNC] = "Phase functions DISTANCE, INVERSE_DISTANCE, SCALED_DISTANCE and SCALED_INVERSE_DISTANCE require a strictly even number of sub-registers."
+    [E_INVALID_NUM_REGS_DISTANCE_PHASE_FUNC] = "Phase functions DISTANCE, INVERSE_DISTANCE, SCALED_DISTANCE and SCALED_INVERSE_DISTANCE require a strictly even number of sub-registers.",
+    [E_INVALID_NUM_FUSED_QUBITS] = "Invalid number of qubits of a fused gate. Must be >0 and <=numQubits.",
+    [E_INVALID_NUM_TILE_QUBITS] = "Invalid number of tile qubits. Must be at least the maximum number of qubits of a fused gate, and a tile cannot exceed the amplitudes stored in a single node.",
+    [E_INVALID_NUM_SHOTS] = "Invalid number of shots. Must be >0.",
+    [E_INVALID_NUM_TOP_OUTCOMES] = "Invalid number of outcomes. Must be >0 and <=2^numQubits.",
+    [E_NOT_SUPPORTED_BY_PACKED_DENSMATRS] = "Operation not supported upon packed density matrices (created by createPackedDensityQureg()). Use createDensityQureg() instead.",
+    [E_MISMATCHING_QUREG_PACKING] = "Registers must both be packed density matrices, or neither be packed.",
+    [E_DISTRIB_PACKED_DENSMATR] = "Packed density matrices cannot be distributed between multiple nodes.",
+    [E_INVALID_NOISE_CHANNEL_TYPE] = "Invalid noise channel type. Must be one of NO_NOISE, DEPHASING_NOISE, DEPOLARISING_NOISE, DAMPING_NOISE or PAULI_NOISE.",
+    [E_INVALID_NOISY_GATE_TYPE] = "Invalid noisy gate type. Must be one of ONE_QUBIT_GATES, TWO_QUBIT_GATES or MULTI_QUBIT_GATES.",
+    [E_INVALID_READOUT_ERROR_PROB] = "The probability of a readout error must be within [0, 1/2], since 1/2 is maximally erroneous.",
+    [E_MISMATCHING_NOISE_MODEL_QUREG_NUM_QUBITS] = "The noise model must have the same number of qubits as the density matrix to which it is attached.",
+    [E_DEFERRING_GATES_WITH_NOISE_MODEL] = "Gate deferral cannot be started, stopped or applied while a noise model is attached, nor can a noise model be attached while gates are deferred."
 };
 
 void default_invalidQuESTInputError(const char* errMsg, const char* errFunc) {
@@ -362,6 +389,27 @@ void validateNumQubitsInMatrix(int numQubits, const char* caller) {
     QuESTAssert(numQubits>0, E_INVALID_NUM_QUBITS, caller);
 }
 
+void validateNumFusedQubits(Qureg qureg, int numQubits, const char* caller) {
+    QuESTAssert(numQubits>0 && numQubits<=qureg.numQubitsRepresented, E_INVALID_NUM_FUSED_QUBITS, caller);
+}
+
+void validateNumTileQubits(Qureg qureg, int numFusedQubits, int numTileQubits, const char* caller) {
+    int isValid = (
+        numTileQubits >= numFusedQubits && 
+        numTileQubits <= qureg.numQubitsInStateVec &&
+        (1LL << numTileQubits) <= qureg.numAmpsPerChunk);
+    QuESTAssert(isValid, E_INVALID_NUM_TILE_QUBITS, caller);
+}
+
+void validateNumShots(int numShots, const char* caller) {
+    QuESTAssert(numShots>0, E_INVALID_NUM_SHOTS, caller);
+}
+
+void validateNumTopOutcomes(Qureg qureg, int numOutcomes, const char* caller) {
+    int isValid = (numOutcomes > 0 && numOutcomes <= (1LL << qureg.numQubitsRepresented));
+    QuESTAssert(isValid, E_INVALID_NUM_TOP_OUTCOMES, caller);
+}
+
 void validateNumQubitsInDiagOp(int numQubits, int numRanks, const char* caller) {
     QuESTAssert(numQubits>0, E_INVALID_NUM_CREATE_QUBITS, caller);
     
@@ -471,7 +519,8 @@ void validateControlState(int* controlState, int numControlQubits, const char* c
 }
 
 void validateMultiQubitMatrixFitsInNode(Qureg qureg, int numTargets, const char* caller) {
-    QuESTAssert(qureg.numAmpsPerChunk >= (1LL << numTargets), E_CANNOT_FIT_MULTI_QUBIT_MATRIX, caller);
+    // packed density matrices are never distributed
+    QuESTAssert(qureg.isPackedDensityMatrix || qureg.numAmpsPerChunk >= (1LL << numTargets), E_CANNOT_FIT_MULTI_QUBIT_MATRIX, caller);
 }
 
 void validateOneQubitUnitaryMatrix(ComplexMatrix2 u, const char* caller) {
@@ -524,6 +573,10 @@ void validateOutcome(int outcome, const char* caller) {
     QuESTAssert(outcome==0 || outcome==1, E_INVALID_QUBIT_OUTCOME, caller);
 }
 
+void validateMultiQubitOutcome(long long int outcome, int numQubits, const char* caller) {
+    QuESTAssert(outcome>=0 && outcome<(1LL<<numQubits), E_INVALID_MULTI_QUBIT_OUTCOME, caller);
+}
+
 void validateMeasurementProb(qreal prob, const char* caller) {
     QuESTAssert(prob>REAL_EPS, E_COLLAPSE_STATE_ZERO_PROB, caller);
 }
@@ -536,6 +589,18 @@ void validateMatchingQuregTypes(Qureg qureg1, Qureg qureg2, const char *caller)
     QuESTAssert(qureg1.isDensityMatrix==qureg2.isDensityMatrix, E_MISMATCHING_QUREG_TYPES, caller);
 }
 
+void validateMatchingQuregPacking(Qureg qureg1, Qureg qureg2, const char *caller) {
+    QuESTAssert(qureg1.isPackedDensityMatrix==qureg2.isPackedDensityMatrix, E_MISMATCHING_QUREG_PACKING, caller);
+}
+
+void validateUnpackedQureg(Qureg qureg, const char* caller) {
+    QuESTAssert( ! qureg.isPackedDensityMatrix, E_NOT_SUPPORTED_BY_PACKED_DENSMATRS, caller);
+}
+
+void validateNumRanksOfPackedQureg(int numRanks, const char* caller) {
+    QuESTAssert(numRanks == 1, E_DISTRIB_PACKED_DENSMATR, caller);
+}
+
 void validateSecondQuregStateVec(Qureg qureg2, const char *caller) {
     QuESTAssert( ! qureg2.isDensityMatrix, E_SECOND_ARG_MUST_BE_STATEVEC, caller);
 }
@@ -648,6 +713,73 @@ void validateMultiQubitKrausMap(Qureg qureg, int numTargs, ComplexMatrixN* ops,
     QuESTAssert(isPos, E_INVALID_KRAUS_OPS, caller);
 }
 
+void validateNoiseChannel(NoiseChannel channel, const char* caller) {
+    switch (channel.type) {
+        case NO_NOISE:
+            return;
+        case DEPHASING_NOISE:
+            validateOneQubitDephaseProb(channel.prob, caller);
+            return;
+        case DEPOLARISING_NOISE:
+            validateOneQubitDepolProb(channel.prob, caller);
+            return;
+        case DAMPING_NOISE:
+            validateOneQubitDampingProb(channel.prob, caller);
+            return;
+        case PAULI_NOISE:
+            validateOneQubitPauliProbs(channel.probX, channel.probY, channel.probZ, caller);
+            return;
+    }
+    QuESTAssert(0, E_INVALID_NOISE_CHANNEL_TYPE, caller);
+}
+
+void validateNoiseLayer(Qureg qureg, NoiseChannel* channels, const char* caller) {
+    for (int q=0; q<qureg.numQubitsRepresented; q++)
+        validateNoiseChannel(channels[q], caller);
+}
+
+void validateNumQubitsInNoiseModel(int numQubits, const char* caller) {
+    QuESTAssert(numQubits>0, E_INVALID_NUM_CREATE_QUBITS, caller);
+}
+
+void validateNoiseModelQubit(NoiseModel model, int qubit, const char* caller) {
+    QuESTAssert(qubit>=0 && qubit<model.numQubits, E_INVALID_TARGET_QUBIT, caller);
+}
+
+void validateNoisyGateType(enum noisyGateType gateType, const char* caller) {
+    int isValid = (gateType == ONE_QUBIT_GATES || gateType == TWO_QUBIT_GATES || gateType == MULTI_QUBIT_GATES);
+    QuESTAssert(isValid, E_INVALID_NOISY_GATE_TYPE, caller);
+}
+
+void validateNoiseModelKrausMap(ComplexMatrix2* ops, int numOps, const char* caller) {
+    QuESTAssert(numOps > 0 && numOps <= 4, E_INVALID_NUM_ONE_QUBIT_KRAUS_OPS, caller);
+    
+    int isPos = isCompletelyPositiveMap2(ops, numOps);
+    QuESTAssert(isPos, E_INVALID_KRAUS_OPS, caller);
+}
+
+void validateReadoutErrorProb(qreal prob, const char* caller) {
+    QuESTAssert(prob >= 0 && prob <= 1/2.0, E_INVALID_READOUT_ERROR_PROB, caller);
+}
+
+void validateNoiseModelAttachment(Qureg qureg, NoiseModel model, const char* caller) {
+    validateDensityMatrQureg(qureg, caller);
+    validateUnpackedQureg(qureg, caller);
+    QuESTAssert(model.numQubits == qureg.numQubitsRepresented, E_MISMATCHING_NOISE_MODEL_QUREG_NUM_QUBITS, caller);
+    
+    // the gate queue is deferring on behalf of an already attached model
+    int isUserDeferring = qureg.gateQueue->isDeferring && !noise_isAttached(qureg);
+    QuESTAssert(!isUserDeferring, E_DEFERRING_GATES_WITH_NOISE_MODEL, caller);
+    
+    // two-qubit gates are applied with their channels as a superoperator upon four state-vector qubits
+    int superOpNumQubits = (qureg.numQubitsRepresented > 1)? 4 : 2;
+    validateMultiQubitMatrixFitsInNode(qureg, superOpNumQubits, caller);
+}
+
+void validateNoNoiseModel(Qureg qureg, const char* caller) {
+    QuESTAssert(!noise_isAttached(qureg), E_DEFERRING_GATES_WITH_NOISE_MODEL, caller);
+}
+
 void validateHamilParams(int numQubits, int numTerms, const char* caller) {
     QuESTAssert(numQubits > 0 && numTerms > 0, E_INVALID_PAULI_HAMIL_PARAMS, caller);
 }
@@ -24,6 +24,14 @@ void validateNumQubitsInQureg(int numQubits, int numRanks, const char* caller);
 
 void validateNumQubitsInMatrix(int numQubits, const char* caller);
 
+void validateNumFusedQubits(Qureg qureg, int numQubits, const char* caller);
+
+void validateNumTileQubits(Qureg qureg, int numFusedQubits, int numTileQubits, const char* caller);
+
+void validateNumShots(int numShots, const char* caller);
+
+void validateNumTopOutcomes(Qureg qureg, int numOutcomes, const char* caller);
+
 void validateNumQubitsInDiagOp(int numQubits, int numRanks, const char* caller);
 
 void validateAmpIndex(Qureg qureg, long long int ampInd, const char* caller);
@@ -68,12 +76,20 @@ void validateDensityMatrQureg(Qureg qureg, const char* caller);
 
 void validateOutcome(int outcome, const char* caller);
 
+void validateMultiQubitOutcome(long long int outcome, int numQubits, const char* caller);
+
 void validateMeasurementProb(qreal prob, const char* caller);
 
 void validateMatchingQuregDims(Qureg qureg1, Qureg qureg2, const char *caller);
 
 void validateMatchingQuregTypes(Qureg qureg1, Qureg qureg2, const char *caller);
 
+void validateMatchingQuregPacking(Qureg qureg1, Qureg qureg2, const char *caller);
+
+void validateUnpackedQureg(Qureg qureg, const char* caller);
+
+void validateNumRanksOfPackedQureg(int numRanks, const char* caller);
+
 void validateSecondQuregStateVec(Qureg qureg2, const char *caller);
 
 void validateNumAmps(Qureg qureg, long long int startInd, long long int numAmps, const char* caller);
@@ -94,6 +110,24 @@ void validateTwoQubitDepolProb(qreal prob, const char* caller);
 
 void validateOneQubitPauliProbs(qreal probX, qreal probY, qreal probZ, const char* caller);
 
+void validateNoiseChannel(NoiseChannel channel, const char* caller);
+
+void validateNoiseLayer(Qureg qureg, NoiseChannel* channels, const char* caller);
+
+void validateNumQubitsInNoiseModel(int numQubits, const char* caller);
+
+void validateNoiseModelQubit(NoiseModel model, int qubit, const char* caller);
+
+void validateNoisyGateType(enum noisyGateType gateType, const char* caller);
+
+void validateNoiseModelKrausMap(ComplexMatrix2* ops, int numOps, const char* caller);
+
+void validateReadoutErrorProb(qreal prob, const char* caller);
+
+void validateNoiseModelAttachment(Qureg qureg, NoiseModel model, const char* caller);
+
+void validateNoNoiseModel(Qureg qureg, const char* caller);
+
 void validatePauliCodes(enum pauliOpType* pauliCodes, int numPauliCodes, const char* caller);
 
 void validateNumPauliSumTerms(int numTerms, const char* caller);
@@ -9,6 +9,9 @@ void init_by_array(unsigned long init_key[], int key_length);
 
 void init_genrand(unsigned long s);
 
+/* generates a random number on [0,0xffffffff]-interval */
+unsigned long genrand_int32(void);
+
 /* generates a random number on [0,1]-real-interval */
 double genrand_real1(void);
 
@@ -0,0 +1,80 @@
+/** @file
+ * Measures the time per amplitude of applying dense unitaries upon
+ * 1 to 5 target qubits, to compare the performance of the CPU kernels
+ *
+ * Compile and run from within the build folder, using:
+cmake .. -DUSER_SOURCE=../examples/unitary_benchmark.c \
+        -DOUTPUT_EXE=benchmark
+make
+./benchmark
+ *
+ */
+
+#define _POSIX_C_SOURCE 199309L // for clock_gettime
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "QuEST.h"
+
+#define NUM_QUBITS 24
+#define NUM_REPS 10
+#define MAX_NUM_TARGS 5
+
+
+
+/* returns the wall time in seconds */
+double getTime(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + 1E-9*t.tv_nsec;
+}
+
+/* returns the mean time per amplitude (in ns) of applying u upon consecutive
+ * disjoint sets of target qubits, spanning the whole register
+ */
+double timeMultiQubitUnitary(Qureg qureg, ComplexMatrixN u) {
+
+    int numTargs = u.numQubits;
+    int targs[MAX_NUM_TARGS];
+    int numGates = 0;
+
+    double start = getTime();
+    for (int r=0; r<NUM_REPS; r++) {
+        for (int low=0; low+numTargs<=NUM_QUBITS; low+=numTargs) {
+            for (int t=0; t<numTargs; t++)
+                targs[t] = low + t;
+            multiQubitUnitary(qureg, targs, numTargs, u);
+            numGates++;
+        }
+    }
+    double dur = getTime() - start;
+    return 1E9 * dur / ((double) numGates * qureg.numAmpsTotal);
+}
+
+int main (int narg, char *varg[]) {
+
+    QuESTEnv env = createQuESTEnv();
+    Qureg qureg = createQureg(NUM_QUBITS, env);
+    initPlusState(qureg);
+
+    reportQuESTEnv(env);
+    printf("\n%d qubits, %d repetitions\n", NUM_QUBITS, NUM_REPS);
+    printf("targets | time per amplitude (ns)\n");
+
+    for (int numTargs=1; numTargs<=MAX_NUM_TARGS; numTargs++) {
+
+        // a diagonal unitary is sufficient, since the kernels treat u as dense
+        ComplexMatrixN u = createComplexMatrixN(numTargs);
+        for (int i=0; i<(1<<numTargs); i++)
+            u.real[i][i] = 1;
+
+        printf("%7d | %g\n", numTargs, timeMultiQubitUnitary(qureg, u));
+        destroyComplexMatrixN(u);
+    }
+
+    destroyQureg(qureg, env);
+    destroyQuESTEnv(env);
+    return 0;
+}
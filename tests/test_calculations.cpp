@@ -14,6 +14,63 @@ using Catch::Matchers::Contains;
 
 
 
+/** @sa calcAllQubitMarginals
+ * @ingroup unittest 
+ */
+TEST_CASE( "calcAllQubitMarginals", "[calculations]" ) {
+    
+    SECTION( "correctness" ) {
+        
+        // include enough qubits that some lie above those tallied per block
+        int numQubits = GENERATE( NUM_QUBITS, 10 );
+        std::vector<qreal> probs(numQubits);
+        QVector refProbs = QVector(numQubits);
+        
+        SECTION( "state-vector" ) {
+            
+            Qureg vec = createQureg(numQubits, QUEST_ENV);
+            QVector ref = getRandomStateVector(numQubits);
+            toQureg(vec, ref);
+            
+            // prob of qubit q is the sum of |amp|^2 of basis states wherein q is 1
+            for (size_t i=0; i<ref.size(); i++)
+                for (int q=0; q<numQubits; q++)
+                    if ((i >> q) & 1)
+                        refProbs[q] += pow(abs(ref[i]), 2);
+            
+            calcAllQubitMarginals(vec, probs.data());
+            REQUIRE( areEqual(refProbs, probs.data()) );
+            destroyQureg(vec, QUEST_ENV);
+        }
+        SECTION( "density-matrix" ) {
+            
+            Qureg mat = createDensityQureg(numQubits, QUEST_ENV);
+            // an unnormalised matrix, scaled so that the sums are precisely comparable
+            QMatrix ref = getRandomQMatrix(1<<numQubits);
+            for (size_t i=0; i<ref.size(); i++)
+                ref[i][i] /= (qreal) ref.size();
+            toQureg(mat, ref);
+            
+            // prob of qubit q is the sum of diagonals wherein q is 1
+            for (size_t i=0; i<ref.size(); i++)
+                for (int q=0; q<numQubits; q++)
+                    if ((i >> q) & 1)
+                        refProbs[q] += real(ref[i][i]);
+            
+            calcAllQubitMarginals(mat, probs.data());
+            REQUIRE( areEqual(refProbs, probs.data()) );
+            destroyQureg(mat, QUEST_ENV);
+        }
+    }
+    SECTION( "input validation" ) {
+        
+        // no validation 
+        SUCCEED();
+    }
+}
+
+
+
 /** @sa calcDensityInnerProduct
  * @ingroup unittest 
  * @author Tyson Jones 
@@ -235,6 +292,68 @@ TEST_CASE( "calcExpecPauliHamil", "[calculations]" ) {
             qreal res = calcExpecPauliHamil(mat, hamil, matWork);
             REQUIRE( res == Approx(tr).margin(1E2*REAL_EPS) );
         }
+        SECTION( "qubit-wise commuting terms" ) {
+            
+            // every term acts upon each qubit as either the identity, or that qubit's Pauli
+            pauliOpType basis[NUM_QUBITS];
+            for (int q=0; q<NUM_QUBITS; q++)
+                basis[q] = (pauliOpType) getRandomInt(1,4);
+            for (int t=0; t<numTerms; t++)
+                for (int q=0; q<NUM_QUBITS; q++)
+                    hamil.pauliCodes[t*NUM_QUBITS + q] = (getRandomInt(0,2))? basis[q] : PAULI_I;
+            refHamil = toQMatrix(hamil);
+            
+            QVector sumRef = refHamil * vecRef;
+            qcomp prod = 0;
+            for (size_t i=0; i<vecRef.size(); i++)
+                prod += conj(vecRef[i]) * sumRef[i];
+            REQUIRE( calcExpecPauliHamil(vec, hamil, vecWork) == Approx(real(prod)).margin(10*REAL_EPS) );
+            
+            matRef = refHamil * matRef;            
+            qreal tr = 0;
+            for (size_t i=0; i<matRef.size(); i++)
+                tr += real(matRef[i][i]);
+            REQUIRE( calcExpecPauliHamil(mat, hamil, matWork) == Approx(tr).margin(1E2*REAL_EPS) );
+        }
+        SECTION( "diagonal terms" ) {
+            
+            // terms of only PAULI_I and PAULI_Z are evaluated together, and the workspace is unused
+            for (int t=0; t<numTerms; t++)
+                for (int q=0; q<NUM_QUBITS; q++)
+                    hamil.pauliCodes[t*NUM_QUBITS + q] = (getRandomInt(0,2))? PAULI_Z : PAULI_I;
+            refHamil = toQMatrix(hamil);
+            initZeroState(vecWork);
+            initZeroState(matWork);
+            
+            QVector sumRef = refHamil * vecRef;
+            qcomp prod = 0;
+            for (size_t i=0; i<vecRef.size(); i++)
+                prod += conj(vecRef[i]) * sumRef[i];
+            REQUIRE( calcExpecPauliHamil(vec, hamil, vecWork) == Approx(real(prod)).margin(10*REAL_EPS) );
+            
+            matRef = refHamil * matRef;            
+            qreal tr = 0;
+            for (size_t i=0; i<matRef.size(); i++)
+                tr += real(matRef[i][i]);
+            REQUIRE( calcExpecPauliHamil(mat, hamil, matWork) == Approx(tr).margin(1E2*REAL_EPS) );
+            
+            QVector zeroVec = toQVector(vecWork);
+            REQUIRE( abs(zeroVec[0] - qcomp(1)) < REAL_EPS );
+            REQUIRE( calcTotalProb(matWork) == Approx(1) );
+        }
+        SECTION( "modified terms" ) {
+            
+            // terms changed after an earlier evaluation are respected
+            calcExpecPauliHamil(vec, hamil, vecWork);
+            setRandomPauliSum(hamil);
+            refHamil = toQMatrix(hamil);
+            
+            QVector sumRef = refHamil * vecRef;
+            qcomp prod = 0;
+            for (size_t i=0; i<vecRef.size(); i++)
+                prod += conj(vecRef[i]) * sumRef[i];
+            REQUIRE( calcExpecPauliHamil(vec, hamil, vecWork) == Approx(real(prod)).margin(10*REAL_EPS) );
+        }
         
         destroyPauliHamil(hamil);
     }
@@ -437,6 +556,117 @@ TEST_CASE( "calcExpecPauliProd", "[calculations]" ) {
 
 
 
+/** @sa calcExpecPauliStrings
+ * @ingroup unittest 
+ */
+TEST_CASE( "calcExpecPauliStrings", "[calculations]" ) {
+    
+    Qureg vec = createQureg(NUM_QUBITS, QUEST_ENV);
+    Qureg mat = createDensityQureg(NUM_QUBITS, QUEST_ENV);
+    initDebugState(vec);
+    initDebugState(mat);
+    QVector vecRef = toQVector(vec);
+    QMatrix matRef = toQMatrix(mat);
+    
+    SECTION( "correctness" ) {
+        
+        int numStrings = GENERATE( 1, 2, 10, 15 );
+        
+        // try 10 random sets of Pauli strings
+        GENERATE( range(0,10) );
+        int totNumCodes = numStrings*NUM_QUBITS;
+        pauliOpType paulis[totNumCodes];
+        qreal coeffs[numStrings];
+        setRandomPauliSum(coeffs, paulis, NUM_QUBITS, numStrings);
+        
+        qreal expecs[numStrings];
+        
+        SECTION( "state-vector" ) {
+            
+            /* calcExpecPauliStrings calculates each <qureg|pauliString|qureg> */
+            
+            calcExpecPauliStrings(vec, paulis, numStrings, expecs);
+            
+            for (int t=0; t<numStrings; t++) {
+                qreal one = 1;
+                QVector prodRef = toQMatrix(&one, &paulis[t*NUM_QUBITS], NUM_QUBITS, 1) * vecRef;
+                qcomp prod = 0;
+                for (size_t i=0; i<vecRef.size(); i++)
+                    prod += conj(vecRef[i]) * prodRef[i];
+                REQUIRE( expecs[t] == Approx(real(prod)).margin(10*REAL_EPS) );
+            }
+            REQUIRE( areEqual(vec, vecRef) );
+        }
+        SECTION( "density-matrix" ) {
+            
+            /* calcExpecPauliStrings calculates each Trace( pauliString * qureg ) */
+            
+            calcExpecPauliStrings(mat, paulis, numStrings, expecs);
+            
+            for (int t=0; t<numStrings; t++) {
+                qreal one = 1;
+                QMatrix prodRef = toQMatrix(&one, &paulis[t*NUM_QUBITS], NUM_QUBITS, 1) * matRef;
+                qreal tr = 0;
+                for (size_t i=0; i<prodRef.size(); i++)
+                    tr += real(prodRef[i][i]);
+                REQUIRE( expecs[t] == Approx(tr).margin(1E2*REAL_EPS) );
+            }
+            REQUIRE( areEqual(mat, matRef) );
+        }
+        SECTION( "many amplitudes" ) {
+            
+            /* spans several of the blocks (and distributed chunks) in which strings are evaluated,
+             * and is compared against explicitly applying each string to a separate register
+             */
+            int numQb = 14;
+            Qureg big = createQureg(numQb, QUEST_ENV);
+            Qureg work = createQureg(numQb, QUEST_ENV);
+            toQureg(big, getRandomStateVector(numQb));
+            
+            pauliOpType bigPaulis[numStrings*numQb];
+            qreal bigCoeffs[numStrings];
+            setRandomPauliSum(bigCoeffs, bigPaulis, numQb, numStrings);
+            
+            qreal bigExpecs[numStrings];
+            calcExpecPauliStrings(big, bigPaulis, numStrings, bigExpecs);
+            
+            for (int t=0; t<numStrings; t++) {
+                qreal one = 1;
+                applyPauliSum(big, &bigPaulis[t*numQb], &one, 1, work);
+                REQUIRE( bigExpecs[t] == Approx(calcInnerProduct(big, work).real).margin(10*REAL_EPS) );
+            }
+            
+            destroyQureg(big, QUEST_ENV);
+            destroyQureg(work, QUEST_ENV);
+        }
+    }
+    SECTION( "input validation" ) {
+        
+        SECTION( "number of strings" ) {
+            
+            int numStrings = GENERATE( -1, 0 );
+            REQUIRE_THROWS_WITH( calcExpecPauliStrings(vec, NULL, numStrings, NULL), Contains("Invalid number of terms in the Pauli sum") );
+        }
+        SECTION( "pauli codes" ) {
+            
+            // make valid params
+            int numStrings = 3;
+            qreal expecs[numStrings];
+            pauliOpType codes[numStrings*NUM_QUBITS];
+            for (int i=0; i<numStrings*NUM_QUBITS; i++)
+                codes[i] = PAULI_I;
+
+            // make one pauli wrong
+            codes[GENERATE_COPY( range(0,numStrings*NUM_QUBITS) )] = (pauliOpType) GENERATE( -1, 4 );
+            REQUIRE_THROWS_WITH( calcExpecPauliStrings(vec, codes, numStrings, expecs), Contains("Invalid Pauli code") );
+        }
+    }
+    destroyQureg(vec, QUEST_ENV);
+    destroyQureg(mat, QUEST_ENV);
+}
+
+
+
 /** @sa calcExpecPauliSum
  * @ingroup unittest 
  * @author Tyson Jones 
@@ -1198,6 +1428,102 @@ TEST_CASE( "calcPurity", "[calculations]" ) {
 
 
 
+/** @sa calcTopKOutcomes
+ * @ingroup unittest 
+ */
+TEST_CASE( "calcTopKOutcomes", "[calculations]" ) {
+    
+    Qureg vec = createQureg(NUM_QUBITS, QUEST_ENV);
+    Qureg mat = createDensityQureg(NUM_QUBITS, QUEST_ENV);
+    
+    SECTION( "correctness" ) {
+        
+        int k = GENERATE( range(1, (1<<NUM_QUBITS)+1) );
+        std::vector<long long int> inds(k);
+        std::vector<qreal> probs(k);
+        
+        // the reference outcomes are all basis states, in order of decreasing probability
+        std::vector<qreal> refProbs(1<<NUM_QUBITS);
+        std::vector<long long int> refInds(1<<NUM_QUBITS);
+        auto sortRefInds = [&]() {
+            for (size_t i=0; i<refInds.size(); i++)
+                refInds[i] = i;
+            std::stable_sort(refInds.begin(), refInds.end(), 
+                [&](long long int a, long long int b) { return refProbs[a] > refProbs[b]; });
+        };
+        auto checkTopOutcomes = [&]() {
+            int numWrong = 0;
+            for (int i=0; i<k; i++)
+                numWrong += (inds[i] != refInds[i] || abs(probs[i] - refProbs[refInds[i]]) > REAL_EPS);
+            REQUIRE( numWrong == 0 );
+        };
+        
+        SECTION( "state-vector" ) {
+            
+            SECTION( "random state" ) {
+            
+                QVector ref = getRandomQVector(1<<NUM_QUBITS);
+                toQureg(vec, ref);
+                for (size_t i=0; i<ref.size(); i++)
+                    refProbs[i] = pow(abs(ref[i]), 2);
+                sortRefInds();
+                
+                calcTopKOutcomes(vec, k, inds.data(), probs.data());
+                checkTopOutcomes();
+            }
+            SECTION( "basis state" ) {
+                
+                // the remaining (zero probability) outcomes are ordered by index
+                int ind = GENERATE( range(0, 1<<NUM_QUBITS) );
+                initClassicalState(vec, ind);
+                refProbs[ind] = 1;
+                sortRefInds();
+                
+                calcTopKOutcomes(vec, k, inds.data(), probs.data());
+                checkTopOutcomes();
+            }
+        }
+        SECTION( "density-matrix" ) {
+            
+            SECTION( "random state" ) {
+            
+                QMatrix ref = getRandomQMatrix(1<<NUM_QUBITS);
+                toQureg(mat, ref);
+                for (size_t i=0; i<ref.size(); i++)
+                    refProbs[i] = real(ref[i][i]);
+                sortRefInds();
+                
+                calcTopKOutcomes(mat, k, inds.data(), probs.data());
+                checkTopOutcomes();
+            }
+            SECTION( "basis state" ) {
+                
+                int ind = GENERATE( range(0, 1<<NUM_QUBITS) );
+                initClassicalState(mat, ind);
+                refProbs[ind] = 1;
+                sortRefInds();
+                
+                calcTopKOutcomes(mat, k, inds.data(), probs.data());
+                checkTopOutcomes();
+            }
+        }
+    }
+    SECTION( "input validation" ) {
+        
+        SECTION( "number of outcomes" ) {
+            
+            int k = GENERATE( -1, 0, (1<<NUM_QUBITS)+1 );
+            long long int inds[1];
+            qreal probs[1];
+            REQUIRE_THROWS_WITH( calcTopKOutcomes(vec, k, inds, probs), Contains("Invalid number of outcomes") );
+        }
+    }
+    destroyQureg(vec, QUEST_ENV);
+    destroyQureg(mat, QUEST_ENV);
+}
+
+
+
 /** @sa calcTotalProb
  * @ingroup unittest 
  * @author Tyson Jones 
@@ -1265,6 +1591,82 @@ TEST_CASE( "calcTotalProb", "[calculations]" ) {
 
 
 
+/** @sa calcZZCorrelationMatrix
+ * @ingroup unittest 
+ */
+TEST_CASE( "calcZZCorrelationMatrix", "[calculations]" ) {
+    
+    SECTION( "correctness" ) {
+        
+        // include enough qubits that some lie above those tallied per block
+        int numQubits = GENERATE( NUM_QUBITS, 10 );
+        std::vector<qreal> corrs(numQubits*numQubits);
+        QVector refCorrs = QVector(numQubits*numQubits);
+        
+        // Z_i Z_j contributes -1 when qubits i and j differ, else +1
+        auto getSign = [](size_t ind, int i, int j) {
+            return (((ind >> i) & 1) == ((ind >> j) & 1))? 1 : -1;
+        };
+        
+        SECTION( "state-vector" ) {
+            
+            Qureg vec = createQureg(numQubits, QUEST_ENV);
+            QVector ref = getRandomStateVector(numQubits);
+            toQureg(vec, ref);
+            
+            for (size_t k=0; k<ref.size(); k++)
+                for (int i=0; i<numQubits; i++)
+                    for (int j=0; j<numQubits; j++)
+                        refCorrs[i*numQubits + j] += getSign(k, i, j) * pow(abs(ref[k]), 2);
+            
+            calcZZCorrelationMatrix(vec, corrs.data());
+            REQUIRE( areEqual(refCorrs, corrs.data()) );
+            destroyQureg(vec, QUEST_ENV);
+        }
+        SECTION( "density-matrix" ) {
+            
+            Qureg mat = createDensityQureg(numQubits, QUEST_ENV);
+            // an unnormalised matrix, scaled so that the sums are precisely comparable
+            QMatrix ref = getRandomQMatrix(1<<numQubits);
+            for (size_t i=0; i<ref.size(); i++)
+                ref[i][i] /= (qreal) ref.size();
+            toQureg(mat, ref);
+            
+            for (size_t k=0; k<ref.size(); k++)
+                for (int i=0; i<numQubits; i++)
+                    for (int j=0; j<numQubits; j++)
+                        refCorrs[i*numQubits + j] += getSign(k, i, j) * real(ref[k][k]);
+            
+            calcZZCorrelationMatrix(mat, corrs.data());
+            REQUIRE( areEqual(refCorrs, corrs.data()) );
+            destroyQureg(mat, QUEST_ENV);
+        }
+        SECTION( "agrees with calcExpecPauliProd" ) {
+            
+            Qureg vec = createQureg(numQubits, QUEST_ENV);
+            Qureg work = createQureg(numQubits, QUEST_ENV);
+            toQureg(vec, getRandomStateVector(numQubits));
+            
+            calcZZCorrelationMatrix(vec, corrs.data());
+            
+            int targs[2] = {0, numQubits-1};
+            enum pauliOpType codes[2] = {PAULI_Z, PAULI_Z};
+            qreal prod = calcExpecPauliProd(vec, targs, codes, 2, work);
+            REQUIRE( corrs[targs[0]*numQubits + targs[1]] == Approx(prod).margin(10*REAL_EPS) );
+            
+            destroyQureg(vec, QUEST_ENV);
+            destroyQureg(work, QUEST_ENV);
+        }
+    }
+    SECTION( "input validation" ) {
+        
+        // no validation 
+        SUCCEED();
+    }
+}
+
+
+
 /** @sa getAmp
  * @ingroup unittest 
  * @author Tyson Jones 
@@ -1524,3 +1926,165 @@ TEST_CASE( "getRealAmp", "[calculations]" ) {
 }
 
 
+
+/** @sa sampleOutcomes
+ * @ingroup unittest 
+ */
+TEST_CASE( "sampleOutcomes", "[calculations]" ) {
+    
+    Qureg vec = createQureg(NUM_QUBITS, QUEST_ENV);
+    Qureg mat = createDensityQureg(NUM_QUBITS, QUEST_ENV);
+    
+    SECTION( "correctness" ) {
+    
+        // generate all possible qubit arrangements
+        int numQubits = GENERATE_COPY( range(1,NUM_QUBITS+1) );
+        int* qubits = GENERATE_COPY( sublists(range(0,NUM_QUBITS), numQubits) );
+        
+        int numOutcomes = 1<<numQubits;
+        int numShots = 10000;
+        std::vector<long long int> outcomes(numShots);
+        QVector refProbs = QVector(numOutcomes);
+        
+        // frequencies of the sampled outcomes should approach their probabilities
+        // (the tolerance is many standard deviations, so spurious failure is negligible)
+        auto checkFrequencies = [&]() {
+            std::vector<qreal> freqs(numOutcomes, 0);
+            int numImpossible = 0;
+            for (int s=0; s<numShots; s++) {
+                if (outcomes[s] < 0 || outcomes[s] >= numOutcomes || real(refProbs[outcomes[s]]) <= 0)
+                    numImpossible++;
+                else
+                    freqs[outcomes[s]] += 1./numShots;
+            }
+            REQUIRE( numImpossible == 0 );
+            for (int i=0; i<numOutcomes; i++)
+                REQUIRE( freqs[i] == Approx(real(refProbs[i])).margin(0.05) );
+        };
+        
+        SECTION( "state-vector" ) {
+            
+            SECTION( "basis state" ) {
+                
+                int ind = GENERATE( range(0,1<<NUM_QUBITS) );
+                initClassicalState(vec, ind);
+                
+                long long int outcome = 0;
+                for (int q=0; q<numQubits; q++)
+                    outcome += ((ind >> qubits[q]) & 1) * (1 << q);
+                
+                // every shot must produce the same outcome
+                numShots = 100;
+                sampleOutcomes(vec, qubits, numQubits, numShots, outcomes.data());
+                REQUIRE( std::count(outcomes.begin(), outcomes.begin()+numShots, outcome) == numShots );
+            }
+            SECTION( "random state" ) {
+                
+                QVector ref = getRandomStateVector(NUM_QUBITS);
+                
+                // zero some amplitudes, so that some outcomes may be impossible
+                ref[getRandomInt(0, 1<<NUM_QUBITS)] = 0;
+                ref = getNormalised(ref);
+                toQureg(vec, ref);
+
+                // prob is sum of |amp|^2 of basis states which encode outcome
+                for (size_t i=0; i<ref.size(); i++) {
+                    int outcome = 0;
+                    for (int q=0; q<numQubits; q++) {
+                        int bit = (i >> qubits[q]) & 1;
+                        outcome += bit * (1 << q);
+                    }
+                    refProbs[outcome] += pow(abs(ref[i]), 2);
+                }
+
+                sampleOutcomes(vec, qubits, numQubits, numShots, outcomes.data());
+                checkFrequencies();
+                
+                // the state is unchanged
+                REQUIRE( areEqual(vec, ref) );
+            }
+        }
+        SECTION( "density-matrix" ) {
+            
+            SECTION( "basis state" ) {
+                
+                int ind = GENERATE( range(0,1<<NUM_QUBITS) );
+                initClassicalState(mat, ind);
+                
+                long long int outcome = 0;
+                for (int q=0; q<numQubits; q++)
+                    outcome += ((ind >> qubits[q]) & 1) * (1 << q);
+                
+                // every shot must produce the same outcome
+                numShots = 100;
+                sampleOutcomes(mat, qubits, numQubits, numShots, outcomes.data());
+                REQUIRE( std::count(outcomes.begin(), outcomes.begin()+numShots, outcome) == numShots );
+            }
+            SECTION( "random state" ) {
+            
+                QMatrix ref = getRandomDensityMatrix(NUM_QUBITS);
+                toQureg(mat, ref);
+                
+                // prob is sum of diagonals which encode outcome 
+                for (size_t i=0; i<ref.size(); i++) {
+                    int outcome = 0;
+                    for (int q=0; q<numQubits; q++) {
+                        int bit = (i >> qubits[q]) & 1;
+                        outcome += bit * (1 << q);
+                    }
+                    refProbs[outcome] += real(ref[i][i]);
+                }
+                
+                sampleOutcomes(mat, qubits, numQubits, numShots, outcomes.data());
+                checkFrequencies();
+                
+                // the state is unchanged
+                REQUIRE( areEqual(mat, ref) );
+            }
+            SECTION( "mixed basis states" ) {
+                
+                // a lopsided mixture, whose diagonals must not be confused with their squares
+                int lastInd = (1<<NUM_QUBITS) - 1;
+                QMatrix ref = getZeroMatrix(1<<NUM_QUBITS);
+                ref[0][0] = .8;
+                ref[lastInd][lastInd] = .2;
+                toQureg(mat, ref);
+                
+                refProbs[0] += .8;
+                refProbs[numOutcomes-1] += .2;
+                
+                sampleOutcomes(mat, qubits, numQubits, numShots, outcomes.data());
+                checkFrequencies();
+            }
+        }
+    }
+    SECTION( "input validation" ) {
+        
+        int numQubits = 3;
+        int qubits[] = {0, 1, 2};
+        long long int outcomes[1];
+        
+        SECTION( "number of qubits" ) {
+            
+            numQubits = GENERATE( -1, 0, NUM_QUBITS+1 );
+            REQUIRE_THROWS_WITH( sampleOutcomes(mat, qubits, numQubits, 1, outcomes), Contains("Invalid number of target qubits") );
+        }
+        SECTION( "qubit indices" ) {
+            
+            qubits[GENERATE_COPY(range(0,numQubits))] = GENERATE( -1, NUM_QUBITS );
+            REQUIRE_THROWS_WITH( sampleOutcomes(mat, qubits, numQubits, 1, outcomes), Contains("Invalid target qubit") );
+        }
+        SECTION( "repetition of qubits" ) {
+            
+            qubits[GENERATE_COPY(1,2)] = qubits[0];
+            REQUIRE_THROWS_WITH( sampleOutcomes(mat, qubits, numQubits, 1, outcomes), Contains("qubits must be unique") );
+        }
+        SECTION( "number of shots" ) {
+            
+            int numShots = GENERATE( -1, 0 );
+            REQUIRE_THROWS_WITH( sampleOutcomes(vec, qubits, numQubits, numShots, outcomes), Contains("Invalid number of shots") );
+        }
+    }
+    destroyQureg(vec, QUEST_ENV);
+    destroyQureg(mat, QUEST_ENV); 
+}
@@ -413,6 +413,215 @@ TEST_CASE( "createDiagonalOpFromPauliHamilFile", "[data_structures]" ) {
 
 
 
+/** @sa createNoiseModel
+ * @ingroup unittest 
+ */
+TEST_CASE( "createNoiseModel", "[data_structures]" ) {
+    
+    SECTION( "correctness" ) {
+        
+        int numQb = GENERATE( range(1,NUM_QUBITS+1) );
+        NoiseModel model = createNoiseModel(numQb);
+        
+        // every gate type and qubit is noiseless
+        REQUIRE( model.numQubits == numQb );
+        for (int i=0; i<3*numQb; i++) {
+            REQUIRE( model.channels[i].type == NO_NOISE );
+            REQUIRE( model.numKrausOps[i] == 0 );
+        }
+        for (int q=0; q<numQb; q++)
+            REQUIRE( model.readoutErrorProbs[q] == 0 );
+        
+        destroyNoiseModel(model);
+    }
+    SECTION( "input validation" ) {
+        
+        SECTION( "number of qubits" ) {
+            
+            int numQb = GENERATE( -1, 0 );
+            REQUIRE_THROWS_WITH( createNoiseModel(numQb), Contains("Invalid number of qubits") );
+        }
+    }
+}
+
+
+
+/** @sa createPackedDensityQureg
+ * @ingroup unittest 
+ */
+TEST_CASE( "createPackedDensityQureg", "[data_structures]" ) {
+    
+    // packed density matrices are never distributed
+    if (QUEST_ENV.numRanks > 1) {
+        REQUIRE_THROWS_WITH( createPackedDensityQureg(NUM_QUBITS, QUEST_ENV), Contains("cannot be distributed") );
+        return;
+    }
+    
+    // every element of the packed qureg must agree with the reference matrix
+    auto areEqualPacked = [](Qureg packed, QMatrix ref) {
+        for (size_t r=0; r<ref.size(); r++) {
+            for (size_t c=0; c<ref.size(); c++) {
+                Complex amp = getDensityAmp(packed, r, c);
+                if (absReal(amp.real - real(ref[r][c])) > REAL_EPS || absReal(amp.imag - imag(ref[r][c])) > REAL_EPS)
+                    return false;
+            }
+        }
+        return true;
+    };
+    
+    SECTION( "correctness" ) {
+        
+        SECTION( "initial state" ) {
+            
+            int numQb = GENERATE( range(1, NUM_QUBITS+1) );
+            Qureg reg = createPackedDensityQureg(numQb, QUEST_ENV);
+            
+            // only the upper triangle (including the diagonal) is stored
+            long long int dim = 1LL << numQb;
+            REQUIRE( reg.isDensityMatrix );
+            REQUIRE( reg.isPackedDensityMatrix );
+            REQUIRE( reg.numQubitsRepresented == numQb );
+            REQUIRE( reg.numAmpsTotal == dim*(dim+1)/2 );
+            
+            // reg begins in |0><0|
+            QMatrix ref = getZeroMatrix(dim);
+            ref[0][0] = 1;
+            REQUIRE( areEqualPacked(reg, ref) );
+            
+            destroyQureg(reg, QUEST_ENV);
+        }
+        SECTION( "operations" ) {
+            
+            Qureg packed = createPackedDensityQureg(NUM_QUBITS, QUEST_ENV);
+            Qureg dense = createDensityQureg(NUM_QUBITS, QUEST_ENV);
+            Qureg pure = createQureg(NUM_QUBITS, QUEST_ENV);
+            
+            // begin in a random pure state
+            toQureg(pure, getRandomStateVector(NUM_QUBITS));
+            initPureState(packed, pure);
+            initPureState(dense, pure);
+            
+            // apply an identical random circuit of every supported operation to both
+            ComplexMatrix2 u1 = toComplexMatrix2(getRandomUnitary(1));
+            ComplexMatrix4 u2 = toComplexMatrix4(getRandomUnitary(2));
+            std::vector<QMatrix> kraus1 = getRandomKrausMap(1, 3);
+            std::vector<QMatrix> kraus2 = getRandomKrausMap(2, 3);
+            ComplexMatrix2 ops1[3];
+            ComplexMatrix4 ops2[3];
+            for (int n=0; n<3; n++) {
+                ops1[n] = toComplexMatrix2(kraus1[n]);
+                ops2[n] = toComplexMatrix4(kraus2[n]);
+            }
+            int ctrls[] = {0, 4};
+            int targs[] = {1, 3};
+            int ctrlState[] = {1, 0};
+            int ctrl[] = {2};
+            for (Qureg reg : {packed, dense}) {
+                hadamard(reg, 0);
+                rotateX(reg, 1, .3);
+                rotateY(reg, 2, -.7);
+                rotateZ(reg, 3, 1.1);
+                pauliX(reg, 4);
+                pauliY(reg, 2);
+                pauliZ(reg, 1);
+                sGate(reg, 3);
+                tGate(reg, 0);
+                phaseShift(reg, 4, .9);
+                controlledNot(reg, 3, 1);
+                controlledPauliY(reg, 0, 4);
+                controlledPhaseShift(reg, 2, 4, -1.3);
+                controlledPhaseFlip(reg, 1, 3);
+                controlledRotateAroundAxis(reg, 4, 2, .4, {1, -2, .5});
+                multiControlledUnitary(reg, ctrls, 2, 2, u1);
+                multiStateControlledUnitary(reg, ctrls, ctrlState, 2, 3, u1);
+                twoQubitUnitary(reg, 4, 1, u2);
+                multiControlledTwoQubitUnitary(reg, ctrl, 1, 0, 3, u2);
+                multiControlledMultiQubitNot(reg, ctrls, 2, targs, 2);
+                multiQubitNot(reg, targs, 2);
+                multiRotateZ(reg, targs, 2, .6);
+                multiControlledMultiRotateZ(reg, ctrls, 2, targs, 2, -.2);
+                swapGate(reg, 0, 3);
+                sqrtSwapGate(reg, 4, 2);
+                mixDephasing(reg, 0, .1);
+                mixTwoQubitDephasing(reg, 3, 1, .2);
+                mixDepolarising(reg, 2, .15);
+                mixTwoQubitDepolarising(reg, 4, 0, .3);
+                mixDamping(reg, 1, .25);
+                mixPauli(reg, 3, .05, .1, .15);
+                mixKrausMap(reg, 4, ops1, 3);
+                mixTwoQubitKrausMap(reg, 2, 0, ops2, 3);
+            }
+            QMatrix ref = toQMatrix(dense);
+            REQUIRE( areEqualPacked(packed, ref) );
+            
+            // calculations agree
+            REQUIRE( calcTotalProb(packed) == Approx(calcTotalProb(dense)).margin(REAL_EPS) );
+            REQUIRE( calcPurity(packed) == Approx(calcPurity(dense)).margin(REAL_EPS) );
+            QVector psi = toQVector(pure);
+            qcomp fid = 0;
+            for (size_t r=0; r<psi.size(); r++)
+                for (size_t c=0; c<psi.size(); c++)
+                    fid += conj(psi[r]) * ref[r][c] * psi[c];
+            REQUIRE( calcFidelity(packed, pure) == Approx(real(fid)).margin(REAL_EPS) );
+            for (int q=0; q<NUM_QUBITS; q++)
+                REQUIRE( calcProbOfOutcome(packed, q, 1) == Approx(calcProbOfOutcome(dense, q, 1)).margin(REAL_EPS) );
+            
+            int numTerms = 10;
+            PauliHamil hamil = createPauliHamil(NUM_QUBITS, numTerms);
+            setRandomPauliSum(hamil);
+            Qureg packedWork = createCloneQureg(packed, QUEST_ENV);
+            Qureg denseWork = createCloneQureg(dense, QUEST_ENV);
+            qreal expec = calcExpecPauliHamil(dense, hamil, denseWork);
+            REQUIRE( calcExpecPauliHamil(packed, hamil, packedWork) == Approx(expec).margin(10*REAL_EPS) );
+            REQUIRE( calcExpecPauliSum(packed, hamil.pauliCodes, hamil.termCoeffs, numTerms, packedWork) == Approx(expec).margin(10*REAL_EPS) );
+            
+            // the clone is an exact copy
+            REQUIRE( areEqualPacked(packedWork, ref) );
+            
+            // collapse upon the same outcome
+            qreal prob = collapseToOutcome(packed, 2, 0);
+            REQUIRE( prob == Approx(collapseToOutcome(dense, 2, 0)).margin(REAL_EPS) );
+            REQUIRE( areEqualPacked(packed, toQMatrix(dense)) );
+            
+            destroyPauliHamil(hamil);
+            destroyQureg(packedWork, QUEST_ENV);
+            destroyQureg(denseWork, QUEST_ENV);
+            destroyQureg(packed, QUEST_ENV);
+            destroyQureg(dense, QUEST_ENV);
+            destroyQureg(pure, QUEST_ENV);
+        }
+    }
+    SECTION( "input validation" ) {
+        
+        SECTION( "number of qubits" ) {
+            
+            int numQb = GENERATE( -1, 0 );
+            REQUIRE_THROWS_WITH( createPackedDensityQureg(numQb, QUEST_ENV), Contains("Invalid number of qubits") );
+        }
+        SECTION( "distribution" ) {
+            
+            QuESTEnv env = QUEST_ENV;
+            env.numRanks = 2;
+            REQUIRE_THROWS_WITH( createPackedDensityQureg(NUM_QUBITS, env), Contains("cannot be distributed") );
+        }
+        SECTION( "unsupported operation" ) {
+            
+            Qureg packed = createPackedDensityQureg(NUM_QUBITS, QUEST_ENV);
+            Qureg dense = createDensityQureg(NUM_QUBITS, QUEST_ENV);
+            
+            REQUIRE_THROWS_WITH( applyFullQFT(packed), Contains("packed density matrices") );
+            REQUIRE_THROWS_WITH( startDeferringGates(packed, 2), Contains("packed density matrices") );
+            REQUIRE_THROWS_WITH( calcDensityInnerProduct(dense, packed), Contains("packed density matrices") );
+            REQUIRE_THROWS_WITH( cloneQureg(dense, packed), Contains("both be packed") );
+            
+            destroyQureg(packed, QUEST_ENV);
+            destroyQureg(dense, QUEST_ENV);
+        }
+    }
+}
+
+
+
 /** @sa createPauliHamil
  * @ingroup unittest 
  * @author Tyson Jones 
@@ -703,6 +912,19 @@ TEST_CASE( "destroyDiagonalOp", "[data_structures]" ) {
 
 
 
+/** @sa destroyNoiseModel
+ * @ingroup unittest 
+ */
+TEST_CASE( "destroyNoiseModel", "[data_structures]" ) {
+    
+    /* there is no meaningful way to test this, since the struct is passed 
+     * by value and its pointers are not updated.
+     */
+    SUCCEED( );
+}
+
+
+
 /** @sa destroyPauliHamil
  * @ingroup unittest 
  * @author Tyson Jones 
@@ -795,8 +1017,8 @@ TEST_CASE( "initDiagonalOp", "[data_structures]" ) {
         // via if it modifies an all-unity state-vec correctly 
         Qureg qureg = createQureg(numQb, QUEST_ENV);
         for (long long int i=0; i<qureg.numAmpsPerChunk; i++) {
-            qureg.stateVec.real[i] = 1;
-            qureg.stateVec.imag[i] = 1;
+            qureg.stateVec.real[AMP_INDEX(i)] = 1;
+            qureg.stateVec.imag[AMP_INDEX(i)] = 1;
         }
         copyStateToGPU(qureg);
         
@@ -1027,6 +1249,180 @@ TEST_CASE( "setDiagonalOpElems", "[data_structures]" ) {
 
 
 
+/** @sa setGateKrausNoise
+ * @ingroup unittest 
+ */
+TEST_CASE( "setGateKrausNoise", "[data_structures]" ) {
+    
+    NoiseModel model = createNoiseModel(NUM_QUBITS);
+    
+    SECTION( "correctness" ) {
+        
+        enum noisyGateType type = GENERATE( ONE_QUBIT_GATES, TWO_QUBIT_GATES, MULTI_QUBIT_GATES );
+        int qubit = GENERATE( range(0,NUM_QUBITS) );
+        int numOps = GENERATE( range(1,5) ); // max 4 inclusive
+        int slot = type*NUM_QUBITS + qubit;
+        
+        std::vector<QMatrix> matrs = getRandomKrausMap(1, numOps);
+        ComplexMatrix2 ops[numOps];
+        for (int i=0; i<numOps; i++)
+            ops[i] = toComplexMatrix2(matrs[i]);
+        
+        // the Kraus map replaces any previous channel
+        setGateNoise(model, type, qubit, (NoiseChannel) {.type=DEPHASING_NOISE, .prob=.1});
+        setGateKrausNoise(model, type, qubit, ops, numOps);
+        REQUIRE( model.channels[slot].type == NO_NOISE );
+        REQUIRE( model.numKrausOps[slot] == numOps );
+        
+        // the operators are copied
+        for (int i=0; i<numOps; i++) {
+            REQUIRE( areEqual(toQMatrix(model.krausOps[slot][i]), matrs[i]) );
+            ops[i].real[0][0] = 0;
+        }
+        REQUIRE( areEqual(toQMatrix(model.krausOps[slot][0]), matrs[0]) );
+        
+        // and may be replaced
+        QMatrix unitary = getRandomUnitary(1);
+        ComplexMatrix2 op = toComplexMatrix2(unitary);
+        setGateKrausNoise(model, type, qubit, &op, 1);
+        REQUIRE( model.numKrausOps[slot] == 1 );
+        REQUIRE( areEqual(toQMatrix(model.krausOps[slot][0]), unitary) );
+        
+        // no other slot is modified
+        for (int i=0; i<3*NUM_QUBITS; i++)
+            if (i != slot)
+                REQUIRE( model.numKrausOps[i] == 0 );
+    }
+    SECTION( "input validation" ) {
+        
+        SECTION( "gate type" ) {
+            
+            enum noisyGateType type = (enum noisyGateType) GENERATE( -1, 3 );
+            REQUIRE_THROWS_WITH( setGateKrausNoise(model, type, 0, NULL, 1), Contains("Invalid noisy gate type") );
+        }
+        SECTION( "qubit index" ) {
+            
+            int qubit = GENERATE( -1, NUM_QUBITS );
+            REQUIRE_THROWS_WITH( setGateKrausNoise(model, ONE_QUBIT_GATES, qubit, NULL, 1), Contains("Invalid target qubit") );
+        }
+        SECTION( "number of operators" ) {
+            
+            int numOps = GENERATE( 0, 5 );
+            REQUIRE_THROWS_WITH( setGateKrausNoise(model, ONE_QUBIT_GATES, 0, NULL, numOps), Contains("operators") );
+        }
+        SECTION( "trace preserving" ) {
+            
+            int numOps = GENERATE( range(1,5) ); // max 4 inclusive
+            std::vector<QMatrix> matrs = getRandomKrausMap(1, numOps);
+            ComplexMatrix2 ops[numOps];
+            for (int i=0; i<numOps; i++)
+                ops[i] = toComplexMatrix2(matrs[i]);
+            
+            // make invalid
+            ops[GENERATE_REF( range(0,numOps) )].real[0][0] = 0;
+            REQUIRE_THROWS_WITH( setGateKrausNoise(model, ONE_QUBIT_GATES, 0, ops, numOps), Contains("trace preserving") );
+        }
+    }
+    destroyNoiseModel(model);
+}
+
+
+
+/** @sa setGateNoise
+ * @ingroup unittest 
+ */
+TEST_CASE( "setGateNoise", "[data_structures]" ) {
+    
+    NoiseModel model = createNoiseModel(NUM_QUBITS);
+    
+    SECTION( "correctness" ) {
+        
+        enum noisyGateType type = GENERATE( ONE_QUBIT_GATES, TWO_QUBIT_GATES, MULTI_QUBIT_GATES );
+        int qubit = GENERATE( range(0,NUM_QUBITS) );
+        int slot = type*NUM_QUBITS + qubit;
+        
+        // the channel replaces any previous Kraus map
+        std::vector<QMatrix> matrs = getRandomKrausMap(1, 2);
+        ComplexMatrix2 ops[] = {toComplexMatrix2(matrs[0]), toComplexMatrix2(matrs[1])};
+        setGateKrausNoise(model, type, qubit, ops, 2);
+        
+        NoiseChannel channel = {.type=PAULI_NOISE, .prob=0, .probX=.1, .probY=.05, .probZ=.2};
+        setGateNoise(model, type, qubit, channel);
+        REQUIRE( model.numKrausOps[slot] == 0 );
+        REQUIRE( model.channels[slot].type == PAULI_NOISE );
+        REQUIRE( model.channels[slot].probX == channel.probX );
+        REQUIRE( model.channels[slot].probY == channel.probY );
+        REQUIRE( model.channels[slot].probZ == channel.probZ );
+        
+        // no other slot is modified
+        for (int i=0; i<3*NUM_QUBITS; i++)
+            if (i != slot)
+                REQUIRE( model.channels[i].type == NO_NOISE );
+    }
+    SECTION( "input validation" ) {
+        
+        NoiseChannel channel = {.type=DEPOLARISING_NOISE, .prob=.1};
+        
+        SECTION( "gate type" ) {
+            
+            enum noisyGateType type = (enum noisyGateType) GENERATE( -1, 3 );
+            REQUIRE_THROWS_WITH( setGateNoise(model, type, 0, channel), Contains("Invalid noisy gate type") );
+        }
+        SECTION( "qubit index" ) {
+            
+            int qubit = GENERATE( -1, NUM_QUBITS );
+            REQUIRE_THROWS_WITH( setGateNoise(model, ONE_QUBIT_GATES, qubit, channel), Contains("Invalid target qubit") );
+        }
+        SECTION( "channel type" ) {
+            
+            channel.type = (enum noiseChannelType) GENERATE( -1, 5 );
+            REQUIRE_THROWS_WITH( setGateNoise(model, ONE_QUBIT_GATES, 0, channel), Contains("Invalid noise channel type") );
+        }
+        SECTION( "probability" ) {
+            
+            channel.prob = GENERATE( -.1, 1.1 );
+            REQUIRE_THROWS_WITH( setGateNoise(model, ONE_QUBIT_GATES, 0, channel), Contains("Probabilities") );
+        }
+    }
+    destroyNoiseModel(model);
+}
+
+
+
+/** @sa setReadoutNoise
+ * @ingroup unittest 
+ */
+TEST_CASE( "setReadoutNoise", "[data_structures]" ) {
+    
+    NoiseModel model = createNoiseModel(NUM_QUBITS);
+    
+    SECTION( "correctness" ) {
+        
+        int qubit = GENERATE( range(0,NUM_QUBITS) );
+        qreal prob = getRandomReal(0, 1/2.);
+        setReadoutNoise(model, qubit, prob);
+        
+        for (int q=0; q<NUM_QUBITS; q++)
+            REQUIRE( model.readoutErrorProbs[q] == ((q == qubit)? prob : 0) );
+    }
+    SECTION( "input validation" ) {
+        
+        SECTION( "qubit index" ) {
+            
+            int qubit = GENERATE( -1, NUM_QUBITS );
+            REQUIRE_THROWS_WITH( setReadoutNoise(model, qubit, 0), Contains("Invalid target qubit") );
+        }
+        SECTION( "probability" ) {
+            
+            qreal prob = GENERATE( -.1, .6 );
+            REQUIRE_THROWS_WITH( setReadoutNoise(model, 0, prob), Contains("readout error") );
+        }
+    }
+    destroyNoiseModel(model);
+}
+
+
+
 /** @sa syncDiagonalOp
  * @ingroup unittest 
  * @author Tyson Jones 
@@ -1055,8 +1451,8 @@ TEST_CASE( "syncDiagonalOp", "[data_structures]" ) {
         // via if it modifies an all-unity state-vec correctly 
         Qureg qureg = createQureg(numQb, QUEST_ENV);
         for (long long int i=0; i<qureg.numAmpsPerChunk; i++) {
-            qureg.stateVec.real[i] = 1;
-            qureg.stateVec.imag[i] = 1;
+            qureg.stateVec.real[AMP_INDEX(i)] = 1;
+            qureg.stateVec.imag[AMP_INDEX(i)] = 1;
         }
         copyStateToGPU(qureg);
         
@@ -1064,8 +1460,8 @@ TEST_CASE( "syncDiagonalOp", "[data_structures]" ) {
         applyDiagonalOp(qureg, op);
         copyStateFromGPU(qureg);
         for (n=0; n<qureg.numAmpsPerChunk; n++) {
-            REQUIRE( qureg.stateVec.real[n] == 3*n );
-            REQUIRE( qureg.stateVec.imag[n] == -n );
+            REQUIRE( qureg.stateVec.real[AMP_INDEX(n)] == 3*n );
+            REQUIRE( qureg.stateVec.imag[AMP_INDEX(n)] == -n );
         }
         
         destroyQureg(qureg, QUEST_ENV);
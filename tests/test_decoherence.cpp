@@ -14,6 +14,319 @@
 /* allows concise use of Contains in catch's REQUIRE_THROWS_WITH */
 using Catch::Matchers::Contains;
 
+/** Effects the single-qubit Kraus map ops upon the target of a reference density matrix 
+ */
+static void applyReferenceKrausMap(QMatrix& matr, int target, std::vector<QMatrix> ops) {
+    QMatrix sum = getZeroMatrix(matr.size());
+    for (size_t i=0; i<ops.size(); i++) {
+        QMatrix term = matr;
+        applyReferenceOp(term, target, ops[i]);
+        sum += term;
+    }
+    matr = sum;
+}
+
+/** Effects the channel upon the target of a reference density matrix 
+ */
+static void applyReferenceNoiseChannel(QMatrix& matr, int target, NoiseChannel channel) {
+    qreal pX=0, pY=0, pZ=0;
+    if (channel.type == DEPHASING_NOISE)
+        pZ = channel.prob;
+    if (channel.type == DEPOLARISING_NOISE)
+        pX = pY = pZ = channel.prob/3;
+    if (channel.type == PAULI_NOISE) {
+        pX = channel.probX; pY = channel.probY; pZ = channel.probZ;
+    }
+    if (channel.type == DAMPING_NOISE) {
+        QMatrix k0Ref = matr;
+        applyReferenceOp(k0Ref, target, QMatrix{{1,0},{0,sqrt(1-channel.prob)}});
+        applyReferenceOp(matr, target, QMatrix{{0,sqrt(channel.prob)},{0,0}});
+        matr = matr + k0Ref;
+        return;
+    }
+    QMatrix xRef = matr;
+    applyReferenceOp(xRef, target, QMatrix{{0,1},{1,0}}); // X ref X
+    QMatrix yRef = matr;
+    applyReferenceOp(yRef, target, QMatrix{{0,-qcomp(0,1)},{qcomp(0,1),0}}); // Y ref Y
+    QMatrix zRef = matr;
+    applyReferenceOp(zRef, target, QMatrix{{1,0},{0,-1}}); // Z ref Z
+    matr = ((1 - pX - pY - pZ) * matr) + (pX * xRef) + (pY * yRef) + (pZ * zRef);
+}
+
+/** Returns a random valid channel of the given type 
+ */
+static NoiseChannel getRandomNoiseChannel(enum noiseChannelType type) {
+    NoiseChannel channel;
+    channel.type = type;
+    channel.prob = channel.probX = channel.probY = channel.probZ = 0;
+    if (type == DEPHASING_NOISE)
+        channel.prob = getRandomReal(0, 1/2.);
+    if (type == DEPOLARISING_NOISE)
+        channel.prob = getRandomReal(0, 3/4.);
+    if (type == DAMPING_NOISE)
+        channel.prob = getRandomReal(0, 1);
+    if (type == PAULI_NOISE) {
+        channel.probX = getRandomReal(0, 1/4.);
+        channel.probY = getRandomReal(0, 1/4.);
+        channel.probZ = getRandomReal(0, 1/4.);
+    }
+    return channel;
+}
+
+
+
+/** @sa attachNoiseModel
+ * @ingroup unittest 
+ */
+TEST_CASE( "attachNoiseModel", "[decoherence]" ) {
+    
+    PREPARE_TEST(qureg, ref);
+    
+    NoiseModel model = createNoiseModel(NUM_QUBITS);
+    
+    // populates every slot of the model with a random channel, keeping a copy for the reference
+    const int numGateTypes = 3;
+    NoiseChannel channels[numGateTypes][NUM_QUBITS];
+    for (int t=0; t<numGateTypes; t++) {
+        for (int q=0; q<NUM_QUBITS; q++) {
+            channels[t][q] = getRandomNoiseChannel((enum noiseChannelType) getRandomInt(0, 5));
+            setGateNoise(model, (enum noisyGateType) t, q, channels[t][q]);
+        }
+    }
+    
+    // effects the gate op and then the channels of its qubits upon the reference
+    auto applyReferenceNoisyGate = [&](int* ctrls, int numCtrls, int* targs, int numTargs, QMatrix op) {
+        applyReferenceOp(ref, ctrls, numCtrls, targs, numTargs, op);
+        int type = (numCtrls + numTargs == 1)? ONE_QUBIT_GATES : (numCtrls + numTargs == 2)? TWO_QUBIT_GATES : MULTI_QUBIT_GATES;
+        for (int i=0; i<numCtrls; i++)
+            applyReferenceNoiseChannel(ref, ctrls[i], channels[type][ctrls[i]]);
+        for (int i=0; i<numTargs; i++)
+            applyReferenceNoiseChannel(ref, targs[i], channels[type][targs[i]]);
+    };
+    
+    SECTION( "correctness" ) {
+        
+        attachNoiseModel(qureg, model);
+        
+        SECTION( "one-qubit gates" ) {
+            
+            int targ = GENERATE( range(0,NUM_QUBITS) );
+            QMatrix op = getRandomUnitary(1);
+            qreal angle = getRandomReal(-4*M_PI, 4*M_PI);
+            
+            unitary(qureg, targ, toComplexMatrix2(op));
+            applyReferenceNoisyGate(NULL, 0, &targ, 1, op);
+            
+            hadamard(qureg, targ);
+            qreal a = 1/sqrt(2);
+            applyReferenceNoisyGate(NULL, 0, &targ, 1, QMatrix{{a,a},{a,-a}});
+            
+            rotateY(qureg, targ, angle);
+            QMatrix rot{{cos(angle/2),-sin(angle/2)},{sin(angle/2),cos(angle/2)}};
+            applyReferenceNoisyGate(NULL, 0, &targ, 1, rot);
+            
+            REQUIRE( areEqual(qureg, ref, 10*REAL_EPS) );
+        }
+        SECTION( "two-qubit gates" ) {
+            
+            int targs[] = {0, 0};
+            targs[0] = GENERATE( range(0,NUM_QUBITS) );
+            targs[1] = (targs[0] + GENERATE( range(1,NUM_QUBITS) )) % NUM_QUBITS;
+            QMatrix op = getRandomUnitary(2);
+            
+            twoQubitUnitary(qureg, targs[0], targs[1], toComplexMatrix4(op));
+            applyReferenceNoisyGate(NULL, 0, targs, 2, op);
+            
+            controlledNot(qureg, targs[1], targs[0]);
+            applyReferenceNoisyGate(&targs[1], 1, &targs[0], 1, QMatrix{{0,1},{1,0}});
+            
+            controlledPhaseFlip(qureg, targs[0], targs[1]);
+            applyReferenceNoisyGate(&targs[0], 1, &targs[1], 1, QMatrix{{1,0},{0,-1}});
+            
+            REQUIRE( areEqual(qureg, ref, 10*REAL_EPS) );
+        }
+        SECTION( "multi-qubit gates" ) {
+            
+            int ctrls[] = {0, 2};
+            int targ = GENERATE( 1, 3, 4 );
+            QMatrix op = getRandomUnitary(1);
+            
+            multiControlledUnitary(qureg, ctrls, 2, targ, toComplexMatrix2(op));
+            applyReferenceNoisyGate(ctrls, 2, &targ, 1, op);
+            
+            int targs[] = {4, 1, 3};
+            ComplexMatrixN opN = createComplexMatrixN(3);
+            QMatrix ref3 = getRandomUnitary(3);
+            toComplexMatrixN(ref3, opN);
+            multiQubitUnitary(qureg, targs, 3, opN);
+            applyReferenceNoisyGate(NULL, 0, targs, 3, ref3);
+            destroyComplexMatrixN(opN);
+            
+            REQUIRE( areEqual(qureg, ref, 10*REAL_EPS) );
+        }
+        SECTION( "Kraus maps" ) {
+            
+            int targs[] = {0, 0};
+            targs[0] = GENERATE( range(0,NUM_QUBITS) );
+            targs[1] = (targs[0] + 1) % NUM_QUBITS;
+            int numOps = GENERATE( range(1,5) ); // max 4 inclusive
+            
+            // the gates' qubits undergo Kraus maps in lieu of their channels
+            std::vector<QMatrix> matrs[2];
+            for (int i=0; i<2; i++) {
+                matrs[i] = getRandomKrausMap(1, numOps);
+                ComplexMatrix2 ops[numOps];
+                for (int n=0; n<numOps; n++)
+                    ops[n] = toComplexMatrix2(matrs[i][n]);
+                setGateKrausNoise(model, (i==0)? ONE_QUBIT_GATES : TWO_QUBIT_GATES, targs[i], ops, numOps);
+            }
+            
+            QMatrix op = getRandomUnitary(1);
+            unitary(qureg, targs[0], toComplexMatrix2(op));
+            applyReferenceOp(ref, targs[0], op);
+            applyReferenceKrausMap(ref, targs[0], matrs[0]);
+            
+            QMatrix op2 = getRandomUnitary(2);
+            twoQubitUnitary(qureg, targs[0], targs[1], toComplexMatrix4(op2));
+            applyReferenceOp(ref, targs, 2, op2);
+            applyReferenceNoiseChannel(ref, targs[0], channels[TWO_QUBIT_GATES][targs[0]]);
+            applyReferenceKrausMap(ref, targs[1], matrs[1]);
+            
+            REQUIRE( areEqual(qureg, ref, 10*REAL_EPS) );
+        }
+        SECTION( "readout error" ) {
+            
+            int targ = GENERATE( range(0,NUM_QUBITS) );
+            qreal prob = getRandomReal(0, 1/2.);
+            setReadoutNoise(model, targ, prob);
+            
+            // make the outcome probabilities of the debug state valid
+            Qureg pure = createQureg(NUM_QUBITS, QUEST_ENV);
+            QVector vec = getRandomStateVector(NUM_QUBITS);
+            toQureg(pure, vec);
+            initPureState(qureg, pure);
+            ref = getPureDensityMatrix(vec);
+            destroyQureg(pure, QUEST_ENV);
+            
+            // the reported outcome probability includes the chance of a readout error
+            applyReferenceNoiseChannel(ref, targ, (NoiseChannel) {.type=PAULI_NOISE, .prob=0, .probX=prob, .probY=0, .probZ=0});
+            qreal outcomeProb;
+            int outcome = measureWithStats(qureg, targ, &outcomeProb);
+            qreal refProb = 0;
+            for (size_t i=0; i<ref.size(); i++)
+                if (((i >> targ) & 1) == (size_t) outcome)
+                    refProb += real(ref[i][i]);
+            
+            REQUIRE( outcomeProb == Approx(refProb) );
+        }
+        SECTION( "modified model" ) {
+            
+            // changes to the model after attachment affect the qureg
+            int targ = GENERATE( range(0,NUM_QUBITS) );
+            channels[ONE_QUBIT_GATES][targ] = getRandomNoiseChannel(DAMPING_NOISE);
+            setGateNoise(model, ONE_QUBIT_GATES, targ, channels[ONE_QUBIT_GATES][targ]);
+            
+            pauliY(qureg, targ);
+            applyReferenceNoisyGate(NULL, 0, &targ, 1, QMatrix{{0,-qcomp(0,1)},{qcomp(0,1),0}});
+            
+            REQUIRE( areEqual(qureg, ref, 10*REAL_EPS) );
+        }
+    }
+    SECTION( "input validation" ) {
+        
+        SECTION( "density-matrix" ) {
+            
+            Qureg vec = createQureg(NUM_QUBITS, QUEST_ENV);
+            REQUIRE_THROWS_WITH( attachNoiseModel(vec, model), Contains("density matrices") );
+            destroyQureg(vec, QUEST_ENV);
+        }
+        SECTION( "number of qubits" ) {
+            
+            NoiseModel other = createNoiseModel(NUM_QUBITS - 1);
+            REQUIRE_THROWS_WITH( attachNoiseModel(qureg, other), Contains("same number of qubits") );
+            destroyNoiseModel(other);
+        }
+        SECTION( "deferred gates" ) {
+            
+            startDeferringGates(qureg, 2);
+            REQUIRE_THROWS_WITH( attachNoiseModel(qureg, model), Contains("noise model") );
+            stopDeferringGates(qureg);
+            
+            // nor may the deferral which the model relies upon be controlled
+            attachNoiseModel(qureg, model);
+            REQUIRE_THROWS_WITH( startDeferringGates(qureg, 2), Contains("noise model") );
+            REQUIRE_THROWS_WITH( stopDeferringGates(qureg), Contains("noise model") );
+            REQUIRE_THROWS_WITH( applyDeferredGates(qureg), Contains("noise model") );
+        }
+        SECTION( "packed density-matrix" ) {
+            
+            if (QUEST_ENV.numRanks > 1)
+                return;
+            
+            Qureg packed = createPackedDensityQureg(NUM_QUBITS, QUEST_ENV);
+            REQUIRE_THROWS_WITH( attachNoiseModel(packed, model), Contains("packed density matrices") );
+            destroyQureg(packed, QUEST_ENV);
+        }
+        SECTION( "superoperator fits in node" ) {
+            
+            qureg.numAmpsPerChunk = 15; // min 16
+            REQUIRE_THROWS_WITH( attachNoiseModel(qureg, model), Contains("targets too many qubits") );
+        }
+    }
+    destroyQureg(qureg, QUEST_ENV);
+    destroyNoiseModel(model);
+}
+
+
+
+/** @sa detachNoiseModel
+ * @ingroup unittest 
+ */
+TEST_CASE( "detachNoiseModel", "[decoherence]" ) {
+    
+    PREPARE_TEST(qureg, ref);
+    
+    NoiseModel model = createNoiseModel(NUM_QUBITS);
+    for (int q=0; q<NUM_QUBITS; q++) {
+        setGateNoise(model, ONE_QUBIT_GATES, q, getRandomNoiseChannel(DEPOLARISING_NOISE));
+        setGateNoise(model, TWO_QUBIT_GATES, q, getRandomNoiseChannel(DAMPING_NOISE));
+        setReadoutNoise(model, q, getRandomReal(0, 1/2.));
+    }
+    
+    SECTION( "correctness" ) {
+        
+        attachNoiseModel(qureg, model);
+        detachNoiseModel(qureg);
+        
+        // subsequent gates are noiseless
+        int targ = GENERATE( range(0,NUM_QUBITS) );
+        int ctrl = (targ + 1) % NUM_QUBITS;
+        QMatrix op = getRandomUnitary(1);
+        
+        unitary(qureg, targ, toComplexMatrix2(op));
+        applyReferenceOp(ref, targ, op);
+        controlledNot(qureg, ctrl, targ);
+        applyReferenceOp(ref, ctrl, targ, QMatrix{{0,1},{1,0}});
+        
+        REQUIRE( areEqual(qureg, ref, 10*REAL_EPS) );
+        
+        // and gates may again be deferred
+        startDeferringGates(qureg, 2);
+        stopDeferringGates(qureg);
+        SUCCEED( );
+    }
+    SECTION( "input validation" ) {
+        
+        // detaching from a qureg without a model is harmless
+        Qureg vec = createQureg(NUM_QUBITS, QUEST_ENV);
+        detachNoiseModel(vec);
+        destroyQureg(vec, QUEST_ENV);
+        SUCCEED( );
+    }
+    destroyQureg(qureg, QUEST_ENV);
+    destroyNoiseModel(model);
+}
+
 
 
 /** @sa mixDamping
@@ -435,6 +748,116 @@ TEST_CASE( "mixMultiQubitKrausMap", "[decoherence]" ) {
 
 
 
+/** @sa mixNoiseLayer
+ * @ingroup unittest 
+ */
+TEST_CASE( "mixNoiseLayer", "[decoherence]" ) {
+    
+    PREPARE_TEST(qureg, ref);
+    
+    NoiseChannel channels[NUM_QUBITS];
+    
+    SECTION( "correctness" ) {
+        
+        SECTION( "uniform channels" ) {
+            
+            // every qubit undergoes the same type of channel (with differing probabilities)
+            enum noiseChannelType type = GENERATE( NO_NOISE, DEPHASING_NOISE, DEPOLARISING_NOISE, DAMPING_NOISE, PAULI_NOISE );
+            for (int q=0; q<NUM_QUBITS; q++)
+                channels[q] = getRandomNoiseChannel(type);
+            
+            mixNoiseLayer(qureg, channels);
+            for (int q=0; q<NUM_QUBITS; q++)
+                applyReferenceNoiseChannel(ref, q, channels[q]);
+            
+            REQUIRE( areEqual(qureg, ref, 10*REAL_EPS) );
+        }
+        SECTION( "mixed channels" ) {
+            
+            // every qubit undergoes a random type of channel
+            GENERATE( range(0,10) );
+            for (int q=0; q<NUM_QUBITS; q++)
+                channels[q] = getRandomNoiseChannel((enum noiseChannelType) getRandomInt(0, 5));
+            
+            mixNoiseLayer(qureg, channels);
+            for (int q=0; q<NUM_QUBITS; q++)
+                applyReferenceNoiseChannel(ref, q, channels[q]);
+            
+            REQUIRE( areEqual(qureg, ref, 10*REAL_EPS) );
+        }
+        SECTION( "full batches" ) {
+            
+            // a larger register admits batches of 4 non-dephasing channels, both upon the lowest
+            // qubits and (when those are at most dephased) upon runs of contiguous amplitudes
+            int numQb = 7;
+            Qureg big = createDensityQureg(numQb, QUEST_ENV);
+            QMatrix bigRef = getRandomDensityMatrix(numQb);
+            toQureg(big, bigRef);
+            
+            int numLow = GENERATE( 0, 3 );
+            NoiseChannel bigChannels[7];
+            for (int q=0; q<numQb; q++) {
+                enum noiseChannelType type = (q < numLow)?
+                    (enum noiseChannelType) getRandomInt(0, 2) :  // NO_NOISE or DEPHASING_NOISE
+                    (enum noiseChannelType) getRandomInt(2, 5);   // DEPOLARISING, DAMPING or PAULI
+                bigChannels[q] = getRandomNoiseChannel(type);
+            }
+            
+            mixNoiseLayer(big, bigChannels);
+            for (int q=0; q<numQb; q++)
+                applyReferenceNoiseChannel(bigRef, q, bigChannels[q]);
+            
+            REQUIRE( areEqual(big, bigRef, 10*REAL_EPS) );
+            destroyQureg(big, QUEST_ENV);
+        }
+    }
+    SECTION( "input validation" ) {
+        
+        for (int q=0; q<NUM_QUBITS; q++)
+            channels[q] = getRandomNoiseChannel(NO_NOISE);
+        int target = GENERATE( range(0,NUM_QUBITS) );
+        
+        SECTION( "channel type" ) {
+            
+            channels[target].type = (enum noiseChannelType) GENERATE( -1, 5 );
+            REQUIRE_THROWS_WITH( mixNoiseLayer(qureg, channels), Contains("Invalid noise channel type") );
+        }
+        SECTION( "probability" ) {
+            
+            // probs must be in [0, 1]
+            channels[target].type = (enum noiseChannelType) GENERATE( DEPHASING_NOISE, DEPOLARISING_NOISE, DAMPING_NOISE );
+            channels[target].prob = GENERATE( -.1, 1.1 );
+            REQUIRE_THROWS_WITH( mixNoiseLayer(qureg, channels), Contains("Probabilities") );
+        }
+        SECTION( "maximal mixing" ) {
+            
+            channels[target].type = DEPHASING_NOISE;
+            channels[target].prob = .6;
+            REQUIRE_THROWS_WITH( mixNoiseLayer(qureg, channels), Contains("dephase") && Contains("cannot exceed") );
+            
+            channels[target].type = DEPOLARISING_NOISE;
+            channels[target].prob = .8;
+            REQUIRE_THROWS_WITH( mixNoiseLayer(qureg, channels), Contains("depolarising") && Contains("cannot exceed") );
+            
+            // must satisfy px, py, pz < 1 - px - py - pz
+            channels[target].type = PAULI_NOISE;
+            channels[target].probX = .3;
+            channels[target].probY = .3;
+            channels[target].probZ = .3;
+            REQUIRE_THROWS_WITH( mixNoiseLayer(qureg, channels), Contains("cannot exceed the probability") );
+        }
+        SECTION( "density-matrix" ) {
+            
+            Qureg vec = createQureg(NUM_QUBITS, QUEST_ENV);
+            REQUIRE_THROWS_WITH( mixNoiseLayer(vec, channels), Contains("density matrices") );
+            destroyQureg(vec, QUEST_ENV);
+        }
+    }
+    destroyQureg(qureg, QUEST_ENV);
+}
+
+
+
 /** @sa mixPauli
  * @ingroup unittest 
  * @author Tyson Jones 
@@ -8,6 +8,117 @@ using Catch::Matchers::Contains;
 
 
 
+/** @sa collapseToMultiOutcome
+ * @ingroup unittest 
+ */
+TEST_CASE( "collapseToMultiOutcome", "[gates]" ) {
+    
+    Qureg vec = createQureg(NUM_QUBITS, QUEST_ENV);
+    Qureg mat = createDensityQureg(NUM_QUBITS, QUEST_ENV);
+    
+    SECTION( "correctness" ) {
+        
+        // try every possible sub-register
+        int numQubits = GENERATE_COPY( range(1,NUM_QUBITS+1) );
+        int* qubits = GENERATE_COPY( sublists(range(0,NUM_QUBITS), numQubits) );
+        long long int outcome = getRandomInt(0, 1<<numQubits);
+        
+        // the joint outcome of the qubits in basis state ind
+        auto getOutcome = [&](size_t ind) {
+            long long int out = 0;
+            for (int q=0; q<numQubits; q++)
+                out |= ((ind >> qubits[q]) & 1) << q;
+            return out;
+        };
+        
+        SECTION( "state-vector" ) {
+            
+            QVector vecRef = getRandomStateVector(NUM_QUBITS);
+            toQureg(vec, vecRef);
+            
+            // calculate prob of outcome
+            qreal prob = 0;
+            for (size_t ind=0; ind<vecRef.size(); ind++)
+                if (getOutcome(ind) == outcome)
+                    prob += pow(abs(vecRef[ind]), 2);
+                
+            // renormalise by the outcome prob
+            for (size_t ind=0; ind<vecRef.size(); ind++) {
+                if (getOutcome(ind) == outcome)
+                    vecRef[ind] /= sqrt(prob);
+                else 
+                    vecRef[ind] = 0;
+            }
+            
+            qreal res = collapseToMultiOutcome(vec, qubits, numQubits, outcome);
+            REQUIRE( res == Approx(prob) );
+            REQUIRE( areEqual(vec, vecRef) );
+        }
+        SECTION( "density-matrix" ) {
+            
+            QMatrix matRef = getRandomDensityMatrix(NUM_QUBITS);
+            toQureg(mat, matRef);
+            
+            // prob is sum of diagonal amps where qubits are in outcome
+            qreal prob = 0;
+            for (size_t ind=0; ind<matRef.size(); ind++)
+                if (getOutcome(ind) == outcome)
+                    prob += real(matRef[ind][ind]);
+            
+            // renorm (/prob) every |*outcome*><*outcome*| state, zeroing all others 
+            for (size_t r=0; r<matRef.size(); r++) {
+                for (size_t c=0; c<matRef.size(); c++) {
+                    if (getOutcome(r) == outcome && getOutcome(c) == outcome)
+                        matRef[r][c] /= prob;
+                    else
+                        matRef[r][c] = 0;
+                }
+            }
+            
+            qreal res = collapseToMultiOutcome(mat, qubits, numQubits, outcome);
+            REQUIRE( res == Approx(prob) );
+            REQUIRE( areEqual(mat, matRef) );
+        }
+    }
+    SECTION( "input validation" ) {
+        
+        int numQubits = 3;
+        int qubits[] = {0, 1, 2};
+        
+        SECTION( "number of qubits" ) {
+            
+            numQubits = GENERATE( -1, 0, NUM_QUBITS+1 );
+            REQUIRE_THROWS_WITH( collapseToMultiOutcome(mat, qubits, numQubits, 0), Contains("Invalid number of target qubits") );
+        }
+        SECTION( "qubit indices" ) {
+            
+            qubits[GENERATE_COPY(range(0,numQubits))] = GENERATE( -1, NUM_QUBITS );
+            REQUIRE_THROWS_WITH( collapseToMultiOutcome(mat, qubits, numQubits, 0), Contains("Invalid target qubit") );
+        }
+        SECTION( "repetition of qubits" ) {
+            
+            qubits[GENERATE_COPY(1,2)] = qubits[0];
+            REQUIRE_THROWS_WITH( collapseToMultiOutcome(mat, qubits, numQubits, 0), Contains("qubits must be unique") );
+        }
+        SECTION( "outcome value" ) {
+            
+            long long int outcome = GENERATE( -1, 8 );
+            REQUIRE_THROWS_WITH( collapseToMultiOutcome(mat, qubits, numQubits, outcome), Contains("Invalid measurement outcome") );
+        }
+        SECTION( "outcome probability" ) {
+            
+            initZeroState(vec);
+            REQUIRE_THROWS_WITH( collapseToMultiOutcome(vec, qubits, numQubits, 1), Contains("Can't collapse to state with zero probability") );
+            initClassicalState(vec, 5);
+            REQUIRE_THROWS_WITH( collapseToMultiOutcome(vec, qubits, numQubits, 0), Contains("Can't collapse to state with zero probability") );
+        }
+    }
+    destroyQureg(vec, QUEST_ENV);
+    destroyQureg(mat, QUEST_ENV);
+}
+
+
+
 /** @sa collapseToOutcome
  * @ingroup unittest 
  * @author Tyson Jones 
@@ -206,6 +317,111 @@ TEST_CASE( "measure", "[gates]" ) {
 
 
 
+/** @sa measureMultiple
+ * @ingroup unittest 
+ */
+TEST_CASE( "measureMultiple", "[gates]" ) {
+    
+    Qureg vec = createQureg(NUM_QUBITS, QUEST_ENV);
+    Qureg mat = createDensityQureg(NUM_QUBITS, QUEST_ENV);
+        
+    SECTION( "correctness" ) {
+        
+        // try every possible sub-register
+        int numQubits = GENERATE_COPY( range(1,NUM_QUBITS+1) );
+        int* qubits = GENERATE_COPY( sublists(range(0,NUM_QUBITS), numQubits) );
+        
+        // the joint outcome of the qubits in basis state ind
+        auto getOutcome = [&](size_t ind) {
+            long long int out = 0;
+            for (int q=0; q<numQubits; q++)
+                out |= ((ind >> qubits[q]) & 1) << q;
+            return out;
+        };
+        
+        SECTION( "state-vector" ) {
+            
+            QVector vecRef = getRandomStateVector(NUM_QUBITS);
+            toQureg(vec, vecRef);
+            
+            long long int outcome = measureMultiple(vec, qubits, numQubits);
+            REQUIRE( outcome >= 0 );
+            REQUIRE( outcome < (1LL << numQubits) );
+            
+            // calculate prob of this outcome
+            qreal prob = 0;
+            for (size_t ind=0; ind<vecRef.size(); ind++)
+                if (getOutcome(ind) == outcome)
+                    prob += pow(abs(vecRef[ind]), 2);
+                
+            REQUIRE( prob > REAL_EPS );
+                
+            // renormalise by the outcome prob
+            for (size_t ind=0; ind<vecRef.size(); ind++) {
+                if (getOutcome(ind) == outcome)
+                    vecRef[ind] /= sqrt(prob);
+                else 
+                    vecRef[ind] = 0;
+            }
+            REQUIRE( areEqual(vec, vecRef) );
+        }
+        SECTION( "density-matrix" ) {
+            
+            QMatrix matRef = getRandomDensityMatrix(NUM_QUBITS);
+            toQureg(mat, matRef);
+            
+            long long int outcome = measureMultiple(mat, qubits, numQubits);
+            REQUIRE( outcome >= 0 );
+            REQUIRE( outcome < (1LL << numQubits) );
+            
+            // compute prob of this outcome
+            qreal prob = 0;
+            for (size_t ind=0; ind<matRef.size(); ind++)
+                if (getOutcome(ind) == outcome)
+                    prob += real(matRef[ind][ind]);
+            
+            REQUIRE( prob > REAL_EPS );
+                        
+            // renorm (/prob) every |*outcome*><*outcome*| state, zeroing all others 
+            for (size_t r=0; r<matRef.size(); r++) {
+                for (size_t c=0; c<matRef.size(); c++) {
+                    if (getOutcome(r) == outcome && getOutcome(c) == outcome)
+                        matRef[r][c] /= prob;
+                    else
+                        matRef[r][c] = 0;
+                }
+            }
+            
+            REQUIRE( areEqual(mat, matRef) );
+        }
+    }
+    SECTION( "input validation" ) {
+        
+        int numQubits = 3;
+        int qubits[] = {0, 1, 2};
+        
+        SECTION( "number of qubits" ) {
+            
+            numQubits = GENERATE( -1, 0, NUM_QUBITS+1 );
+            REQUIRE_THROWS_WITH( measureMultiple(vec, qubits, numQubits), Contains("Invalid number of target qubits") );
+        }
+        SECTION( "qubit indices" ) {
+            
+            qubits[GENERATE_COPY(range(0,numQubits))] = GENERATE( -1, NUM_QUBITS );
+            REQUIRE_THROWS_WITH( measureMultiple(vec, qubits, numQubits), Contains("Invalid target qubit") );
+        }
+        SECTION( "repetition of qubits" ) {
+            
+            qubits[GENERATE_COPY(1,2)] = qubits[0];
+            REQUIRE_THROWS_WITH( measureMultiple(vec, qubits, numQubits), Contains("qubits must be unique") );
+        }
+    }
+    destroyQureg(vec, QUEST_ENV);
+    destroyQureg(mat, QUEST_ENV);
+}
+
+
+
 /** @sa measureWithStats
  * @ingroup unittest 
  * @author Tyson Jones 
@@ -297,4 +513,104 @@ TEST_CASE( "measureWithStats", "[gates]" ) {
     }
     destroyQureg(vec, QUEST_ENV);
     destroyQureg(mat, QUEST_ENV);
-}
\ No newline at end of file
+}
+
+
+
+/** @sa seedQuregRNG
+ * @ingroup unittest 
+ */
+TEST_CASE( "seedQuregRNG", "[gates]" ) {
+    
+    int numShots = 100;
+    int qubits[] = {0, 1, 2};
+    int numQubits = 3;
+    
+    Qureg vec1 = createQureg(NUM_QUBITS, QUEST_ENV);
+    Qureg vec2 = createQureg(NUM_QUBITS, QUEST_ENV);
+    
+    QVector ref = getRandomStateVector(NUM_QUBITS);
+    
+    SECTION( "same seeds reproduce outcomes" ) {
+        
+        unsigned long int seed = GENERATE( 0, 1, 12345 );
+        seedQuregRNG(vec1, seed);
+        seedQuregRNG(vec2, seed);
+        
+        // interleave draws upon both quregs, which must not disturb one another
+        int numDiffs = 0;
+        for (int s=0; s<numShots; s++) {
+            toQureg(vec1, ref);
+            toQureg(vec2, ref);
+            numDiffs += (measure(vec1, 0) != measure(vec2, 0));
+            numDiffs += (measureMultiple(vec1, qubits, numQubits) != measureMultiple(vec2, qubits, numQubits));
+        }
+        REQUIRE( numDiffs == 0 );
+        
+        std::vector<long long int> outcomes1(numShots);
+        std::vector<long long int> outcomes2(numShots);
+        toQureg(vec1, ref);
+        toQureg(vec2, ref);
+        sampleOutcomes(vec1, qubits, numQubits, numShots, outcomes1.data());
+        sampleOutcomes(vec2, qubits, numQubits, numShots, outcomes2.data());
+        REQUIRE( outcomes1 == outcomes2 );
+    }
+    SECTION( "different seeds give different outcomes" ) {
+        
+        seedQuregRNG(vec1, 1);
+        seedQuregRNG(vec2, 2);
+        
+        // the chance of 100 identical samples of a random 3-qubit distribution is negligible
+        std::vector<long long int> outcomes1(numShots);
+        std::vector<long long int> outcomes2(numShots);
+        toQureg(vec1, ref);
+        toQureg(vec2, ref);
+        sampleOutcomes(vec1, qubits, numQubits, numShots, outcomes1.data());
+        sampleOutcomes(vec2, qubits, numQubits, numShots, outcomes2.data());
+        REQUIRE( outcomes1 != outcomes2 );
+    }
+    SECTION( "reseeding QuEST reproduces outcomes" ) {
+        
+        unsigned long int keys[] = {42, 7};
+        std::vector<long long int> outcomes1(numShots);
+        std::vector<long long int> outcomes2(numShots);
+        
+        seedQuEST(&QUEST_ENV, keys, 2);
+        toQureg(vec1, ref);
+        sampleOutcomes(vec1, qubits, numQubits, numShots, outcomes1.data());
+        
+        seedQuEST(&QUEST_ENV, keys, 2);
+        toQureg(vec1, ref);
+        sampleOutcomes(vec1, qubits, numQubits, numShots, outcomes2.data());
+        
+        REQUIRE( outcomes1 == outcomes2 );
+        
+        // restore non-deterministic seeding for subsequent tests
+        seedQuESTDefault(&QUEST_ENV);
+    }
+    SECTION( "reseeded outcomes are independent of draw order" ) {
+        
+        unsigned long int keys[] = {42, 7};
+        std::vector<long long int> outcomes1(numShots);
+        std::vector<long long int> outcomes2(numShots);
+        
+        // vec2 draws first
+        seedQuEST(&QUEST_ENV, keys, 2);
+        toQureg(vec2, ref);
+        sampleOutcomes(vec2, qubits, numQubits, numShots, outcomes1.data());
+        
+        // vec1 draws before vec2, which must not change vec2's outcomes
+        seedQuEST(&QUEST_ENV, keys, 2);
+        toQureg(vec1, ref);
+        toQureg(vec2, ref);
+        measure(vec1, 0);
+        sampleOutcomes(vec2, qubits, numQubits, numShots, outcomes2.data());
+        
+        REQUIRE( outcomes1 == outcomes2 );
+        
+        // restore non-deterministic seeding for subsequent tests
+        seedQuESTDefault(&QUEST_ENV);
+    }
+    destroyQureg(vec1, QUEST_ENV);
+    destroyQureg(vec2, QUEST_ENV);
+}
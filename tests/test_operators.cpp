@@ -582,6 +582,91 @@ TEST_CASE( "applyMultiControlledMatrixN", "[operators]" ) {
 
 
 
+/** @sa applyMultiQubitProjector
+ * @ingroup unittest 
+ */
+TEST_CASE( "applyMultiQubitProjector", "[operators]" ) {
+    
+    Qureg vec = createQureg(NUM_QUBITS, QUEST_ENV);
+    Qureg mat = createDensityQureg(NUM_QUBITS, QUEST_ENV);
+    
+    SECTION( "correctness" ) {
+        
+        // try every possible sub-register, and every outcome
+        int numQubits = GENERATE_COPY( range(1,NUM_QUBITS+1) );
+        int* qubits = GENERATE_COPY( sublists(range(0,NUM_QUBITS), numQubits) );
+        long long int outcome = GENERATE_COPY( range(0LL, 1LL<<numQubits) );
+        
+        // the joint outcome of the qubits in basis state ind
+        auto getOutcome = [&](size_t ind) {
+            long long int out = 0;
+            for (int q=0; q<numQubits; q++)
+                out |= ((ind >> qubits[q]) & 1) << q;
+            return out;
+        };
+        
+        SECTION( "state-vector" ) {
+            
+            // use a random non-physical state
+            QVector vecRef = getRandomQVector(1 << NUM_QUBITS);
+            toQureg(vec, vecRef);
+            
+            // zero non-outcome reference amps
+            for (size_t ind=0; ind<vecRef.size(); ind++)
+                if (getOutcome(ind) != outcome)
+                    vecRef[ind] = 0;
+            
+            applyMultiQubitProjector(vec, qubits, numQubits, outcome);
+            REQUIRE( areEqual(vec, vecRef) );
+        }
+        SECTION( "density-matrix" ) {
+            
+            // use a random non-physical matrix
+            QMatrix matRef = getRandomQMatrix(1 << NUM_QUBITS);
+            toQureg(mat, matRef);
+            
+            // zero every element which isn't |*outcome*><*outcome*|
+            for (size_t r=0; r<matRef.size(); r++)
+                for (size_t c=0; c<matRef.size(); c++)
+                    if (getOutcome(r) != outcome || getOutcome(c) != outcome)
+                        matRef[r][c] = 0;
+            
+            applyMultiQubitProjector(mat, qubits, numQubits, outcome);
+            REQUIRE( areEqual(mat, matRef) );
+        }
+    }
+    SECTION( "input validation" ) {
+        
+        int numQubits = 3;
+        int qubits[] = {0, 1, 2};
+        
+        SECTION( "number of qubits" ) {
+            
+            numQubits = GENERATE( -1, 0, NUM_QUBITS+1 );
+            REQUIRE_THROWS_WITH( applyMultiQubitProjector(mat, qubits, numQubits, 0), Contains("Invalid number of target qubits") );
+        }
+        SECTION( "qubit indices" ) {
+            
+            qubits[GENERATE_COPY(range(0,numQubits))] = GENERATE( -1, NUM_QUBITS );
+            REQUIRE_THROWS_WITH( applyMultiQubitProjector(mat, qubits, numQubits, 0), Contains("Invalid target qubit") );
+        }
+        SECTION( "repetition of qubits" ) {
+            
+            qubits[GENERATE_COPY(1,2)] = qubits[0];
+            REQUIRE_THROWS_WITH( applyMultiQubitProjector(mat, qubits, numQubits, 0), Contains("qubits must be unique") );
+        }
+        SECTION( "outcome value" ) {
+            
+            long long int outcome = GENERATE( -1, 8 );
+            REQUIRE_THROWS_WITH( applyMultiQubitProjector(mat, qubits, numQubits, outcome), Contains("Invalid measurement outcome") );
+        }
+    }
+    destroyQureg(vec, QUEST_ENV);
+    destroyQureg(mat, QUEST_ENV);
+}
+
+
+
 /** @sa applyMultiVarPhaseFunc
  * @ingroup unittest 
  * @author Tyson Jones 
@@ -2822,6 +2907,49 @@ TEST_CASE( "applyPauliSum", "[operators]" ) {
             // ensure matOut changed correctly 
             REQUIRE( areEqual(matOut, pauliSum * matRef, 1E2*REAL_EPS) );
         }
+        SECTION( "many amplitudes" ) {
+            
+            /* spans several of the blocks (and distributed chunks) in which terms are gathered,
+             * and is compared against explicitly applying each term's Paulis to a clone
+             */
+            int numQb = 14;
+            Qureg big = createQureg(numQb, QUEST_ENV);
+            Qureg bigOut = createQureg(numQb, QUEST_ENV);
+            Qureg work = createQureg(numQb, QUEST_ENV);
+            Qureg ref = createQureg(numQb, QUEST_ENV);
+            toQureg(big, getRandomStateVector(numQb));
+            QVector bigRef = toQVector(big);
+            
+            pauliOpType bigPaulis[numTerms*numQb];
+            qreal bigCoeffs[numTerms];
+            setRandomPauliSum(bigCoeffs, bigPaulis, numQb, numTerms);
+            applyPauliSum(big, bigPaulis, bigCoeffs, numTerms, bigOut);
+            
+            Complex zero = {.real=0, .imag=0};
+            Complex one = {.real=1, .imag=0};
+            initBlankState(ref);
+            for (int t=0; t<numTerms; t++) {
+                cloneQureg(work, big);
+                for (int q=0; q<numQb; q++) {
+                    if (bigPaulis[t*numQb+q] == PAULI_X)
+                        pauliX(work, q);
+                    if (bigPaulis[t*numQb+q] == PAULI_Y)
+                        pauliY(work, q);
+                    if (bigPaulis[t*numQb+q] == PAULI_Z)
+                        pauliZ(work, q);
+                }
+                Complex coeff = {.real=bigCoeffs[t], .imag=0};
+                setWeightedQureg(coeff, work, zero, work, one, ref);
+            }
+            
+            REQUIRE( areEqual(big, bigRef) );
+            REQUIRE( areEqual(bigOut, toQVector(ref), 1E2*REAL_EPS) );
+            
+            destroyQureg(big, QUEST_ENV);
+            destroyQureg(bigOut, QUEST_ENV);
+            destroyQureg(work, QUEST_ENV);
+            destroyQureg(ref, QUEST_ENV);
+        }
     }
     SECTION( "input validation" ) {
         
@@ -3596,6 +3724,49 @@ TEST_CASE( "applyTrotterCircuit", "[operators]" ) {
 
             destroyPauliHamil(hamil);
         }
+        SECTION( "diagonal terms" ) {
+            
+            // diagonal terms are gathered, and here commute with the off-diagonal term
+            PauliHamil hamil = createPauliHamil(NUM_QUBITS, 5);
+            
+            // H = c0 Z Z I I I + c1 I I I X Y + c2 I Z Z I I + c3 I I I I I + c4 Z I I I I
+            int targs[] = {0, 1, 2, 3, 4};
+            pauliOpType codes[] = {
+                PAULI_Z, PAULI_Z, PAULI_I, PAULI_I, PAULI_I,
+                PAULI_I, PAULI_I, PAULI_I, PAULI_X, PAULI_Y,
+                PAULI_I, PAULI_Z, PAULI_Z, PAULI_I, PAULI_I,
+                PAULI_I, PAULI_I, PAULI_I, PAULI_I, PAULI_I,
+                PAULI_Z, PAULI_I, PAULI_I, PAULI_I, PAULI_I};
+            qreal coeffs[5];
+            for (int i=0; i<5; i++)
+                coeffs[i] = getRandomReal(-5,5);
+            initPauliHamil(hamil, coeffs, codes);
+            
+            qreal time = getRandomReal(-2,2);
+            int reps = GENERATE( range(1,5) );
+            
+            // multiRotatePauli (like the Trotter circuit) ignores all-identity global phases
+            SECTION( "state-vector" ) {
+                
+                int order = GENERATE( 1, 2, 4 );
+                
+                applyTrotterCircuit(vec, hamil, time, order, reps);
+                for (int t=0; t<5; t++)
+                    multiRotatePauli(vecRef, targs, &codes[t*NUM_QUBITS], NUM_QUBITS, 2*time*coeffs[t]);
+                REQUIRE( areEqual(vec, vecRef, 10*REAL_EPS) );
+            }
+            SECTION( "density-matrix" ) {
+                
+                int order = GENERATE( 1, 2 ); // precision hurts density matrices quickly
+                
+                applyTrotterCircuit(mat, hamil, time, order, reps);
+                for (int t=0; t<5; t++)
+                    multiRotatePauli(matRef, targs, &codes[t*NUM_QUBITS], NUM_QUBITS, 2*time*coeffs[t]);
+                REQUIRE( areEqual(mat, matRef, 1E2*REAL_EPS) );
+            }
+            
+            destroyPauliHamil(hamil);
+        }
         SECTION( "general" ) {
             
             /* We'll consider an analytic time-evolved state, so that we can avoid 
@@ -3724,3 +3895,80 @@ TEST_CASE( "applyTrotterCircuit", "[operators]" ) {
     destroyQureg(matRef, QUEST_ENV);
 }
 
+
+
+
+/** @sa setPhaseFuncCaching
+ * @ingroup unittest 
+ */
+TEST_CASE( "setPhaseFuncCaching", "[operators]" ) {
+    
+    PREPARE_TEST( quregVec, quregMatr, refVec, refMatr );
+    
+    SECTION( "correctness" ) {
+        
+        // try every kind of binary encodings
+        enum bitEncoding encoding = GENERATE( UNSIGNED,TWOS_COMPLEMENT );
+        
+        // try every sub-register size (of at least 2 qubits, for two's complement)
+        int numQubits = GENERATE_COPY( range(2,NUM_QUBITS+1) );
+        
+        // try every possible sub-register
+        int* qubits = GENERATE_COPY( sublists(range(0,NUM_QUBITS), numQubits) );
+        
+        // a phase function with integer powers, overriding the diverging zero index
+        int numTerms = 3;
+        qreal coeffs[] = {getRandomReal(-10,10), getRandomReal(-10,10), getRandomReal(-10,10)};
+        qreal expons[] = {-1, 1, 2};
+        long long int overrideInds[] = {0LL};
+        qreal overridePhases[] = {getRandomReal(-4,4)};
+        int numOverrides = 1;
+        
+        // build the reference diagonal matrices of the phase function, and of its doubled coefficients
+        QMatrix matr = getZeroMatrix( 1 << numQubits );
+        QMatrix matrDoubled = getZeroMatrix( 1 << numQubits );
+        for (size_t i=0; i<matr.size(); i++) {
+            
+            long long int ind = (encoding == UNSIGNED)? i : getTwosComplement(i, numQubits);
+            qreal phase = 0;
+            for (int t=0; t<numTerms; t++)
+                phase += coeffs[t] * pow(ind, expons[t]);
+            if (ind == 0)
+                phase = overridePhases[0];
+            
+            matr[i][i] = expI(phase);
+            matrDoubled[i][i] = expI((ind == 0)? phase : 2*phase);
+        }
+        
+        // the second application should reuse the first's table, and the third must not
+        setPhaseFuncCaching(QUEST_ENV, 1);
+        
+        SECTION( "state-vector" ) {
+            
+            for (int r=0; r<2; r++) {
+                applyPhaseFuncOverrides(quregVec, qubits, numQubits, encoding, coeffs, expons, numTerms, overrideInds, overridePhases, numOverrides);
+                applyReferenceOp(refVec, qubits, numQubits, matr);
+            }
+            for (int t=0; t<numTerms; t++)
+                coeffs[t] *= 2;
+            applyPhaseFuncOverrides(quregVec, qubits, numQubits, encoding, coeffs, expons, numTerms, overrideInds, overridePhases, numOverrides);
+            applyReferenceOp(refVec, qubits, numQubits, matrDoubled);
+            REQUIRE( areEqual(quregVec, refVec, 1E4*REAL_EPS) );
+        }
+        SECTION( "density-matrix" ) {
+            
+            for (int r=0; r<2; r++) {
+                applyPhaseFuncOverrides(quregMatr, qubits, numQubits, encoding, coeffs, expons, numTerms, overrideInds, overridePhases, numOverrides);
+                applyReferenceOp(refMatr, qubits, numQubits, matr);
+            }
+            for (int t=0; t<numTerms; t++)
+                coeffs[t] *= 2;
+            applyPhaseFuncOverrides(quregMatr, qubits, numQubits, encoding, coeffs, expons, numTerms, overrideInds, overridePhases, numOverrides);
+            applyReferenceOp(refMatr, qubits, numQubits, matrDoubled);
+            REQUIRE( areEqual(quregMatr, refMatr, 1E6*REAL_EPS) );
+        }
+        
+        setPhaseFuncCaching(QUEST_ENV, 0);
+    }
+    CLEANUP_TEST( quregVec, quregMatr );
+}
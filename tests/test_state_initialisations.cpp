@@ -466,9 +466,9 @@ TEST_CASE( "setWeightedQureg", "[state_initialisations]" ) {
             Qureg vecB = createQureg(NUM_QUBITS, QUEST_ENV);
             Qureg vecC = createQureg(NUM_QUBITS, QUEST_ENV);
             for (int j=0; j<vecA.numAmpsPerChunk; j++) {
-                vecA.stateVec.real[j] = getRandomReal(-5,5); vecA.stateVec.imag[j] = getRandomReal(-5,5);
-                vecB.stateVec.real[j] = getRandomReal(-5,5); vecB.stateVec.imag[j] = getRandomReal(-5,5);
-                vecC.stateVec.real[j] = getRandomReal(-5,5); vecC.stateVec.imag[j] = getRandomReal(-5,5);
+                vecA.stateVec.real[AMP_INDEX(j)] = getRandomReal(-5,5); vecA.stateVec.imag[AMP_INDEX(j)] = getRandomReal(-5,5);
+                vecB.stateVec.real[AMP_INDEX(j)] = getRandomReal(-5,5); vecB.stateVec.imag[AMP_INDEX(j)] = getRandomReal(-5,5);
+                vecC.stateVec.real[AMP_INDEX(j)] = getRandomReal(-5,5); vecC.stateVec.imag[AMP_INDEX(j)] = getRandomReal(-5,5);
             }
             copyStateToGPU(vecA); copyStateToGPU(vecB); copyStateToGPU(vecC);
             QVector refA = toQVector(vecA);
@@ -529,9 +529,9 @@ TEST_CASE( "setWeightedQureg", "[state_initialisations]" ) {
             Qureg matB = createDensityQureg(NUM_QUBITS, QUEST_ENV);
             Qureg matC = createDensityQureg(NUM_QUBITS, QUEST_ENV);
             for (int j=0; j<matA.numAmpsPerChunk; j++) {
-                matA.stateVec.real[j] = getRandomReal(-5,5); matA.stateVec.imag[j] = getRandomReal(-5,5);
-                matB.stateVec.real[j] = getRandomReal(-5,5); matB.stateVec.imag[j] = getRandomReal(-5,5);
-                matC.stateVec.real[j] = getRandomReal(-5,5); matC.stateVec.imag[j] = getRandomReal(-5,5);
+                matA.stateVec.real[AMP_INDEX(j)] = getRandomReal(-5,5); matA.stateVec.imag[AMP_INDEX(j)] = getRandomReal(-5,5);
+                matB.stateVec.real[AMP_INDEX(j)] = getRandomReal(-5,5); matB.stateVec.imag[AMP_INDEX(j)] = getRandomReal(-5,5);
+                matC.stateVec.real[AMP_INDEX(j)] = getRandomReal(-5,5); matC.stateVec.imag[AMP_INDEX(j)] = getRandomReal(-5,5);
             }
             copyStateToGPU(matA); copyStateToGPU(matB); copyStateToGPU(matC);
             QMatrix refA = toQMatrix(matA);
@@ -37,6 +37,92 @@
 /* allows concise use of Contains in catch's REQUIRE_THROWS_WITH */
 using Catch::Matchers::Contains;
 
+/** Applies a fixed circuit of assorted gates (of up to 3 qubits, including controls) 
+ * to the given register, which is used to compare deferred and immediate gate application
+ */
+void applyAssortedGates(Qureg qureg, ComplexMatrix2 u1, ComplexMatrix4 u2, ComplexMatrixN u3) {
+    
+    Vector axis = {.x=1, .y=-2, .z=3};
+    int targs[] = {0, 2, 4};
+    int ctrls[] = {3, 1};
+    int ctrlState[] = {0, 1};
+    
+    hadamard(qureg, 0);
+    rotateX(qureg, 1, .1);
+    controlledRotateY(qureg, 2, 3, .2);
+    unitary(qureg, 4, u1);
+    controlledNot(qureg, 0, 4);
+    tGate(qureg, 3);
+    multiQubitUnitary(qureg, targs, 3, u3);
+    sqrtSwapGate(qureg, 1, 3);
+    multiStateControlledUnitary(qureg, ctrls, ctrlState, 2, 0, u1);
+    rotateAroundAxis(qureg, 2, .3, axis);
+    twoQubitUnitary(qureg, 3, 0, u2);
+    multiRotateZ(qureg, targs, 3, .4);
+    controlledPhaseShift(qureg, 4, 1, .5);
+    multiControlledMultiQubitNot(qureg, ctrls, 1, targs, 2);
+    swapGate(qureg, 2, 1);
+    pauliY(qureg, 4);
+    sGate(qureg, 0);
+}
+
+
+
+/** @sa applyDeferredGates
+ * @ingroup unittest 
+ */
+TEST_CASE( "applyDeferredGates", "[unitaries]" ) {
+    
+    PREPARE_TEST( quregVec, quregMatr, refVec, refMatr );
+    
+    SECTION( "correctness" ) {
+        
+        ComplexMatrix2 u1 = toComplexMatrix2(getRandomUnitary(1));
+        ComplexMatrix4 u2 = toComplexMatrix4(getRandomUnitary(2));
+        ComplexMatrixN u3 = createComplexMatrixN(3);
+        toComplexMatrixN(getRandomUnitary(3), u3);
+        
+        int maxNumQubits = GENERATE( range(1,NUM_QUBITS+1) );
+        
+        SECTION( "state-vector" ) {
+            
+            Qureg immediate = createCloneQureg(quregVec, QUEST_ENV);
+            applyAssortedGates(immediate, u1, u2, u3);
+            
+            startDeferringGates(quregVec, maxNumQubits);
+            applyAssortedGates(quregVec, u1, u2, u3);
+            applyDeferredGates(quregVec);
+            REQUIRE( areEqual(quregVec, immediate) );
+            
+            // pending gates are not applied to the amplitudes until needed
+            hadamard(quregVec, 0);
+            REQUIRE( areEqual(quregVec, immediate) );
+            applyDeferredGates(quregVec);
+            hadamard(immediate, 0);
+            REQUIRE( areEqual(quregVec, immediate) );
+            
+            stopDeferringGates(quregVec);
+            destroyQureg(immediate, QUEST_ENV);
+        }
+        SECTION( "density-matrix" ) {
+            
+            Qureg immediate = createCloneQureg(quregMatr, QUEST_ENV);
+            applyAssortedGates(immediate, u1, u2, u3);
+            
+            startDeferringGates(quregMatr, maxNumQubits);
+            applyAssortedGates(quregMatr, u1, u2, u3);
+            applyDeferredGates(quregMatr);
+            REQUIRE( areEqual(quregMatr, immediate, 10*REAL_EPS) );
+            
+            stopDeferringGates(quregMatr);
+            destroyQureg(immediate, QUEST_ENV);
+        }
+        
+        destroyComplexMatrixN(u3);
+    }
+    CLEANUP_TEST( quregVec, quregMatr );
+}
+
 
 
 /** @sa compactUnitary
@@ -2576,6 +2662,121 @@ TEST_CASE( "sqrtSwapGate", "[unitaries]" ) {
 
 
 
+/** @sa startDeferringGates
+ * @ingroup unittest 
+ */
+TEST_CASE( "startDeferringGates", "[unitaries]" ) {
+    
+    PREPARE_TEST( quregVec, quregMatr, refVec, refMatr );
+    
+    SECTION( "correctness" ) {
+        
+        int maxNumQubits = GENERATE( range(1,NUM_QUBITS+1) );
+        int targ = GENERATE( range(0,NUM_QUBITS) );
+        QMatrix op{{1/sqrt(2),1/sqrt(2)},{1/sqrt(2),-1/sqrt(2)}};
+        
+        SECTION( "state-vector" ) {
+            
+            // a non-gate function applies the pending gates before use
+            startDeferringGates(quregVec, maxNumQubits);
+            hadamard(quregVec, targ);
+            applyReferenceOp(refVec, targ, op);
+            Complex amp = getAmp(quregVec, 0);
+            REQUIRE( real(refVec[0]) == Approx(amp.real) );
+            REQUIRE( imag(refVec[0]) == Approx(amp.imag) );
+            REQUIRE( areEqual(quregVec, refVec) );
+            
+            // stopping applies the pending gates
+            hadamard(quregVec, targ);
+            applyReferenceOp(refVec, targ, op);
+            stopDeferringGates(quregVec);
+            REQUIRE( areEqual(quregVec, refVec) );
+        }
+        SECTION( "density-matrix" ) {
+            
+            startDeferringGates(quregMatr, maxNumQubits);
+            hadamard(quregMatr, targ);
+            applyReferenceOp(refMatr, targ, op);
+            stopDeferringGates(quregMatr);
+            REQUIRE( areEqual(quregMatr, refMatr) );
+        }
+    }
+    SECTION( "input validation" ) {
+        
+        SECTION( "number of qubits" ) {
+            
+            int numQb = GENERATE( -1, 0, NUM_QUBITS+1 );
+            REQUIRE_THROWS_WITH( startDeferringGates(quregVec, numQb), Contains("Invalid number of qubits") );
+        }
+    }
+    CLEANUP_TEST( quregVec, quregMatr );
+}
+
+
+
+/** @sa startDeferringGatesInTiles
+ * @ingroup unittest 
+ */
+TEST_CASE( "startDeferringGatesInTiles", "[unitaries]" ) {
+    
+    PREPARE_TEST( quregVec, quregMatr, refVec, refMatr );
+    
+    SECTION( "correctness" ) {
+        
+        ComplexMatrix2 u1 = toComplexMatrix2(getRandomUnitary(1));
+        ComplexMatrix4 u2 = toComplexMatrix4(getRandomUnitary(2));
+        ComplexMatrixN u3 = createComplexMatrixN(3);
+        toComplexMatrixN(getRandomUnitary(3), u3);
+        
+        int maxNumQubits = GENERATE( range(1,4) );
+        int numTileQubits = GENERATE_COPY( range(maxNumQubits,NUM_QUBITS+1) );
+        
+        SECTION( "state-vector" ) {
+            
+            Qureg immediate = createCloneQureg(quregVec, QUEST_ENV);
+            applyAssortedGates(immediate, u1, u2, u3);
+            
+            // gates upon qubits outside the tile swap them into the tile, which is undone when applied
+            startDeferringGatesInTiles(quregVec, maxNumQubits, numTileQubits);
+            applyAssortedGates(quregVec, u1, u2, u3);
+            applyDeferredGates(quregVec);
+            REQUIRE( areEqual(quregVec, immediate) );
+            
+            // non-gate functions see the original qubit ordering
+            applyAssortedGates(quregVec, u1, u2, u3);
+            applyAssortedGates(immediate, u1, u2, u3);
+            Complex amp = getAmp(quregVec, 1);
+            REQUIRE( areEqual(quregVec, immediate) );
+            REQUIRE( amp.real == Approx(getRealAmp(immediate, 1)) );
+            
+            stopDeferringGates(quregVec);
+            destroyQureg(immediate, QUEST_ENV);
+        }
+        
+        destroyComplexMatrixN(u3);
+    }
+    SECTION( "input validation" ) {
+        
+        SECTION( "number of fused qubits" ) {
+            
+            int numQb = GENERATE( -1, 0, NUM_QUBITS+1 );
+            REQUIRE_THROWS_WITH( startDeferringGatesInTiles(quregVec, numQb, NUM_QUBITS), Contains("Invalid number of qubits") );
+        }
+        SECTION( "number of tile qubits" ) {
+            
+            int numTileQb = GENERATE( 1, NUM_QUBITS+1 );
+            REQUIRE_THROWS_WITH( startDeferringGatesInTiles(quregVec, 2, numTileQb), Contains("Invalid number of tile qubits") );
+        }
+        SECTION( "density-matrix" ) {
+            
+            REQUIRE_THROWS_WITH( startDeferringGatesInTiles(quregMatr, 2, 2), Contains("valid only for state-vectors") );
+        }
+    }
+    CLEANUP_TEST( quregVec, quregMatr );
+}
+
+
+
 /** @sa swapGate
  * @ingroup unittest 
  * @author Tyson Jones 
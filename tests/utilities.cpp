@@ -865,8 +865,8 @@ bool areEqual(Qureg qureg1, Qureg qureg2, qreal precision) {
     int ampsAgree = 1;
     for (long long int i=0; ampsAgree && i<qureg1.numAmpsPerChunk; i++)
         ampsAgree = (
-               absReal(qureg1.stateVec.real[i] - qureg2.stateVec.real[i]) < precision
-            && absReal(qureg1.stateVec.imag[i] - qureg2.stateVec.imag[i]) < precision);
+               absReal(qureg1.stateVec.real[AMP_INDEX(i)] - qureg2.stateVec.real[AMP_INDEX(i)]) < precision
+            && absReal(qureg1.stateVec.imag[AMP_INDEX(i)] - qureg2.stateVec.imag[AMP_INDEX(i)]) < precision);
             
     // if one node's partition wasn't equal, all-nodes must report not-equal
     int allAmpsAgree = ampsAgree;
@@ -892,8 +892,8 @@ bool areEqual(Qureg qureg, QVector vec, qreal precision) {
             
     int ampsAgree = 1;
     for (long long int i=0; i<qureg.numAmpsPerChunk; i++) {
-        qreal realDif = absReal(qureg.stateVec.real[i] - real(vec[startInd+i]));
-        qreal imagDif = absReal(qureg.stateVec.imag[i] - imag(vec[startInd+i]));
+        qreal realDif = absReal(qureg.stateVec.real[AMP_INDEX(i)] - real(vec[startInd+i]));
+        qreal imagDif = absReal(qureg.stateVec.imag[AMP_INDEX(i)] - imag(vec[startInd+i]));
 
         if (realDif > precision || imagDif > precision) {
             ampsAgree = 0;
@@ -906,7 +906,7 @@ bool areEqual(Qureg qureg, QVector vec, qreal precision) {
                 REAL_STRING_FORMAT, REAL_STRING_FORMAT, REAL_STRING_FORMAT);
             printf(buff,
                 realDif, imagDif,
-                qureg.stateVec.real[i], qureg.stateVec.imag[i],
+                qureg.stateVec.real[AMP_INDEX(i)], qureg.stateVec.imag[AMP_INDEX(i)],
                 real(vec[startInd+i]), imag(vec[startInd+i]));
             
             break;
@@ -943,8 +943,8 @@ bool areEqual(Qureg qureg, QMatrix matr, qreal precision) {
         globalInd = startInd + i;
         row = globalInd % matr.size();
         col = globalInd / matr.size();
-        qreal realDif = absReal(qureg.stateVec.real[i] - real(matr[row][col]));
-        qreal imagDif = absReal(qureg.stateVec.imag[i] - imag(matr[row][col]));
+        qreal realDif = absReal(qureg.stateVec.real[AMP_INDEX(i)] - real(matr[row][col]));
+        qreal imagDif = absReal(qureg.stateVec.imag[AMP_INDEX(i)] - imag(matr[row][col]));
         ampsAgree = (realDif < precision && imagDif < precision);
         
         // DEBUG
@@ -1100,7 +1100,7 @@ QMatrix toQMatrix(Qureg qureg) {
     long long int dim = (1 << qureg.numQubitsRepresented);
     QMatrix matr = getZeroMatrix(dim);
     for (long long int n=0; n<qureg.numAmpsTotal; n++)
-        matr[n%dim][n/dim] = qcomp(fullRe[n], fullIm[n]);
+        matr[n%dim][n/dim] = qcomp(fullRe[AMP_INDEX(n)], fullIm[AMP_INDEX(n)]);
     
     // clean up if we malloc'd the distributed array
 #ifdef DISTRIBUTED_MODE
@@ -1142,7 +1142,7 @@ QVector toQVector(Qureg qureg) {
     // copy full state vector into a QVector
     QVector vec = QVector(qureg.numAmpsTotal);
     for (long long int i=0; i<qureg.numAmpsTotal; i++)
-        vec[i] = qcomp(fullRe[i], fullIm[i]);
+        vec[i] = qcomp(fullRe[AMP_INDEX(i)], fullIm[AMP_INDEX(i)]);
             
     // clean up if we malloc'd distrib array
 #ifdef DISTRIBUTED_MODE
@@ -1206,8 +1206,8 @@ void toQureg(Qureg qureg, QVector vec) {
     
     for (int i=0; i<qureg.numAmpsPerChunk; i++) {
         int ind = qureg.chunkId*qureg.numAmpsPerChunk + i;
-        qureg.stateVec.real[i] = real(vec[ind]);
-        qureg.stateVec.imag[i] = imag(vec[ind]);
+        qureg.stateVec.real[AMP_INDEX(i)] = real(vec[ind]);
+        qureg.stateVec.imag[AMP_INDEX(i)] = imag(vec[ind]);
     }
     copyStateToGPU(qureg);
 }
@@ -1220,8 +1220,8 @@ void toQureg(Qureg qureg, QMatrix mat) {
     int len = (1 << qureg.numQubitsRepresented);
     for (int i=0; i<qureg.numAmpsPerChunk; i++) {
         int ind = qureg.chunkId*qureg.numAmpsPerChunk + i;
-        qureg.stateVec.real[i] = real(mat[ind%len][ind/len]);
-        qureg.stateVec.imag[i] = imag(mat[ind%len][ind/len]);
+        qureg.stateVec.real[AMP_INDEX(i)] = real(mat[ind%len][ind/len]);
+        qureg.stateVec.imag[AMP_INDEX(i)] = imag(mat[ind%len][ind/len]);
     }
     copyStateToGPU(qureg);
 }